@@ -18,6 +18,7 @@
 #include "rttrDefines.h" // IWYU pragma: keep
 #include "Debug.h"
 #include "GameManager.h"
+#include "Profiler.h"
 #include "QuickStartGame.h"
 #include "RTTR_AssertError.h"
 #include "RTTR_Version.h"
@@ -267,7 +268,7 @@ bool InitDirectories()
     LOG.write("Starting in %s\n", LogTarget::Stdout) % curPath;
 
     // diverse dirs anlegen
-    std::array<unsigned, 9> dirs = {{94, 41, 47, 48, 51, 85, 98, 99, 100}}; // settingsdir muss zuerst angelegt werden (94)
+    std::array<unsigned, 10> dirs = {{94, 41, 47, 48, 51, 85, 98, 99, 100, 101}}; // settingsdir muss zuerst angelegt werden (94)
 
     std::string oldSettingsDir;
 
@@ -377,6 +378,8 @@ int RunProgram(po::variables_map& options)
 
         if(options.count("map"))
             QuickStartGame(options["map"].as<std::string>());
+        if(options.count("profile"))
+            Profiler::setEnabled(true);
 
         // Hauptschleife
         while(GAMEMANAGER.Run())
@@ -388,6 +391,13 @@ int RunProgram(po::variables_map& options)
 
         // Spiel beenden
         GAMEMANAGER.Stop();
+        if(options.count("profile"))
+        {
+            Profiler::setEnabled(false);
+            const std::string profilePath = options["profile"].as<std::string>();
+            if(!Profiler::writeChromeTrace(profilePath))
+                LOG.write("Could not write profiling data to %1%\n") % profilePath;
+        }
         libsiedler2::setAllocator(nullptr);
     } catch(RTTR_AssertError& error)
     {
@@ -420,7 +430,8 @@ int main(int argc, char** argv)
 
     po::options_description desc("Allowed options");
     desc.add_options()("help,h", "Show help")("map,m", po::value<std::string>(),
-                                              "Map to load")("test", "Run in test mode (shows errors during run)");
+                                              "Map to load")("test", "Run in test mode (shows errors during run)")(
+      "profile", po::value<std::string>(), "Record timings of the main subsystems and write them as a Chrome trace to the given file");
     po::positional_options_description positionalOptions;
     positionalOptions.add("map", 1);
 
@@ -48,6 +48,7 @@ void BuildingRegister::Deserialize(SerializedGameData& sgd)
         sgd.PopObjectContainer(building_sites, GOT_BUILDINGSITE);
         sgd.PopObjectContainer(military_buildings, GOT_NOB_MILITARY);
     }
+    RecalcProductivitySums();
 }
 
 void BuildingRegister::Deserialize2(SerializedGameData& sgd)
@@ -58,6 +59,7 @@ void BuildingRegister::Deserialize2(SerializedGameData& sgd)
             sgd.PopObjectContainer(buildings[i], GOT_NOB_USUAL);
         sgd.PopObjectContainer(building_sites, GOT_BUILDINGSITE);
         sgd.PopObjectContainer(military_buildings, GOT_NOB_MILITARY);
+        RecalcProductivitySums();
     }
 }
 
@@ -87,6 +89,7 @@ void BuildingRegister::Add(noBuilding* bld, BuildingType bldType)
     {
         RTTR_Assert(!helpers::contains(buildings[bldType - FIRST_USUAL_BUILDING], bld));
         buildings[bldType - FIRST_USUAL_BUILDING].push_back(static_cast<nobUsual*>(bld));
+        productivitySums[bldType - FIRST_USUAL_BUILDING] += static_cast<nobUsual*>(bld)->GetProductivity();
     }
     if(bldType == BLD_HARBORBUILDING)
     {
@@ -109,6 +112,8 @@ void BuildingRegister::Remove(noBuilding* bld, BuildingType bldType)
     {
         RTTR_Assert(helpers::contains(buildings[bldType - FIRST_USUAL_BUILDING], bld));
         buildings[bldType - FIRST_USUAL_BUILDING].remove(static_cast<nobUsual*>(bld));
+        RTTR_Assert(productivitySums[bldType - FIRST_USUAL_BUILDING] >= static_cast<nobUsual*>(bld)->GetProductivity());
+        productivitySums[bldType - FIRST_USUAL_BUILDING] -= static_cast<nobUsual*>(bld)->GetProductivity();
     }
     if(bldType == BLD_HARBORBUILDING)
     {
@@ -159,33 +164,43 @@ unsigned BuildingRegister::CalcAverageProductivity(BuildingType bldType) const
 {
     if(BLD_WORK_DESC[bldType].producedWare == GD_NOTHING)
         return 0;
-    unsigned productivity = 0;
-    unsigned numBlds = GetBuildings(bldType).size();
-    if(numBlds > 0)
-    {
-        for(const nobUsual* bld : GetBuildings(bldType))
-            productivity += bld->GetProductivity();
-        productivity /= numBlds;
-    }
-    return productivity;
+    const unsigned numBlds = GetBuildings(bldType).size();
+    if(numBlds == 0)
+        return 0;
+    return productivitySums[bldType - FIRST_USUAL_BUILDING] / numBlds;
 }
 
 unsigned short BuildingRegister::CalcAverageProductivity() const
 {
     unsigned totalProductivity = 0;
     unsigned numBlds = 0;
-    for(unsigned i = 0; i < NUM_BUILDING_TYPES; ++i)
+    for(unsigned i = FIRST_USUAL_BUILDING; i < NUM_BUILDING_TYPES; ++i)
     {
         auto bldType = BuildingType(i);
         if(BLD_WORK_DESC[bldType].producedWare == GD_NOTHING)
             continue;
 
-        for(const nobUsual* bld : GetBuildings(bldType))
-            totalProductivity += bld->GetProductivity();
-
+        totalProductivity += productivitySums[bldType - FIRST_USUAL_BUILDING];
         numBlds += GetBuildings(bldType).size();
     }
     if(numBlds == 0)
         return 0;
     return totalProductivity / numBlds;
 }
+
+void BuildingRegister::ChangeProductivity(BuildingType bldType, int change)
+{
+    unsigned& productivitySum = productivitySums[bldType - FIRST_USUAL_BUILDING];
+    RTTR_Assert(change >= 0 || productivitySum >= static_cast<unsigned>(-change));
+    productivitySum += change;
+}
+
+void BuildingRegister::RecalcProductivitySums()
+{
+    for(unsigned i = 0; i < buildings.size(); ++i)
+    {
+        productivitySums[i] = 0;
+        for(const nobUsual* bld : buildings[i])
+            productivitySums[i] += bld->GetProductivity();
+    }
+}
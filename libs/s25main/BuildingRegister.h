@@ -20,6 +20,7 @@
 #define BuildingRegister_h__
 
 #include "gameTypes/BuildingCount.h"
+#include <array>
 #include <list>
 #include <vector>
 
@@ -60,10 +61,17 @@ public:
     unsigned CalcAverageProductivity(BuildingType bldType) const;
     /// Calculate the average productivity for all buildings
     unsigned short CalcAverageProductivity() const;
+    /// Change the summed productivity of all buildings of the given type (productivity of one building changed)
+    void ChangeProductivity(BuildingType bldType, int change);
 
 private:
+    /// Recalculate the productivity sums from the buildings (e.g. after loading)
+    void RecalcProductivitySums();
+
     std::list<noBuildingSite*> building_sites;
     std::array<std::list<nobUsual*>, 30> buildings;
+    /// Sum of the productivities of all buildings per type (same indices as buildings)
+    std::array<unsigned, 30> productivitySums = {};
     std::list<nobMilitary*> military_buildings;
     std::list<nobHarborBuilding*> harbors;
     std::list<nobBaseWarehouse*> warehouses;
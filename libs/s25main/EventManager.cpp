@@ -17,8 +17,10 @@
 
 #include "rttrDefines.h" // IWYU pragma: keep
 #include "EventManager.h"
+#include "EventStatistics.h"
 #include "GameEvent.h"
 #include "GameObject.h"
+#include "Profiler.h"
 #include "SerializedGameData.h"
 #include "helpers/containerUtils.h"
 #include "s25util/Log.h"
@@ -94,10 +96,21 @@ unsigned EventManager::GetNextEventInstanceId()
 
 void EventManager::ExecuteNextGF()
 {
+    ProfilingScope profilingScope(ProfilingZone::Events);
     currentGF++;
 
     ExecuteCurrentEvents();
     DestroyCurrentObjects();
+    if(statistics)
+        statistics->finishGF();
+}
+
+void EventManager::SetStatisticsEnabled(bool enabled)
+{
+    if(!enabled)
+        statistics.reset();
+    else if(!statistics)
+        statistics = std::make_unique<EventStatistics>();
 }
 
 void EventManager::DestroyCurrentObjects()
@@ -149,7 +162,16 @@ void EventManager::ExecuteEvents(const EventMap::iterator& itEvents)
         RTTR_Assert(ev->obj->GetObjId() <= GameObject::GetObjIDCounter());
 
         curActiveEvent = ev;
-        ev->obj->HandleEvent(ev->id);
+        if(statistics)
+        {
+            // Copy values as the object may be destroyed by the event
+            const unsigned objId = ev->obj->GetObjId();
+            const GO_Type got = ev->obj->GetGOT();
+            const EventStatistics::clock::time_point startTime = EventStatistics::clock::now();
+            ev->obj->HandleEvent(ev->id);
+            statistics->addEvent(currentGF, objId, got, ev->id, EventStatistics::clock::now() - startTime);
+        } else
+            ev->obj->HandleEvent(ev->id);
 
         delete ev;
         --numActiveEvents;
@@ -21,8 +21,10 @@
 
 #include <list>
 #include <map>
+#include <memory>
 #include <vector>
 
+class EventStatistics;
 class SerializedGameData;
 class GameEvent;
 class GameObject;
@@ -65,6 +67,11 @@ public:
     /// Return true if the object will be destroyed after the current GF
     bool IsObjectInKillList(const GameObject& obj);
 
+    /// Enable or disable accounting of event counts and run times. Disabling discards the statistics
+    void SetStatisticsEnabled(bool enabled);
+    /// Return the event statistics or nullptr if not enabled
+    const EventStatistics* GetStatistics() const { return statistics.get(); }
+
 protected:
     // Use list to allow removing of events while iterating (Event A can cause Event B in the same GF to be removed)
     using EventList = std::list<const GameEvent*>;
@@ -78,6 +85,7 @@ protected:
     EventMap events;      /// Mapping of GF to Events to be executed in this GF
     GameObjList killList; /// Objects that will be killed after current GF
     const GameEvent* curActiveEvent;
+    std::unique_ptr<EventStatistics> statistics;
 
     const GameEvent* AddEventToQueue(const GameEvent* event);
     void RemoveEventFromQueue(const GameEvent& event);
@@ -0,0 +1,130 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "EventStatistics.h"
+#include <boost/nowide/fstream.hpp>
+#include <algorithm>
+#include <array>
+
+EventStatistics::EventStatistics(unsigned windowLength) : windowLength_(std::max(1u, windowLength)), numGFs_(0), numGFsInWindow_(0) {}
+
+void EventStatistics::addEvent(unsigned gf, unsigned objId, GO_Type got, unsigned eventId, clock::duration time)
+{
+    const auto key = std::make_pair(got, eventId);
+    for(EntryMap* entries : {&curWindow_, &total_})
+    {
+        auto it = entries->find(key);
+        if(it == entries->end())
+            it = entries->emplace(key, Entry{got, eventId, 0, clock::duration::zero(), clock::duration::zero()}).first;
+        Entry& entry = it->second;
+        entry.count++;
+        entry.time += time;
+        entry.maxTime = std::max(entry.maxTime, time);
+    }
+
+    ObjectInfo& objInfo = curObjects_[objId];
+    if(objInfo.numEvents == 0 || objInfo.lastGF != gf)
+        objInfo.numGFs++;
+    objInfo.got = got;
+    objInfo.numEvents++;
+    objInfo.lastGF = gf;
+    objInfo.time += time;
+}
+
+void EventStatistics::finishGF()
+{
+    numGFs_++;
+    if(++numGFsInWindow_ < windowLength_)
+        return;
+
+    lastWindow_.swap(curWindow_);
+    curWindow_.clear();
+
+    suspiciousObjects_.clear();
+    for(const auto& objInfo : curObjects_)
+    {
+        // An object waking up in (almost) every GF usually indicates a busy loop
+        if(objInfo.second.numGFs * 10u >= windowLength_ * 9u)
+        {
+            suspiciousObjects_.push_back(
+              SuspiciousObject{objInfo.first, objInfo.second.got, objInfo.second.numGFs, objInfo.second.numEvents, objInfo.second.time});
+        }
+    }
+    std::sort(suspiciousObjects_.begin(), suspiciousObjects_.end(), [](const SuspiciousObject& lhs, const SuspiciousObject& rhs) {
+        return lhs.numEvents > rhs.numEvents || (lhs.numEvents == rhs.numEvents && lhs.objId < rhs.objId);
+    });
+    curObjects_.clear();
+    numGFsInWindow_ = 0;
+}
+
+std::vector<EventStatistics::Entry> EventStatistics::sortByTime(const EntryMap& entries)
+{
+    std::vector<Entry> result;
+    result.reserve(entries.size());
+    for(const auto& entry : entries)
+        result.push_back(entry.second);
+    std::stable_sort(result.begin(), result.end(), [](const Entry& lhs, const Entry& rhs) { return lhs.time > rhs.time; });
+    return result;
+}
+
+std::vector<EventStatistics::Entry> EventStatistics::getTopEntries(unsigned maxCount) const
+{
+    std::vector<Entry> result = sortByTime(lastWindow_);
+    if(result.size() > maxCount)
+        result.resize(maxCount);
+    return result;
+}
+
+std::vector<EventStatistics::Entry> EventStatistics::getTotalEntries() const
+{
+    return sortByTime(total_);
+}
+
+bool EventStatistics::writeCSV(const boost::filesystem::path& filePath) const
+{
+    using microseconds = std::chrono::microseconds;
+    bnw::ofstream file(filePath);
+    if(!file)
+        return false;
+    file << "Type,Object type,Event id,Count,Total time [us],Max time [us],Average time [us],Object id,Number of GFs\n";
+    for(const Entry& entry : getTotalEntries())
+    {
+        const auto time = std::chrono::duration_cast<microseconds>(entry.time).count();
+        file << "event," << getName(entry.got) << ',' << entry.eventId << ',' << entry.count << ',' << time << ','
+             << std::chrono::duration_cast<microseconds>(entry.maxTime).count() << ',' << time / entry.count << ",,\n";
+    }
+    for(const SuspiciousObject& obj : suspiciousObjects_)
+    {
+        file << "suspicious," << getName(obj.got) << ",," << obj.numEvents << ','
+             << std::chrono::duration_cast<microseconds>(obj.time).count() << ",,," << obj.objId << ',' << obj.numGFs << '\n';
+    }
+    return static_cast<bool>(file);
+}
+
+const char* EventStatistics::getName(GO_Type got)
+{
+    static const std::array<const char*, GOT_NOF_TRADEDONKEY + 1> names = {
+      {"Unknown", "Nothing", "HQ", "Military", "Storehouse", "Usual", "Shipyard", "Harbor", "BuildingSite", "AggrDefender", "Attacker",
+       "Defender", "PassiveSoldier", "Wellguy", "Carrier", "Woodcutter", "Fisher", "Forester", "Carpenter", "Stonemason", "Hunter",
+       "Farmer", "Miller", "Baker", "Butcher", "Miner", "Brewer", "Pigbreeder", "Donkeybreeder", "Ironfounder", "Minter", "Metalworker",
+       "Armorer", "Builder", "Planer", "Geologist", "Shipwright", "FreeScout", "TowerScout", "WarehouseWorker", "Catapultman",
+       "PassiveWorker", "Charburner", "Extension", "EnvObject", "Fire", "Flag", "Grainfield", "Granite", "Sign", "Skeleton",
+       "StaticObject", "DisappearingEnvObject", "Tree", "Animal", "Fighting", "RoadSegment", "Ware", "CatapultStone", "BurnedWarehouse",
+       "ShipBuildingSite", "Ship", "CharburnerPile", "TradeLeader", "TradeDonkey"}};
+    return got < names.size() ? names[got] : "Invalid";
+}
@@ -0,0 +1,98 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EventStatistics_h__
+#define EventStatistics_h__
+
+#include "gameTypes/GO_Type.h"
+#include <boost/filesystem/path.hpp>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+/// Accounts the number and run time of executed events per object type and event id.
+/// Values are aggregated over windows of a fixed number of GFs
+class EventStatistics
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    struct Entry
+    {
+        GO_Type got;
+        unsigned eventId;
+        unsigned count;
+        clock::duration time;
+        clock::duration maxTime;
+    };
+
+    /// Object which had events in (almost) every GF of a window
+    struct SuspiciousObject
+    {
+        unsigned objId;
+        GO_Type got;
+        /// Number of GFs of the window in which the object had at least 1 event
+        unsigned numGFs;
+        unsigned numEvents;
+        clock::duration time;
+    };
+
+    /// @param windowLength Number of GFs to aggregate
+    explicit EventStatistics(unsigned windowLength = 100);
+
+    /// Account an event executed in the current GF
+    void addEvent(unsigned gf, unsigned objId, GO_Type got, unsigned eventId, clock::duration time);
+    /// To be called after all events of the GF are executed
+    void finishGF();
+
+    unsigned getWindowLength() const { return windowLength_; }
+    /// Return the most expensive entries of the last complete window sorted by time (descending)
+    std::vector<Entry> getTopEntries(unsigned maxCount) const;
+    /// Return all entries since accounting was started sorted by time (descending)
+    std::vector<Entry> getTotalEntries() const;
+    /// Return objects that had events in at least 90% of the GFs of the last complete window
+    const std::vector<SuspiciousObject>& getSuspiciousObjects() const { return suspiciousObjects_; }
+    /// Number of GFs accounted in total
+    unsigned getNumGFs() const { return numGFs_; }
+    /// Write the totals and suspicious objects as CSV
+    bool writeCSV(const boost::filesystem::path& filePath) const;
+
+    static const char* getName(GO_Type got);
+
+private:
+    using EntryMap = std::map<std::pair<GO_Type, unsigned>, Entry>;
+    struct ObjectInfo
+    {
+        GO_Type got;
+        unsigned numGFs = 0;
+        unsigned numEvents = 0;
+        unsigned lastGF = 0;
+        clock::duration time = clock::duration::zero();
+    };
+
+    static std::vector<Entry> sortByTime(const EntryMap& entries);
+
+    unsigned windowLength_;
+    unsigned numGFs_, numGFsInWindow_;
+    EntryMap curWindow_, lastWindow_, total_;
+    std::unordered_map<unsigned, ObjectInfo> curObjects_;
+    std::vector<SuspiciousObject> suspiciousObjects_;
+};
+
+#endif // EventStatistics_h__
@@ -20,6 +20,7 @@
 #include "EventManager.h"
 #include "GameInterface.h"
 #include "GamePlayer.h"
+#include "Profiler.h"
 #include "ai/AIPlayer.h"
 #include "lua/LuaInterfaceGame.h"
 #include <boost/optional.hpp>
@@ -67,6 +68,7 @@ unsigned getNumAlivePlayers(const GameWorldBase& world)
 
 void Game::RunGF()
 {
+    ProfilingScope profilingScope(ProfilingZone::GameFrame);
     unsigned numPlayersAlive = getNumAlivePlayers(world_);
     //  EventManager Bescheid sagen
     em_->ExecuteNextGF();
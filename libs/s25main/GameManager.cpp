@@ -63,6 +63,7 @@ bool GameManager::Start()
         return false;
     VIDEODRIVER.setTargetFramerate(SETTINGS.video.vsync);
     VIDEODRIVER.SetMouseWarping(SETTINGS.global.smartCursor);
+    WINDOWMANAGER.SetRetainedMode(SETTINGS.video.retainedGui);
 
     /// Audiodriver laden
     if(!AUDIODRIVER.LoadDriver(SETTINGS.driver.audio))
@@ -25,10 +25,10 @@
 /**
  *  Objekt-ID-Counter.
  */
-unsigned GameObject::objIdCounter_ = 0;
-unsigned GameObject::objCounter_ = 0;
+thread_local unsigned GameObject::objIdCounter_ = 0;
+thread_local unsigned GameObject::objCounter_ = 0;
 
-GameWorldGame* GameObject::gwg = nullptr;
+thread_local GameWorldGame* GameObject::gwg = nullptr;
 
 GameObject::GameObject() : objId(++objIdCounter_)
 {
@@ -65,7 +65,7 @@ protected:
 private:
     unsigned objId; /// unique ID
 
-    // Static members
+    // Static members. They are per thread so independent games can run in parallel on different threads
 public:
     /// Set the currently active world for all game objects
     static void AttachWorld(GameWorldGame* gameWorld);
@@ -90,11 +90,11 @@ public:
 
 protected:
     /// Zugriff auf übrige Spielwelt
-    static GameWorldGame* gwg;
+    static thread_local GameWorldGame* gwg;
 
 private:
-    static unsigned objIdCounter_; /// Objekt-ID-Counter (number of objects created)
-    static unsigned objCounter_;   /// Objekt-Counter (number of objects alive)
+    static thread_local unsigned objIdCounter_; /// Objekt-ID-Counter (number of objects created)
+    static thread_local unsigned objCounter_;   /// Objekt-Counter (number of objects alive)
 };
 
 /// Calls destroy on a GameObject and then deletes it setting the ptr to nullptr
@@ -23,7 +23,6 @@
 #include "GlobalGameSettings.h"
 #include "RoadSegment.h"
 #include "SerializedGameData.h"
-#include "TradePathCache.h"
 #include "Ware.h"
 #include "addons/const_addons.h"
 #include "buildings/noBuildingSite.h"
@@ -55,6 +54,8 @@
 #include "gameData/ShieldConsts.h"
 #include "gameData/ToolConsts.h"
 #include "s25util/Log.h"
+#include <boost/container/small_vector.hpp>
+#include <algorithm>
 #include <limits>
 
 GamePlayer::GamePlayer(unsigned playerId, const PlayerInfo& playerInfo, GameWorldGame& gwg)
@@ -358,6 +359,8 @@ void GamePlayer::Deserialize(SerializedGameData& sgd)
     }
     for(unsigned i = 0; i < NUM_STAT_TYPES; ++i)
         statisticCurrentData[i] = sgd.PopUnsignedInt();
+    // Older games stored only the values of the last statistic step
+    RecalcInventoryStatistics();
 
     for(unsigned i = 0; i < NUM_STAT_MERCHANDISE_TYPES; ++i)
         statisticCurrentMerchandiseData[i] = sgd.PopUnsignedShort();
@@ -378,37 +381,57 @@ template<class T_IsWarehouseGood>
 nobBaseWarehouse* GamePlayer::FindWarehouse(const noRoadNode& start, const T_IsWarehouseGood& isWarehouseGood, bool to_wh,
                                             bool use_boat_roads, unsigned* length, const RoadSegment* forbidden) const
 {
-    nobBaseWarehouse* best = nullptr;
-
-    unsigned best_length = std::numeric_limits<unsigned>::max();
-
+    // Die Wege können nie kürzer als die Luftlinie sein. Daher die Lagerhäuser nach dieser Entfernung sortiert prüfen, damit
+    // möglichst wenige Wegsuchen nötig sind. Bei gleicher Weglänge gewinnt wie bisher das erste Lagerhaus in der Liste
+    struct WhCandidate
+    {
+        nobBaseWarehouse* wh;
+        unsigned minLength;
+        unsigned idx;
+    };
+    boost::container::small_vector<WhCandidate, 16> candidates;
+    unsigned idx = 0;
     for(nobBaseWarehouse* wh : buildings.GetStorehouses())
     {
         // Lagerhaus geeignet?
         RTTR_Assert(wh);
-        if(!isWarehouseGood(*wh))
-            continue;
-
-        if(start.GetPos() == wh->GetPos())
+        if(isWarehouseGood(*wh))
         {
-            // We are already there -> Take it
-            if(length)
-                *length = 0;
-            return wh;
+            if(start.GetPos() == wh->GetPos())
+            {
+                // We are already there -> Take it
+                if(length)
+                    *length = 0;
+                return wh;
+            }
+            candidates.push_back(WhCandidate{wh, gwg.CalcDistance(start.GetPos(), wh->GetPos()), idx});
         }
+        ++idx;
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const WhCandidate& lhs, const WhCandidate& rhs) {
+        return lhs.minLength < rhs.minLength || (lhs.minLength == rhs.minLength && lhs.idx < rhs.idx);
+    });
 
-        // now check if there is at least a chance that the next wh is closer than current best because pathfinding takes time
-        if(gwg.CalcDistance(start.GetPos(), wh->GetPos()) > best_length)
-            continue;
+    nobBaseWarehouse* best = nullptr;
+    unsigned best_length = std::numeric_limits<unsigned>::max();
+    unsigned bestIdx = 0;
+
+    for(const WhCandidate& candidate : candidates)
+    {
+        // No chance to be better than the current best -> neither are all following ones
+        if(best && (candidate.minLength > best_length || (candidate.minLength == best_length && candidate.idx > bestIdx)))
+            break;
         // Bei der erlaubten Benutzung von Bootsstraßen Waren-Pathfinding benutzen wenns zu nem Lagerhaus gehn soll start <-> ziel tauschen
         // bei der wegfindung
         unsigned tlength;
-        if(gwg.GetRoadPathFinder().FindPath(to_wh ? start : *wh, to_wh ? *wh : start, use_boat_roads, best_length, forbidden, &tlength))
+        if(gwg.GetRoadPathFinder().FindPath(to_wh ? start : *candidate.wh, to_wh ? *candidate.wh : start, use_boat_roads, best_length,
+                                            forbidden, &tlength))
         {
-            if(tlength < best_length || !best)
+            if(!best || tlength < best_length || (tlength == best_length && candidate.idx < bestIdx))
             {
                 best_length = tlength;
-                best = wh;
+                best = candidate.wh;
+                bestIdx = candidate.idx;
             }
         }
     }
@@ -1116,29 +1139,56 @@ nobBaseWarehouse* GamePlayer::FindWarehouseForWare(const Ware& ware) const
 
 nobBaseMilitary* GamePlayer::FindClientForCoin(Ware* ware) const
 {
-    nobBaseMilitary* bb = nullptr;
-    unsigned best_points = 0, points;
-
-    // Militärgebäude durchgehen
+    // Punkte aller Militärgebäude berechnen. Der Weg über die Straßen ist nie kürzer als die Luftlinie, also ergibt sich daraus
+    // eine obere Schranke für die endgültigen Punkte. Die Gebäude werden absteigend nach dieser Schranke geprüft, so dass nur für
+    // Gebäude, die noch besser als das bisher beste sein können, ein Weg gesucht werden muss.
+    // Bei Gleichstand gewinnt wie bisher das erste Gebäude in der Liste
+    struct CoinCandidate
+    {
+        nobMilitary* bld;
+        unsigned points;
+        unsigned maxPoints;
+        unsigned idx;
+    };
+    std::vector<CoinCandidate> candidates;
+    const MapPoint wareLocation = ware->GetLocation()->GetPos();
+    unsigned idx = 0;
     for(nobMilitary* milBld : buildings.GetMilitaryBuildings())
     {
-        unsigned way_points;
-
-        points = milBld->CalcCoinsPoints();
+        const unsigned points = milBld->CalcCoinsPoints();
         // Wenn 0, will er gar keine Münzen (Goldzufuhr gestoppt)
         if(points)
         {
-            // Weg dorthin berechnen
-            if(gwg.FindPathForWareOnRoads(*ware->GetLocation(), *milBld, &way_points) != 0xFF)
+            const unsigned minWayPoints = gwg.CalcDistance(wareLocation, milBld->GetPos());
+            // If the way points can exceed the points the (unsigned) result wraps around, so we cannot give an upper bound
+            const unsigned maxPoints = (minWayPoints <= points) ? points - minWayPoints : std::numeric_limits<unsigned>::max();
+            candidates.push_back(CoinCandidate{milBld, points, maxPoints, idx});
+        }
+        ++idx;
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const CoinCandidate& lhs, const CoinCandidate& rhs) {
+        return lhs.maxPoints > rhs.maxPoints || (lhs.maxPoints == rhs.maxPoints && lhs.idx < rhs.idx);
+    });
+
+    nobBaseMilitary* bb = nullptr;
+    unsigned best_points = 0, bestIdx = 0;
+    for(const CoinCandidate& candidate : candidates)
+    {
+        // Kann weder dieses noch eins der folgenden Gebäude besser sein? -> Fertig
+        if(candidate.maxPoints < best_points || (candidate.maxPoints == best_points && (!bb || candidate.idx > bestIdx)))
+            break;
+        unsigned way_points;
+        // Weg dorthin berechnen
+        if(gwg.FindPathForWareOnRoads(*ware->GetLocation(), *candidate.bld, &way_points) != 0xFF)
+        {
+            // Die Wegpunkte noch davon abziehen
+            const unsigned points = candidate.points - way_points;
+            // Besser als der bisher Beste?
+            if(points > best_points || (bb && points == best_points && candidate.idx < bestIdx))
             {
-                // Die Wegpunkte noch davon abziehen
-                points -= way_points;
-                // Besser als der bisher Beste?
-                if(points > best_points)
-                {
-                    best_points = points;
-                    bb = milBld;
-                }
+                best_points = points;
+                bb = candidate.bld;
+                bestIdx = candidate.idx;
             }
         }
     }
@@ -1407,12 +1457,18 @@ void GamePlayer::Surrender()
 void GamePlayer::SetStatisticValue(StatisticType type, unsigned value)
 {
     statisticCurrentData[type] = value;
+    // Total points for tournament games
+    if(type == STAT_MILITARY || type == STAT_VANQUISHED)
+        statisticCurrentData[STAT_TOURNAMENT] = statisticCurrentData[STAT_MILITARY] + 3 * statisticCurrentData[STAT_VANQUISHED];
 }
 
 void GamePlayer::ChangeStatisticValue(StatisticType type, int change)
 {
     assert(statisticCurrentData[type] + change >= 0);
     statisticCurrentData[type] += change;
+    // Total points for tournament games
+    if(type == STAT_MILITARY || type == STAT_VANQUISHED)
+        statisticCurrentData[STAT_TOURNAMENT] = statisticCurrentData[STAT_MILITARY] + 3 * statisticCurrentData[STAT_VANQUISHED];
 }
 
 void GamePlayer::IncreaseMerchandiseStatistic(GoodType type)
@@ -1457,6 +1513,12 @@ void GamePlayer::IncreaseMerchandiseStatistic(GoodType type)
 
 /// Calculates current statistics
 void GamePlayer::CalcStatistics()
+{
+    // Alle anderen Werte werden bei jeder Änderung mitgezählt
+    statisticCurrentData[STAT_PRODUCTIVITY] = buildings.CalcAverageProductivity();
+}
+
+void GamePlayer::RecalcInventoryStatistics()
 {
     // Waren aus der Inventur zählen
     statisticCurrentData[STAT_MERCHANDISE] = 0;
@@ -1473,9 +1535,6 @@ void GamePlayer::CalcStatistics()
                                           + global_inventory.people[JOB_SERGEANT] * 3 + global_inventory.people[JOB_OFFICER] * 4
                                           + global_inventory.people[JOB_GENERAL] * 5;
 
-    // Produktivität berechnen
-    statisticCurrentData[STAT_PRODUCTIVITY] = buildings.CalcAverageProductivity();
-
     // Total points for tournament games
     statisticCurrentData[STAT_TOURNAMENT] = statisticCurrentData[STAT_MILITARY] + 3 * statisticCurrentData[STAT_VANQUISHED];
 }
@@ -1764,14 +1823,42 @@ bool GamePlayer::IsWareDependent(Ware* ware)
     return false;
 }
 
+namespace {
+/// Value of one person of the given job for the military statistic (rank + 1 for soldiers)
+int getMilitaryStatisticValue(const Job job)
+{
+    if(job < JOB_PRIVATE || job > JOB_GENERAL)
+        return 0;
+    return job - JOB_PRIVATE + 1;
+}
+} // namespace
+
 void GamePlayer::IncreaseInventoryWare(const GoodType ware, const unsigned count)
 {
     global_inventory.Add(ConvertShields(ware), count);
+    ChangeStatisticValue(STAT_MERCHANDISE, static_cast<int>(count));
 }
 
 void GamePlayer::DecreaseInventoryWare(const GoodType ware, const unsigned count)
 {
     global_inventory.Remove(ConvertShields(ware), count);
+    ChangeStatisticValue(STAT_MERCHANDISE, -static_cast<int>(count));
+}
+
+void GamePlayer::IncreaseInventoryJob(const Job job, const unsigned count)
+{
+    global_inventory.Add(job, count);
+    ChangeStatisticValue(STAT_INHABITANTS, static_cast<int>(count));
+    if(getMilitaryStatisticValue(job))
+        ChangeStatisticValue(STAT_MILITARY, getMilitaryStatisticValue(job) * static_cast<int>(count));
+}
+
+void GamePlayer::DecreaseInventoryJob(const Job job, const unsigned count)
+{
+    global_inventory.Remove(job, count);
+    ChangeStatisticValue(STAT_INHABITANTS, -static_cast<int>(count));
+    if(getMilitaryStatisticValue(job))
+        ChangeStatisticValue(STAT_MILITARY, -getMilitaryStatisticValue(job) * static_cast<int>(count));
 }
 
 /// Registriert ein Schiff beim Einwohnermeldeamt
@@ -2160,7 +2247,7 @@ std::vector<nobBaseWarehouse*> GamePlayer::GetWarehousesForTrading(const nobBase
     for(nobBaseWarehouse* wh : buildings.GetStorehouses())
     {
         // Is there a trade path from this warehouse to wh? (flag to flag)
-        if(TradePathCache::inst().PathExists(gwg, wh->GetFlag()->GetPos(), goalFlagPos, GetPlayerId()))
+        if(gwg.GetTradePathCache().PathExists(gwg, wh->GetFlag()->GetPos(), goalFlagPos, GetPlayerId()))
             result.push_back(wh);
     }
 
@@ -2230,7 +2317,7 @@ void GamePlayer::Trade(nobBaseWarehouse* goalWh, const GoodType gt, const Job jo
         if(tr.IsValid())
         {
             // Add to cache for future searches
-            TradePathCache::inst().AddEntry(gwg, tr.GetTradePath(), GetPlayerId());
+            gwg.GetTradePathCache().AddEntry(gwg, tr.GetTradePath(), GetPlayerId());
 
             wh->StartTradeCaravane(gt, job, available, tr, goalWh);
             count -= available;
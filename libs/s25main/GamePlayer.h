@@ -97,6 +97,8 @@ public:
     void AddBuildingSite(noBuildingSite* bldSite);
     void RemoveBuildingSite(noBuildingSite* bldSite);
     const BuildingRegister& GetBuildingRegister() const { return buildings; }
+    /// Called when the productivity of one of our buildings changed
+    void ChangeBuildingProductivity(BuildingType type, int change) { buildings.ChangeProductivity(type, change); }
 
     /// Notify that a new road connection exists (not only an existing road splitted)
     void NewRoadConnection(RoadSegment* rs);
@@ -174,8 +176,8 @@ public:
     /// Fügt Waren zur Inventur hinzu
     void IncreaseInventoryWare(GoodType ware, unsigned count);
     void DecreaseInventoryWare(GoodType ware, unsigned count);
-    void IncreaseInventoryJob(const Job job, unsigned count) { global_inventory.Add(job, count); }
-    void DecreaseInventoryJob(const Job job, unsigned count) { global_inventory.Remove(job, count); }
+    void IncreaseInventoryJob(Job job, unsigned count);
+    void DecreaseInventoryJob(Job job, unsigned count);
 
     /// Gibt Inventory-Settings zurück
     const Inventory& GetInventory() const { return global_inventory; }
@@ -318,8 +320,9 @@ public:
 
     void IncreaseMerchandiseStatistic(GoodType type);
 
-    /// Calculates current statistics
+    /// Takes the current values of the statistics that are not counted on every change (productivity)
     void CalcStatistics();
+    /// Shifts the statistics by one step using the current values
     void StatisticStep();
 
     const Statistic& GetStatistic(StatisticTime time) const { return statistic[time]; };
@@ -433,6 +436,8 @@ private:
     bool FindWarehouseForJob(Job job, noRoadNode* goal);
     /// Prüft, ob der Spieler besiegt wurde
     void TestDefeat();
+    /// Recalculates the statistic values that are counted from the inventory (e.g. after loading)
+    void RecalcInventoryStatistics();
 
     //////////////////////////////////////////////////////////////////////////
     /// Unsynchronized state (e.g. lua, gui...)
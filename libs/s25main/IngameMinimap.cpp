@@ -19,14 +19,19 @@
 #include "IngameMinimap.h"
 #include "FOWObjects.h"
 #include "GamePlayer.h"
+#include "Profiler.h"
 #include "world/GameWorldBase.h"
 #include "world/GameWorldViewer.h"
 #include "gameData/MinimapConsts.h"
 #include "gameData/TerrainDesc.h"
 #include "libsiedler2/ColorBGRA.h"
+#include <algorithm>
+#include <future>
+#include <thread>
 
 IngameMinimap::IngameMinimap(const GameWorldViewer& gwv)
     : Minimap(gwv.GetWorld().GetSize()), gwv(gwv), nodes_updated(GetMapSize().x * GetMapSize().y, false),
+      numTiles((GetMapSize() + MapExtent::all(TILE_SIZE - 1)) / TILE_SIZE), nodesToUpdate(numTiles.x * numTiles.y),
       dos(GetMapSize().x * GetMapSize().y, DO_INVALID), territory(true), houses(true), roads(true)
 {
     CreateMapTexture();
@@ -69,7 +74,7 @@ unsigned IngameMinimap::CalcPixelColor(const MapPoint pt, const unsigned t)
         // Baum an dieser Stelle?
         if((!fow && noType == NOP_TREE) || (fow && fot == FOW_TREE)) //-V807
         {
-            color = VaryBrightness(TREE_COLOR, VARY_TREE_COLOR);
+            color = VaryBrightness(TREE_COLOR, VARY_TREE_COLOR, pt, t);
             drawn_object = DO_TERRAIN;
             // Ggf. mit Spielerfarbe
             if(owner)
@@ -82,7 +87,7 @@ unsigned IngameMinimap::CalcPixelColor(const MapPoint pt, const unsigned t)
         // Granit an dieser Stelle?
         else if((!fow && noType == NOP_GRANITE) || (fow && fot == FOW_GRANITE))
         {
-            color = VaryBrightness(GRANITE_COLOR, VARY_GRANITE_COLOR);
+            color = VaryBrightness(GRANITE_COLOR, VARY_GRANITE_COLOR, pt, t);
             drawn_object = DO_TERRAIN;
             // Ggf. mit Spielerfarbe
             if(owner)
@@ -200,7 +205,10 @@ void IngameMinimap::UpdateNode(const MapPoint pt)
     if(!nodes_updated[GetMMIdx(pt)])
     {
         nodes_updated[GetMMIdx(pt)] = true;
-        nodesToUpdate.push_back(pt);
+        const unsigned tileIdx = (pt.y / TILE_SIZE) * numTiles.x + pt.x / TILE_SIZE;
+        if(nodesToUpdate[tileIdx].empty())
+            dirtyTiles.push_back(tileIdx);
+        nodesToUpdate[tileIdx].push_back(pt);
     }
 }
 
@@ -209,36 +217,73 @@ void IngameMinimap::UpdateNode(const MapPoint pt)
  */
 void IngameMinimap::BeforeDrawing()
 {
-    // Ab welcher Knotenanzahl (Teil der Gesamtknotenanzahl) die Textur komplett neu erstellt werden soll
-    static const unsigned MAX_NODES_UPDATE_DENOMINATOR = 2; // (2 = 1/2, 3 = 1/3 usw.)
+    ProfilingScope profilingScope(ProfilingZone::Minimap);
+    // Maximum number of nodes updated per frame (part of all nodes). More updates are delayed to the next frames
+    static const unsigned MAX_NODES_UPDATE_DENOMINATOR = 8; // (2 = 1/2, 3 = 1/3 usw.)
 
-    if(!nodesToUpdate.empty())
+    if(dirtyTiles.empty())
+        return;
+
+    const unsigned maxNodesToUpdate = std::max<unsigned>(nodes_updated.size() / MAX_NODES_UPDATE_DENOMINATOR, TILE_SIZE * TILE_SIZE);
+    unsigned numNodes = 0;
+    auto itEnd = dirtyTiles.begin();
+    for(; itEnd != dirtyTiles.end() && numNodes < maxNodesToUpdate; ++itEnd)
+        numNodes += nodesToUpdate[*itEnd].size();
+    const std::vector<unsigned> tilesToUpdate(dirtyTiles.begin(), itEnd);
+    dirtyTiles.erase(dirtyTiles.begin(), itEnd);
+
+    const std::vector<std::vector<unsigned>> tileColors = CalcTileColors(tilesToUpdate, numNodes);
+
+    // Upload each tile on its own, so only the changed areas are transferred
+    for(unsigned i = 0; i < tilesToUpdate.size(); i++)
     {
-        // Komplette Textur neu erzeugen, weil es zu viele Knoten sind?
-        if(nodesToUpdate.size() >= nodes_updated.size() / MAX_NODES_UPDATE_DENOMINATOR)
+        std::vector<MapPoint>& tileNodes = nodesToUpdate[tilesToUpdate[i]];
+        map.beginUpdate();
+        for(unsigned j = 0; j < tileNodes.size(); j++)
         {
-            // Ja, alles neu erzeugen
-            UpdateAll();
-            std::fill(nodes_updated.begin(), nodes_updated.end(), false);
-        } else
+            const MapPoint pt = tileNodes[j];
+            for(unsigned t = 0; t < 2; ++t)
+            {
+                DrawPoint texPos((pt.x * 2 + t + (pt.y & 1)) % (GetMapSize().x * 2), pt.y);
+                map.updatePixel(texPos, libsiedler2::ColorBGRA(tileColors[i][j * 2 + t]));
+            }
+            nodes_updated[GetMMIdx(pt)] = false;
+        }
+        map.endUpdate();
+        tileNodes.clear();
+    }
+}
+
+std::vector<std::vector<unsigned>> IngameMinimap::CalcTileColors(const std::vector<unsigned>& tiles, unsigned numNodes)
+{
+    // Below this number of nodes starting threads costs more than it saves
+    static const unsigned MIN_NODES_PER_THREAD = 2048;
+
+    std::vector<std::vector<unsigned>> tileColors(tiles.size());
+    // Only reads the world (which does not change while drawing) and writes distinct entries of dos and tileColors
+    const auto calcColors = [this, &tiles, &tileColors](unsigned startIdx, unsigned step) {
+        for(unsigned i = startIdx; i < tiles.size(); i += step)
         {
-            map.beginUpdate();
-            // Entsprechende Pixel updaten
-            for(auto& it : nodesToUpdate)
+            const std::vector<MapPoint>& tileNodes = nodesToUpdate[tiles[i]];
+            std::vector<unsigned>& colors = tileColors[i];
+            colors.resize(tileNodes.size() * 2);
+            for(unsigned j = 0; j < tileNodes.size(); j++)
             {
                 for(unsigned t = 0; t < 2; ++t)
-                {
-                    unsigned color = CalcPixelColor(it, t);
-                    DrawPoint texPos((it.x * 2 + t + (it.y & 1)) % (GetMapSize().x * 2), it.y);
-                    map.updatePixel(texPos, libsiedler2::ColorBGRA(color));
-                }
-                nodes_updated[GetMMIdx(it)] = false;
+                    colors[j * 2 + t] = CalcPixelColor(tileNodes[j], t);
             }
-            map.endUpdate();
         }
+    };
 
-        this->nodesToUpdate.clear();
-    }
+    const unsigned numThreads =
+      std::max(1u, std::min({std::thread::hardware_concurrency(), numNodes / MIN_NODES_PER_THREAD, static_cast<unsigned>(tiles.size())}));
+    std::vector<std::future<void>> workers;
+    for(unsigned i = 1; i < numThreads; i++)
+        workers.push_back(std::async(std::launch::async, calcColors, i, numThreads));
+    calcColors(0, numThreads);
+    for(std::future<void>& worker : workers)
+        worker.get();
+    return tileColors;
 }
 
 /**
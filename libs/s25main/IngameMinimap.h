@@ -31,8 +31,14 @@ class IngameMinimap : public Minimap
     /// Speichert die einzelnen Veränderungen eines jeden Mappunktes, damit nicht unnötigerweise
     /// in einem GF mehrmals der Mappunkt verändert wird
     std::vector<bool> nodes_updated;
-    /// Liste mit allen Punkten, die geändert werden müssen
-    std::vector<MapPoint> nodesToUpdate;
+    /// The map is updated in square tiles of this size (in nodes) which are uploaded separately
+    static constexpr unsigned TILE_SIZE = 32;
+    /// Number of tiles in each direction
+    MapExtent numTiles;
+    /// Points that need to be updated per tile
+    std::vector<std::vector<MapPoint>> nodesToUpdate;
+    /// Tiles with points to update in the order they got dirty
+    std::vector<unsigned> dirtyTiles;
 
     /// Für jeden einzelnen Knoten speichern, welches Objekt hier dominiert, also wessen Pixel angezeigt wird
     enum DrawnObject
@@ -78,6 +84,8 @@ protected:
     /// Zusätzliche Dinge, die die einzelnen Maps vor dem Zeichenvorgang zu tun haben
     /// in dem Falle: Karte aktualisieren
     void BeforeDrawing() override;
+    /// Calculate the colors of the points to update in the given tiles (2 per point) using multiple threads if worthwhile
+    std::vector<std::vector<unsigned>> CalcTileColors(const std::vector<unsigned>& tiles, unsigned numNodes);
     /// Alle Punkte Updaten, bei denen das DrawnObject gleich dem übergebenen drawn_object ist
     void UpdateAll(DrawnObject drawn_object);
 };
@@ -19,6 +19,7 @@
 
 #include "rttrDefines.h" // IWYU pragma: keep
 #include "Loader.h"
+#include "FileChecksum.h"
 #include "ListDir.h"
 #include "RttrConfig.h"
 #include "Settings.h"
@@ -34,6 +35,7 @@
 #include "ogl/glArchivItem_Bob.h"
 #include "ogl/glFont.h"
 #include "ogl/glSmartBitmap.h"
+#include "ogl/glSpriteAtlas.h"
 #include "ogl/glTexturePacker.h"
 #include "gameTypes/Direction.h"
 #include "gameData/JobConsts.h"
@@ -54,12 +56,49 @@
 #include <boost/range/adaptor/map.hpp>
 #include <algorithm>
 #include <cstdio>
+#include <ctime>
 #include <iomanip>
 #include <memory>
 #include <sstream>
 #include <stdexcept>
 
-Loader::Loader() : isWinterGFX_(false), map_gfx(nullptr), stp(nullptr)
+namespace {
+/// Version of the cached data. Increase when the conversion or packing changes
+constexpr uint32_t SOUND_CACHE_VERSION = 1;
+constexpr uint32_t TEXTURE_CACHE_VERSION = 1;
+/// Number of texture caches kept. The loaded nations and map gfx set differ between games and menus
+constexpr unsigned MAX_TEXTURE_CACHE_FILES = 8;
+
+void addToChecksum(uint32_t& checksum, uint32_t value)
+{
+    checksum = checksum * 31u + value;
+}
+
+/// Add the names and contents of the given file or all files in the given folder to the checksum
+void addFileToChecksum(uint32_t& checksum, const std::string& filePath)
+{
+    addToChecksum(checksum, CalcChecksumOfBuffer(filePath.c_str(), filePath.size()));
+    if(bfs::is_directory(filePath))
+    {
+        std::vector<std::string> folderFiles;
+        for(const auto& it : bfs::recursive_directory_iterator(filePath))
+        {
+            if(bfs::is_regular_file(it.status()))
+                folderFiles.push_back(it.path().string());
+        }
+        std::sort(folderFiles.begin(), folderFiles.end());
+        for(const std::string& folderFile : folderFiles)
+            addFileToChecksum(checksum, folderFile);
+    } else
+    {
+        addToChecksum(checksum, CalcChecksumOfFile(filePath));
+        boost::system::error_code ec;
+        addToChecksum(checksum, static_cast<uint32_t>(bfs::file_size(filePath, ec)));
+    }
+}
+} // namespace
+
+Loader::Loader() : spriteAtlas_(std::make_unique<glSpriteAtlas>()), isWinterGFX_(false), map_gfx(nullptr), stp(nullptr)
 {
     std::fill(nation_gfx.begin(), nation_gfx.end(), static_cast<libsiedler2::Archiv*>(nullptr));
 }
@@ -234,16 +273,37 @@ bool Loader::LoadSounds()
     std::string soundLSTPath = RTTRCONFIG.ExpandPath(FILE_PATHS[55]);
     if(bfs::exists(soundLSTPath))
         bfs::remove(soundLSTPath);
-    if(!LoadFile(RTTRCONFIG.ExpandPath(FILE_PATHS[49])))
-        return false;
-    auto const convertStartTime = VIDEODRIVER.GetTickCount();
-    LOG.write(_("Starting sound conversion..."));
-    if(!convertSounds(GetArchive("sound"), RTTRCONFIG.ExpandPath(FILE_PATHS[56])))
+
+    // The conversion is expensive so use the cached result if neither the sounds (including overrides) nor the script changed
+    const std::string soundPath = RTTRCONFIG.ExpandPath(FILE_PATHS[49]);
+    const std::string scriptPath = RTTRCONFIG.ExpandPath(FILE_PATHS[56]);
+    uint32_t checksum = SOUND_CACHE_VERSION;
+    for(const std::string& filePath : GetFilesToLoad(soundPath))
+        addFileToChecksum(checksum, filePath);
+    addFileToChecksum(checksum, scriptPath);
+    // Only changes with updated game files so one cache is enough.
+    // Note: It is read with the regular LST loader which takes a path and copies every sound into its item,
+    // so memory-mapping the file would not avoid any copy
+    const bfs::path cachedSoundPath = GetCacheFilePath("sound", checksum, ".lst", 1);
+
+    FileEntry& soundEntry = files_["sound"];
+    if(bfs::exists(cachedSoundPath) && LoadArchiv(soundEntry.archiv, cachedSoundPath.string()))
+        soundEntry.filesUsed = GetFilesToLoad(soundPath);
+    else
     {
-        LOG.write(_("failed\n"));
-        return false;
+        if(!LoadFile(soundPath))
+            return false;
+        auto const convertStartTime = VIDEODRIVER.GetTickCount();
+        LOG.write(_("Starting sound conversion..."));
+        if(!convertSounds(GetArchive("sound"), scriptPath))
+        {
+            LOG.write(_("failed\n"));
+            return false;
+        }
+        LOG.write(_("done in %ums\n")) % (VIDEODRIVER.GetTickCount() - convertStartTime);
+        if(int ec = libsiedler2::Write(cachedSoundPath.string(), GetArchive("sound")))
+            LOG.write(_("Could not write sound cache %1%: %2%\n")) % cachedSoundPath.string() % libsiedler2::getErrorString(ec);
     }
-    LOG.write(_("done in %ums\n")) % (VIDEODRIVER.GetTickCount() - convertStartTime);
 
     const std::string oggPath = RTTRCONFIG.ExpandPath(FILE_PATHS[50]);
     std::vector<std::string> oggFiles = ListDir(oggPath, "ogg");
@@ -424,6 +484,17 @@ bool Loader::LoadFiles(const std::vector<std::string>& files)
 void Loader::fillCaches()
 {
     stp = std::make_unique<glTexturePacker>();
+    spriteAtlas_->clear();
+    spriteAtlas_->resetStats();
+    spriteAtlas_->setMemoryBudget(static_cast<uint64_t>(SETTINGS.video.textureMemoryBudget) * 1024u * 1024u);
+    // Nation specific bitmaps and animals are many but only few are visible at once. So pack them on demand if possible
+    const bool useSpriteAtlas = SETTINGS.video.shared_textures && SETTINGS.video.textureMemoryBudget > 0;
+    const auto addOnDemand = [this, useSpriteAtlas](glSmartBitmap& bmp) {
+        if(useSpriteAtlas)
+            bmp.setAtlas(spriteAtlas_.get());
+        else
+            stp->add(bmp);
+    };
 
     // Animals
     for(unsigned species = 0; species < NUM_SPECS; ++species)
@@ -449,7 +520,7 @@ void Loader::fillCaches()
                         bmp.addShadow(GetMapImageN(ANIMALCONSTS[species].shadow_id + (dir + 3) % 6));
                 }
 
-                stp->add(bmp);
+                addOnDemand(bmp);
             }
         }
 
@@ -466,7 +537,7 @@ void Loader::fillCaches()
                 bmp.addShadow(GetMapImageN(ANIMALCONSTS[species].shadow_dead_id));
             }
 
-            stp->add(bmp);
+            addOnDemand(bmp);
         }
     }
 
@@ -510,8 +581,8 @@ void Loader::fillCaches()
                 }
             }
 
-            stp->add(bmp);
-            stp->add(skel);
+            addOnDemand(bmp);
+            addOnDemand(skel);
         }
 
         // FLAGS
@@ -590,7 +661,7 @@ void Loader::fillCaches()
                     bmp.add(dynamic_cast<glArchivItem_Bitmap_Player*>(bob_jobs->get(overlayOffset + bob_jobs->getLink(good))));
                     bmp.addShadow(GetMapImageN(900 + ((dir + 3) % 6) * 8 + ani_step));
 
-                    stp->add(bmp);
+                    addOnDemand(bmp);
                 }
             }
         }
@@ -602,7 +673,7 @@ void Loader::fillCaches()
         bmp.add(GetNationPlayerImage(nation, 0));
         bmp.addShadow(GetNationImage(nation, 1));
 
-        stp->add(bmp);
+        addOnDemand(bmp);
     }
 
     // BUILDING FLAG ANIMATION (for military buildings)
@@ -800,12 +871,72 @@ void Loader::fillCaches()
 
     if(SETTINGS.video.shared_textures)
     {
-        // generate mega texture
-        stp->pack();
+        // generate mega texture. As this requires compositing all bitmaps the result is cached per set of loaded files
+        uint32_t checksum = TEXTURE_CACHE_VERSION;
+        addToChecksum(checksum, CalcLoadedFilesChecksum());
+        addToChecksum(checksum, isWinterGFX_ ? 1 : 0);
+        std::string cacheName = "textures";
+        for(const auto& file : files_)
+        {
+            if(&file.second.archiv == map_gfx)
+                cacheName += "_" + file.first;
+        }
+        stp->pack(GetCacheFilePath(cacheName, checksum, ".dat", MAX_TEXTURE_CACHE_FILES));
     } else
         stp.reset();
 }
 
+bfs::path Loader::GetCacheFilePath(const std::string& name, uint32_t checksum, const std::string& extension, unsigned maxNumFiles)
+{
+    RTTR_Assert(maxNumFiles > 0u);
+    const bfs::path cacheFolder = RTTRCONFIG.ExpandPath(FILE_PATHS[101]);
+    std::stringstream fileName;
+    fileName << name << "_" << std::setw(8) << std::setfill('0') << std::hex << checksum << extension;
+    const bfs::path cacheFilePath = cacheFolder / fileName.str();
+
+    boost::system::error_code ec;
+    if(!bfs::is_directory(cacheFolder, ec))
+    {
+        bfs::create_directories(cacheFolder, ec);
+        return cacheFilePath;
+    }
+    // Mark as recently used
+    if(bfs::exists(cacheFilePath, ec))
+        bfs::last_write_time(cacheFilePath, std::time(nullptr), ec);
+
+    std::vector<std::pair<std::time_t, bfs::path>> otherFiles;
+    for(const auto& it : bfs::directory_iterator(cacheFolder, ec))
+    {
+        const bfs::path& curPath = it.path();
+        const std::string curFileName = curPath.filename().string();
+        if(curPath != cacheFilePath && curPath.extension() == extension && curFileName.size() == fileName.str().size()
+           && curFileName.compare(0, name.size() + 1, name + "_") == 0)
+            otherFiles.emplace_back(bfs::last_write_time(curPath, ec), curPath);
+    }
+    // Remove the least recently used files leaving space for the requested one
+    if(otherFiles.size() >= maxNumFiles)
+    {
+        std::sort(otherFiles.begin(), otherFiles.end());
+        for(unsigned i = 0; i <= otherFiles.size() - maxNumFiles; i++)
+            bfs::remove(otherFiles[i].second, ec);
+    }
+    return cacheFilePath;
+}
+
+uint32_t Loader::CalcLoadedFilesChecksum() const
+{
+    uint32_t checksum = 0;
+    for(const auto& file : files_)
+    {
+        if(file.second.archiv.empty())
+            continue;
+        addToChecksum(checksum, CalcChecksumOfBuffer(file.first.c_str(), file.first.size()));
+        for(const std::string& filePath : file.second.filesUsed)
+            addFileToChecksum(checksum, filePath);
+    }
+    return checksum;
+}
+
 /**
  *  Extrahiert eine Textur aus den Daten.
  */
@@ -951,10 +1082,12 @@ bool Loader::LoadFile(const std::string& pfad, const libsiedler2::ArchivItem_Pal
     // Load if: 1. Not loaded
     //          2. archive content changed BUT we are not loading an override file or the file wasn't loaded since the last override
     //          change
-    if(entry.archiv.empty() || (entry.filesUsed != GetFilesToLoad(pfad) && (!isFromOverrideDir || !entry.loadedAfterOverrideChange)))
+    const std::vector<std::string> filesToLoad = GetFilesToLoad(pfad);
+    if(entry.archiv.empty() || (entry.filesUsed != filesToLoad && (!isFromOverrideDir || !entry.loadedAfterOverrideChange)))
     {
         if(!LoadFile(entry.archiv, pfad, palette))
             return false;
+        entry.filesUsed = filesToLoad;
         entry.loadedAfterOverrideChange = true;
     }
     return true;
@@ -30,6 +30,7 @@
 #include "gameData/AnimalConsts.h"
 #include "libsiedler2/Archiv.h"
 #include "s25util/Singleton.h"
+#include <boost/filesystem/path.hpp>
 #include <array>
 #include <cstdint>
 #include <map>
@@ -46,6 +47,7 @@ class glArchivItem_Bob;
 class glFont;
 class SoundEffectItem;
 class glTexturePacker;
+class glSpriteAtlas;
 namespace libsiedler2 {
 class ArchivItem_Ini;
 class ArchivItem_Palette;
@@ -78,6 +80,8 @@ class Loader : public Singleton<Loader, SingletonPolicies::WithLongevity>
         /// Filenames in the folder
         std::vector<std::string> files;
     };
+    /// Atlas for bitmaps packed on demand. Declared before the caches as those reference it
+    std::unique_ptr<glSpriteAtlas> spriteAtlas_;
 
 public:
     static constexpr unsigned Longevity = 19;
@@ -136,6 +140,7 @@ public:
     glArchivItem_Bitmap_Player* GetMapPlayerImage(unsigned nr);
 
     bool IsWinterGFX() const { return isWinterGFX_; }
+    const glSpriteAtlas& GetSpriteAtlas() const { return *spriteAtlas_; }
 
     libsiedler2::Archiv sng_lst;
 
@@ -174,6 +179,13 @@ private:
     /// Lädt alle Sounds.
     bool LoadSounds();
 
+    /// Get the path of the cache file for the given name whose contents depend on the given checksum.
+    /// At most maxNumFiles files with the same name are kept, the least recently used ones are removed
+    static boost::filesystem::path GetCacheFilePath(const std::string& name, uint32_t checksum, const std::string& extension,
+                                                    unsigned maxNumFiles);
+    /// Calculate a checksum over all source files used for the currently loaded archives
+    uint32_t CalcLoadedFilesChecksum() const;
+
     /// Load a file into the archiv
     bool LoadSingleFile(libsiedler2::Archiv& to, const std::string& filePath, const libsiedler2::ArchivItem_Palette* palette = nullptr);
     bool LoadArchiv(libsiedler2::Archiv& archiv, const std::string& pfad, const libsiedler2::ArchivItem_Palette* palette = nullptr);
@@ -0,0 +1,534 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "MapFileCache.h"
+#include "FileChecksum.h"
+#include "PreviewMinimap.h"
+#include "mygettext/mygettext.h"
+#include "ogl/glArchivItem_Map.h"
+#include "libsiedler2/ArchivItem_Map_Header.h"
+#include "libsiedler2/ErrorCodes.h"
+#include "s25util/Log.h"
+#include "s25util/Serializer.h"
+#include "s25util/ucString.h"
+#include <boost/filesystem/operations.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/iostreams/stream.hpp>
+#include <boost/nowide/fstream.hpp>
+#include <algorithm>
+#include <bzlib.h>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+
+namespace bio = boost::iostreams;
+
+namespace {
+/// Increase when the format of the cache file changes
+const unsigned CACHE_VERSION = 2;
+/// Increase when the format of the thumbnail files changes
+const unsigned THUMBNAIL_VERSION = 1;
+
+/// Load the map from the memory-mapped file. Returns the error message on failure.
+/// Only the header is read unless the checksum is requested, which needs the whole file anyway
+std::string loadMap(const std::string& filePath, glArchivItem_Map& map, uint32_t* checksum = nullptr)
+{
+    try
+    {
+        bio::mapped_file_source file;
+        file.open(bfs::path(filePath));
+        const bool onlyHeader = !checksum;
+        if(checksum)
+            *checksum = CalcChecksumOfBuffer(file.data(), file.size());
+        bio::stream<bio::array_source> stream(file.data(), file.size());
+        if(int ec = map.load(stream, onlyHeader))
+            return libsiedler2::getErrorString(ec);
+    } catch(const std::exception& e)
+    {
+        return e.what();
+    }
+    return "";
+}
+
+bool getFileState(const std::string& filePath, uint32_t& fileSize, std::time_t& lastWriteTime)
+{
+    boost::system::error_code ec;
+    const auto size = bfs::file_size(filePath, ec);
+    if(ec)
+        return false;
+    lastWriteTime = bfs::last_write_time(filePath, ec);
+    fileSize = static_cast<uint32_t>(size);
+    return !ec;
+}
+
+MapFileInfo makeInfo(const std::string& filePath, const glArchivItem_Map& map)
+{
+    const libsiedler2::ArchivItem_Map_Header& header = map.getHeader();
+    MapFileInfo info;
+    info.filePath = filePath;
+    info.name = cvStringToUTF8(header.getName());
+    info.author = cvStringToUTF8(header.getAuthor());
+    info.numPlayers = header.getNumPlayers();
+    info.gfxSet = header.getGfxSet();
+    info.width = header.getWidth();
+    info.height = header.getHeight();
+    return info;
+}
+
+std::shared_ptr<const MapThumbnail> makeThumbnail(const glArchivItem_Map& map)
+{
+    auto thumbnail = std::make_shared<MapThumbnail>();
+    thumbnail->size = MapExtent(map.getHeader().getWidth(), map.getHeader().getHeight());
+    thumbnail->pixels = PreviewMinimap::CalcPixels(map);
+    thumbnail->startPositions = PreviewMinimap::FindStartPositions(map);
+    return thumbnail;
+}
+
+/// Read a thumbnail written by saveThumbnail. Returns nullptr if it does not exist or is invalid
+std::shared_ptr<const MapThumbnail> loadThumbnail(const bfs::path& filePath)
+{
+    bnw::ifstream file(filePath, std::ios::binary);
+    if(!file)
+        return nullptr;
+    const std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    try
+    {
+        Serializer ser(data.data(), data.size());
+        if(ser.PopUnsignedInt() != THUMBNAIL_VERSION)
+            return nullptr;
+        auto thumbnail = std::make_shared<MapThumbnail>();
+        thumbnail->size.x = ser.PopUnsignedShort();
+        thumbnail->size.y = ser.PopUnsignedShort();
+        if(ser.PopUnsignedChar() != thumbnail->startPositions.size())
+            return nullptr;
+        for(MapPoint& pos : thumbnail->startPositions)
+        {
+            pos.x = ser.PopUnsignedShort();
+            pos.y = ser.PopUnsignedShort();
+        }
+        const unsigned compressedSize = ser.PopUnsignedInt();
+        if(ser.GetBytesLeft() != compressedSize)
+            return nullptr;
+        std::vector<char> compressedPixels(compressedSize);
+        ser.PopRawData(compressedPixels.data(), compressedSize);
+        thumbnail->pixels.resize(static_cast<size_t>(thumbnail->size.x) * 2u * thumbnail->size.y);
+        const unsigned pixelsSize = thumbnail->pixels.size() * sizeof(unsigned);
+        unsigned decompressedSize = pixelsSize;
+        auto* pixels = reinterpret_cast<char*>(thumbnail->pixels.data());
+        const int err = BZ2_bzBuffToBuffDecompress(pixels, &decompressedSize, compressedPixels.data(), compressedSize, 0, 0);
+        if(err != BZ_OK || decompressedSize != pixelsSize)
+            return nullptr;
+        return thumbnail;
+    } catch(const std::exception&)
+    {
+        return nullptr;
+    }
+}
+
+void saveThumbnail(const bfs::path& filePath, const MapThumbnail& thumbnail)
+{
+    // The minimap has large areas of the same color, so it compresses well
+    const unsigned pixelsSize = thumbnail.pixels.size() * sizeof(unsigned);
+    // Source is not modified, the API just lacks the const
+    auto* pixels = const_cast<char*>(reinterpret_cast<const char*>(thumbnail.pixels.data()));
+    std::vector<char> compressedPixels(pixelsSize + pixelsSize / 100 + 600); // At most 1% bigger + 600 Bytes according to docu
+    unsigned compressedSize = compressedPixels.size();
+    if(BZ2_bzBuffToBuffCompress(compressedPixels.data(), &compressedSize, pixels, pixelsSize, 9, 0, 0) != BZ_OK)
+    {
+        LOG.write(_("Could not write map preview %1%\n")) % filePath.string();
+        return;
+    }
+
+    Serializer ser;
+    ser.PushUnsignedInt(THUMBNAIL_VERSION);
+    ser.PushUnsignedShort(thumbnail.size.x);
+    ser.PushUnsignedShort(thumbnail.size.y);
+    ser.PushUnsignedChar(thumbnail.startPositions.size());
+    for(const MapPoint& pos : thumbnail.startPositions)
+    {
+        ser.PushUnsignedShort(pos.x);
+        ser.PushUnsignedShort(pos.y);
+    }
+    ser.PushUnsignedInt(compressedSize);
+    ser.PushRawData(compressedPixels.data(), compressedSize);
+
+    boost::system::error_code ec;
+    bfs::create_directories(filePath.parent_path(), ec);
+    bnw::ofstream file(filePath, std::ios::binary);
+    if(!file.write(reinterpret_cast<const char*>(ser.GetData()), ser.GetLength()))
+        LOG.write(_("Could not write map preview %1%\n")) % filePath.string();
+}
+} // namespace
+
+MapFileCache::MapFileCache(boost::filesystem::path cacheDir, unsigned maxPreviews)
+    : cacheDir_(std::move(cacheDir)), cacheFilePath_(cacheDir_.empty() ? bfs::path() : cacheDir_ / "mapInfos.dat"),
+      maxPreviews_(maxPreviews), stop_(false), entriesChanged_(false), scanId_(0), isScanningFile_(false)
+{
+    Load();
+    worker_ = std::thread(&MapFileCache::Run, this);
+}
+
+MapFileCache::~MapFileCache()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    workAvailable_.notify_all();
+    worker_.join();
+    if(entriesChanged_)
+        Save();
+}
+
+void MapFileCache::Scan(std::vector<std::string> files)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        filesToScan_.assign(std::make_move_iterator(files.begin()), std::make_move_iterator(files.end()));
+        scannedInfos_.clear();
+        ++scanId_;
+    }
+    workAvailable_.notify_all();
+}
+
+std::vector<MapFileInfo> MapFileCache::GetScannedInfos()
+{
+    std::vector<MapFileInfo> result;
+    std::lock_guard<std::mutex> lock(mutex_);
+    swap(result, scannedInfos_);
+    return result;
+}
+
+bool MapFileCache::IsScanning() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !filesToScan_.empty() || isScanningFile_;
+}
+
+bool MapFileCache::GetPreviewLocked(const std::string& filePath, MapPreview& preview)
+{
+    const auto itError = previewErrors_.find(filePath);
+    if(itError != previewErrors_.end())
+    {
+        preview.error = itError->second;
+        return false;
+    }
+    const auto itEntry = entries_.find(filePath);
+    if(itEntry != entries_.end() && itEntry->second.hasChecksum)
+    {
+        const uint32_t checksum = itEntry->second.checksum;
+        const auto itPreview =
+          std::find_if(previews_.begin(), previews_.end(), [checksum](const auto& curPreview) { return curPreview.first == checksum; });
+        if(itPreview != previews_.end())
+        {
+            // Mark as most recently used
+            previews_.splice(previews_.begin(), previews_, itPreview);
+            preview.thumbnail = itPreview->second;
+            preview.info = itEntry->second.info;
+            return false;
+        }
+    }
+    return filePath != loadingPreviewPath_;
+}
+
+MapPreview MapFileCache::RequestPreview(const std::string& filePath)
+{
+    MapPreview preview;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if(!GetPreviewLocked(filePath, preview))
+            return preview;
+        const auto it = std::find(previewsToLoad_.begin(), previewsToLoad_.end(), filePath);
+        if(it != previewsToLoad_.end())
+        {
+            if(it == previewsToLoad_.begin())
+                return preview;
+            previewsToLoad_.erase(it);
+        }
+        previewsToLoad_.push_front(filePath);
+    }
+    workAvailable_.notify_all();
+    return preview;
+}
+
+void MapFileCache::PrefetchPreview(const std::string& filePath)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        MapPreview preview;
+        if(!GetPreviewLocked(filePath, preview))
+            return;
+        if(std::find(previewsToLoad_.begin(), previewsToLoad_.end(), filePath) != previewsToLoad_.end())
+            return;
+        previewsToLoad_.push_back(filePath);
+    }
+    workAvailable_.notify_all();
+}
+
+void MapFileCache::Invalidate(const std::string& filePath)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    previewErrors_.erase(filePath);
+    const auto itEntry = entries_.find(filePath);
+    if(itEntry == entries_.end())
+        return;
+    if(itEntry->second.hasChecksum)
+    {
+        const uint32_t checksum = itEntry->second.checksum;
+        previews_.remove_if([checksum](const auto& curPreview) { return curPreview.first == checksum; });
+    }
+    entries_.erase(itEntry);
+    entriesChanged_ = true;
+}
+
+void MapFileCache::Run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while(true)
+    {
+        workAvailable_.wait(lock, [this]() { return stop_ || !previewsToLoad_.empty() || !filesToScan_.empty(); });
+        if(stop_)
+            return;
+        // Previews are what the user is looking at, so they come first
+        if(!previewsToLoad_.empty())
+        {
+            loadingPreviewPath_ = previewsToLoad_.front();
+            previewsToLoad_.pop_front();
+            const std::string filePath = loadingPreviewPath_;
+            lock.unlock();
+            LoadPreview(filePath);
+            lock.lock();
+            loadingPreviewPath_.clear();
+        } else
+        {
+            const std::string filePath = filesToScan_.front();
+            filesToScan_.pop_front();
+            isScanningFile_ = true;
+            lock.unlock();
+            ScanFile(filePath);
+            lock.lock();
+        }
+    }
+}
+
+void MapFileCache::ScanFile(const std::string& filePath)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    const unsigned scanId = scanId_;
+    lock.unlock();
+
+    MapFileInfo info;
+    bool isValid = false;
+    uint32_t fileSize;
+    std::time_t lastWriteTime;
+    if(getFileState(filePath, fileSize, lastWriteTime))
+    {
+        lock.lock();
+        const auto itEntry = entries_.find(filePath);
+        if(itEntry != entries_.end() && itEntry->second.fileSize == fileSize && itEntry->second.lastWriteTime == lastWriteTime)
+        {
+            info = itEntry->second.info;
+            isValid = true;
+        }
+        lock.unlock();
+        if(!isValid)
+        {
+            glArchivItem_Map map;
+            if(loadMap(filePath, map).empty())
+            {
+                info = makeInfo(filePath, map);
+                isValid = true;
+                lock.lock();
+                entries_[filePath] = CacheEntry{fileSize, lastWriteTime, false, 0, info};
+                entriesChanged_ = true;
+                lock.unlock();
+            }
+        }
+        info.hasLua = bfs::is_regular_file(bfs::path(filePath).replace_extension("lua"));
+    }
+
+    lock.lock();
+    isScanningFile_ = false;
+    if(isValid && scanId == scanId_)
+        scannedInfos_.push_back(std::move(info));
+}
+
+void MapFileCache::LoadPreview(const std::string& filePath)
+{
+    uint32_t fileSize;
+    std::time_t lastWriteTime;
+    const bool hasFileState = getFileState(filePath, fileSize, lastWriteTime);
+    if(hasFileState && !cacheDir_.empty())
+    {
+        // Use the stored thumbnail if the file did not change since its checksum was calculated
+        std::unique_lock<std::mutex> lock(mutex_);
+        const auto itEntry = entries_.find(filePath);
+        if(itEntry != entries_.end() && itEntry->second.hasChecksum && itEntry->second.fileSize == fileSize
+           && itEntry->second.lastWriteTime == lastWriteTime)
+        {
+            const uint32_t checksum = itEntry->second.checksum;
+            lock.unlock();
+            std::shared_ptr<const MapThumbnail> thumbnail = loadThumbnail(GetThumbnailPath(checksum));
+            if(thumbnail)
+            {
+                lock.lock();
+                AddPreviewLocked(checksum, std::move(thumbnail));
+                return;
+            }
+        }
+    }
+
+    glArchivItem_Map map;
+    uint32_t checksum;
+    const std::string error = loadMap(filePath, map, &checksum);
+    std::shared_ptr<const MapThumbnail> thumbnail;
+    if(error.empty())
+    {
+        thumbnail = makeThumbnail(map);
+        if(!cacheDir_.empty())
+            saveThumbnail(GetThumbnailPath(checksum), *thumbnail);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if(!error.empty())
+    {
+        previewErrors_[filePath] = error;
+        return;
+    }
+    // Remember the checksum to find the thumbnail. The map might not have been scanned or changed since, so update its infos
+    if(hasFileState)
+    {
+        const auto itEntry = entries_.find(filePath);
+        if(itEntry == entries_.end() || itEntry->second.fileSize != fileSize || itEntry->second.lastWriteTime != lastWriteTime)
+        {
+            MapFileInfo info = makeInfo(filePath, map);
+            info.hasLua = itEntry != entries_.end() && itEntry->second.info.hasLua;
+            entries_[filePath] = CacheEntry{fileSize, lastWriteTime, true, checksum, info};
+        } else
+        {
+            itEntry->second.hasChecksum = true;
+            itEntry->second.checksum = checksum;
+        }
+        entriesChanged_ = true;
+    }
+    AddPreviewLocked(checksum, std::move(thumbnail));
+}
+
+void MapFileCache::AddPreviewLocked(uint32_t checksum, std::shared_ptr<const MapThumbnail> thumbnail)
+{
+    // Copies of a map share the thumbnail
+    const auto itPreview =
+      std::find_if(previews_.begin(), previews_.end(), [checksum](const auto& curPreview) { return curPreview.first == checksum; });
+    if(itPreview != previews_.end())
+    {
+        previews_.splice(previews_.begin(), previews_, itPreview);
+        return;
+    }
+    previews_.emplace_front(checksum, std::move(thumbnail));
+    if(previews_.size() > maxPreviews_)
+        previews_.pop_back();
+}
+
+bfs::path MapFileCache::GetThumbnailPath(uint32_t checksum) const
+{
+    std::stringstream fileName;
+    fileName << std::setw(8) << std::setfill('0') << std::hex << checksum << ".dat";
+    return cacheDir_ / "mapPreviews" / fileName.str();
+}
+
+void MapFileCache::Load()
+{
+    if(cacheFilePath_.empty())
+        return;
+    bnw::ifstream file(cacheFilePath_, std::ios::binary);
+    if(!file)
+        return;
+    const std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if(data.empty())
+        return;
+    try
+    {
+        Serializer ser(data.data(), data.size());
+        if(ser.PopUnsignedInt() != CACHE_VERSION)
+            return;
+        const unsigned numEntries = ser.PopUnsignedInt();
+        for(unsigned i = 0; i < numEntries; i++)
+        {
+            CacheEntry entry;
+            entry.info.filePath = ser.PopLongString();
+            entry.fileSize = ser.PopUnsignedInt();
+            const uint64_t lastWriteTimeLow = ser.PopUnsignedInt();
+            const uint64_t lastWriteTimeHigh = ser.PopUnsignedInt();
+            entry.lastWriteTime = static_cast<std::time_t>((lastWriteTimeHigh << 32) | lastWriteTimeLow);
+            entry.hasChecksum = ser.PopBool();
+            entry.checksum = ser.PopUnsignedInt();
+            entry.info.name = ser.PopString();
+            entry.info.author = ser.PopString();
+            entry.info.numPlayers = ser.PopUnsignedChar();
+            entry.info.gfxSet = ser.PopUnsignedChar();
+            entry.info.width = ser.PopUnsignedShort();
+            entry.info.height = ser.PopUnsignedShort();
+            const std::string filePath = entry.info.filePath;
+            entries_[filePath] = std::move(entry);
+        }
+    } catch(const std::exception&)
+    {
+        // Broken cache, just read all files again
+        entries_.clear();
+    }
+}
+
+void MapFileCache::Save() const
+{
+    if(cacheFilePath_.empty())
+        return;
+    Serializer ser;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<const CacheEntry*> existingEntries;
+        for(const auto& entry : entries_)
+        {
+            if(bfs::exists(entry.first))
+                existingEntries.push_back(&entry.second);
+        }
+        ser.PushUnsignedInt(CACHE_VERSION);
+        ser.PushUnsignedInt(existingEntries.size());
+        for(const CacheEntry* entry : existingEntries)
+        {
+            ser.PushLongString(entry->info.filePath);
+            ser.PushUnsignedInt(entry->fileSize);
+            const auto lastWriteTime = static_cast<uint64_t>(entry->lastWriteTime);
+            ser.PushUnsignedInt(static_cast<unsigned>(lastWriteTime & 0xFFFFFFFF));
+            ser.PushUnsignedInt(static_cast<unsigned>(lastWriteTime >> 32));
+            ser.PushBool(entry->hasChecksum);
+            ser.PushUnsignedInt(entry->checksum);
+            ser.PushString(entry->info.name);
+            ser.PushString(entry->info.author);
+            ser.PushUnsignedChar(entry->info.numPlayers);
+            ser.PushUnsignedChar(entry->info.gfxSet);
+            ser.PushUnsignedShort(entry->info.width);
+            ser.PushUnsignedShort(entry->info.height);
+        }
+    }
+    boost::system::error_code ec;
+    bfs::create_directories(cacheFilePath_.parent_path(), ec);
+    bnw::ofstream file(cacheFilePath_, std::ios::binary);
+    if(!file.write(reinterpret_cast<const char*>(ser.GetData()), ser.GetLength()))
+        LOG.write(_("Could not write map cache %1%\n")) % cacheFilePath_.string();
+}
@@ -0,0 +1,153 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef MapFileCache_h__
+#define MapFileCache_h__
+
+#include "gameTypes/MapCoordinates.h"
+#include "gameData/MaxPlayers.h"
+#include <boost/filesystem/path.hpp>
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// Information from the header of a map file as shown in the map selection
+struct MapFileInfo
+{
+    std::string filePath;
+    /// Name and author as UTF-8
+    std::string name, author;
+    unsigned char numPlayers = 0;
+    unsigned char gfxSet = 0;
+    unsigned short width = 0, height = 0;
+    /// Is there a lua script next to the map?
+    bool hasLua = false;
+};
+
+/// Minimap rendered from a map for its preview
+struct MapThumbnail
+{
+    /// Size of the map in nodes
+    MapExtent size;
+    /// Colors of the minimap texture as calculated by PreviewMinimap::CalcPixels
+    std::vector<unsigned> pixels;
+    /// Start positions of the players, invalid if not set
+    std::array<MapPoint, MAX_PLAYERS> startPositions;
+};
+
+/// Thumbnail for a preview or the reason it could not be loaded. Both are empty while it is being loaded
+struct MapPreview
+{
+    std::shared_ptr<const MapThumbnail> thumbnail;
+    /// Infos of the map if the thumbnail is set
+    MapFileInfo info;
+    std::string error;
+
+    bool IsLoading() const { return !thumbnail && error.empty(); }
+};
+
+/// Reads map files on a background thread so the map selection does not need to wait for them:
+/// - The header infos are kept in a cache file. Only new or changed maps (by size and modification time) are read again
+///   and only their header is parsed from the memory-mapped file
+/// - Previews are only created when requested. This reads the full map and calculates its checksum.
+///   The rendered minimaps are stored in the cache directory by checksum, so unchanged maps are not read again.
+///   The most recently used ones are also kept in memory
+class MapFileCache
+{
+public:
+    /// Load the cached infos from the given directory and store new ones there. An empty path disables the cache files
+    explicit MapFileCache(boost::filesystem::path cacheDir, unsigned maxPreviews = 32);
+    /// Stop the background thread and store the infos
+    ~MapFileCache();
+
+    /// Read the infos of the given files, discarding all of a previous call which were not yet returned
+    void Scan(std::vector<std::string> files);
+    /// Return the infos read since the last call. Files that are not valid maps are skipped
+    std::vector<MapFileInfo> GetScannedInfos();
+    /// True if not all files passed to Scan have been read yet
+    bool IsScanning() const;
+
+    /// Get the thumbnail of a scanned file for a preview.
+    /// If it is not loaded yet it will be loaded before all previously requested previews
+    MapPreview RequestPreview(const std::string& filePath);
+    /// Load the thumbnail of a scanned file in the background after all other requests, e.g. for visible rows
+    void PrefetchPreview(const std::string& filePath);
+    /// Forget the infos and preview of the file, e.g. because it was overwritten
+    void Invalidate(const std::string& filePath);
+
+    /// Store the infos in the cache file
+    void Save() const;
+
+private:
+    struct CacheEntry
+    {
+        uint32_t fileSize;
+        std::time_t lastWriteTime;
+        /// Checksum of the file contents which identifies its thumbnail. Only calculated when the preview is loaded
+        bool hasChecksum;
+        uint32_t checksum;
+        MapFileInfo info;
+    };
+
+    void Load();
+    /// Get the preview state while the mutex is locked. Returns true if it still needs to be requested
+    bool GetPreviewLocked(const std::string& filePath, MapPreview& preview);
+    void Run();
+    void ScanFile(const std::string& filePath);
+    void LoadPreview(const std::string& filePath);
+    /// Make the thumbnail available as the most recently used one. Mutex must be locked
+    void AddPreviewLocked(uint32_t checksum, std::shared_ptr<const MapThumbnail> thumbnail);
+    boost::filesystem::path GetThumbnailPath(uint32_t checksum) const;
+
+    const boost::filesystem::path cacheDir_;
+    const boost::filesystem::path cacheFilePath_;
+    const unsigned maxPreviews_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable workAvailable_;
+    bool stop_;
+    /// Header infos by file path
+    std::map<std::string, CacheEntry> entries_;
+    bool entriesChanged_;
+    /// Files of the current scan which were not yet read
+    std::deque<std::string> filesToScan_;
+    std::vector<MapFileInfo> scannedInfos_;
+    /// Increased for every scan to drop results of older ones
+    unsigned scanId_;
+    bool isScanningFile_;
+    /// Files to load the preview for, highest priority first
+    std::deque<std::string> previewsToLoad_;
+    /// File whose preview is currently loaded by the background thread
+    std::string loadingPreviewPath_;
+    /// Loaded thumbnails by checksum, most recently used first
+    std::list<std::pair<uint32_t, std::shared_ptr<const MapThumbnail>>> previews_;
+    /// Files whose preview failed to load with the reason
+    std::map<std::string, std::string> previewErrors_;
+
+    std::thread worker_;
+};
+
+#endif // MapFileCache_h__
@@ -22,25 +22,43 @@
 Minimap::Minimap(const MapExtent& mapSize) : mapSize(mapSize) {}
 
 void Minimap::CreateMapTexture()
+{
+    CreateMapTexture(CalcMapPixels());
+}
+
+void Minimap::CreateMapTexture(const std::vector<unsigned>& pixels)
 {
     map.DeleteTexture();
 
     /// Buffer für die Daten erzeugen
     libsiedler2::PixelBufferBGRA buffer(mapSize.x * 2, mapSize.y);
+    RTTR_Assert(pixels.size() == static_cast<size_t>(buffer.getWidth()) * buffer.getHeight());
+
+    auto itPixel = pixels.begin();
+    for(unsigned y = 0; y < buffer.getHeight(); ++y)
+    {
+        for(unsigned x = 0; x < buffer.getWidth(); ++x)
+            buffer.set(x, y, libsiedler2::ColorBGRA(*itPixel++));
+    }
+
+    map.setInterpolateTexture(false);
+    map.create(buffer);
+}
 
+std::vector<unsigned> Minimap::CalcMapPixels()
+{
+    const unsigned width = mapSize.x * 2;
+    std::vector<unsigned> pixels(static_cast<size_t>(width) * mapSize.y);
     RTTR_FOREACH_PT(MapPoint, mapSize)
     {
         // Die 2. Terraindreiecke durchgehen
         for(unsigned t = 0; t < 2; ++t)
         {
-            libsiedler2::ColorBGRA color(CalcPixelColor(pt, t));
-            unsigned xCoord = (pt.x * 2 + t + (pt.y & 1)) % buffer.getWidth();
-            buffer.set(xCoord, pt.y, color);
+            unsigned xCoord = (pt.x * 2 + t + (pt.y & 1)) % width;
+            pixels[static_cast<size_t>(pt.y) * width + xCoord] = CalcPixelColor(pt, t);
         }
     }
-
-    map.setInterpolateTexture(false);
-    map.create(buffer);
+    return pixels;
 }
 
 void Minimap::Draw(const Rect& rect)
@@ -55,9 +73,12 @@ void Minimap::BeforeDrawing() {}
 /**
  *  Variiert die übergebene Farbe zufällig in der Helligkeit
  */
-unsigned Minimap::VaryBrightness(const unsigned color, const int range) const
+unsigned Minimap::VaryBrightness(const unsigned color, const int range, const MapPoint pt, const unsigned t) const
 {
-    int add = 100 - rand() % (2 * range);
+    // Cheap integer hash of the pixel index
+    unsigned hash = (GetMMIdx(pt) * 2u + t) * 2654435761u;
+    hash ^= hash >> 16;
+    int add = 100 - static_cast<int>(hash % (2u * range));
 
     int red = GetRed(color) * add / 100;
     if(red < 0)
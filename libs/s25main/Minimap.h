@@ -20,6 +20,7 @@
 #include "Rect.h"
 #include "ogl/glArchivItem_Bitmap_Direct.h"
 #include "gameTypes/MapCoordinates.h"
+#include <vector>
 
 class Minimap
 {
@@ -44,9 +45,14 @@ public:
 protected:
     unsigned GetMMIdx(const MapPoint pt) const { return static_cast<unsigned>(pt.y) * mapSize.x + static_cast<unsigned>(pt.x); }
     /// Variiert die übergebene Farbe zufällig in der Helligkeit
-    unsigned VaryBrightness(unsigned color, int range) const;
+    /// The variation only depends on the pixel, so it is stable and can be calculated from multiple threads
+    unsigned VaryBrightness(unsigned color, int range, MapPoint pt, unsigned t) const;
     /// Erstellt die Textur
     void CreateMapTexture();
+    /// Create the texture from the pixels returned by CalcMapPixels
+    void CreateMapTexture(const std::vector<unsigned>& pixels);
+    /// Calculate the colors of all texture pixels (2 per node) row by row. Does not need an OpenGL context
+    std::vector<unsigned> CalcMapPixels();
     virtual unsigned CalcPixelColor(MapPoint pt, unsigned t) = 0;
     /// Zusätzliche Dinge, die die einzelnen Maps vor dem Zeichenvorgang zu tun haben
     virtual void BeforeDrawing();
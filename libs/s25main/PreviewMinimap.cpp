@@ -35,6 +35,46 @@ PreviewMinimap::PreviewMinimap(const glArchivItem_Map* const s2map)
 }
 
 void PreviewMinimap::SetMap(const glArchivItem_Map& s2map)
+{
+    ReadMap(s2map);
+    CreateMapTexture();
+}
+
+void PreviewMinimap::SetPixels(const MapExtent& size, const std::vector<unsigned>& pixels)
+{
+    mapSize = size;
+    CreateMapTexture(pixels);
+}
+
+std::vector<unsigned> PreviewMinimap::CalcPixels(const glArchivItem_Map& s2map)
+{
+    PreviewMinimap minimap(nullptr);
+    minimap.ReadMap(s2map);
+    return minimap.CalcMapPixels();
+}
+
+std::array<MapPoint, MAX_PLAYERS> PreviewMinimap::FindStartPositions(const glArchivItem_Map& s2map)
+{
+    std::array<MapPoint, MAX_PLAYERS> startPositions;
+    startPositions.fill(MapPoint::Invalid());
+    const unsigned short mapWidth = s2map.getHeader().getWidth();
+    const unsigned short mapHeight = s2map.getHeader().getHeight();
+    for(unsigned short y = 0; y < mapHeight; ++y)
+    {
+        for(unsigned short x = 0; x < mapWidth; ++x)
+        {
+            // Startposition eines Spielers an dieser Stelle?
+            if(s2map.GetMapDataAt(MAP_TYPE, x, y) != 0x80)
+                continue;
+            unsigned player = s2map.GetMapDataAt(MAP_LANDSCAPE, x, y);
+            if(player < MAX_PLAYERS)
+                startPositions[player] = MapPoint(x, y);
+        }
+    }
+    return startPositions;
+}
+
+void PreviewMinimap::ReadMap(const glArchivItem_Map& s2map)
 {
     const libsiedler2::ArchivItem_Map_Header& header = s2map.getHeader();
     mapSize.x = header.getWidth();
@@ -68,8 +108,6 @@ void PreviewMinimap::SetMap(const glArchivItem_Map& s2map)
                 terrain2Clr[ter.s2Id] = ter.minimapColor;
         }
     }
-
-    CreateMapTexture();
 }
 
 unsigned PreviewMinimap::CalcPixelColor(const MapPoint pt, const unsigned t)
@@ -78,10 +116,10 @@ unsigned PreviewMinimap::CalcPixelColor(const MapPoint pt, const unsigned t)
     // Baum an dieser Stelle?
     unsigned char landscape_obj = objects[GetMMIdx(pt)];
     if(landscape_obj >= 0xC4 && landscape_obj <= 0xC6)
-        color = VaryBrightness(TREE_COLOR, VARY_TREE_COLOR);
+        color = VaryBrightness(TREE_COLOR, VARY_TREE_COLOR, pt, t);
     // Granit an dieser Stelle?
     else if(landscape_obj == 0xCC || landscape_obj == 0xCD)
-        color = VaryBrightness(GRANITE_COLOR, VARY_GRANITE_COLOR);
+        color = VaryBrightness(GRANITE_COLOR, VARY_GRANITE_COLOR, pt, t);
     // Ansonsten die jeweilige Terrainfarbe nehmen
     else
     {
@@ -19,6 +19,8 @@
 #define PreviewMinimap_h__
 
 #include "Minimap.h"
+#include "gameData/MaxPlayers.h"
+#include <array>
 #include <map>
 
 class glArchivItem_Map;
@@ -32,12 +34,21 @@ public:
     explicit PreviewMinimap(const glArchivItem_Map* s2map);
 
     void SetMap(const glArchivItem_Map& s2map);
+    /// Show the pixels previously calculated by CalcPixels for a map of the given size
+    void SetPixels(const MapExtent& size, const std::vector<unsigned>& pixels);
+
+    /// Calculate the pixels of the minimap of the map without creating a texture, so this can be used from any thread
+    static std::vector<unsigned> CalcPixels(const glArchivItem_Map& s2map);
+    /// Get the start positions of the players on the map. Invalid for players without one
+    static std::array<MapPoint, MAX_PLAYERS> FindStartPositions(const glArchivItem_Map& s2map);
 
 protected:
     /// Berechnet die Farbe für einen bestimmten Pixel der Minimap (t = Terrain1 oder 2)
     unsigned CalcPixelColor(MapPoint pt, unsigned t) override;
 
 private:
+    /// Read the layers and terrain colors required to calculate the pixels
+    void ReadMap(const glArchivItem_Map& s2map);
     unsigned char CalcShading(MapPoint pt, const std::vector<unsigned char>& altitudes) const;
     void CalcShadows(const std::vector<unsigned char>& altitudes);
 };
@@ -0,0 +1,175 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "Profiler.h"
+#include <boost/nowide/fstream.hpp>
+#include <algorithm>
+#include <array>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+
+std::atomic<bool> Profiler::enabled_(false);
+
+namespace {
+struct ThreadBuffer
+{
+    /// Locked by the owning thread when writing and by others when reading. So it is practically never contended
+    std::mutex mutex;
+    std::vector<Profiler::Sample> samples;
+    /// Total number of samples written, the last ones are at (numSamples - 1) % BUFFER_SIZE
+    uint64_t numSamples = 0;
+    /// False if the owning thread has finished so the buffer can be reused
+    bool inUse = true;
+
+    template<class T_Func>
+    void forEachSample(T_Func&& func) const
+    {
+        const uint64_t begin = numSamples > samples.size() ? numSamples - samples.size() : 0;
+        for(uint64_t i = begin; i < numSamples; i++)
+            func(samples[i % samples.size()]);
+    }
+};
+
+std::mutex registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>>& getBuffers()
+{
+    static std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    return buffers;
+}
+
+/// Hands the buffer back when its thread finishes
+struct ThreadBufferHandle
+{
+    ThreadBuffer* buffer = nullptr;
+    ~ThreadBufferHandle()
+    {
+        if(buffer)
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            buffer->inUse = false;
+        }
+    }
+};
+
+ThreadBuffer& getThreadBuffer()
+{
+    static thread_local ThreadBufferHandle handle;
+    if(!handle.buffer)
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        std::vector<std::unique_ptr<ThreadBuffer>>& buffers = getBuffers();
+        for(const auto& buffer : buffers)
+        {
+            if(!buffer->inUse)
+            {
+                buffer->inUse = true;
+                handle.buffer = buffer.get();
+                break;
+            }
+        }
+        if(!handle.buffer)
+        {
+            buffers.push_back(std::make_unique<ThreadBuffer>());
+            buffers.back()->samples.resize(Profiler::BUFFER_SIZE);
+            handle.buffer = buffers.back().get();
+        }
+    }
+    return *handle.buffer;
+}
+} // namespace
+
+void Profiler::setEnabled(bool enabled)
+{
+    enabled_ = enabled;
+}
+
+void Profiler::addSample(ProfilingZone zone, Clock::time_point start, Clock::time_point end)
+{
+    ThreadBuffer& buffer = getThreadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.samples[buffer.numSamples % buffer.samples.size()] = Sample{zone, start, end - start};
+    buffer.numSamples++;
+}
+
+void Profiler::clear()
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for(const auto& buffer : getBuffers())
+    {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        buffer->numSamples = 0;
+    }
+}
+
+std::vector<Profiler::duration> Profiler::getRecentDurations(ProfilingZone zone, unsigned maxCount)
+{
+    std::vector<Sample> zoneSamples;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for(const auto& buffer : getBuffers())
+        {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            buffer->forEachSample([&zoneSamples, zone](const Sample& sample) {
+                if(sample.zone == zone)
+                    zoneSamples.push_back(sample);
+            });
+        }
+    }
+    std::stable_sort(zoneSamples.begin(), zoneSamples.end(), [](const Sample& lhs, const Sample& rhs) { return lhs.start < rhs.start; });
+    const size_t first = zoneSamples.size() > maxCount ? zoneSamples.size() - maxCount : 0;
+    std::vector<duration> result;
+    result.reserve(zoneSamples.size() - first);
+    for(size_t i = first; i < zoneSamples.size(); i++)
+        result.push_back(zoneSamples[i].length);
+    return result;
+}
+
+bool Profiler::writeChromeTrace(const boost::filesystem::path& filePath)
+{
+    bnw::ofstream file(filePath);
+    if(!file)
+        return false;
+    file << "{\"traceEvents\":[";
+    file << std::fixed << std::setprecision(3);
+    bool isFirst = true;
+    std::lock_guard<std::mutex> lock(registryMutex);
+    const std::vector<std::unique_ptr<ThreadBuffer>>& buffers = getBuffers();
+    for(unsigned tid = 0; tid < buffers.size(); tid++)
+    {
+        std::lock_guard<std::mutex> bufferLock(buffers[tid]->mutex);
+        buffers[tid]->forEachSample([&file, &isFirst, tid](const Sample& sample) {
+            using microseconds = std::chrono::duration<double, std::micro>;
+            if(!isFirst)
+                file << ',';
+            isFirst = false;
+            // Complete events ("X") with timestamps in microseconds
+            file << "\n{\"name\":\"" << getName(sample.zone) << "\",\"cat\":\"rttr\",\"ph\":\"X\",\"pid\":0,\"tid\":" << tid
+                 << ",\"ts\":" << microseconds(sample.start.time_since_epoch()).count()
+                 << ",\"dur\":" << microseconds(sample.length).count() << '}';
+        });
+    }
+    file << "\n]}\n";
+    return static_cast<bool>(file);
+}
+
+const char* Profiler::getName(ProfilingZone zone)
+{
+    static const std::array<const char*, NUM_ZONES> names = {{"GameFrame", "Events", "AI", "GameWorld", "Terrain", "Minimap", "Windows"}};
+    return names[static_cast<unsigned>(zone)];
+}
@@ -0,0 +1,96 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef Profiler_h__
+#define Profiler_h__
+
+#include "Clock.h"
+#include "helpers/MaxEnumValue.h"
+#include <boost/filesystem/path.hpp>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/// Subsystems whose run time can be measured by the profiler
+enum class ProfilingZone : uint8_t
+{
+    GameFrame,
+    Events,
+    AI,
+    GameWorld,
+    Terrain,
+    Minimap,
+    Windows
+};
+DEFINE_MAX_ENUM_VALUE(ProfilingZone, ProfilingZone::Windows)
+
+/// Collects timings of the profiling zones. Each thread records into its own ring buffer.
+/// Recording is disabled by default in which case a ProfilingScope costs only a single check
+class Profiler
+{
+public:
+    using duration = Clock::duration;
+    static constexpr unsigned NUM_ZONES = helpers::MaxEnumValue_v<ProfilingZone> + 1;
+    /// Number of samples kept per thread. Older ones get overwritten
+    static constexpr unsigned BUFFER_SIZE = 1 << 14;
+
+    struct Sample
+    {
+        ProfilingZone zone;
+        Clock::time_point start;
+        duration length;
+    };
+
+    static bool isEnabled() { return enabled_.load(std::memory_order_relaxed); }
+    static void setEnabled(bool enabled);
+    /// Record a sample in the buffer of the calling thread
+    static void addSample(ProfilingZone zone, Clock::time_point start, Clock::time_point end);
+    /// Remove all recorded samples
+    static void clear();
+    /// Return the lengths of the last maxCount samples of the zone from all threads (oldest first)
+    static std::vector<duration> getRecentDurations(ProfilingZone zone, unsigned maxCount);
+    /// Write all recorded samples in the Chrome trace event format (viewable with chrome://tracing or Perfetto)
+    static bool writeChromeTrace(const boost::filesystem::path& filePath);
+    static const char* getName(ProfilingZone zone);
+
+private:
+    static std::atomic<bool> enabled_;
+};
+
+/// RAII timer recording the time from construction to destruction as a sample for the zone
+class ProfilingScope
+{
+    const ProfilingZone zone_;
+    const bool active_;
+    Clock::time_point start_;
+
+public:
+    explicit ProfilingScope(ProfilingZone zone) : zone_(zone), active_(Profiler::isEnabled())
+    {
+        if(active_)
+            start_ = Clock::now();
+    }
+    ~ProfilingScope()
+    {
+        if(active_)
+            Profiler::addSample(zone_, start_, Clock::now());
+    }
+    ProfilingScope(const ProfilingScope&) = delete;
+    ProfilingScope& operator=(const ProfilingScope&) = delete;
+};
+
+#endif // Profiler_h__
@@ -85,6 +85,8 @@ void Settings::LoadDefaults()
     video.vsync = 0;
     video.vbo = true;
     video.shared_textures = true;
+    video.textureMemoryBudget = 128;
+    video.retainedGui = true;
     // }
 
     // language
@@ -202,6 +204,9 @@ void Settings::Load()
         video.vsync = iniVideo->getValueI("vsync");
         video.vbo = (iniVideo->getValueI("vbo") != 0);
         video.shared_textures = (iniVideo->getValueI("shared_textures") != 0);
+        video.textureMemoryBudget =
+          iniVideo->getValue("texture_memory_budget").empty() ? 128 : iniVideo->getValueI("texture_memory_budget");
+        video.retainedGui = iniVideo->getValue("retained_gui").empty() || iniVideo->getValueI("retained_gui") != 0;
         // };
 
         if(video.fullscreenSize.width == 0 || video.fullscreenSize.height == 0 || video.windowedSize.width == 0
@@ -343,6 +348,8 @@ void Settings::Save()
     iniVideo->setValue("vsync", video.vsync);
     iniVideo->setValue("vbo", (video.vbo ? 1 : 0));
     iniVideo->setValue("shared_textures", (video.shared_textures ? 1 : 0));
+    iniVideo->setValue("texture_memory_budget", video.textureMemoryBudget);
+    iniVideo->setValue("retained_gui", (video.retainedGui ? 1 : 0));
     // };
 
     // language
@@ -64,6 +64,10 @@ public:
         bool fullscreen;
         bool vbo;
         bool shared_textures;
+        /// Maximum memory in MiB for textures packed on demand. 0 to pack all textures on game start
+        unsigned textureMemoryBudget;
+        /// Draw unchanged menus and windows from cached images
+        bool retainedGui;
     } video;
 
     struct
@@ -18,6 +18,7 @@
 #include "rttrDefines.h" // IWYU pragma: keep
 #include "TerrainRenderer.h"
 #include "Loader.h"
+#include "Profiler.h"
 #include "Settings.h"
 #include "drivers/VideoDriverWrapper.h"
 #include "helpers/containerUtils.h"
@@ -668,6 +669,7 @@ void TerrainRenderer::UpdateBorderTriangleTerrain(const MapPoint pt, bool update
  */
 void TerrainRenderer::Draw(const Position& firstPt, const Position& lastPt, const GameWorldViewer& gwv, unsigned* water) const
 {
+    ProfilingScope profilingScope(ProfilingZone::Terrain);
     RTTR_Assert(!gl_vertices.empty());
     RTTR_Assert(!borders.empty());
 
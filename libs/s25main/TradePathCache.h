@@ -19,12 +19,12 @@
 #define TradePathCache_h__
 
 #include "world/TradePath.h"
-#include "s25util/Singleton.h"
 #include <array>
 
 class GameWorldGame;
 
-class TradePathCache : public Singleton<TradePathCache>
+/// Caches the last found trade pathes of a world
+class TradePathCache
 {
     struct Entry
     {
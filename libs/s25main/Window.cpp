@@ -25,32 +25,124 @@
 #include "drivers/ScreenResizeEvent.h"
 #include "drivers/VideoDriverWrapper.h"
 #include "ogl/IRenderer.h"
-#include <boost/range/adaptor/map.hpp>
-#include <boost/range/adaptor/reversed.hpp>
 #include <cstdarg>
 
 Window::Window(Window* parent, unsigned id, const DrawPoint& pos, const Extent& size)
-    : parent_(parent), id_(id), pos_(pos), size_(size), active_(false), visible_(true), scale_(false), isInMouseRelay(false),
-      animations_(this)
+    : parent_(parent), id_(id), pos_(pos), size_(size), active_(false), visible_(true), scale_(false), isDirty_(true),
+      isInMouseRelay(false), numCtrlChanges_(0), animations_(this)
 {}
 
 Window::~Window()
 {
     RTTR_Assert(!isInMouseRelay);
     // Steuerelemente aufräumen
-    for(Window* ctrl : childIdToWnd_ | boost::adaptors::map_values)
+    for(Window* ctrl : ctrls_)
         delete ctrl;
 }
 
+size_t Window::FindCtrlIdx(unsigned id) const
+{
+    const auto itId = std::lower_bound(ctrlIds_.begin(), ctrlIds_.end(), id);
+    if(itId == ctrlIds_.end() || *itId != id)
+        return ctrls_.size();
+    return static_cast<size_t>(itId - ctrlIds_.begin());
+}
+
+void Window::OnCtrlsChanged()
+{
+    ++numCtrlChanges_;
+    ctrlsByType_.clear();
+}
+
+const std::vector<void*>& Window::GetCtrlsOfType(const std::type_index& type, CtrlCastFn castFn) const
+{
+    auto it = ctrlsByType_.find(type);
+    if(it == ctrlsByType_.end())
+    {
+        std::vector<void*> ctrls;
+        for(Window* wnd : ctrls_)
+        {
+            void* ctrl = castFn(wnd);
+            if(ctrl)
+                ctrls.push_back(ctrl);
+        }
+        it = ctrlsByType_.emplace(type, std::move(ctrls)).first;
+    }
+    return it->second;
+}
+
+template<bool T_reversed, class T_Func>
+bool Window::ForEachCtrl(T_Func&& func)
+{
+    if(T_reversed)
+    {
+        for(size_t idx = ctrls_.size(); idx > 0;)
+        {
+            --idx;
+            const unsigned id = ctrlIds_[idx];
+            const unsigned numChanges = numCtrlChanges_;
+            if(func(*ctrls_[idx]))
+                return true;
+            // Continue with the next smaller ID
+            if(numChanges != numCtrlChanges_)
+                idx = std::lower_bound(ctrlIds_.begin(), ctrlIds_.end(), id) - ctrlIds_.begin();
+        }
+    } else
+    {
+        for(size_t idx = 0; idx < ctrls_.size();)
+        {
+            const unsigned id = ctrlIds_[idx];
+            const unsigned numChanges = numCtrlChanges_;
+            if(func(*ctrls_[idx]))
+                return true;
+            // Continue with the next larger ID
+            if(numChanges != numCtrlChanges_)
+                idx = std::upper_bound(ctrlIds_.begin(), ctrlIds_.end(), id) - ctrlIds_.begin();
+            else
+                ++idx;
+        }
+    }
+    return false;
+}
+
 /**
  *  zeichnet das Fenster.
  */
 void Window::Draw()
 {
+    // Reset before drawing so changes done while drawing cause another redraw
+    isDirty_ = false;
     if(visible_)
         Draw_();
 }
 
+void Window::Invalidate()
+{
+    // No early exit on already dirty windows: A parent might have been drawn (and cleaned) after this one was marked
+    for(Window* wnd = this; wnd; wnd = wnd->parent_)
+        wnd->isDirty_ = true;
+}
+
+bool Window::IsRedrawRequired() const
+{
+    return isDirty_ || HasVolatileContent();
+}
+
+bool Window::HasVolatileContent() const
+{
+    if(!visible_)
+        return false;
+    // Locked regions are used by e.g. dropdowns which draw outside of the window
+    if(IsContentVolatile() || animations_.getNumActiveAnimations() > 0 || !lockedAreas_.empty())
+        return true;
+    for(const Window* ctrl : ctrls_)
+    {
+        if(ctrl->HasVolatileContent())
+            return true;
+    }
+    return false;
+}
+
 DrawPoint Window::GetPos() const
 {
     return pos_;
@@ -82,6 +174,12 @@ Rect Window::GetDrawRect() const
     return Rect(GetDrawPos(), GetSize());
 }
 
+void Window::Resize(const Extent& newSize)
+{
+    size_ = newSize;
+    Invalidate();
+}
+
 Rect Window::GetBoundaryRect() const
 {
     // Default to draw rect
@@ -104,13 +202,7 @@ bool Window::RelayKeyboardMessage(KeyboardMsgHandler msg, const KeyEvent& ke)
 
     // Alle Controls durchgehen
     // Falls das Fenster dann plötzlich nich mehr aktiv ist (z.b. neues Fenster geöffnet, sofort abbrechen!)
-    for(Window* wnd : childIdToWnd_ | boost::adaptors::map_values)
-    {
-        if(wnd->visible_ && wnd->active_ && CALL_MEMBER_FN(*wnd, msg)(ke))
-            return true;
-    }
-
-    return false;
+    return ForEachCtrl<false>([msg, &ke](Window& wnd) { return wnd.visible_ && wnd.active_ && CALL_MEMBER_FN(wnd, msg)(ke); });
 }
 
 bool Window::RelayMouseMessage(MouseMsgHandler msg, const MouseCoords& mc)
@@ -124,15 +216,15 @@ bool Window::RelayMouseMessage(MouseMsgHandler msg, const MouseCoords& mc)
     isInMouseRelay = true;
 
     // Alle Controls durchgehen
-    // Use reverse iterator because the topmost (=last elements) should receive the messages first!
-    for(Window* wnd : childIdToWnd_ | boost::adaptors::map_values | boost::adaptors::reversed)
-    {
-        if(!lockedAreas_.empty() && IsInLockedRegion(mc.GetPos(), wnd))
-            continue;
+    // Iterate in reverse because the topmost (=last elements) should receive the messages first!
+    ForEachCtrl<true>([this, msg, &mc, &processed](Window& wnd) {
+        if(!lockedAreas_.empty() && IsInLockedRegion(mc.GetPos(), &wnd))
+            return false;
 
-        if(wnd->visible_ && wnd->active_ && CALL_MEMBER_FN(*wnd, msg)(mc))
+        if(wnd.visible_ && wnd.active_ && CALL_MEMBER_FN(wnd, msg)(mc))
             processed = true;
-    }
+        return false;
+    });
 
     for(auto tofreeArea : tofreeAreas_)
         lockedAreas_.erase(tofreeArea);
@@ -149,6 +241,8 @@ bool Window::RelayMouseMessage(MouseMsgHandler msg, const MouseCoords& mc)
  */
 void Window::SetActive(bool activate)
 {
+    if(active_ != activate)
+        Invalidate();
     this->active_ = activate;
     ActivateControls(activate);
 }
@@ -160,8 +254,8 @@ void Window::SetActive(bool activate)
  */
 void Window::ActivateControls(bool activate)
 {
-    for(auto& it : childIdToWnd_)
-        it.second->SetActive(activate);
+    for(Window* ctrl : ctrls_)
+        ctrl->SetActive(activate);
 }
 
 /**
@@ -194,7 +288,20 @@ void Window::FreeRegion(Window* window)
 
 void Window::SetPos(const DrawPoint& newPos)
 {
+    if(pos_ == newPos)
+        return;
     pos_ = newPos;
+    // Moving a top level window does not change its content, only the place where it is composed
+    if(parent_)
+        parent_->Invalidate();
+}
+
+void Window::SetVisible(bool visible)
+{
+    if(visible_ == visible)
+        return;
+    visible_ = visible;
+    Invalidate();
 }
 
 /// Weiterleitung von Nachrichten von abgeleiteten Klassen erlaubt oder nicht?
@@ -205,14 +312,17 @@ bool Window::IsMessageRelayAllowed() const
 
 void Window::DeleteCtrl(unsigned id)
 {
-    auto it = childIdToWnd_.find(id);
+    const size_t idx = FindCtrlIdx(id);
 
-    if(it == childIdToWnd_.end())
+    if(idx == ctrls_.size())
         return;
 
-    delete it->second;
+    delete ctrls_[idx];
 
-    childIdToWnd_.erase(it);
+    ctrls_.erase(ctrls_.begin() + idx);
+    ctrlIds_.erase(ctrlIds_.begin() + idx);
+    OnCtrlsChanged();
+    Invalidate();
 }
 
 ctrlBuildingIcon* Window::AddBuildingIcon(unsigned id, const DrawPoint& pos, BuildingType type, const Nation nation, unsigned short size,
@@ -489,19 +599,24 @@ void Window::DrawLine(DrawPoint pt1, DrawPoint pt2, unsigned short width, unsign
 void Window::Msg_PaintBefore()
 {
     animations_.update(VIDEODRIVER.GetTickCount());
-    for(Window* control : childIdToWnd_ | boost::adaptors::map_values)
-        control->Msg_PaintBefore();
+    // Timers fire here and their handlers may add or remove controls
+    ForEachCtrl<false>([](Window& control) {
+        control.Msg_PaintBefore();
+        return false;
+    });
 }
 
 void Window::Msg_PaintAfter()
 {
-    for(Window* control : childIdToWnd_ | boost::adaptors::map_values)
-        control->Msg_PaintAfter();
+    ForEachCtrl<false>([](Window& control) {
+        control.Msg_PaintAfter();
+        return false;
+    });
 }
 
 void Window::Draw_()
 {
-    for(Window* control : childIdToWnd_ | boost::adaptors::map_values)
+    for(Window* control : ctrls_)
         control->Draw();
 }
 
@@ -511,7 +626,7 @@ void Window::Msg_ScreenResize(const ScreenResizeEvent& sr)
     if(!scale_)
         return;
     RescaleWindowProp rescale(sr.oldSize, sr.newSize);
-    for(Window* ctrl : childIdToWnd_ | boost::adaptors::map_values)
+    for(Window* ctrl : ctrls_)
     {
         if(!ctrl)
             continue;
@@ -522,6 +637,7 @@ void Window::Msg_ScreenResize(const ScreenResizeEvent& sr)
         ctrl->Resize(newSize);
     }
     animations_.onRescale(sr);
+    Invalidate();
 }
 
 template<class T_Pt>
@@ -29,8 +29,10 @@
 #include "gameTypes/Nation.h"
 #include "gameTypes/TextureColor.h"
 #include "s25util/colors.h"
-#include <boost/range/adaptor/map.hpp>
+#include <algorithm>
 #include <map>
+#include <typeindex>
+#include <unordered_map>
 #include <vector>
 
 class ctrlBuildingIcon;
@@ -89,7 +91,7 @@ public:
     /// Get the actual extents of the rect (might be different to the draw rect if the window resizes according to content)
     virtual Rect GetBoundaryRect() const;
     /// setzt die Größe des Fensters
-    virtual void Resize(const Extent& newSize) { size_ = newSize; }
+    virtual void Resize(const Extent& newSize);
     /// setzt die Breite des Fensters
     void SetWidth(unsigned width) { Resize(Extent(width, size_.y)); }
     /// setzt die Höhe des Fensters
@@ -113,7 +115,7 @@ public:
     void SetPos(const DrawPoint& newPos);
 
     // macht das Fenster sichtbar oder blendet es aus
-    virtual void SetVisible(bool visible) { this->visible_ = visible; }
+    virtual void SetVisible(bool visible);
     /// Ist das Fenster sichtbar?
     bool IsVisible() const { return visible_; }
     /// Ist das Fenster aktiv?
@@ -139,6 +141,13 @@ public:
 
     AnimationManager& GetAnimationManager() { return animations_; }
 
+    /// Marks the window as changed so it and all its parents get redrawn (only relevant for retained drawing)
+    void Invalidate();
+    /// Return true if the window was changed since it was last drawn or contains volatile content
+    bool IsRedrawRequired() const;
+    /// Return true if this window or any visible child draws content which may change every frame
+    bool HasVolatileContent() const;
+
     template<typename T>
     T* AddCtrl(T* ctrl);
 
@@ -266,7 +275,6 @@ protected:
         BUTTON_HOVER,
         BUTTON_PRESSED
     };
-    using ControlMap = std::map<unsigned, Window*>;
 
     /// scales X- und Y values to fit the screen
     template<class T_Pt>
@@ -280,8 +288,23 @@ protected:
     virtual void Draw_();
     /// Weiterleitung von Nachrichten von abgeleiteten Klassen erlaubt oder nicht?
     virtual bool IsMessageRelayAllowed() const;
+    /// Return true if Draw_ shows content that changes without Invalidate being called (e.g. the game world or live statistics)
+    virtual bool IsContentVolatile() const { return false; }
 
 private:
+    using CtrlCastFn = void* (*)(Window*);
+
+    /// Return the index of the control with the given id or the number of controls if not found
+    size_t FindCtrlIdx(unsigned id) const;
+    /// Must be called after controls were added or removed
+    void OnCtrlsChanged();
+    /// Get all controls for which castFn returns non-null as the returned (cast) pointers
+    const std::vector<void*>& GetCtrlsOfType(const std::type_index& type, CtrlCastFn castFn) const;
+    /// Call func for each control in order of their IDs (or reversed) until it returns true.
+    /// Controls may be added or removed by func. Return true if func returned true
+    template<bool T_reversed, class T_Func>
+    bool ForEachCtrl(T_Func&& func);
+
     Window* const parent_; /// Handle auf das Parentfenster.
     unsigned id_;          /// ID des Fensters.
     DrawPoint pos_;        /// Position des Fensters.
@@ -289,22 +312,31 @@ private:
     bool active_;          /// Fenster aktiv?
     bool visible_;         /// Fenster sichtbar?
     bool scale_;           /// Sollen Controls an Fenstergröße angepasst werden?
+    bool isDirty_;         /// Changed since the last Draw?
 
     std::map<Window*, Rect> lockedAreas_; /// gesperrte Regionen des Fensters.
     std::vector<Window*> tofreeAreas_;
     bool isInMouseRelay;
-    ControlMap childIdToWnd_; /// Die Steuerelemente des Fensters.
+    std::vector<unsigned> ctrlIds_; /// IDs of the controls in ascending order
+    std::vector<Window*> ctrls_;    /// Die Steuerelemente des Fensters. Same order as ctrlIds_
+    unsigned numCtrlChanges_;       /// Counts additions and removals of controls so iterations can detect them
+    /// Controls of the types requested by GetCtrls, already cast to that type. Cleared when controls change
+    mutable std::unordered_map<std::type_index, std::vector<void*>> ctrlsByType_;
     AnimationManager animations_;
 };
 
 template<typename T>
 inline T* Window::AddCtrl(T* ctrl)
 {
-    RTTR_Assert(childIdToWnd_.find(ctrl->GetID()) == childIdToWnd_.end());
-    childIdToWnd_.insert(std::make_pair(ctrl->GetID(), ctrl));
+    const auto itId = std::lower_bound(ctrlIds_.begin(), ctrlIds_.end(), ctrl->GetID());
+    RTTR_Assert(itId == ctrlIds_.end() || *itId != ctrl->GetID());
+    ctrls_.insert(ctrls_.begin() + (itId - ctrlIds_.begin()), ctrl);
+    ctrlIds_.insert(itId, ctrl->GetID());
+    OnCtrlsChanged();
 
     ctrl->scale_ = scale_;
     ctrl->SetActive(active_);
+    Invalidate();
 
     return ctrl;
 }
@@ -312,46 +344,42 @@ inline T* Window::AddCtrl(T* ctrl)
 template<typename T>
 inline T* Window::GetCtrl(unsigned id)
 {
-    auto it = childIdToWnd_.find(id);
-    if(it == childIdToWnd_.end())
+    const size_t idx = FindCtrlIdx(id);
+    if(idx == ctrls_.size())
         return nullptr;
 
-    return dynamic_cast<T*>(it->second);
+    return dynamic_cast<T*>(ctrls_[idx]);
 }
 
 template<typename T>
 inline const T* Window::GetCtrl(unsigned id) const
 {
-    auto it = childIdToWnd_.find(id);
-    if(it == childIdToWnd_.end())
+    const size_t idx = FindCtrlIdx(id);
+    if(idx == ctrls_.size())
         return nullptr;
 
-    return dynamic_cast<T*>(it->second);
+    return dynamic_cast<const T*>(ctrls_[idx]);
 }
 
 template<typename T>
 inline std::vector<T*> Window::GetCtrls()
 {
+    const std::vector<void*>& ctrls = GetCtrlsOfType(typeid(T), [](Window* wnd) -> void* { return dynamic_cast<T*>(wnd); });
     std::vector<T*> result;
-    for(auto wnd : childIdToWnd_ | boost::adaptors::map_values)
-    {
-        T* ctrl = dynamic_cast<T*>(wnd);
-        if(ctrl)
-            result.push_back(ctrl);
-    }
+    result.reserve(ctrls.size());
+    for(void* ctrl : ctrls)
+        result.push_back(static_cast<T*>(ctrl));
     return result;
 }
 
 template<typename T>
 inline std::vector<const T*> Window::GetCtrls() const
 {
+    const std::vector<void*>& ctrls = GetCtrlsOfType(typeid(T), [](Window* wnd) -> void* { return dynamic_cast<T*>(wnd); });
     std::vector<const T*> result;
-    for(const auto wnd : childIdToWnd_ | boost::adaptors::map_values)
-    {
-        const T* ctrl = dynamic_cast<const T*>(wnd);
-        if(ctrl)
-            result.push_back(ctrl);
-    }
+    result.reserve(ctrls.size());
+    for(const void* ctrl : ctrls)
+        result.push_back(static_cast<const T*>(ctrl));
     return result;
 }
 
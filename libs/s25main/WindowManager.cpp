@@ -19,6 +19,7 @@
 #include "WindowManager.h"
 #include "CollisionDetection.h"
 #include "Loader.h"
+#include "Profiler.h"
 #include "RttrConfig.h"
 #include "Settings.h"
 #include "Window.h"
@@ -32,6 +33,7 @@
 #include "ogl/FontStyle.h"
 #include "ogl/SoundEffectItem.h"
 #include "ogl/glFont.h"
+#include "ogl/glWindowCache.h"
 #include "ogl/saveBitmap.h"
 #include "gameData/const_gui_ids.h"
 #include "libsiedler2/PixelBufferBGRA.h"
@@ -40,13 +42,15 @@
 #include <algorithm>
 
 WindowManager::WindowManager()
-    : disable_mouse(false), lastMousePos(Position::Invalid()), curRenderSize(0, 0), lastLeftClickTime(0), lastLeftClickPos(0, 0)
+    : disable_mouse(false), lastMousePos(Position::Invalid()), curRenderSize(0, 0), retainedMode(false), lastLeftClickTime(0),
+      lastLeftClickPos(0, 0)
 {}
 
 WindowManager::~WindowManager() = default;
 
 void WindowManager::CleanUp()
 {
+    windowCaches.clear();
     windows.clear();
     curDesktop.reset();
     nextdesktop.reset();
@@ -58,6 +62,7 @@ void WindowManager::CleanUp()
  */
 void WindowManager::Draw()
 {
+    ProfilingScope profilingScope(ProfilingZone::Windows);
     // ist ein neuer Desktop eingetragen? Wenn ja, wechseln
     if(nextdesktop)
         DoDesktopSwitch();
@@ -66,7 +71,7 @@ void WindowManager::Draw()
         return;
 
     curDesktop->Msg_PaintBefore();
-    curDesktop->Draw();
+    DrawWindow(*curDesktop);
     curDesktop->Msg_PaintAfter();
 
     // First close all marked windows
@@ -76,7 +81,7 @@ void WindowManager::Draw()
         // If the window is not minimized, call paintAfter
         if(!wnd->IsMinimized())
             wnd->Msg_PaintBefore();
-        wnd->Draw();
+        DrawWindow(*wnd);
         // If the window is not minimized, call paintAfter
         if(!wnd->IsMinimized())
             wnd->Msg_PaintAfter();
@@ -85,6 +90,53 @@ void WindowManager::Draw()
     DrawToolTip();
 }
 
+void WindowManager::SetRetainedMode(bool enabled)
+{
+    retainedMode = enabled;
+    windowCaches.clear();
+}
+
+/**
+ *  Draws the desktop or ingame window.
+ *  Desktops and ingame windows are opaque rectangles and drawn in z-order, so the screen area of the window contains only
+ *  its own content directly after drawing it. This is copied to a texture and reused until the window changes.
+ *  Content drawn in Msg_PaintAfter is not cached and drawn on top each frame.
+ */
+void WindowManager::DrawWindow(Window& wnd)
+{
+    if(!retainedMode)
+    {
+        wnd.Draw();
+        return;
+    }
+    if(!wnd.IsVisible())
+        return;
+    const Rect drawRect = wnd.GetBoundaryRect();
+    std::unique_ptr<glWindowCache>& cache = windowCaches[&wnd];
+    if(cache && !wnd.IsRedrawRequired() && cache->isValid(drawRect.getSize()))
+    {
+        cache->draw(drawRect.getOrigin());
+        return;
+    }
+    wnd.Draw();
+    // Don't cache windows which changed while drawing or change every frame anyway
+    if(wnd.IsRedrawRequired())
+        return;
+    if(!cache)
+        cache = std::make_unique<glWindowCache>();
+    cache->capture(drawRect);
+}
+
+void WindowManager::InvalidateActiveWindow()
+{
+    if(!curDesktop)
+        return;
+    if(curDesktop->IsActive())
+        curDesktop->Invalidate();
+    else if(!windows.empty())
+        windows.back()->Invalidate();
+}
+
 /**
  *  liefert ob der aktuelle Desktop den Focus besitzt oder nicht.
  *
@@ -244,6 +296,7 @@ IngameWindow* WindowManager::FindNonModalWindow(unsigned id) const
  */
 void WindowManager::Msg_LeftDown(MouseCoords mc)
 {
+    InvalidateActiveWindow();
     // ist unser Desktop gültig?
     if(!curDesktop)
         return;
@@ -339,6 +392,7 @@ void WindowManager::Msg_LeftDown(MouseCoords mc)
  */
 void WindowManager::Msg_LeftUp(MouseCoords mc)
 {
+    InvalidateActiveWindow();
     // ist unser Desktop gültig?
     if(!curDesktop)
         return;
@@ -392,6 +446,7 @@ void WindowManager::Msg_LeftUp(MouseCoords mc)
  */
 void WindowManager::Msg_RightDown(const MouseCoords& mc)
 {
+    InvalidateActiveWindow();
     // ist unser Desktop gültig?
     if(!curDesktop)
         return;
@@ -447,6 +502,7 @@ void WindowManager::Msg_RightDown(const MouseCoords& mc)
 
 void WindowManager::Msg_RightUp(const MouseCoords& mc)
 {
+    InvalidateActiveWindow();
     RelayMouseMessage(&Window::Msg_RightUp, mc);
 }
 
@@ -457,6 +513,7 @@ void WindowManager::Msg_RightUp(const MouseCoords& mc)
  */
 void WindowManager::Msg_WheelUp(const MouseCoords& mc)
 {
+    InvalidateActiveWindow();
     // ist unser Desktop gültig?
     if(!curDesktop)
         return;
@@ -520,6 +577,7 @@ void WindowManager::Msg_WheelUp(const MouseCoords& mc)
  */
 void WindowManager::Msg_WheelDown(const MouseCoords& mc)
 {
+    InvalidateActiveWindow();
     if(!curDesktop)
         return;
     if(windows.empty())
@@ -560,6 +618,7 @@ void WindowManager::Msg_WheelDown(const MouseCoords& mc)
 void WindowManager::Msg_MouseMove(const MouseCoords& mc)
 {
     lastMousePos = mc.pos;
+    InvalidateActiveWindow();
 
     // ist unser Desktop gültig?
     if(!curDesktop)
@@ -589,6 +648,10 @@ void WindowManager::Msg_MouseMove(const MouseCoords& mc)
 
 void WindowManager::Msg_KeyDown(const KeyEvent& ke)
 {
+    InvalidateActiveWindow();
+    // Unhandled keys are passed to the desktop
+    if(curDesktop)
+        curDesktop->Invalidate();
     if(ke.alt && (ke.kt == KT_RETURN))
     {
         // Switch Fullscreen/Windowed
@@ -615,6 +678,8 @@ void WindowManager::WindowResized()
  */
 void WindowManager::Msg_ScreenResize(const Extent& newSize)
 {
+    // The screen might have been recreated, so the cached images are lost
+    windowCaches.clear();
     // Don't handle it if nothing changed
     if(newSize == curRenderSize)
         return;
@@ -667,6 +732,7 @@ void WindowManager::Close(const IngameWindow* window)
     // Remove from list and notify parent, hold onto it till parent is notified
     const auto tmpHolder = std::move(*it);
     windows.erase(it);
+    windowCaches.erase(window);
     if(isActiveWnd)
     {
         if(windows.empty())
@@ -709,6 +775,7 @@ void WindowManager::DoDesktopSwitch()
         // Alle (alten) Fenster zumachen
         windows.clear();
     }
+    windowCaches.clear();
 
     // Desktop auf Neuen umstellen
     curDesktop = std::move(nextdesktop);
@@ -23,6 +23,7 @@
 #include "driver/VideoDriverLoaderInterface.h"
 #include "s25util/Singleton.h"
 #include <list>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -33,6 +34,7 @@ class IngameWindow;
 class MouseCoords;
 struct KeyEvent;
 class ctrlBaseTooltip;
+class glWindowCache;
 
 /// Verwaltet alle (offenen) Fenster bzw Desktops samt ihren Controls und Messages
 class WindowManager : public Singleton<WindowManager>, public VideoDriverLoaderInterface
@@ -47,6 +49,9 @@ public:
 
     /// Zeichnet Desktop und alle Fenster.
     void Draw();
+    /// Enable drawing unchanged desktops and windows from a cached image instead of drawing all their controls each frame
+    void SetRetainedMode(bool enabled);
+    bool IsRetainedMode() const { return retainedMode; }
     /// liefert ob der aktuelle Desktop den Focus besitzt oder nicht.
     bool IsDesktopActive();
 
@@ -128,6 +133,10 @@ private:
     class Tooltip;
 
     void DrawToolTip();
+    /// Draw the desktop or ingame window. In retained mode use (or update) the cached image
+    void DrawWindow(Window& wnd);
+    /// Mark the window receiving the input as changed as it usually reacts to it (hover, click, ...)
+    void InvalidateActiveWindow();
 
     void TakeScreenshot();
     /// wechselt einen Desktop
@@ -146,6 +155,9 @@ private:
     Position lastMousePos;
     std::unique_ptr<Tooltip> curTooltip;
     Extent curRenderSize; /// current render size
+    bool retainedMode;
+    /// Cached images of the desktop and ingame windows (retained mode only)
+    std::map<const Window*, std::unique_ptr<glWindowCache>> windowCaches;
 
     // Für Doppelklick merken:
     unsigned lastLeftClickTime; /// Zeit des letzten Links-Klicks
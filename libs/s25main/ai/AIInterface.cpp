@@ -140,7 +140,7 @@ int AIInterface::CalcResourceValue(const MapPoint pt, AIResource res, int8_t dir
 {
     if(direction == -1) // calculate complete value from scratch (3n^2+3n+1)
     {
-        std::vector<MapPoint> pts = gwb.GetPointsInRadiusWithCenter(pt, RES_RADIUS[static_cast<unsigned>(res)]);
+        const MapRadiusRange pts = gwb.PointsInRadius(pt, RES_RADIUS[static_cast<unsigned>(res)], true);
         return std::accumulate(pts.begin(), pts.end(), 0,
                                [this, res](int lhs, const auto& curPt) { return lhs + this->GetResourceRating(curPt, res); });
     } else // calculate different nodes only (4n+2 ?anyways much faster)
@@ -197,6 +197,14 @@ bool AIInterface::FindFreePathForNewRoad(MapPoint start, MapPoint target, std::v
                                                                  IsPointOK_RoadPathEvenStep, nullptr, (void*)&boat);
 }
 
+std::vector<std::vector<Direction>> AIInterface::FindFreePathsForNewRoad(const MapPoint start, const std::vector<MapPoint>& targets) const
+{
+    Param_RoadPath prp;
+    prp.boat_road = false;
+    return gwb.GetFreePathFinder().FindPathsAlternatingConditions(start, targets, 100, IsPointOK_RoadPath, IsPointOK_RoadPathEvenStep,
+                                                                  &prp);
+}
+
 bool AIInterface::CalcBQSumDifference(const MapPoint pt1, const MapPoint pt2)
 {
     return GetBuildingQuality(pt2) < GetBuildingQuality(pt1);
@@ -84,6 +84,9 @@ public:
     BuildingQuality GetBuildingQualityAnyOwner(MapPoint pt) const;
     /// Tries to find a free path for a road and return length and the route
     bool FindFreePathForNewRoad(MapPoint start, MapPoint target, std::vector<Direction>* route = nullptr, unsigned* length = nullptr) const;
+    /// Searches free paths for roads from start to all targets at once. Returns the route to each target or an empty one if none was found.
+    /// Routes might have possible flag positions next to the target which FindFreePathForNewRoad would avoid
+    std::vector<std::vector<Direction>> FindFreePathsForNewRoad(MapPoint start, const std::vector<MapPoint>& targets) const;
     /// Tries to find a route from start to target, returning length of that route if it exists
     bool FindPathOnRoads(const noRoadNode& start, const noRoadNode& target, unsigned* length = nullptr) const;
     /// Checks if it is allowed to build catapults
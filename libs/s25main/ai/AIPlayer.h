@@ -21,6 +21,8 @@
 
 #include "AIInterface.h"
 #include "GameCommand.h"
+#include <string>
+#include <vector>
 
 class GameWorldBase;
 class GamePlayer;
@@ -50,6 +52,14 @@ public:
         return tmp;
     }
 
+    /// Get the chat messages to all players and mark them as sent
+    std::vector<std::string> FetchChatMessages()
+    {
+        std::vector<std::string> tmp;
+        std::swap(tmp, chatMsgs);
+        return tmp;
+    }
+
     // access to ais CommandFactory
     const AIInterface& getAIInterface() const { return aii; }
     AIInterface& getAIInterface() { return aii; }
@@ -67,6 +77,8 @@ public:
 protected:
     /// Queue der GameCommands, die noch bearbeitet werden müssen
     std::vector<gc::GameCommandPtr> gcs;
+    /// Chat messages to all players. Sent by the owner of the game (e.g. the GameClient) as the AI might not run on its thread
+    std::vector<std::string> chatMsgs;
     /// Stärke der KI
     const AI::Level level;
     /// Abstrahiertes Interfaces, leitet Befehle weiter an
@@ -49,7 +49,8 @@
 namespace AIJH {
 
 AIConstruction::AIConstruction(AIPlayerJH& aijh)
-    : aijh(aijh), aii(aijh.GetInterface()), bldPlanner(aijh.GetBldPlanner()), constructionorders(NUM_BUILDING_TYPES)
+    : aijh(aijh), aii(aijh.GetInterface()), bldPlanner(aijh.GetBldPlanner()), constructionorders(NUM_BUILDING_TYPES),
+      availableJobBudget(0)
 {}
 
 AIConstruction::~AIConstruction()
@@ -108,15 +109,18 @@ void AIConstruction::AddBuildJob(BuildJob* job, bool front)
 
 }*/
 
-void AIConstruction::ExecuteJobs(unsigned limit)
+void AIConstruction::ExecuteJobs(unsigned limit, unsigned budget)
 {
+    // Unused units are saved for at most one more GF, so the work is still spread when the jobs come in bursts
+    availableJobBudget = std::min(availableJobBudget + static_cast<int>(budget), 2 * static_cast<int>(budget));
     unsigned i = 0; // count up to limit
     unsigned initconjobs = std::min<unsigned>(connectJobs.size(), 5);
     unsigned initbuildjobs = std::min<unsigned>(buildJobs.size(), 5);
-    for(; i < limit && !connectJobs.empty() && i < initconjobs;
+    for(; i < limit && !connectJobs.empty() && i < initconjobs && availableJobBudget > 0;
         i++) // go through list, until limit is reached or list empty or when every entry has been checked
     {
         ConnectJob* job = connectJobs.front();
+        availableJobBudget -= static_cast<int>(job->GetCost());
         job->ExecuteJob();
         if(job->GetState() != JOB_FINISHED && job->GetState() != JOB_FAILED) // couldnt do job? -> move to back of list
         {
@@ -128,9 +132,10 @@ void AIConstruction::ExecuteJobs(unsigned limit)
             delete job;
         }
     }
-    for(; i < limit && !buildJobs.empty() && i < (initconjobs + initbuildjobs); i++)
+    for(; i < limit && !buildJobs.empty() && i < (initconjobs + initbuildjobs) && availableJobBudget > 0; i++)
     {
         BuildJob* job = GetBuildJob();
+        availableJobBudget -= static_cast<int>(job->GetCost());
         job->ExecuteJob();
         if(job->GetState() != JOB_FINISHED && job->GetState() != JOB_FAILED) // couldnt do job? -> move to back of list
         {
@@ -205,6 +210,19 @@ void AIConstruction::ConstructionsExecuted()
 }
 
 namespace {
+    /// FindFreePathForNewRoad avoids possible flag positions (every 2nd node) next to the target, the search for multiple targets does not
+    bool IsValidRouteEnd(const GameWorldBase& world, MapPoint start, const std::vector<Direction>& route, const MapPoint target)
+    {
+        MapPoint curPt = start;
+        for(unsigned i = 0; i + 1 < route.size(); i++)
+        {
+            curPt = world.GetNeighbour(curPt, route[i]);
+            if(i % 2 == 1 && world.CalcDistance(curPt, target) < 2)
+                return false;
+        }
+        return true;
+    }
+
     struct Point2FlagAI
     {
         using result_type = const noFlag*;
@@ -304,21 +322,37 @@ bool AIConstruction::ConnectFlagToRoadSytem(const noFlag* flag, std::vector<Dire
     std::cout << "FindFlagsNum: " << flags.size() << std::endl;
 #endif
 
+    // the flag should not be at a military building!
+    helpers::remove_if(flags, [this](const noFlag* curFlag) {
+        return aii.gwb.IsMilitaryBuildingOnNode(aii.gwb.GetNeighbour(curFlag->GetPos(), Direction::NORTHWEST), true);
+    });
+    std::vector<MapPoint> flagPositions;
+    flagPositions.reserve(flags.size());
+    for(const noFlag* curFlag : flags)
+        flagPositions.push_back(curFlag->GetPos());
+    // Search the paths to all flags at once
+    const std::vector<std::vector<Direction>> routes = aii.FindFreePathsForNewRoad(flag->GetPos(), flagPositions);
+
     const noFlag* shortest = nullptr;
     unsigned shortestLength = 99999;
     std::vector<Direction> tmpRoute;
 
     // Jede Flagge testen...
-    for(const noFlag* curFlag : flags)
+    for(unsigned i = 0; i < flags.size(); i++)
     {
-        tmpRoute.clear();
-        unsigned length;
-        // the flag should not be at a military building!
-        if(aii.gwb.IsMilitaryBuildingOnNode(aii.gwb.GetNeighbour(curFlag->GetPos(), Direction::NORTHWEST), true))
-            continue;
+        const noFlag* curFlag = flags[i];
+        tmpRoute = routes[i];
         // Gibts überhaupt einen Pfad zu dieser Flagge
-        if(!aii.FindFreePathForNewRoad(flag->GetPos(), curFlag->GetPos(), &tmpRoute, &length))
+        if(tmpRoute.empty())
             continue;
+        if(!IsValidRouteEnd(aii.gwb, flag->GetPos(), tmpRoute, curFlag->GetPos()))
+        {
+            // Let the exact search decide
+            tmpRoute.clear();
+            if(!aii.FindFreePathForNewRoad(flag->GetPos(), curFlag->GetPos(), &tmpRoute))
+                continue;
+        }
+        const unsigned length = tmpRoute.size();
 
         // Wenn ja, dann gucken ob dieser Pfad möglichst kurz zum "höheren" Ziel (allgemeines Lager im Moment) ist
         unsigned maxNonFlagPts = 0;
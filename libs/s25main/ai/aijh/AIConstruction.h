@@ -53,6 +53,7 @@ public:
     BuildJob* GetBuildJob();
     unsigned GetBuildJobNum() const { return buildJobs.size(); }
     unsigned GetConnectJobNum() const { return connectJobs.size(); }
+    int GetAvailableJobBudget() const { return availableJobBudget; }
 
     void AddConnectFlagJob(const noFlag* flag);
 
@@ -88,7 +89,9 @@ public:
 
     bool CanStillConstructHere(MapPoint pt) const;
 
-    void ExecuteJobs(unsigned limit);
+    /// Execute up to limit jobs. Budget is added to the available cost units which are used up by the jobs (see Job::GetCost).
+    /// Jobs exceeding the available units are still executed and the overdraft is paid back in the next GFs
+    void ExecuteJobs(unsigned limit, unsigned budget);
     /// Set flags along the road starting at the given node in the given direction
     void SetFlagsAlongRoad(const noRoadNode& roadNode, Direction dir);
     /// To be called after a new construction site was added
@@ -108,6 +111,8 @@ private:
     std::deque<MapPoint> constructionlocations;
     // contains the type and amount of buildings ordered since the last nwf
     std::vector<uint8_t> constructionorders;
+    /// Cost units available for executing jobs. Negative if more was used than available
+    int availableJobBudget;
 };
 
 } // namespace AIJH
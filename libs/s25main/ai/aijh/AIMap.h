@@ -33,6 +33,8 @@ struct Node
     char failed_penalty; // when a node was marked reachable, but building failed, this field is >0
     bool border;
     bool farmed;
+    bool changed; // Node is in the list of nodes to update
+    bool ownFlag; // Node had an own flag at the last update of the reachable nodes
 };
 
 /// Map of AINodes.
@@ -22,6 +22,7 @@
 #include "FindWhConditions.h"
 #include "GamePlayer.h"
 #include "Jobs.h"
+#include "Profiler.h"
 #include "addons/const_addons.h"
 #include "ai/AIEvents.h"
 #include "boost/filesystem/fstream.hpp"
@@ -30,8 +31,7 @@
 #include "buildings/nobMilitary.h"
 #include "buildings/nobUsual.h"
 #include "helpers/containerUtils.h"
-#include "network/GameClient.h"
-#include "network/GameMessages.h"
+#include "mygettext/mygettext.h"
 #include "notifications/BuildingNote.h"
 #include "notifications/ExpeditionNote.h"
 #include "notifications/NodeNote.h"
@@ -119,14 +119,17 @@ AIPlayerJH::AIPlayerJH(const unsigned char playerId, const GameWorldBase& gwb, c
         case AI::EASY:
             attack_interval = 2500;
             build_interval = 1000;
+            jobBudgetPerGF = 6;
             break;
         case AI::MEDIUM:
             attack_interval = 750;
             build_interval = 400;
+            jobBudgetPerGF = 12;
             break;
         case AI::HARD:
             attack_interval = 100;
             build_interval = 200;
+            jobBudgetPerGF = 20;
             break;
         default: throw std::invalid_argument("Invalid AI level!");
     }
@@ -152,9 +155,23 @@ AIPlayerJH::AIPlayerJH(const unsigned char playerId, const GameWorldBase& gwb, c
         if(note.player == playerId)
             HandleShipNote(eventManager, note);
     });
-    subBQ = notifications.subscribe<NodeNote>([this](const NodeNote& note) {
-        if(note.type == NodeNote::BQ)
-            UpdateNodeBQ(note.pos);
+    subNode = notifications.subscribe<NodeNote>([this](const NodeNote& note) {
+        switch(note.type)
+        {
+            case NodeNote::BQ:
+                UpdateNodeBQ(note.pos);
+                // BQ changes when objects or roads at or around the node change
+                MarkNodeChanged(note.pos);
+                break;
+            case NodeNote::Owner:
+                // Territory and border state of the neighbours depend on this owner too
+                MarkNodeChanged(note.pos);
+                for(const MapPoint curPt : gwb.PointsOnRing(note.pos, 1))
+                    MarkNodeChanged(curPt);
+                break;
+            case NodeNote::Road: MarkNodeChanged(note.pos); break;
+            default: break;
+        }
     });
 }
 
@@ -167,11 +184,13 @@ AIPlayerJH::~AIPlayerJH()
 /// Wird jeden GF aufgerufen und die KI kann hier entsprechende Handlungen vollziehen
 void AIPlayerJH::RunGF(const unsigned gf, bool gfisnwf)
 {
+    ProfilingScope profilingScope(ProfilingZone::AI);
     if(defeated)
         return;
 
     if(TestDefeat())
         return;
+    UpdateChangedNodes();
     if(!isInitGfCompleted)
     {
         InitStoreAndMilitarylists();
@@ -256,6 +275,11 @@ void AIPlayerJH::RunGF(const unsigned gf, bool gfisnwf)
 void AIPlayerJH::PlanNewBuildings(const unsigned gf)
 {
     bldPlanner->UpdateBuildingsWanted(*this);
+    // Recheck nodes we failed to connect before
+    helpers::remove_if(failedNodes, [this](const MapPoint pt) { return aiMap[pt].reachable || aiMap[pt].failed_penalty == 0; });
+    for(const MapPoint pt : failedNodes)
+        MarkNodeChanged(pt);
+    UpdateChangedNodes();
 
     // pick a random storehouse and try to build one of these buildings around it (checks if we actually want more of the building type)
     std::array<BuildingType, 24> bldToTest = {{BLD_HARBORBUILDING, BLD_SHIPYARD,       BLD_SAWMILL,    BLD_FORESTER,     BLD_FARM,
@@ -287,7 +311,6 @@ void AIPlayerJH::PlanNewBuildings(const unsigned gf)
         auto it = storehouses.begin();
         std::advance(it, randomStore);
         const MapPoint whPos = (*it)->GetPos();
-        UpdateNodesAround(whPos, 15); // update the area we want to build in first
         for(auto& i : bldToTest)
         {
             if(construction->Wanted(i))
@@ -308,7 +331,6 @@ void AIPlayerJH::PlanNewBuildings(const unsigned gf)
     auto it2 = militaryBuildings.begin();
     std::advance(it2, randomMiliBld);
     MapPoint bldPos = (*it2)->GetPos();
-    UpdateNodesAround(bldPos, 15);
     // resource gathering buildings only around military; processing only close to warehouses
     for(unsigned i = 0; i < numResGatherBlds; i++)
     {
@@ -471,6 +493,14 @@ AIResource AIPlayerJH::CalcResource(const MapPoint pt)
 }
 
 void AIPlayerJH::InitReachableNodes()
+{
+    RTTR_FOREACH_PT(MapPoint, aiMap.GetSize())
+        aiMap[pt].failed_penalty = 0;
+    failedNodes.clear();
+    RecalcReachableNodes();
+}
+
+void AIPlayerJH::RecalcReachableNodes()
 {
     std::queue<MapPoint> toCheck;
 
@@ -479,9 +509,8 @@ void AIPlayerJH::InitReachableNodes()
     {
         Node& node = aiMap[pt];
         node.reachable = false;
-        node.failed_penalty = 0;
-        const auto* myFlag = gwb.GetSpecObj<noFlag>(pt);
-        if(myFlag && myFlag->GetPlayer() == playerId)
+        node.ownFlag = IsOwnFlag(pt);
+        if(node.ownFlag)
         {
             node.reachable = true;
             toCheck.push(pt);
@@ -491,6 +520,12 @@ void AIPlayerJH::InitReachableNodes()
     IterativeReachableNodeChecker(toCheck);
 }
 
+bool AIPlayerJH::IsOwnFlag(const MapPoint pt) const
+{
+    const auto* flag = gwb.GetSpecObj<noFlag>(pt);
+    return flag && flag->GetPlayer() == playerId;
+}
+
 void AIPlayerJH::IterativeReachableNodeChecker(std::queue<MapPoint> toCheck)
 {
     // TODO auch mal bootswege bauen können
@@ -528,53 +563,151 @@ void AIPlayerJH::IterativeReachableNodeChecker(std::queue<MapPoint> toCheck)
     }
 }
 
-void AIPlayerJH::UpdateReachableNodes(const std::vector<MapPoint>& pts)
+bool AIPlayerJH::AreReachableNeighboursConnected(const MapPoint pt) const
 {
-    std::queue<MapPoint> toCheck;
+    // Search only close to the point. Usually the neighbours are connected around it, otherwise we do a full recalculation
+    const unsigned maxDistance = 3;
+    std::vector<MapPoint> neighbours;
+    for(const MapPoint curPt : gwb.PointsOnRing(pt, 1))
+    {
+        if(aiMap[curPt].reachable)
+            neighbours.push_back(curPt);
+    }
+    // Removing a dead end does not disconnect anything
+    if(neighbours.size() < 2u)
+        return true;
 
-    for(const MapPoint& curPt : pts)
+    std::vector<MapPoint> visited(1, neighbours.front());
+    std::queue<MapPoint> toCheck;
+    toCheck.push(neighbours.front());
+    unsigned numNeighboursFound = 1;
+    while(!toCheck.empty() && numNeighboursFound < neighbours.size())
     {
-        const auto* flag = gwb.GetSpecObj<noFlag>(curPt);
-        if(flag && flag->GetPlayer() == playerId)
+        const MapPoint curPt = toCheck.front();
+        toCheck.pop();
+        for(const MapPoint nb : gwb.PointsOnRing(curPt, 1))
         {
-            aiMap[curPt].reachable = true;
-            toCheck.push(curPt);
-        } else
-            aiMap[curPt].reachable = false;
+            if(nb == pt || !aiMap[nb].reachable || gwb.CalcDistance(pt, nb) > maxDistance || helpers::contains(visited, nb))
+                continue;
+            visited.push_back(nb);
+            toCheck.push(nb);
+            if(helpers::contains(neighbours, nb))
+                numNeighboursFound++;
+        }
     }
-    IterativeReachableNodeChecker(toCheck);
+    return numNeighboursFound == neighbours.size();
 }
 
-void AIPlayerJH::InitNodes()
+void AIPlayerJH::MarkNodeChanged(const MapPoint pt)
 {
-    aiMap.Resize(gwb.GetSize());
+    Node& node = aiMap[pt];
+    if(!node.changed)
+    {
+        node.changed = true;
+        changedNodes.push_back(pt);
+    }
+}
 
-    InitReachableNodes();
+void AIPlayerJH::UpdateChangedNodes()
+{
+    if(changedNodes.empty())
+        return;
 
-    RTTR_FOREACH_PT(MapPoint, aiMap.GetSize())
+    PathConditionRoad<GameWorldBase> roadPathChecker(gwb, false);
+    std::queue<MapPoint> toCheck;
+    std::vector<MapPoint> removedPts;
+    bool flagRemoved = false;
+    for(const MapPoint pt : changedNodes)
     {
         Node& node = aiMap[pt];
-
+        node.changed = false;
+        // Change of ownership might change bq
         node.bq = aii.GetBuildingQuality(pt);
-        node.res = CalcResource(pt);
         node.owned = aii.IsOwnTerritory(pt);
         node.border = aii.IsBorder(pt);
-        node.farmed = false;
+
+        const bool isOwnFlag = IsOwnFlag(pt);
+        // Flags are the sources of the reachable area. A removed one might have been the only one of its area
+        if(node.ownFlag && !isOwnFlag)
+            flagRemoved = true;
+        node.ownFlag = isOwnFlag;
+        if(isOwnFlag)
+        {
+            if(!node.reachable)
+            {
+                node.reachable = true;
+                toCheck.push(pt);
+            }
+        } else if(!roadPathChecker.IsNodeOk(pt))
+        {
+            if(node.reachable)
+            {
+                node.reachable = false;
+                removedPts.push_back(pt);
+            }
+        } else if(!node.reachable)
+        {
+            // Usable again -> reachable if a neighbour is (checked once per reachable neighbour as in the full search)
+            for(const MapPoint curPt : gwb.PointsOnRing(pt, 1))
+            {
+                if(!aiMap[curPt].reachable)
+                    continue;
+                if(node.failed_penalty == 0)
+                {
+                    node.reachable = true;
+                    toCheck.push(pt);
+                    break;
+                } else
+                    node.failed_penalty--;
+            }
+        }
+    }
+    changedNodes.clear();
+
+    if(flagRemoved)
+    {
+        RecalcReachableNodes();
+        return;
+    }
+    // A removed node might split the reachable area. If it might, do a full recalculation
+    for(const MapPoint pt : removedPts)
+    {
+        if(!AreReachableNeighboursConnected(pt))
+        {
+            RecalcReachableNodes();
+            return;
+        }
     }
+    IterativeReachableNodeChecker(toCheck);
+}
+
+void AIPlayerJH::SetNodeFailed(const MapPoint pt)
+{
+    Node& node = aiMap[pt];
+    node.reachable = false;
+    node.failed_penalty = 20;
+    if(!helpers::contains(failedNodes, pt))
+        failedNodes.push_back(pt);
 }
 
-void AIPlayerJH::UpdateNodesAround(const MapPoint pt, unsigned radius)
+void AIPlayerJH::InitNodes()
 {
-    std::vector<MapPoint> pts = gwb.GetPointsInRadius(pt, radius);
-    UpdateReachableNodes(pts);
-    for(const MapPoint& pt : pts)
+    aiMap.Resize(gwb.GetSize());
+
+    InitReachableNodes();
+
+    RTTR_FOREACH_PT(MapPoint, aiMap.GetSize())
     {
         Node& node = aiMap[pt];
-        // Change of ownership might change bq
+
         node.bq = aii.GetBuildingQuality(pt);
+        node.res = CalcResource(pt);
         node.owned = aii.IsOwnTerritory(pt);
         node.border = aii.IsBorder(pt);
+        node.farmed = false;
+        node.changed = false;
     }
+    changedNodes.clear();
 }
 
 void AIPlayerJH::UpdateNodeBQ(const MapPoint& pt)
@@ -584,7 +717,7 @@ void AIPlayerJH::UpdateNodeBQ(const MapPoint& pt)
     {
         aiMap[pt].bq = newBQ;
         // Neighbour points might change to (flags at borders etc.)
-        for(const MapPoint& curPt : gwb.GetPointsInRadius(pt, 1))
+        for(const MapPoint& curPt : gwb.PointsInRadius(pt, 1))
             UpdateNodeBQ(curPt);
     }
 }
@@ -605,8 +738,7 @@ void AIPlayerJH::SetFarmedNodes(const MapPoint pt, bool set)
     const unsigned radius = 3;
 
     aiMap[pt].farmed = set;
-    std::vector<MapPoint> pts = gwb.GetPointsInRadius(pt, radius);
-    for(const MapPoint& curPt : pts)
+    for(const MapPoint& curPt : gwb.PointsInRadius(pt, radius))
         aiMap[curPt].farmed = set;
 }
 
@@ -816,7 +948,8 @@ void AIPlayerJH::ExecuteAIJob()
     if(quota > 40)
         quota = 40;
 
-    construction->ExecuteJobs(quota); // try to execute up to quota connect & construction jobs
+    // try to execute up to quota connect & construction jobs, limited by the budget to avoid expensive GFs
+    construction->ExecuteJobs(quota, jobBudgetPerGF);
     /*
     // if no current job available, take next one! events first, then constructions
     if (!currentJob)
@@ -1012,8 +1145,7 @@ MapPoint AIPlayerJH::SimpleFindPosition(const MapPoint& pt, BuildingQuality size
     if(radius == -1)
         radius = 30;
 
-    std::vector<MapPoint> pts = gwb.GetPointsInRadius(pt, radius);
-    for(const MapPoint& curPt : pts)
+    for(const MapPoint& curPt : gwb.PointsInRadius(pt, radius))
     {
         if(!aiMap[curPt].reachable || aiMap[curPt].farmed || !aii.IsOwnTerritory(curPt))
             continue;
@@ -1118,16 +1250,14 @@ unsigned AIPlayerJH::GetDensity(MapPoint pt, AIResource res, int radius)
 {
     RTTR_Assert(pt.x < aiMap.GetWidth() && pt.y < aiMap.GetHeight());
 
-    std::vector<MapPoint> pts = gwb.GetPointsInRadius(pt, radius);
-    const unsigned all = pts.size();
-    RTTR_Assert(all > 0);
-
-    unsigned good = 0;
-    for(const MapPoint& curPt : pts)
+    unsigned all = 0, good = 0;
+    for(const MapPoint& curPt : gwb.PointsInRadius(pt, radius))
     {
+        all++;
         if(aiMap[curPt].res == res)
             good++;
     }
+    RTTR_Assert(all > 0);
 
     return (good * 100) / all;
 }
@@ -1207,7 +1337,7 @@ void AIPlayerJH::HandleBuilingDestroyed(MapPoint pt, BuildingType bld)
         case BLD_HARBORBUILDING:
         {
             // destroy all other buildings around the harborspot in range 2 so we can rebuild the harbor ...
-            for(const MapPoint curPt : gwb.GetPointsInRadius(pt, 2))
+            for(const MapPoint curPt : gwb.PointsInRadius(pt, 2))
             {
                 const auto* const bb = gwb.GetSpecObj<noBaseBuilding>(curPt);
                 if(bb)
@@ -1275,7 +1405,6 @@ void AIPlayerJH::HandleBuildingFinished(const MapPoint pt, BuildingType bld)
     switch(bld)
     {
         case BLD_HARBORBUILDING:
-            UpdateNodesAround(pt, 8);    // todo: fix radius
             RemoveAllUnusedRoads(pt);    // repair & reconnect road system - required when a colony gets a new harbor by expedition
             aii.ChangeReserve(pt, 0, 1); // order 1 defender to stay in the harborbuilding
 
@@ -1349,10 +1478,6 @@ void AIPlayerJH::HandleTreeChopped(const MapPoint pt)
 {
     // std::cout << "Tree chopped." << std::endl;
 
-    aiMap[pt].reachable = true;
-
-    UpdateNodesAround(pt, 3);
-
     int random = rand();
 
     if(random % 2 == 0)
@@ -1407,7 +1532,6 @@ void AIPlayerJH::HandleNoMoreResourcesReachable(const MapPoint pt, BuildingType
     if(bld == BLD_FISHERY)
         SetResourceMap(AIResource::FISH, pt, 0);
 
-    UpdateNodesAround(pt, 11); // todo: fix radius
     RemoveUnusedRoad(*gwb.GetSpecObj<noFlag>(gwb.GetNeighbour(pt, Direction::SOUTHEAST)), 1, true);
 
     // try to expand, maybe res blocked a passage
@@ -1458,8 +1582,6 @@ void AIPlayerJH::HandleShipBuilt(const MapPoint pt)
 
 void AIPlayerJH::HandleBorderChanged(const MapPoint pt)
 {
-    UpdateNodesAround(pt, 11); // todo: fix radius
-
     const auto* mil = gwb.GetSpecObj<nobMilitary>(pt);
     if(mil)
     {
@@ -1544,7 +1666,7 @@ void AIPlayerJH::MilUpgradeOptim()
 
 void AIPlayerJH::Chat(const std::string& message)
 {
-    GAMECLIENT.GetMainPlayer().sendMsgAsync(new GameMessage_Chat(playerId, CD_ALL, message));
+    chatMsgs.push_back(message);
 }
 
 bool AIPlayerJH::HasFrontierBuildings()
@@ -1964,7 +2086,6 @@ void AIPlayerJH::RemoveAllUnusedRoads(const MapPoint pt)
         if(RemoveUnusedRoad(*flag, 255, true, false))
             reconnectflags.push_back(flag);
     }
-    UpdateNodesAround(pt, 25);
     for(const noFlag* flag : reconnectflags)
         construction->AddConnectFlagJob(flag);
 }
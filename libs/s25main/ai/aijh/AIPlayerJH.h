@@ -53,6 +53,7 @@ public:
     const GameWorldBase& GetWorld() const { return gwb; }
     // Required by the AIJobs:
     AIConstruction& GetConstruction() { return *construction; }
+    unsigned GetJobBudgetPerGF() const { return jobBudgetPerGF; }
     const BuildingPlanner& GetBldPlanner() const { return *bldPlanner; }
     const Job* GetCurrentJob() const { return currentJob.get(); }
     unsigned GetNumJobs() const;
@@ -116,8 +117,13 @@ public:
     void SetGatheringForUpgradeWarehouse(nobBaseWarehouse* upgradewarehouse);
     /// Initializes the nodes on start of the game
     void InitNodes();
-    /// Updates the nodes around a position
-    void UpdateNodesAround(MapPoint pt, unsigned radius);
+    /// Marks a node whose ownership, roads or objects changed for the next UpdateChangedNodes
+    void MarkNodeChanged(MapPoint pt);
+    /// Updates territory, border and reachability of all nodes marked as changed
+    void UpdateChangedNodes();
+    /// Marks a node as unreachable after connecting a building there failed.
+    /// It has to be found reachable in a couple of later checks before it is used again
+    void SetNodeFailed(MapPoint pt);
     /// Returns the resource on a specific point
     AIResource CalcResource(MapPoint pt);
     /// Initialize the resource maps
@@ -181,7 +187,7 @@ public:
     void HandleNewColonyFounded(MapPoint pt);
     /// Lost land to another player
     void HandleLostLand(MapPoint pt);
-    /// Sends a chat messsage to all players
+    /// Queues a chat messsage to all players (see FetchChatMessages)
     void Chat(const std::string& message);
     /// check expeditions (order new / cancel)
     void CheckExpeditions();
@@ -204,8 +210,12 @@ public:
     void SaveResourceMapsToFile();
 
     void InitReachableNodes();
+    /// Recalculates the reachable nodes starting from all own flags
+    void RecalcReachableNodes();
     void IterativeReachableNodeChecker(std::queue<MapPoint> toCheck);
-    void UpdateReachableNodes(const std::vector<MapPoint>& pts);
+    /// Return true if the reachable neighbours of the given point are still connected without using this point
+    bool AreReachableNeighboursConnected(MapPoint pt) const;
+    bool IsOwnFlag(MapPoint pt) const;
 
     /// disconnects 'inland' military buildings from road system(and sends out soldiers), sets stop gold, uses the upgrade building (order
     /// new private, kick out general)
@@ -246,11 +256,17 @@ private:
     std::list<MapPoint> milBuildingSites;
     /// Nodes containing some information about every map node
     AIMap aiMap;
+    /// Nodes marked as changed by notifications of the world (see MarkNodeChanged)
+    std::vector<MapPoint> changedNodes;
+    /// Nodes with a failed_penalty which are rechecked when planning new buildings
+    std::vector<MapPoint> failedNodes;
     /// Resource maps, containing a rating for every map point concerning a resource
     boost::container::static_vector<AIResourceMap, NUM_AIRESOURCES> resourceMaps;
 
     unsigned attack_interval;
     unsigned build_interval;
+    /// Cost units (see Job::GetCost) the AI may spend on construction and connection jobs per GF
+    unsigned jobBudgetPerGF;
     int isInitGfCompleted;
     /// resigned yes/no
     bool defeated;
@@ -258,7 +274,7 @@ private:
     BuildingPlanner* bldPlanner;
     AIConstruction* construction;
 
-    Subscribtion subBuilding, subExpedition, subResource, subRoad, subShip, subBQ;
+    Subscribtion subBuilding, subExpedition, subResource, subRoad, subShip, subNode;
 
     void UpdateNodeBQ(const MapPoint& pt);
 };
@@ -22,6 +22,9 @@
 #include "buildings/noBuildingSite.h"
 #include "buildings/nobUsual.h"
 #include "gameData/TerrainDesc.h"
+#include <algorithm>
+#include <initializer_list>
+#include <limits>
 
 namespace AIJH {
 
@@ -33,24 +36,196 @@ AIResourceMap::~AIResourceMap() = default;
 
 void AIResourceMap::Init()
 {
-    const MapExtent mapSize = aiMap.GetSize();
+    map.Resize(aiMap.GetSize());
+    ResetTiles();
+    CalcRatings(CalcResourceNodes());
+}
+
+void AIResourceMap::InitBySplatting()
+{
+    map.Resize(aiMap.GetSize());
+    ResetTiles();
+    SplatRatings(CalcResourceNodes());
+}
+
+void AIResourceMap::ResetTiles()
+{
+    numTiles = MapExtent((map.GetWidth() + TILE_SIZE - 1) / TILE_SIZE, (map.GetHeight() + TILE_SIZE - 1) / TILE_SIZE);
+    const unsigned numTotalTiles = prodOfComponents(numTiles);
+    tileMaxima.assign(numTotalTiles, 0);
+    isTileDirty.assign(numTotalTiles, false);
+    dirtyTiles.clear();
+    for(unsigned i = 0; i < numTotalTiles; i++)
+        MarkTileDirty(i);
+}
+
+void AIResourceMap::MarkTileDirty(unsigned tileIdx) const
+{
+    if(isTileDirty[tileIdx])
+        return;
+    isTileDirty[tileIdx] = true;
+    dirtyTiles.push_back(tileIdx);
+}
+
+void AIResourceMap::UpdateTileMaxima() const
+{
+    for(unsigned tileIdx : dirtyTiles)
+    {
+        const unsigned tileX = tileIdx % numTiles.x, tileY = tileIdx / numTiles.x;
+        const unsigned endX = std::min((tileX + 1) * TILE_SIZE, static_cast<unsigned>(map.GetWidth()));
+        const unsigned endY = std::min((tileY + 1) * TILE_SIZE, static_cast<unsigned>(map.GetHeight()));
+        int maxVal = std::numeric_limits<int>::min();
+        for(unsigned y = tileY * TILE_SIZE; y < endY; y++)
+        {
+            for(unsigned x = tileX * TILE_SIZE; x < endX; x++)
+                maxVal = std::max(maxVal, map[MapPoint(x, y)]);
+        }
+        tileMaxima[tileIdx] = maxVal;
+        isTileDirty[tileIdx] = false;
+    }
+    dirtyTiles.clear();
+}
 
-    map.Resize(mapSize);
+void AIResourceMap::AddToRating(const MapPoint pt, int diff)
+{
+    int& value = map[pt];
+    const int oldValue = value;
+    value += diff;
+    const unsigned tileIdx = GetTileIdx(pt);
+    if(isTileDirty[tileIdx])
+        return;
+    if(value > tileMaxima[tileIdx])
+        tileMaxima[tileIdx] = value;
+    else if(oldValue == tileMaxima[tileIdx] && value < oldValue) // The maximum might have been reduced
+        MarkTileDirty(tileIdx);
+}
+
+int AIResourceMap::GetMaxRating(const MapPoint& pt, unsigned radius) const
+{
+    UpdateTileMaxima();
+    // Bounding box of the area: All points in range are at most radius nodes away in x and y direction
+    const unsigned width = map.GetWidth(), height = map.GetHeight();
+    const unsigned numX = std::min(2 * radius + 1, width), numY = std::min(2 * radius + 1, height);
+    const unsigned startX = (pt.x + width - radius % width) % width;
+    const unsigned startY = (pt.y + height - radius % height) % height;
+    int maxVal = std::numeric_limits<int>::min();
+    // Walk over the (wrapped) ranges tile by tile
+    for(unsigned dy = 0; dy < numY;)
+    {
+        const unsigned y = (startY + dy) % height;
+        for(unsigned dx = 0; dx < numX;)
+        {
+            const unsigned x = (startX + dx) % width;
+            maxVal = std::max(maxVal, tileMaxima[GetTileIdx(MapPoint(x, y))]);
+            dx += std::min(TILE_SIZE - x % TILE_SIZE, width - x);
+        }
+        dy += std::min(TILE_SIZE - y % TILE_SIZE, height - y);
+    }
+    return maxVal;
+}
+
+std::vector<uint8_t> AIResourceMap::CalcResourceNodes() const
+{
+    const MapExtent mapSize = aiMap.GetSize();
+    std::vector<uint8_t> resNodes(prodOfComponents(mapSize), 0);
     RTTR_FOREACH_PT(MapPoint, mapSize)
     {
         const Node& node = aiMap[pt];
+        bool isResNode = false;
         if(res == AIResource::FISH && node.res == res)
-            Change(pt, 1);
+            isResNode = true;
         else if(aii.gwb.GetDescription().get(aii.gwb.GetNode(pt).t1).Is(ETerrain::Walkable))
         {
             if(res != AIResource::BORDERLAND && node.res == res)
-                Change(pt, 1);
+                isResNode = true;
             else if(res == AIResource::BORDERLAND && aii.IsBorder(pt))
-                Change(pt, 1);
+                isResNode = true;
             else if(node.res == AIResource::MULTIPLE)
+                isResNode = aii.GetSubsurfaceResource(pt) == res || aii.GetSurfaceResource(pt) == res;
+        }
+        resNodes[map.GetIdx(pt)] = isResNode ? 1 : 0;
+    }
+    return resNodes;
+}
+
+void AIResourceMap::SplatRatings(const std::vector<uint8_t>& resNodes)
+{
+    RTTR_FOREACH_PT(MapPoint, map.GetSize())
+    {
+        if(resNodes[map.GetIdx(pt)])
+            Change(pt, 1);
+    }
+}
+
+void AIResourceMap::CalcRatings(const std::vector<uint8_t>& resNodes)
+{
+    const int width = map.GetWidth(), height = map.GetHeight();
+    const int radius = static_cast<int>(resRadius);
+    // The offsets to the nodes in range only depend on the parity of the row,
+    // which breaks when wrapping around an odd number of rows -> Use the slow way
+    if(height % 2 != 0)
+    {
+        SplatRatings(resNodes);
+        return;
+    }
+
+    // Prefix sums of the number of resource nodes and their x coordinates for each row.
+    // Rows are extended by radius nodes (wrapped around) on both sides, entry i is the sum for all x < i - radius
+    const int rowLen = width + 2 * radius + 1;
+    std::vector<int> prefixCount(rowLen * height), prefixX(rowLen * height);
+    std::vector<bool> rowHasRes(height, false);
+    for(int y = 0; y < height; y++)
+    {
+        int* curCount = &prefixCount[y * rowLen];
+        int* curX = &prefixX[y * rowLen];
+        curCount[0] = curX[0] = 0;
+        for(int i = 1; i < rowLen; i++)
+        {
+            const int x = i - 1 - radius;
+            const int isRes = resNodes[y * width + ((x % width) + width) % width];
+            curCount[i] = curCount[i - 1] + isRes;
+            curX[i] = curX[i - 1] + isRes * x;
+        }
+        rowHasRes[y] = curCount[rowLen - 1] > 0;
+    }
+
+    // The rating at (tx, ty) is the sum of (radius - distance) over all resource nodes (sx, sy) in range.
+    // In a row with |ty - sy| = a the weight is constant for the a + 1 nodes closest to tx and decreases linearly by 1 per node
+    // to both sides. So each row contributes 3 sums over consecutive nodes which are calculated from the prefix sums.
+    // Rows with a == radius are skipped as their weight is 0
+    for(int ty = 0; ty < height; ty++)
+    {
+        for(int a = 0; a < radius; a++)
+        {
+            // Offset of the source row to the target row in half nodes. Has the same parity as a
+            const int c = (ty & 1) - ((ty + a) & 1);
+            for(int dy : {-a, a})
             {
-                if(aii.GetSubsurfaceResource(pt) == res || aii.GetSurfaceResource(pt) == res)
-                    Change(pt, 1);
+                if(dy > 0 && a == 0)
+                    break;
+                const int sy = (((ty - dy) % height) + height) % height;
+                if(!rowHasRes[sy])
+                    continue;
+                const int* curCount = &prefixCount[sy * rowLen];
+                const int* curX = &prefixX[sy * rowLen];
+                const auto count = [curCount, radius](int first, int last) {
+                    return first > last ? 0 : curCount[last + 1 + radius] - curCount[first + radius];
+                };
+                const auto sumX = [curX, radius](int first, int last) {
+                    return first > last ? 0 : curX[last + 1 + radius] - curX[first + radius];
+                };
+                for(int tx = 0; tx < width; tx++)
+                {
+                    const int flatFirst = tx - (a - c) / 2, flatLast = tx + (a + c) / 2;
+                    const int leftFirst = tx - (2 * radius - a - c) / 2;
+                    const int rightLast = tx + (2 * radius - a + c) / 2;
+                    int rating = (radius - a) * count(flatFirst, flatLast);
+                    // Weight for sx < flatFirst: radius - a - (flatFirst - sx)
+                    rating += sumX(leftFirst, flatFirst - 1) + (radius - a - flatFirst) * count(leftFirst, flatFirst - 1);
+                    // Weight for sx > flatLast: radius - a - (sx - flatLast)
+                    rating += (radius - a + flatLast) * count(flatLast + 1, rightLast) - sumX(flatLast + 1, rightLast);
+                    map[static_cast<unsigned>(ty * width + tx)] += rating;
+                }
             }
         }
     }
@@ -85,25 +260,14 @@ void AIResourceMap::AdjustRatingForBlds(BuildingType bld, unsigned radius, int v
     }
 }
 
-namespace {
-    struct ValueAdjuster
-    {
-        NodeMapBase<int>& map;
-        unsigned radius;
-        int value;
-
-        ValueAdjuster(NodeMapBase<int>& map, unsigned radius, int value) : map(map), radius(radius), value(value) {}
-        bool operator()(const MapPoint pt, unsigned r) const
-        {
-            map[pt] += value * (radius - r);
-            return false; // Don't exit
-        }
-    };
-} // namespace
-
 void AIResourceMap::Change(const MapPoint pt, unsigned radius, int value)
 {
-    aii.gwb.CheckPointsInRadius(pt, radius, ValueAdjuster(map, radius, value), true);
+    aii.gwb.CheckPointsInRadius(pt, radius,
+                                [this, radius, value](const MapPoint curPt, unsigned r) {
+                                    AddToRating(curPt, value * static_cast<int>(radius - r));
+                                    return false; // Don't exit
+                                },
+                                true);
 }
 
 MapPoint AIResourceMap::FindGoodPosition(const MapPoint& pt, int threshold, BuildingQuality size, int radius, bool inTerritory) const
@@ -114,20 +278,28 @@ MapPoint AIResourceMap::FindGoodPosition(const MapPoint& pt, int threshold, Buil
     if(radius == -1)
         radius = 30;
 
-    std::vector<MapPoint> pts = aii.gwb.GetPointsInRadiusWithCenter(pt, radius);
-    for(const MapPoint& curPt : pts)
-    {
-        const unsigned idx = map.GetIdx(curPt);
-        if(map[idx] >= threshold)
-        {
-            if((inTerritory && !aiMap[idx].owned) || aiMap[idx].farmed)
-                continue;
-            RTTR_Assert(aii.GetBuildingQuality(curPt) == aiMap[curPt].bq);
-            if(canUseBq(aii.GetBuildingQuality(curPt), size)) //(*nodes)[idx].bq; TODO: Update nodes BQ and use that
-                return curPt;
-        }
-    }
-    return MapPoint::Invalid();
+    // Nothing to find if no tile in range reaches the threshold
+    if(GetMaxRating(pt, radius) < threshold)
+        return MapPoint::Invalid();
+
+    MapPoint result = MapPoint::Invalid();
+    aii.gwb.CheckPointsInRadius(pt, radius,
+                                [this, threshold, size, inTerritory, &result](const MapPoint curPt, unsigned) {
+                                    // Skip points in tiles where no point reaches the threshold
+                                    const unsigned idx = map.GetIdx(curPt);
+                                    if(tileMaxima[GetTileIdx(curPt)] < threshold || map[idx] < threshold)
+                                        return false;
+                                    if((inTerritory && !aiMap[idx].owned) || aiMap[idx].farmed)
+                                        return false;
+                                    RTTR_Assert(aii.GetBuildingQuality(curPt) == aiMap[curPt].bq);
+                                    //(*nodes)[idx].bq; TODO: Update nodes BQ and use that
+                                    if(!canUseBq(aii.GetBuildingQuality(curPt), size))
+                                        return false;
+                                    result = curPt;
+                                    return true;
+                                },
+                                true);
+    return result;
 }
 
 MapPoint AIResourceMap::FindBestPosition(const MapPoint& pt, BuildingQuality size, int minimum, int radius, bool inTerritory) const
@@ -141,22 +313,28 @@ MapPoint AIResourceMap::FindBestPosition(const MapPoint& pt, BuildingQuality siz
     MapPoint best = MapPoint::Invalid();
     int best_value = (minimum == std::numeric_limits<int>::min()) ? minimum : minimum - 1;
 
-    std::vector<MapPoint> pts = aii.gwb.GetPointsInRadiusWithCenter(pt, radius);
-    for(const MapPoint& curPt : pts)
-    {
-        const unsigned idx = map.GetIdx(curPt);
-        if(map[idx] > best_value)
-        {
-            if(!aiMap[idx].reachable || (inTerritory && !aiMap[idx].owned) || aiMap[idx].farmed)
-                continue;
-            RTTR_Assert(aii.GetBuildingQuality(curPt) == aiMap[curPt].bq);
-            if(canUseBq(aii.GetBuildingQuality(curPt), size)) //(*nodes)[idx].bq; TODO: Update nodes BQ and use that
-            {
-                best = curPt;
-                best_value = map[idx];
-            }
-        }
-    }
+    // Only points with a higher value replace the current best one, so we are done when the maximum is reached
+    const int maxValue = GetMaxRating(pt, radius);
+    if(maxValue <= best_value)
+        return best;
+
+    aii.gwb.CheckPointsInRadius(pt, radius,
+                                [this, size, inTerritory, maxValue, &best, &best_value](const MapPoint curPt, unsigned) {
+                                    // Skip points in tiles without a better point
+                                    const unsigned idx = map.GetIdx(curPt);
+                                    if(tileMaxima[GetTileIdx(curPt)] <= best_value || map[idx] <= best_value)
+                                        return false;
+                                    if(!aiMap[idx].reachable || (inTerritory && !aiMap[idx].owned) || aiMap[idx].farmed)
+                                        return false;
+                                    RTTR_Assert(aii.GetBuildingQuality(curPt) == aiMap[curPt].bq);
+                                    if(canUseBq(aii.GetBuildingQuality(curPt), size)) //(*nodes)[idx].bq; TODO: Update nodes BQ and use that
+                                    {
+                                        best = curPt;
+                                        best_value = map[idx];
+                                    }
+                                    return best_value >= maxValue;
+                                },
+                                true);
 
     return best;
 }
@@ -23,6 +23,8 @@
 #include "world/NodeMapBase.h"
 #include "gameTypes/BuildingQuality.h"
 #include "gameTypes/BuildingType.h"
+#include <cstdint>
+#include <vector>
 
 class AIInterface;
 namespace AIJH {
@@ -36,6 +38,9 @@ public:
 
     /// Initialize the resource map
     void Init();
+    /// Same as Init but adds the rating of every resource node separately to its surroundings.
+    /// Slow but simple, so it serves as the reference for Init
+    void InitBySplatting();
     void Recalc();
     /// Changes every point around pt in radius; to every point around pt distanceFromCenter * value is added
     void Change(MapPoint pt, unsigned radius, int value);
@@ -51,16 +56,48 @@ public:
         return FindBestPosition(pt, size, 1, radius, inTerritory);
     }
 
-    int& operator[](const MapPoint& pt) { return map[pt]; }
+    /// Maximum rating of all points in the given radius around pt. Might be larger than the actual maximum
+    /// as it is calculated from the maxima of the tiles overlapping the area
+    int GetMaxRating(const MapPoint& pt, unsigned radius) const;
+
+    /// Write access to a rating. As the value can't be tracked, the tile containing pt is re-evaluated on the next search
+    int& operator[](const MapPoint& pt)
+    {
+        MarkTileDirty(GetTileIdx(pt));
+        return map[pt];
+    }
     int operator[](const MapPoint& pt) const { return map[pt]; }
 
 private:
+    /// Size of the (square) tiles for which the maximum ratings are stored
+    static constexpr unsigned TILE_SIZE = 8;
+
     void AdjustRatingForBlds(BuildingType bld, unsigned radius, int value);
+    /// Return 1 for each node containing the resource, 0 otherwise
+    std::vector<uint8_t> CalcResourceNodes() const;
+    /// Add the ratings of each resource node to the nodes in range
+    void SplatRatings(const std::vector<uint8_t>& resNodes);
+    /// Set the rating of each node to the sum of the ratings from all resource nodes in range using sums over parts of the rows
+    void CalcRatings(const std::vector<uint8_t>& resNodes);
+    /// Set the value at pt to map[pt] + diff and update the maximum of its tile
+    void AddToRating(MapPoint pt, int diff);
+    unsigned GetTileIdx(const MapPoint& pt) const { return (pt.y / TILE_SIZE) * numTiles.x + pt.x / TILE_SIZE; }
+    void MarkTileDirty(unsigned tileIdx) const;
+    /// Resize the tiles according to the map size and mark all of them dirty
+    void ResetTiles();
+    /// Recalculate the maxima of all dirty tiles
+    void UpdateTileMaxima() const;
     /// Which resource is stored in the map and radius of affected nodes
     const AIResource res;
     const unsigned resRadius;
 
     NodeMapBase<int> map;
+    /// Number of tiles in x and y direction. The last tile in each direction can be smaller than TILE_SIZE
+    MapExtent numTiles;
+    /// Maximum rating of each tile. Lazily updated by the (const) searches, hence mutable
+    mutable std::vector<int> tileMaxima;
+    mutable std::vector<bool> isTileDirty;
+    mutable std::vector<unsigned> dirtyTiles;
     const AIInterface& aii;
     const AIMap& aiMap;
 };
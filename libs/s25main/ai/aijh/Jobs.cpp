@@ -32,8 +32,26 @@
 
 namespace AIJH {
 
+namespace {
+    /// Costs of the job steps relative to each other. Searching for a position is about twice as expensive as searching a road
+    const unsigned COST_POSITION_SEARCH = 4;
+    const unsigned COST_ROAD_SEARCH = 2;
+} // namespace
+
 Job::Job(AIPlayerJH& aijh) : aijh(aijh), state(JOB_WAITING) {}
 
+unsigned BuildJob::GetCost() const
+{
+    switch(state)
+    {
+        case JOB_WAITING:
+        case JOB_EXECUTING_START: return COST_POSITION_SEARCH;
+        case JOB_EXECUTING_ROAD1:
+        case JOB_EXECUTING_ROAD2: return COST_ROAD_SEARCH;
+        default: return 1;
+    }
+}
+
 void BuildJob::ExecuteJob()
 {
     // are we allowed to plan construction work in the area in this nwf?
@@ -217,10 +235,9 @@ void BuildJob::BuildMainRoad()
             std::cout << "Player " << (unsigned)aijh.GetPlayerId() << ", Job failed: Cannot connect " << BUILDING_NAMES[type] << " at "
                       << target.x << "/" << target.y << ". Retrying..." << std::endl;
 #endif
-            aijh.GetAINode(target).reachable = false;
             // We thought this had be reachable, but it is not (might be blocked by building site itself):
             // It has to be reachable in a check for 20x times, to avoid retrying it too often.
-            aijh.GetAINode(target).failed_penalty = 20;
+            aijh.SetNodeFailed(target);
             aiInterface.DestroyBuilding(target);
             aiInterface.DestroyFlag(houseFlag->GetPos());
             aijh.AddBuildJob(type, around);
@@ -400,6 +417,11 @@ void EventJob::ExecuteJob() // for now it is assumed that all these will be fini
     state = JOB_FINISHED;
 }
 
+unsigned ConnectJob::GetCost() const
+{
+    return COST_ROAD_SEARCH;
+}
+
 void ConnectJob::ExecuteJob()
 {
 #ifdef DEBUG_AI
@@ -59,6 +59,8 @@ public:
     Job(AIPlayerJH& aijh);
     virtual ~Job() = default;
     virtual void ExecuteJob() = 0;
+    /// Estimated costs of the next call to ExecuteJob. Used to spread the work of the AI over GFs, so it must be deterministic
+    virtual unsigned GetCost() const { return 1; }
     JobState GetState() const { return state; }
     void SetState(JobState s) { state = s; }
 
@@ -89,6 +91,7 @@ public:
 
     ~BuildJob() override = default;
     void ExecuteJob() override;
+    unsigned GetCost() const override;
     inline BuildingType GetType() const { return type; }
     inline MapPoint GetAround() const { return around; }
 
@@ -109,6 +112,7 @@ public:
     ConnectJob(AIPlayerJH& aijh, MapPoint flagPos) : Job(aijh), flagPos(flagPos) {}
     ~ConnectJob() override = default;
     void ExecuteJob() override;
+    unsigned GetCost() const override;
     MapPoint getFlag() const { return flagPos; }
 
 private:
@@ -248,14 +248,15 @@ void nobUsual::HandleEvent(const unsigned id)
     {
         const unsigned short current_productivity = CalcProductivity();
         // Sum over all last productivities and current (as start value)
-        productivity = std::accumulate(last_productivities.begin(), last_productivities.end(), current_productivity);
+        const unsigned short productivitySum =
+          std::accumulate(last_productivities.begin(), last_productivities.end(), current_productivity);
         // Produktivität "verrücken"
         for(unsigned short i = last_productivities.size() - 1; i >= 1; --i)
             last_productivities[i] = last_productivities[i - 1];
         last_productivities[0] = current_productivity;
 
         // Durschnitt ausrechnen der letzten Produktivitäten PLUS der aktuellen!
-        productivity /= (last_productivities.size() + 1);
+        SetProductivity(static_cast<unsigned short>(productivitySum / (last_productivities.size() + 1)));
 
         // Event für nächste Abrechnung
         productivity_ev = GetEvMgr().AddEvent(this, 400, 1);
@@ -530,7 +531,7 @@ void nobUsual::OnOutOfResources()
     if(outOfRessourcesMsgSent)
         return;
     outOfRessourcesMsgSent = true;
-    productivity = 0;
+    SetProductivity(0);
     std::fill(last_productivities.begin(), last_productivities.end(), 0);
 
     const char* error;
@@ -571,6 +572,12 @@ void nobUsual::StopNotWorking()
     }
 }
 
+void nobUsual::SetProductivity(unsigned short newProductivity)
+{
+    gwg->GetPlayer(player).ChangeBuildingProductivity(bldType_, static_cast<int>(newProductivity) - static_cast<int>(productivity));
+    productivity = newProductivity;
+}
+
 unsigned short nobUsual::CalcProductivity()
 {
     if(outOfRessourcesMsgSent)
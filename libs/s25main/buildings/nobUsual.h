@@ -145,6 +145,8 @@ public:
 private:
     /// Calculates the productivity and resets the counter
     unsigned short CalcProductivity();
+    /// Sets the productivity and updates the sums of the owner
+    void SetProductivity(unsigned short newProductivity);
 };
 
 #endif
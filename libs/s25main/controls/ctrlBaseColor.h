@@ -24,10 +24,20 @@ class ctrlBaseColor
 public:
     ctrlBaseColor() : color_(0) {}
     ctrlBaseColor(unsigned color) : color_(color) {}
-    void SetColor(unsigned color) { color_ = color; }
+    virtual ~ctrlBaseColor() = default;
+    void SetColor(unsigned color)
+    {
+        if(color_ == color)
+            return;
+        color_ = color;
+        OnContentChanged();
+    }
     unsigned GetColor() const { return color_; }
 
 protected:
+    /// Called when the shown content was changed
+    virtual void OnContentChanged() = 0;
+
     unsigned color_;
 };
 
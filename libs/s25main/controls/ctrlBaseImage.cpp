@@ -22,9 +22,27 @@
 
 ctrlBaseImage::ctrlBaseImage(ITexture* img /*= nullptr*/) : img_(img), modulationColor_(COLOR_WHITE) {}
 
+void ctrlBaseImage::SetImage(ITexture* image)
+{
+    if(img_ == image)
+        return;
+    img_ = image;
+    OnContentChanged();
+}
+
+void ctrlBaseImage::SetModulationColor(unsigned modulationColor)
+{
+    if(modulationColor_ == modulationColor)
+        return;
+    modulationColor_ = modulationColor;
+    OnContentChanged();
+}
+
 void ctrlBaseImage::SwapImage(ctrlBaseImage& other)
 {
     std::swap(img_, other.img_);
+    OnContentChanged();
+    other.OnContentChanged();
 }
 
 Rect ctrlBaseImage::GetImageRect() const
@@ -30,11 +30,12 @@ class ctrlBaseImage
 {
 public:
     ctrlBaseImage(ITexture* img = nullptr);
+    virtual ~ctrlBaseImage() = default;
 
-    void SetImage(ITexture* image) { img_ = image; }
+    void SetImage(ITexture* image);
     const ITexture* GetImage() const { return img_; }
     /// Changes the color filter used for drawing
-    void SetModulationColor(unsigned modulationColor) { modulationColor_ = modulationColor; }
+    void SetModulationColor(unsigned modulationColor);
     unsigned GetModulationColor() const { return modulationColor_; }
 
     /// Swap the images of those controls
@@ -43,6 +44,10 @@ public:
     void DrawImage(const DrawPoint& pos) const;
     void DrawImage(const DrawPoint& pos, unsigned color) const;
 
+protected:
+    /// Called when the shown content was changed
+    virtual void OnContentChanged() = 0;
+
 private:
     ITexture* img_;
     unsigned modulationColor_;
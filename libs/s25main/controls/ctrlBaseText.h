@@ -29,15 +29,19 @@ class ctrlBaseText
 {
 public:
     ctrlBaseText(std::string text, unsigned color, const glFont* font);
+    virtual ~ctrlBaseText() = default;
 
     void SetText(const std::string& text);
     const std::string& GetText() const { return text; }
     void SetFont(glFont* font);
     const glFont* GetFont() const { return font; }
-    void SetTextColor(unsigned color) { color_ = color; }
+    void SetTextColor(unsigned color);
     unsigned GetTextColor() const { return color_; }
 
 protected:
+    /// Called when the shown content was changed
+    virtual void OnContentChanged() = 0;
+
     std::string text;
     unsigned color_;
     const glFont* font;
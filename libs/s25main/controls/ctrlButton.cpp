@@ -32,6 +32,7 @@ void ctrlButton::SetEnabled(bool enable /*= true*/)
 {
     isEnabled = enable;
     state = BUTTON_UP;
+    Invalidate();
 }
 
 void ctrlButton::SetActive(bool activate)
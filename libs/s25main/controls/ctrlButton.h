@@ -37,14 +37,30 @@ public:
     void SetEnabled(bool enable = true);
     bool GetEnabled() const { return isEnabled; }
     TextureColor GetTexture() const { return tc; }
-    void SetTexture(TextureColor tc) { this->tc = tc; }
+    void SetTexture(TextureColor tc)
+    {
+        this->tc = tc;
+        Invalidate();
+    }
     void SetActive(bool activate = true) override;
 
-    void SetChecked(bool checked) { this->isChecked = checked; }
+    void SetChecked(bool checked)
+    {
+        this->isChecked = checked;
+        Invalidate();
+    }
     bool GetCheck() { return isChecked; }
-    void SetIlluminated(bool illuminated) { this->isIlluminated = illuminated; }
+    void SetIlluminated(bool illuminated)
+    {
+        this->isIlluminated = illuminated;
+        Invalidate();
+    }
     bool GetIlluminated() { return isIlluminated; }
-    void SetBorder(bool hasBorder) { this->hasBorder = hasBorder; }
+    void SetBorder(bool hasBorder)
+    {
+        this->hasBorder = hasBorder;
+        Invalidate();
+    }
 
     bool Msg_MouseMove(const MouseCoords& mc) override;
     bool Msg_LeftDown(const MouseCoords& mc) override;
@@ -38,7 +38,11 @@ public:
     void AddMessage(const std::string& time_string, const std::string& player, unsigned player_color, const std::string& msg,
                     unsigned msg_color);
     /// Setzt Farbe der Zeitangaben.
-    void SetTimeColor(unsigned color) { time_color = color; }
+    void SetTimeColor(unsigned color)
+    {
+        time_color = color;
+        Invalidate();
+    }
 
     bool Msg_MouseMove(const MouseCoords& mc) override;
     bool Msg_LeftDown(const MouseCoords& mc) override;
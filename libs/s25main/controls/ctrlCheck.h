@@ -29,9 +29,17 @@ public:
     ctrlCheck(Window* parent, unsigned id, const DrawPoint& pos, const Extent& size, TextureColor tc, std::string text, const glFont* font,
               bool readonly);
 
-    void SetCheck(bool check) { this->check = check; }
+    void SetCheck(bool check)
+    {
+        this->check = check;
+        Invalidate();
+    }
     bool GetCheck() const { return check; }
-    void SetReadOnly(bool readonly) { this->readonly = readonly; }
+    void SetReadOnly(bool readonly)
+    {
+        this->readonly = readonly;
+        Invalidate();
+    }
     bool GetReadOnly() const { return readonly; }
 
     bool Msg_LeftDown(const MouseCoords& mc) override;
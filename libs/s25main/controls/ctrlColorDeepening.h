@@ -30,6 +30,7 @@ public:
     ctrlColorDeepening(Window* parent, unsigned id, DrawPoint pos, const Extent& size, TextureColor tc, unsigned fillColor);
 
 protected:
+    void OnContentChanged() override { Invalidate(); }
     void DrawContent() const override;
 };
 
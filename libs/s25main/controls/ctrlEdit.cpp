@@ -72,6 +72,7 @@ void ctrlEdit::SetFocus(bool focus)
     {
         focus_ = focus;
         txtCtrl->SetTextColor(focus_ ? 0xFFFFA000 : COLOR_YELLOW);
+        Invalidate();
     }
 }
 
@@ -126,6 +127,8 @@ void ctrlEdit::UpdateInternalText()
             cursorOffsetX_ = 0;
         txtCtrl->SetText(curText);
     }
+    // Cursor position might have changed
+    Invalidate();
 }
 
 inline void ctrlEdit::CursorLeft()
@@ -38,7 +38,11 @@ public:
     std::string GetText() const;
     void SetFocus(bool focus = true);
     bool HasFocus() const { return focus_; }
-    void SetDisabled(bool disabled = true) { this->isDisabled_ = disabled; }
+    void SetDisabled(bool disabled = true)
+    {
+        this->isDisabled_ = disabled;
+        Invalidate();
+    }
     void SetNotify(bool notify = true) { this->notify_ = notify; }
     void SetNumberOnly(const bool activated) { this->numberOnly_ = activated; }
 
@@ -49,6 +53,8 @@ public:
 
 protected:
     void Draw_() override;
+    /// The cursor blinks while the control has the focus
+    bool IsContentVolatile() const override { return focus_ && !isDisabled_; }
 
 private:
     void AddChar(char32_t c);
@@ -35,6 +35,7 @@ public:
     bool Msg_MouseMove(const MouseCoords& mc) override;
 
 protected:
+    void OnContentChanged() override { Invalidate(); }
     void Draw_() override;
 };
 
@@ -31,6 +31,7 @@ public:
                     const std::string& tooltip);
 
 protected:
+    void OnContentChanged() override { Invalidate(); }
     void DrawContent() const override;
 };
 
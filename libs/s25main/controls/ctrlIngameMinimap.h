@@ -46,6 +46,10 @@ public:
     void ToggleTerritory();
     void ToggleHouses();
     void ToggleRoads();
+
+protected:
+    /// Shows the changing world and the current view
+    bool IsContentVolatile() const override { return true; }
 };
 
 #endif
@@ -42,6 +42,7 @@ void ctrlList::SetSelection(int selection)
     if(selection != selection_ && selection < static_cast<int>(lines.size()))
     {
         selection_ = selection;
+        Invalidate();
         if(selection >= 0 && GetParent())
             GetParent()->Msg_ListSelectItem(GetID(), selection);
     }
@@ -186,6 +187,7 @@ void ctrlList::AddString(const std::string& text)
     lines.push_back(text);
 
     GetCtrl<ctrlScrollBar>(0)->SetRange(static_cast<unsigned short>(lines.size()));
+    Invalidate();
 }
 
 /**
@@ -194,6 +196,7 @@ void ctrlList::AddString(const std::string& text)
 void ctrlList::SetString(const std::string& text, const unsigned id)
 {
     lines[id] = text;
+    Invalidate();
 }
 
 /**
@@ -203,6 +206,7 @@ void ctrlList::DeleteAllItems()
 {
     lines.clear();
     selection_ = -1;
+    Invalidate();
 }
 
 /**
@@ -259,6 +263,7 @@ void ctrlList::Swap(unsigned short first, unsigned short second)
 
     // Strings vertauschen
     std::swap(lines[first], lines[second]);
+    Invalidate();
 }
 
 /**
@@ -282,6 +287,7 @@ void ctrlList::Remove(const unsigned short index)
             else
                 SetSelection(index - 1); // or previous if item at end deleted
         }
+        Invalidate();
     }
 }
 
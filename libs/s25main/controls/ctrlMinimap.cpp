@@ -83,6 +83,7 @@ void ctrlMinimap::SetMapSize(const Extent& newMapSize)
         else
             drawnMapSize.y = static_cast<unsigned>(mapSize.y * x_scale);
     }
+    Invalidate();
 }
 
 DrawPoint ctrlMinimap::CalcMapCoord(MapPoint pt) const
@@ -137,6 +137,7 @@ void ctrlMultiline::RecalcWrappedLines()
     if(!scrollbarAllowed_ && drawLines.size() > maxNumVisibleLines)
         drawLines.resize(maxNumVisibleLines);
     GetCtrl<ctrlScrollBar>(0)->SetRange(drawLines.size());
+    Invalidate();
 }
 
 void ctrlMultiline::SetScrollBarAllowed(bool allowed)
@@ -28,11 +28,17 @@ public:
     ctrlPercent(Window* parent, unsigned id, const DrawPoint& pos, const Extent& size, TextureColor tc, unsigned text_color,
                 const glFont* font, const unsigned short* percentage);
 
-    void SetPercentage(const unsigned short* percentage) { this->percentage_ = percentage; }
+    void SetPercentage(const unsigned short* percentage)
+    {
+        this->percentage_ = percentage;
+        Invalidate();
+    }
 
 protected:
     /// Zeichenmethode.
     void Draw_() override;
+    /// The referenced percentage can change at any time
+    bool IsContentVolatile() const override { return true; }
 
 private:
     TextureColor tc;
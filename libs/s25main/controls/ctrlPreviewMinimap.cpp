@@ -17,6 +17,7 @@
 
 #include "rttrDefines.h" // IWYU pragma: keep
 #include "ctrlPreviewMinimap.h"
+#include "MapFileCache.h"
 #include "ogl/glArchivItem_Map.h"
 #include "libsiedler2/ArchivItem_Map_Header.h"
 
@@ -67,25 +68,32 @@ void ctrlPreviewMinimap::SetMap(const glArchivItem_Map* const s2map)
         return;
     }
 
-    unsigned short map_width = s2map->getHeader().getWidth();
-    unsigned short map_height = s2map->getHeader().getHeight();
-    SetMapSize(Extent(map_width, map_height));
+    SetMapSize(Extent(s2map->getHeader().getWidth(), s2map->getHeader().getHeight()));
     minimap.SetMap(*s2map);
+    SetStartPositions(PreviewMinimap::FindStartPositions(*s2map));
+}
+
+void ctrlPreviewMinimap::SetThumbnail(const MapThumbnail* const thumbnail)
+{
+    for(auto& player : players)
+        player.pos = MapPoint::Invalid();
+    if(!thumbnail)
+    {
+        SetMapSize(Extent::all(0));
+        return;
+    }
 
-    // Startpositionen merken
-    for(unsigned short y = 0; y < map_height; ++y)
+    SetMapSize(Extent(thumbnail->size.x, thumbnail->size.y));
+    minimap.SetPixels(thumbnail->size, thumbnail->pixels);
+    SetStartPositions(thumbnail->startPositions);
+}
+
+void ctrlPreviewMinimap::SetStartPositions(const std::array<MapPoint, MAX_PLAYERS>& startPositions)
+{
+    for(unsigned player = 0; player < MAX_PLAYERS; ++player)
     {
-        for(unsigned short x = 0; x < map_width; ++x)
-        {
-            // Startposition eines Spielers an dieser Stelle?
-            if(s2map->GetMapDataAt(MAP_TYPE, x, y) != 0x80)
-                continue;
-            unsigned player = s2map->GetMapDataAt(MAP_LANDSCAPE, x, y);
-            if(player < MAX_PLAYERS)
-            {
-                players[player].pos = MapPoint(x, y);
-                players[player].color = PLAYER_COLORS[player % PLAYER_COLORS.size()];
-            }
-        }
+        players[player].pos = startPositions[player];
+        if(players[player].pos.isValid())
+            players[player].color = PLAYER_COLORS[player % PLAYER_COLORS.size()];
     }
 }
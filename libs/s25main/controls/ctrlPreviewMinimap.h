@@ -23,6 +23,7 @@
 #include "gameData/MaxPlayers.h"
 #include <array>
 class Window;
+struct MapThumbnail;
 
 /// Übersichtskarte (MapPreview)
 class ctrlPreviewMinimap : public ctrlMinimap
@@ -40,6 +41,8 @@ class ctrlPreviewMinimap : public ctrlMinimap
     };
     std::array<Player, MAX_PLAYERS> players;
 
+    void SetStartPositions(const std::array<MapPoint, MAX_PLAYERS>& startPositions);
+
 public:
     ctrlPreviewMinimap(Window* parent, unsigned id, const DrawPoint& pos, const Extent& size, glArchivItem_Map* s2map);
 
@@ -48,9 +51,15 @@ public:
     Rect GetBoundaryRect() const override;
 
     /// Setzt die (Start-)Farbe eines Spielers bzw. löscht diesen (color = 0)
-    void SetPlayerColor(unsigned id, unsigned color) { players[id].color = color; }
+    void SetPlayerColor(unsigned id, unsigned color)
+    {
+        players[id].color = color;
+        Invalidate();
+    }
 
     void SetMap(const glArchivItem_Map* s2map);
+    /// Show a minimap previously rendered from a map instead of the map itself
+    void SetThumbnail(const MapThumbnail* thumbnail);
 };
 
 #endif // !MapPreview_H_
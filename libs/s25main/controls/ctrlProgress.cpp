@@ -59,6 +59,7 @@ ctrlProgress::ctrlProgress(Window* parent, const unsigned id, const DrawPoint& p
 void ctrlProgress::SetPosition(unsigned short position)
 {
     this->position = std::min(position, maximum);
+    Invalidate();
 }
 
 /**
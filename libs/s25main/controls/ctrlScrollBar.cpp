@@ -230,6 +230,7 @@ void ctrlScrollBar::UpdateSliderFromPos()
         sliderPos = scroll_height - sliderHeight;
     else
         sliderPos = (scroll_height * scroll_pos) / scroll_range;
+    Invalidate();
 }
 
 /**
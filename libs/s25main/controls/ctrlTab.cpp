@@ -87,6 +87,7 @@ void ctrlTab::DeleteAllTabs()
 
     tab_selection = 0;
     tab_count = 0;
+    Invalidate();
 }
 /**
  *  aktiviert eine bestimmte Tabseite.
@@ -111,6 +112,7 @@ void ctrlTab::SetSelection(unsigned short nr, bool /*notify*/)
 
     // Umwählen
     tab_selection = nr;
+    Invalidate();
 
     // Farbe des neuen Buttons ändern
     button = GetCtrl<ctrlButton>(tab_selection);
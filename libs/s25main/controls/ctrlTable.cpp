@@ -24,6 +24,7 @@
 #include "driver/MouseCoords.h"
 #include "ogl/glFont.h"
 #include "s25util/StringConversion.h"
+#include <algorithm>
 #include <cmath>
 #include <numeric>
 #include <sstream>
@@ -199,6 +200,7 @@ void ctrlTable::SetSelection(int selection)
         else if(selection_ >= scrollbar->GetScrollPos() + scrollbar->GetPageSize())
             scrollbar->SetScrollPos(selection_ - scrollbar->GetPageSize() + 1);
     }
+    Invalidate();
 
     if(GetParent())
         GetParent()->Msg_TableSelectItem(GetID(), selection_);
@@ -215,6 +217,7 @@ void ctrlTable::AddRow(std::vector<std::string> row)
 
     rows_.emplace_back(Row{std::move(row)});
     GetCtrl<ctrlScrollBar>(0)->SetRange(static_cast<unsigned short>(rows_.size()));
+    Invalidate();
 }
 
 void ctrlTable::RemoveRow(unsigned rowIdx)
@@ -228,6 +231,19 @@ void ctrlTable::RemoveRow(unsigned rowIdx)
     SetSelection(selection_);
 }
 
+unsigned short ctrlTable::GetFirstVisibleRow() const
+{
+    return GetCtrl<ctrlScrollBar>(0)->GetScrollPos();
+}
+
+unsigned short ctrlTable::GetNumVisibleRows() const
+{
+    const unsigned short firstRow = GetFirstVisibleRow();
+    if(firstRow >= rows_.size())
+        return 0;
+    return std::min<unsigned short>(line_count, rows_.size() - firstRow);
+}
+
 /**
  *  liefert den Wert eines Feldes.
  *
@@ -297,6 +313,7 @@ void ctrlTable::SortRows(int column, const bool* direction)
             }
         }
     } while(!done);
+    Invalidate();
 }
 
 /**
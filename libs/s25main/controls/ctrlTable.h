@@ -70,6 +70,10 @@ public:
     unsigned short GetNumRows() const { return static_cast<unsigned short>(rows_.size()); }
     unsigned short GetNumColumns() const { return static_cast<unsigned short>(columns_.size()); }
     int GetSelection() const { return selection_; }
+    /// Index of the first row shown (scroll position)
+    unsigned short GetFirstVisibleRow() const;
+    /// Number of rows shown starting at the first visible one
+    unsigned short GetNumVisibleRows() const;
     void SetSelection(int selection);
 
     bool Msg_LeftDown(const MouseCoords& mc) override;
@@ -25,12 +25,26 @@ ctrlBaseText::ctrlBaseText(std::string text, const unsigned color, const glFont*
 
 void ctrlBaseText::SetText(const std::string& text)
 {
+    if(this->text == text)
+        return;
     this->text = text;
+    OnContentChanged();
 }
 
 void ctrlBaseText::SetFont(glFont* font)
 {
+    if(this->font == font)
+        return;
     this->font = font;
+    OnContentChanged();
+}
+
+void ctrlBaseText::SetTextColor(unsigned color)
+{
+    if(color_ == color)
+        return;
+    color_ = color;
+    OnContentChanged();
 }
 
 ctrlText::ctrlText(Window* parent, unsigned id, const DrawPoint& pos, const std::string& text, unsigned color, FontStyle format,
@@ -34,6 +34,7 @@ public:
     Rect GetBoundaryRect() const override;
 
 protected:
+    void OnContentChanged() override { Invalidate(); }
     void Draw_() override;
 
 protected:
@@ -31,6 +31,7 @@ public:
                    const glFont* font, const std::string& tooltip);
 
 protected:
+    void OnContentChanged() override { Invalidate(); }
     /// Draw actual content (text here)
     void DrawContent() const override;
 };
@@ -35,6 +35,7 @@ public:
     Rect GetBoundaryRect() const override;
 
 protected:
+    void OnContentChanged() override { Invalidate(); }
     void DrawContent() const override;
 
 private:
@@ -65,6 +65,8 @@ void ctrlTimer::Msg_PaintBefore()
     if(VIDEODRIVER.GetTickCount() - timer > timeout_)
     {
         GetParent()->Msg_Timer(GetID());
+        // Timer handlers usually update the shown values
+        GetParent()->Invalidate();
 
         if(timer != 0)
         {
@@ -33,6 +33,9 @@ public:
                      const glFont* font, unsigned color, unsigned count, va_list fmtArgs);
 
 protected:
+    void OnContentChanged() override { Invalidate(); }
+    /// The referenced vars can change at any time
+    bool IsContentVolatile() const override { return true; }
     void DrawContent() const override;
 };
 
@@ -38,6 +38,9 @@ public:
     Rect GetBoundaryRect() const override;
 
 protected:
+    void OnContentChanged() override { Invalidate(); }
+    /// The referenced vars can change at any time
+    bool IsContentVolatile() const override { return true; }
     void Draw_() override;
 
     FontStyle format_;
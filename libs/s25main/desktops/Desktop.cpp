@@ -68,6 +68,12 @@ void Desktop::Draw_()
     Window::Draw_();
 }
 
+bool Desktop::IsContentVolatile() const
+{
+    // The fps display is updated while drawing
+    return GetCtrl<ctrlText>(fpsDisplayId) && VIDEODRIVER.GetFPS() != lastFPS_;
+}
+
 /**
  *  Reagiert auf Spielfenstergrößenänderung
  */
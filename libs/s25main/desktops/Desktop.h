@@ -42,6 +42,7 @@ public:
 
 protected:
     void Draw_() override;
+    bool IsContentVolatile() const override;
 
     glArchivItem_Bitmap* background;
 
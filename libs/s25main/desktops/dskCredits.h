@@ -35,6 +35,8 @@ public:
 
     bool Msg_KeyDown(const KeyEvent& ke) override;
     void Draw_() override;
+    /// Animated credits
+    bool IsContentVolatile() const override { return true; }
     void Msg_ButtonClick(unsigned ctrl_id) override;
     void SetActive(bool active) override;
     bool Close();
@@ -24,6 +24,8 @@
 #include "GamePlayer.h"
 #include "Loader.h"
 #include "NWFInfo.h"
+#include "Profiler.h"
+#include "RttrConfig.h"
 #include "Settings.h"
 #include "SoundManager.h"
 #include "WindowManager.h"
@@ -38,6 +40,7 @@
 #include "controls/ctrlText.h"
 #include "driver/MouseCoords.h"
 #include "drivers/VideoDriverWrapper.h"
+#include "files.h"
 #include "helpers/format.hpp"
 #include "helpers/strUtils.h"
 #include "helpers/toString.h"
@@ -47,9 +50,11 @@
 #include "ingameWindows/iwBuildingSite.h"
 #include "ingameWindows/iwChat.h"
 #include "ingameWindows/iwEndgame.h"
+#include "ingameWindows/iwEventDebug.h"
 #include "ingameWindows/iwHQ.h"
 #include "ingameWindows/iwHarborBuilding.h"
 #include "ingameWindows/iwInventory.h"
+#include "ingameWindows/iwLuaDebug.h"
 #include "ingameWindows/iwMainMenu.h"
 #include "ingameWindows/iwMapDebug.h"
 #include "ingameWindows/iwMilitaryBuilding.h"
@@ -72,6 +77,7 @@
 #include "ogl/SoundEffectItem.h"
 #include "ogl/glArchivItem_Bitmap_Player.h"
 #include "ogl/glFont.h"
+#include "ogl/glSpriteAtlas.h"
 #include "pathfinding/FindPathForRoad.h"
 #include "postSystem/PostBox.h"
 #include "postSystem/PostMsg.h"
@@ -86,7 +92,9 @@
 #include "gameData/TerrainDesc.h"
 #include "gameData/const_gui_ids.h"
 #include "liblobby/LobbyClient.h"
+#include "s25util/MyTime.h"
 #include <algorithm>
+#include <chrono>
 #include <cstdio>
 #include <utility>
 
@@ -296,6 +304,59 @@ void dskGameInterface::Msg_PaintBefore()
     imgButtonBar.DrawFull(DrawPoint((screenSize.x - imgButtonBar.getWidth()) / 2, screenSize.y - imgButtonBar.getHeight()));
 }
 
+void dskGameInterface::ToggleProfiler()
+{
+    if(!Profiler::isEnabled())
+    {
+        Profiler::clear();
+        Profiler::setEnabled(true);
+        return;
+    }
+    Profiler::setEnabled(false);
+    const bfs::path filePath =
+      bfs::path(RTTRCONFIG.ExpandPath(FILE_PATHS[47])) / (s25util::Time::FormatTime("profile_%Y-%m-%d_%H-%i-%s") + ".json");
+    if(Profiler::writeChromeTrace(filePath))
+        messenger.AddMessage("", 0, CD_SYSTEM, helpers::format(_("Profiling data written to %1%"), filePath.string()), COLOR_ORANGE);
+    else
+        messenger.AddMessage("", 0, CD_SYSTEM, helpers::format(_("Could not write profiling data to %1%"), filePath.string()), COLOR_RED);
+}
+
+void dskGameInterface::DrawProfilerOverlay() const
+{
+    using milliseconds = std::chrono::duration<float, std::milli>;
+    // Number of samples shown per zone and height of the histograms (pixels per ms and maximum)
+    constexpr unsigned numSamples = 120;
+    constexpr float pxPerMs = 2.f;
+    constexpr unsigned maxBarHeight = 40;
+
+    DrawPoint curPos(30, 1 + 3 * NormalFont->getHeight());
+    for(unsigned i = 0; i < Profiler::NUM_ZONES; i++)
+    {
+        const auto zone = static_cast<ProfilingZone>(i);
+        const std::vector<Profiler::duration> durations = Profiler::getRecentDurations(zone, numSamples);
+        Profiler::duration total(0), maxDuration(0);
+        for(const Profiler::duration& curDuration : durations)
+        {
+            total += curDuration;
+            maxDuration = std::max(maxDuration, curDuration);
+        }
+        const float avgMs = durations.empty() ? 0.f : milliseconds(total).count() / durations.size();
+        const float maxMs = milliseconds(maxDuration).count();
+        NormalFont->Draw(curPos, helpers::format("%1%: %2$.2f ms (max %3$.2f ms)", Profiler::getName(zone), avgMs, maxMs), FontStyle{},
+                         COLOR_YELLOW);
+        curPos.y += NormalFont->getHeight() + maxBarHeight;
+        DrawRectangle(Rect(curPos - DrawPoint(0, maxBarHeight), Extent(numSamples * 2, maxBarHeight)), COLOR_SHADOW);
+        DrawPoint barPos = curPos;
+        for(const Profiler::duration& curDuration : durations)
+        {
+            const auto height = std::min(static_cast<unsigned>(milliseconds(curDuration).count() * pxPerMs) + 1u, maxBarHeight);
+            DrawRectangle(Rect(barPos - DrawPoint(0, height), Extent(2, height)), height == maxBarHeight ? COLOR_RED : COLOR_GREEN);
+            barPos.x += 2;
+        }
+        curPos.y += 4;
+    }
+}
+
 void dskGameInterface::Msg_PaintAfter()
 {
     Desktop::Msg_PaintAfter();
@@ -330,6 +391,21 @@ void dskGameInterface::Msg_PaintAfter()
 
     NormalFont->Draw(DrawPoint(30, 1), nwf_string.data(), FontStyle{}, COLOR_YELLOW);
 
+    if(SETTINGS.global.debugMode)
+    {
+        const glSpriteAtlas& spriteAtlas = LOADER.GetSpriteAtlas();
+        const glSpriteAtlas::Stats& stats = spriteAtlas.getStats();
+        const uint64_t numDraws = stats.numHits + stats.numMisses;
+        const std::string atlasInfo =
+          helpers::format("Sprite atlas: %1% pages (%2% MiB) / Hit rate: %3%%% / Evictions: %4%", spriteAtlas.getNumPages(),
+                          spriteAtlas.getMemoryUsage() / (1024 * 1024), numDraws ? stats.numHits * 100 / numDraws : 100,
+                          stats.numEvictions);
+        NormalFont->Draw(DrawPoint(30, 1 + NormalFont->getHeight()), atlasInfo, FontStyle{}, COLOR_YELLOW);
+    }
+
+    if(Profiler::isEnabled())
+        DrawProfilerOverlay();
+
     // Replaydateianzeige in der linken unteren Ecke
     if(GAMECLIENT.IsReplayModeOn())
         NormalFont->Draw(DrawPoint(0, VIDEODRIVER.GetRenderSize().y), GAMECLIENT.GetReplayFileName(), FontStyle::BOTTOM, COLOR_YELLOW);
@@ -685,6 +761,9 @@ bool dskGameInterface::Msg_KeyDown(const KeyEvent& ke)
         case KT_F3: // Map debug window/ Multiplayer coordinates
             WINDOWMANAGER.ToggleWindow(std::make_unique<iwMapDebug>(gwv, game_->world_.IsSinglePlayer() || GAMECLIENT.IsReplayModeOn()));
             return true;
+        case KT_F7: // Frame profiler
+            ToggleProfiler();
+            return true;
         case KT_F8: // Tastaturbelegung
             WINDOWMANAGER.ToggleWindow(std::make_unique<iwTextfile>("keyboardlayout.txt", _("Keyboard layout")));
             return true;
@@ -1037,6 +1116,10 @@ void dskGameInterface::OnChatCommand(const std::string& cmd)
         GAMECLIENT.CheatArmageddon();
     else if(cmd == "surrender")
         GAMECLIENT.Surrender();
+    else if(cmd == "eventdebug")
+        WINDOWMANAGER.ToggleWindow(std::make_unique<iwEventDebug>(const_cast<GameWorld&>(game_->world_).GetEvMgr()));
+    else if(cmd == "luadebug" && game_->world_.HasLua())
+        WINDOWMANAGER.ToggleWindow(std::make_unique<iwLuaDebug>(game_->world_.GetLua()));
     else if(cmd == "async")
         (void)RANDOM.Rand(__FILE__, __LINE__, 0, 255);
     else if(cmd == "segfault")
@@ -120,9 +120,15 @@ private:
 
     /// Updatet das Post-Icon mit der Nachrichtenanzahl und der Taube
     void UpdatePostIcon(unsigned postmessages_count, bool showPigeon);
+    /// Start recording timings or stop it and write them to a trace file
+    void ToggleProfiler();
+    /// Draw recent timings of the profiling zones as histograms
+    void DrawProfilerOverlay() const;
 
     void Msg_ButtonClick(unsigned ctrl_id) override;
     void Msg_PaintBefore() override;
+    /// The game world is drawn below the controls each frame
+    bool IsContentVolatile() const override { return true; }
     void Msg_PaintAfter() override;
     bool Msg_LeftDown(const MouseCoords& mc) override;
     bool Msg_LeftUp(const MouseCoords& mc) override;
@@ -19,6 +19,7 @@
 #include "dskSelectMap.h"
 #include "ListDir.h"
 #include "Loader.h"
+#include "MapFileCache.h"
 #include "RttrConfig.h"
 #include "RttrLobbyClient.hpp"
 #include "WindowManager.h"
@@ -43,14 +44,9 @@
 #include "mapGenerator/MapGenerator.h"
 #include "network/GameClient.h"
 #include "ogl/FontStyle.h"
-#include "ogl/glArchivItem_Map.h"
 #include "gameData/MapConsts.h"
 #include "gameData/WorldDescription.h"
 #include "liblobby/LobbyClient.h"
-#include "libsiedler2/ArchivItem_Map_Header.h"
-#include "libsiedler2/ErrorCodes.h"
-#include "libsiedler2/prototypen.h"
-#include "s25util/ucString.h"
 #include <boost/filesystem/operations.hpp>
 #include <utility>
 //#include <boost/thread.hpp>
@@ -63,7 +59,9 @@
  *  @param[in] pass Server-Passwort
  */
 dskSelectMap::dskSelectMap(CreateServerInfo csi)
-    : Desktop(LOADER.GetImageN("setup015", 0)), csi(std::move(csi)), mapGenThread(nullptr), waitWnd(nullptr)
+    : Desktop(LOADER.GetImageN("setup015", 0)), csi(std::move(csi)), mapGenThread(nullptr), waitWnd(nullptr),
+      mapFileCache(std::make_unique<MapFileCache>(bfs::path(RTTRCONFIG.ExpandPath(FILE_PATHS[101])) / "maps")),
+      isScanning(false), prefetchedFirstRow(-1)
 {
     WorldDescription desc;
     GameDataLoader gdLoader(desc);
@@ -160,22 +158,64 @@ void dskSelectMap::Msg_OptionGroupChange(const unsigned /*ctrl_id*/, unsigned se
     static const std::array<unsigned, 9> ids = {{39, 40, 41, 42, 43, 52, 91, 93, 48}};
 
     const std::string mapPath = RTTRCONFIG.ExpandPath(FILE_PATHS[ids[selection]]);
-    FillTable(ListDir(mapPath, "swd"));
-    FillTable(ListDir(mapPath, "wld"));
+    std::vector<std::string> files = ListDir(mapPath, "swd");
+    files = ListDir(mapPath, "wld", false, &files);
     // For own maps (WORLDS folder) also use the one in the installation folder as S2 does
     if(bfs::path(mapPath).filename() == "WORLDS")
     {
         const std::string worldsPath = RTTRCONFIG.ExpandPath("WORLDS");
-        FillTable(ListDir(worldsPath, "swd"));
-        FillTable(ListDir(worldsPath, "wld"));
+        files = ListDir(worldsPath, "swd", false, &files);
+        files = ListDir(worldsPath, "wld", false, &files);
     }
 
-    // Dann noch sortieren
-    bool sortAsc = true;
-    table->SortRows(0, &sortAsc);
+    // The rows are added as the maps are read, see UpdateMapTable
+    mapFileCache->Scan(std::move(files));
+    isScanning = true;
+    prefetchedFirstRow = -1;
+}
+
+void dskSelectMap::UpdateMapTable()
+{
+    auto* table = GetCtrl<ctrlTable>(1);
+    // Check first, so all infos are available when the scan is done
+    const bool scanDone = !mapFileCache->IsScanning();
+    FillTable(mapFileCache->GetScannedInfos());
+
+    if(isScanning && scanDone)
+    {
+        isScanning = false;
+        std::string selectedPath = table->GetItemText(std::max(0, table->GetSelection()), 5);
+        if(!mapPathToSelect.empty())
+        {
+            selectedPath = mapPathToSelect;
+            mapPathToSelect.clear();
+        }
+
+        // Dann noch sortieren
+        bool sortAsc = true;
+        table->SortRows(0, &sortAsc);
+
+        // und Auswahl wiederherstellen bzw. setzen
+        int newSelection = 0;
+        for(int i = 0; i < table->GetNumRows(); i++)
+        {
+            if(table->GetItemText(i, 5) == selectedPath)
+            {
+                newSelection = i;
+                break;
+            }
+        }
+        table->SetSelection(newSelection);
+    } else if(isScanning && table->GetSelection() < 0 && table->GetNumRows() > 0)
+        table->SetSelection(0);
 
-    // und Auswahl zurücksetzen
-    table->SetSelection(0);
+    // Load the previews of the visible maps once all are listed, as the order may still change before
+    if(!isScanning && table->GetFirstVisibleRow() != prefetchedFirstRow)
+    {
+        prefetchedFirstRow = table->GetFirstVisibleRow();
+        for(unsigned i = 0; i < table->GetNumVisibleRows(); i++)
+            mapFileCache->PrefetchPreview(table->GetItemText(prefetchedFirstRow + i, 5));
+    }
 }
 
 /**
@@ -192,33 +232,46 @@ void dskSelectMap::Msg_TableSelectItem(const unsigned ctrl_id, const int selecti
     ctrlText& txtMapName = *GetCtrl<ctrlText>(12);
     ctrlText& txtMapPath = *GetCtrl<ctrlText>(13);
     ctrlButton& btContinue = *GetCtrl<ctrlButton>(5);
-    preview.SetMap(nullptr);
+    preview.SetThumbnail(nullptr);
     txtMapName.SetText("");
     txtMapPath.SetText("");
     btContinue.SetEnabled(false);
 
-    // is the selection valid?
-    if(!path.empty())
+    // Show the map once its preview is loaded
+    previewPath = path;
+    UpdatePreview();
+}
+
+void dskSelectMap::UpdatePreview()
+{
+    if(previewPath.empty())
+        return;
+    const MapPreview mapPreview = mapFileCache->RequestPreview(previewPath);
+    if(mapPreview.IsLoading())
+        return;
+    const std::string path = previewPath;
+    previewPath.clear();
+
+    if(!mapPreview.thumbnail)
     {
-        libsiedler2::Archiv ai;
-        // load map data
-        int ec = libsiedler2::loader::LoadMAP(path, ai);
-        if(ec || !dynamic_cast<glArchivItem_Map*>(ai[0]))
-            MarkMapAsBroken(selection, libsiedler2::getErrorString(ec));
-        else
-        {
-            const glArchivItem_Map* map = static_cast<glArchivItem_Map*>(ai[0]);
-            if(map->getHeader().getWidth() > MAX_MAP_SIZE || map->getHeader().getHeight() > MAX_MAP_SIZE)
-                MarkMapAsBroken(selection, "Map is bigger than allowed size of " + std::to_string(MAX_MAP_SIZE) + " nodes");
-            else
-            {
-                preview.SetMap(map);
-                txtMapName.SetText(cvStringToUTF8(map->getHeader().getName()));
-                txtMapPath.SetText(path);
-                btContinue.SetEnabled(true);
-            }
-        }
+        MarkMapAsBroken(path, mapPreview.error);
+        return;
+    }
+    const MapThumbnail& thumbnail = *mapPreview.thumbnail;
+    if(thumbnail.size.x > MAX_MAP_SIZE || thumbnail.size.y > MAX_MAP_SIZE)
+    {
+        MarkMapAsBroken(path, "Map is bigger than allowed size of " + std::to_string(MAX_MAP_SIZE) + " nodes");
+        return;
     }
+
+    ctrlPreviewMinimap& preview = *GetCtrl<ctrlPreviewMinimap>(11);
+    ctrlText& txtMapName = *GetCtrl<ctrlText>(12);
+    ctrlText& txtMapPath = *GetCtrl<ctrlText>(13);
+    preview.SetThumbnail(&thumbnail);
+    txtMapName.SetText(mapPreview.info.name);
+    txtMapPath.SetText(path);
+    GetCtrl<ctrlButton>(5)->SetEnabled(true);
+
     DrawPoint txtPos = txtMapName.GetPos();
     txtPos.x = preview.GetPos().x + preview.GetSize().x + 10;
     txtMapName.SetPos(txtPos);
@@ -307,22 +360,14 @@ void dskSelectMap::OnMapCreated(const std::string& mapPath)
         waitWnd->Close();
         waitWnd = nullptr;
     }
+    // The file might have changed without changing its size or modification time
+    mapFileCache->Invalidate(mapPath);
     // select the "played maps" entry
     auto* optionGroup = GetCtrl<ctrlOptionGroup>(10);
     optionGroup->SetSelection(8, true);
 
-    // search for the random map entry and select it in the table
-    auto* table = GetCtrl<ctrlTable>(1);
-    for(int i = 0; i < table->GetNumRows(); i++)
-    {
-        std::string entryPath = table->GetItemText(i, 5);
-
-        if(entryPath == mapPath)
-        {
-            table->SetSelection(i);
-            break;
-        }
-    }
+    // select the random map entry in the table once it was read
+    mapPathToSelect = mapPath;
 }
 
 /// Startet das Spiel mit einer bestimmten Auswahl in der Tabelle
@@ -395,8 +440,10 @@ void dskSelectMap::LC_Status_Error(const std::string& error)
     WINDOWMANAGER.Show(std::make_unique<iwMsgbox>(_("Error"), error, this, MSB_OK, MSB_EXCLAMATIONRED, 0));
 }
 
-void dskSelectMap::Draw_()
+void dskSelectMap::Msg_PaintBefore()
 {
+    Desktop::Msg_PaintBefore();
+    // Called every frame even if the desktop is drawn from its cached image, so background work can finish without any input
     if(!newRandMapPath.empty())
     {
         // mapGenThread->join();
@@ -410,49 +457,45 @@ void dskSelectMap::Draw_()
             OnMapCreated(newRandMapPath);
         newRandMapPath.clear();
     }
-    Desktop::Draw_();
+    UpdateMapTable();
+    UpdatePreview();
 }
 
-void dskSelectMap::FillTable(const std::vector<std::string>& files)
+void dskSelectMap::FillTable(const std::vector<MapFileInfo>& infos)
 {
     auto* table = GetCtrl<ctrlTable>(1);
 
-    for(const std::string& filePath : files)
+    for(const MapFileInfo& info : infos)
     {
-        if(helpers::contains(brokenMapPaths, filePath))
+        if(helpers::contains(brokenMapPaths, info.filePath))
             continue;
-        // Karteninformationen laden
-        libsiedler2::Archiv map;
-        if(libsiedler2::loader::LoadMAP(filePath, map, true) != 0)
+        if(info.numPlayers > MAX_PLAYERS)
             continue;
 
-        const libsiedler2::ArchivItem_Map_Header& header = checkedCast<const glArchivItem_Map*>(map[0])->getHeader();
-
-        if(header.getNumPlayers() > MAX_PLAYERS)
-            continue;
-
-        const bfs::path luaFilepath = bfs::path(filePath).replace_extension("lua");
-        const bool hasLua = bfs::is_regular_file(luaFilepath);
-
         // Und Zeilen vorbereiten
-        std::string players = (boost::format(_("%d Player")) % static_cast<unsigned>(header.getNumPlayers())).str();
-        std::string size = helpers::toString(header.getWidth()) + "x" + helpers::toString(header.getHeight());
+        std::string players = (boost::format(_("%d Player")) % static_cast<unsigned>(info.numPlayers)).str();
+        std::string size = helpers::toString(info.width) + "x" + helpers::toString(info.height);
 
-        std::string name = cvStringToUTF8(header.getName());
-        if(hasLua)
+        std::string name = info.name;
+        if(info.hasLua)
             name += " (*)";
-        std::string author = cvStringToUTF8(header.getAuthor());
 
-        table->AddRow({name, author, players, landscapeNames[header.getGfxSet()], size, filePath});
+        table->AddRow({name, info.author, players, landscapeNames[info.gfxSet], size, info.filePath});
     }
 }
 
-void dskSelectMap::MarkMapAsBroken(const int tableIdx, const std::string& reason)
+void dskSelectMap::MarkMapAsBroken(const std::string& path, const std::string& reason)
 {
-    ctrlTable& table = *GetCtrl<ctrlTable>(1);
-    const std::string& path = table.GetItemText(tableIdx, 5);
     brokenMapPaths.emplace_back(path);
     std::string errorTxt = _("Could not load map:\n") + path + '\n' + reason;
     WINDOWMANAGER.Show(std::make_unique<iwMsgbox>(_("Error"), errorTxt, this, MSB_OK, MSB_EXCLAMATIONRED, 1));
-    table.RemoveRow(tableIdx);
+    ctrlTable& table = *GetCtrl<ctrlTable>(1);
+    for(int i = 0; i < table.GetNumRows(); i++)
+    {
+        if(table.GetItemText(i, 5) == path)
+        {
+            table.RemoveRow(i);
+            break;
+        }
+    }
 }
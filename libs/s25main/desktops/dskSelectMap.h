@@ -24,12 +24,15 @@
 #include "network/ClientInterface.h"
 #include "network/CreateServerInfo.h"
 #include "liblobby/LobbyInterface.h"
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace boost {
 class thread;
 }
+class MapFileCache;
+struct MapFileInfo;
 
 class dskSelectMap final : public Desktop, public ClientInterface, public LobbyInterface
 {
@@ -38,9 +41,13 @@ public:
     ~dskSelectMap() override;
 
 private:
-    void Draw_() override;
+    void Msg_PaintBefore() override;
 
-    void FillTable(const std::vector<std::string>& files);
+    void FillTable(const std::vector<MapFileInfo>& infos);
+    /// Add newly scanned maps to the table and load previews of the visible ones
+    void UpdateMapTable();
+    /// Show the preview of the selected map if it was loaded
+    void UpdatePreview();
 
     void Msg_OptionGroupChange(unsigned ctrl_id, unsigned selection) override;
     void Msg_ButtonClick(unsigned ctrl_id) override;
@@ -69,7 +76,7 @@ private:
     void CreateRandomMap();
 
     void OnMapCreated(const std::string& mapPath);
-    void MarkMapAsBroken(int tableIdx, const std::string& reason);
+    void MarkMapAsBroken(const std::string& path, const std::string& reason);
 
     CreateServerInfo csi;
     MapSettings rndMapSettings;
@@ -80,6 +87,16 @@ private:
     std::map<uint8_t, std::string> landscapeNames;
     /// Maps that we already know are broken
     std::vector<std::string> brokenMapPaths;
+    /// Reads the map infos and previews in the background
+    std::unique_ptr<MapFileCache> mapFileCache;
+    /// Are maps still being added to the table?
+    bool isScanning;
+    /// First visible row for which previews were requested, -1 for none
+    int prefetchedFirstRow;
+    /// Map whose preview should be shown once it is loaded
+    std::string previewPath;
+    /// Map to select once all maps are in the table
+    std::string mapPathToSelect;
 };
 
 #endif //! dskSELECTMAP_H_INCLUDED
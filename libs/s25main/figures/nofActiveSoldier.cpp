@@ -258,9 +258,7 @@ bool nofActiveSoldier::FindEnemiesNearby(unsigned char excludedOwner)
     enemy = nullptr;
 
     // Get all points in a radius of 2
-    std::vector<MapPoint> pts = gwg->GetPointsInRadiusWithCenter(pos, 2);
-
-    for(const auto& curPos : pts)
+    for(const MapPoint& curPos : gwg->PointsInRadius(pos, 2, true))
     {
         for(noBase* object : gwg->GetFigures(curPos))
         {
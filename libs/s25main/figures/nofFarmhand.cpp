@@ -92,6 +92,10 @@ void nofFarmhand::HandleDerivedEvent(const unsigned /*id*/)
             bool points_found = false;
             bool wait = false;
 
+            // Nothing to find -> Skip the search
+            if(!CanHaveWorkPointsInRadius(max_radius))
+                max_radius = 0;
+
             for(MapCoord tx = gwg->GetXA(pos, Direction::WEST), r = 1; r <= max_radius;
                 tx = gwg->GetXA(MapPoint(tx, pos.y), Direction::WEST), ++r)
             {
@@ -84,6 +84,8 @@ public:
     bool IsPointAvailable(MapPoint pt) const;
     /// Returns the quality of this working point or determines if the worker can work here at all
     virtual PointQuality GetPointQuality(MapPoint pt) const = 0;
+    /// Returns false if there is definitely no working point in the radius around the workplace, true if there might be one
+    virtual bool CanHaveWorkPointsInRadius(unsigned /*radius*/) const { return true; }
 };
 
 #endif
@@ -150,3 +150,9 @@ nofFarmhand::PointQuality nofFisher::GetPointQuality(const MapPoint pt) const
 
     return PQ_NOTPOSSIBLE;
 }
+
+bool nofFisher::CanHaveWorkPointsInRadius(unsigned radius) const
+{
+    // Fish is at the neighbours of the working points
+    return gwg->GetResourceSquares().HasAnyInRange(ResourceSquares::FISH, pos, radius + 1);
+}
@@ -42,6 +42,7 @@ private:
 
     /// Returns the quality of this working point or determines if the worker can work here at all
     PointQuality GetPointQuality(MapPoint pt) const override;
+    bool CanHaveWorkPointsInRadius(unsigned radius) const override;
 
 public:
     nofFisher(MapPoint pos, unsigned char player, nobUsual* workplace);
@@ -305,32 +305,23 @@ bool nofGeologist::IsNodeGood(const MapPoint pt) const
     return PathConditionHuman(*gwg).IsNodeOk(pt) && obj.GetGOT() != GOT_SIGN && obj.GetType() != NOP_FLAG && obj.GetType() != NOP_TREE;
 }
 
-namespace {
-struct GetMapPointWithRadius
-{
-    using result_type = std::pair<MapPoint, unsigned>;
-
-    result_type operator()(const MapPoint pt, unsigned r) { return std::make_pair(pt, r); }
-};
-} // namespace
-
 void nofGeologist::LookForNewNodes()
 {
-    std::vector<GetMapPointWithRadius::result_type> pts = gwg->GetPointsInRadius(flag->GetPos(), 15, GetMapPointWithRadius());
     unsigned curMaxRadius = 15;
     bool found = false;
-    for(const auto& it : pts)
+    const MapRadiusRange pts = gwg->PointsInRadius(flag->GetPos(), curMaxRadius);
+    for(auto it = pts.begin(); it != pts.end(); ++it)
     {
-        if(it.second > curMaxRadius)
+        if(it.GetRadius() > curMaxRadius)
             break;
-        if(IsValidTargetNode(it.first))
+        if(IsValidTargetNode(*it))
         {
-            available_nodes.push_back(it.first);
+            available_nodes.push_back(*it);
             if(!found)
             {
                 found = true;
                 // if we found a valid node, look only in other nodes within 2 more "circles"
-                curMaxRadius = std::min(10u, it.second + 2);
+                curMaxRadius = std::min(10u, it.GetRadius() + 2);
             }
         }
     }
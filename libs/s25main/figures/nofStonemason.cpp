@@ -87,3 +87,8 @@ nofFarmhand::PointQuality nofStonemason::GetPointQuality(const MapPoint pt) cons
     // An dieser Position muss es nur Stein geben
     return ((gwg->GetNO(pt)->GetType() == NOP_GRANITE) ? PQ_CLASS1 : PQ_NOTPOSSIBLE);
 }
+
+bool nofStonemason::CanHaveWorkPointsInRadius(unsigned radius) const
+{
+    return gwg->GetResourceSquares().HasAnyInRange(ResourceSquares::GRANITE, pos, radius);
+}
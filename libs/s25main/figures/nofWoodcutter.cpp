@@ -113,6 +113,11 @@ nofFarmhand::PointQuality nofWoodcutter::GetPointQuality(const MapPoint pt) cons
     return PQ_NOTPOSSIBLE;
 }
 
+bool nofWoodcutter::CanHaveWorkPointsInRadius(unsigned radius) const
+{
+    return gwg->GetResourceSquares().HasAnyInRange(ResourceSquares::TREES, pos, radius);
+}
+
 void nofWoodcutter::WorkAborted()
 {
     nofFarmhand::WorkAborted();
@@ -37,6 +37,7 @@ private:
 
     /// Returns the quality of this working point or determines if the worker can work here at all
     PointQuality GetPointQuality(MapPoint pt) const override;
+    bool CanHaveWorkPointsInRadius(unsigned radius) const override;
 
     /// wird aufgerufen, wenn die Arbeit abgebrochen wird (von nofBuildingWorker aufgerufen)
     void WorkAborted() override;
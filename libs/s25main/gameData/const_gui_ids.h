@@ -69,6 +69,8 @@ enum GUI_ID
     CGI_MAP_GENERATOR,
     CGI_VICTORY,
     CGI_OBSERVATION,
+    CGI_EVENT_DEBUG,
+    CGI_LUA_DEBUG,
     CGI_BUILDING, /// Building windows use this as the base ID and add a unique number for each building
     CGI_NEXT = CGI_BUILDING + MAX_MAP_SIZE * MAX_MAP_SIZE
 };
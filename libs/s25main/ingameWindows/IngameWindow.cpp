@@ -92,6 +92,12 @@ void IngameWindow::SetIwSize(const Extent& newSize)
     Window::Resize(wndSize);
 }
 
+Rect IngameWindow::GetBoundaryRect() const
+{
+    const Rect drawRect = GetDrawRect();
+    return Rect(drawRect.getOrigin() - borderSize, drawRect.getSize() + borderSize * 2u);
+}
+
 Extent IngameWindow::GetIwSize() const
 {
     return Extent(GetSize().x - contentOffset.x - contentOffsetEnd.x, iwHeight);
@@ -213,8 +219,7 @@ void IngameWindow::Draw_()
     //  This needs a change in GetDrawPos to add this offset and also change all control-add-calls but would be much cleaner (no more hard
     //  coded offsets and we could restyle the ingame windows easily)
     //
-    Rect drawRect = GetDrawRect();
-    Rect fullWndRect(drawRect.getOrigin() - borderSize, drawRect.getSize() + borderSize * 2u);
+    const Rect fullWndRect = GetBoundaryRect();
     // Top
     DrawRectangle(Rect(fullWndRect.getOrigin(), fullWndRect.getSize().x, borderSize.y), COLOR_BLACK);
     // Left
@@ -48,16 +48,26 @@ public:
     ~IngameWindow() override;
 
     /// setzt den Hintergrund.
-    void SetBackground(glArchivItem_Bitmap* background) { this->background = background; }
+    void SetBackground(glArchivItem_Bitmap* background)
+    {
+        this->background = background;
+        Invalidate();
+    }
     /// liefert den Hintergrund.
     glArchivItem_Bitmap* GetBackground() const { return background; }
 
     /// setzt den Fenstertitel.
-    void SetTitle(const std::string& title) { this->title_ = title; }
+    void SetTitle(const std::string& title)
+    {
+        this->title_ = title;
+        Invalidate();
+    }
     /// liefert den Fenstertitel.
     const std::string& GetTitle() const { return title_; }
 
     void Resize(const Extent& newSize) override;
+    /// Includes the border drawn around the window
+    Rect GetBoundaryRect() const override;
     /// Set the size of the (expanded) content area
     void SetIwSize(const Extent& newSize);
     /// Get the size of the (expanded) content area
@@ -0,0 +1,143 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "iwEventDebug.h"
+#include "EventManager.h"
+#include "EventStatistics.h"
+#include "Loader.h"
+#include "RttrConfig.h"
+#include "controls/ctrlCheck.h"
+#include "controls/ctrlTable.h"
+#include "controls/ctrlText.h"
+#include "files.h"
+#include "helpers/format.hpp"
+#include "helpers/toString.h"
+#include "ogl/FontStyle.h"
+#include "gameTypes/TextureColor.h"
+#include "gameData/const_gui_ids.h"
+#include "s25util/MyTime.h"
+#include "s25util/colors.h"
+
+namespace {
+enum
+{
+    ID_cbRecord,
+    ID_btWriteCSV,
+    ID_tblEvents,
+    ID_txtSuspicious,
+    ID_tblSuspicious,
+    ID_txtStatus,
+    ID_tmrUpdate
+};
+/// Number of event types shown
+constexpr unsigned NUM_TOP_ENTRIES = 20;
+
+std::string formatTime(EventStatistics::clock::duration time)
+{
+    return helpers::format("%.3f", std::chrono::duration<double, std::milli>(time).count());
+}
+} // namespace
+
+iwEventDebug::iwEventDebug(EventManager& em)
+    : IngameWindow(CGI_EVENT_DEBUG, IngameWindow::posLastOrCenter, Extent(500, 480), _("Event Debug"), LOADER.GetImageN("resource", 41)),
+      em(em)
+{
+    using SRT = ctrlTable::SortType;
+    AddCheckBox(ID_cbRecord, DrawPoint(15, 25), Extent(230, 20), TC_GREY, _("Record event statistics"), NormalFont)
+      ->SetCheck(em.GetStatistics() != nullptr);
+    AddTextButton(ID_btWriteCSV, DrawPoint(255, 25), Extent(230, 20), TC_GREY, _("Write CSV"), NormalFont);
+    AddTable(ID_tblEvents, DrawPoint(15, 55), Extent(470, 220), TC_GREY, NormalFont,
+             ctrlTable::Columns{{_("Object type"), 300, SRT::String},
+                                {_("Event"), 120, SRT::Number},
+                                {_("Count"), 160, SRT::Number},
+                                {_("Time (ms)"), 200, SRT::Number},
+                                {_("Max (ms)"), 200, SRT::Number}});
+    AddText(ID_txtSuspicious, DrawPoint(15, 285), _("Objects with events in almost every GF:"), COLOR_YELLOW, FontStyle::LEFT,
+            NormalFont);
+    AddTable(ID_tblSuspicious, DrawPoint(15, 305), Extent(470, 130), TC_GREY, NormalFont,
+             ctrlTable::Columns{{_("Object id"), 200, SRT::Number},
+                                {_("Object type"), 300, SRT::String},
+                                {_("GFs"), 120, SRT::Number},
+                                {_("Count"), 160, SRT::Number},
+                                {_("Time (ms)"), 200, SRT::Number}});
+    AddText(ID_txtStatus, DrawPoint(15, 445), "", COLOR_YELLOW, FontStyle::LEFT, NormalFont);
+    AddTimer(ID_tmrUpdate, 1000);
+    UpdateTables();
+}
+
+iwEventDebug::~iwEventDebug()
+{
+    // Accounting costs time so only do it while someone is looking
+    em.SetStatisticsEnabled(false);
+}
+
+void iwEventDebug::Msg_ButtonClick(const unsigned ctrl_id)
+{
+    if(ctrl_id != ID_btWriteCSV)
+        return;
+    auto* txtStatus = GetCtrl<ctrlText>(ID_txtStatus);
+    const EventStatistics* statistics = em.GetStatistics();
+    if(!statistics)
+    {
+        txtStatus->SetText(_("Nothing recorded"));
+        return;
+    }
+    const bfs::path filePath =
+      bfs::path(RTTRCONFIG.ExpandPath(FILE_PATHS[47])) / (s25util::Time::FormatTime("events_%Y-%m-%d_%H-%i-%s") + ".csv");
+    if(statistics->writeCSV(filePath))
+        txtStatus->SetText(helpers::format(_("Written to %1%"), filePath.filename().string()));
+    else
+        txtStatus->SetText(helpers::format(_("Could not write %1%"), filePath.string()));
+}
+
+void iwEventDebug::Msg_CheckboxChange(const unsigned ctrl_id, const bool checked)
+{
+    if(ctrl_id != ID_cbRecord)
+        return;
+    em.SetStatisticsEnabled(checked);
+    UpdateTables();
+}
+
+void iwEventDebug::Msg_Timer(const unsigned ctrl_id)
+{
+    if(ctrl_id == ID_tmrUpdate)
+        UpdateTables();
+}
+
+void iwEventDebug::UpdateTables()
+{
+    auto* tblEvents = GetCtrl<ctrlTable>(ID_tblEvents);
+    auto* tblSuspicious = GetCtrl<ctrlTable>(ID_tblSuspicious);
+    tblEvents->DeleteAllItems();
+    tblSuspicious->DeleteAllItems();
+    const EventStatistics* statistics = em.GetStatistics();
+    if(!statistics)
+        return;
+    for(const EventStatistics::Entry& entry : statistics->getTopEntries(NUM_TOP_ENTRIES))
+    {
+        tblEvents->AddRow({EventStatistics::getName(entry.got), helpers::toString(entry.eventId), helpers::toString(entry.count),
+                           formatTime(entry.time), formatTime(entry.maxTime)});
+    }
+    for(const EventStatistics::SuspiciousObject& obj : statistics->getSuspiciousObjects())
+    {
+        tblSuspicious->AddRow({helpers::toString(obj.objId), EventStatistics::getName(obj.got), helpers::toString(obj.numGFs),
+                               helpers::toString(obj.numEvents), formatTime(obj.time)});
+    }
+    GetCtrl<ctrlText>(ID_txtStatus)
+      ->SetText(helpers::format(_("%1% GFs recorded, last %2% GFs shown"), statistics->getNumGFs(), statistics->getWindowLength()));
+}
@@ -0,0 +1,41 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef iwEventDebug_h__
+#define iwEventDebug_h__
+
+#include "IngameWindow.h"
+
+class EventManager;
+
+/// Shows the most expensive events per object type and objects getting events (almost) every GF
+class iwEventDebug : public IngameWindow
+{
+public:
+    explicit iwEventDebug(EventManager& em);
+    ~iwEventDebug() override;
+
+private:
+    void Msg_ButtonClick(unsigned ctrl_id) override;
+    void Msg_CheckboxChange(unsigned ctrl_id, bool checked) override;
+    void Msg_Timer(unsigned ctrl_id) override;
+    void UpdateTables();
+
+    EventManager& em;
+};
+
+#endif // iwEventDebug_h__
@@ -0,0 +1,150 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "iwLuaDebug.h"
+#include "Loader.h"
+#include "controls/ctrlCheck.h"
+#include "controls/ctrlTable.h"
+#include "controls/ctrlText.h"
+#include "helpers/format.hpp"
+#include "helpers/toString.h"
+#include "lua/LuaInterfaceGameBase.h"
+#include "lua/LuaStatistics.h"
+#include "ogl/FontStyle.h"
+#include "gameTypes/TextureColor.h"
+#include "gameData/const_gui_ids.h"
+#include "s25util/colors.h"
+#include <vector>
+
+namespace {
+enum
+{
+    ID_cbRecord,
+    ID_btWriteLog,
+    ID_tblCallbacks,
+    ID_txtHistogram,
+    ID_tmrUpdate,
+    ID_txtBucket // Must be last
+};
+
+std::string formatTime(LuaStatistics::clock::duration time)
+{
+    return helpers::format("%.3f", std::chrono::duration<double, std::milli>(time).count());
+}
+} // namespace
+
+iwLuaDebug::iwLuaDebug(LuaInterfaceGameBase& lua)
+    : IngameWindow(CGI_LUA_DEBUG, IngameWindow::posLastOrCenter, Extent(500, 430), _("Lua Debug"), LOADER.GetImageN("resource", 41)),
+      lua(lua)
+{
+    using SRT = ctrlTable::SortType;
+    AddCheckBox(ID_cbRecord, DrawPoint(15, 25), Extent(230, 20), TC_GREY, _("Record lua statistics"), NormalFont)
+      ->SetCheck(lua.GetStatistics() != nullptr);
+    AddTextButton(ID_btWriteLog, DrawPoint(255, 25), Extent(230, 20), TC_GREY, _("Write to log"), NormalFont);
+    AddTable(ID_tblCallbacks, DrawPoint(15, 55), Extent(470, 200), TC_GREY, NormalFont,
+             ctrlTable::Columns{{_("Callback"), 300, SRT::String},
+                                {_("Count"), 120, SRT::Number},
+                                {_("Time (ms)"), 160, SRT::Number},
+                                {_("Max (ms)"), 160, SRT::Number},
+                                {_("Max instructions"), 200, SRT::Number}});
+    AddText(ID_txtHistogram, DrawPoint(15, 265), "", COLOR_YELLOW, FontStyle::LEFT, NormalFont);
+    for(unsigned i = 0; i < LuaStatistics::NUM_BUCKETS; i++)
+    {
+        AddText(ID_txtBucket + i, DrawPoint(25 + 230 * (i % 2), 285 + 20 * (i / 2)), "", COLOR_YELLOW, FontStyle::LEFT, NormalFont);
+    }
+    AddTimer(ID_tmrUpdate, 1000);
+    UpdateTable();
+}
+
+iwLuaDebug::~iwLuaDebug()
+{
+    // Accounting costs time so only do it while someone is looking
+    lua.SetStatisticsEnabled(false);
+}
+
+void iwLuaDebug::Msg_ButtonClick(const unsigned ctrl_id)
+{
+    if(ctrl_id != ID_btWriteLog)
+        return;
+    const LuaStatistics* statistics = lua.GetStatistics();
+    if(statistics)
+        statistics->writeToLog();
+}
+
+void iwLuaDebug::Msg_CheckboxChange(const unsigned ctrl_id, const bool checked)
+{
+    if(ctrl_id != ID_cbRecord)
+        return;
+    lua.SetStatisticsEnabled(checked);
+    UpdateTable();
+}
+
+void iwLuaDebug::Msg_TableSelectItem(const unsigned ctrl_id, const int selection)
+{
+    if(ctrl_id != ID_tblCallbacks)
+        return;
+    if(selection >= 0)
+        selectedCallback = GetCtrl<ctrlTable>(ID_tblCallbacks)->GetItemText(selection, 0);
+    UpdateHistogram();
+}
+
+void iwLuaDebug::Msg_Timer(const unsigned ctrl_id)
+{
+    if(ctrl_id == ID_tmrUpdate)
+        UpdateTable();
+}
+
+void iwLuaDebug::UpdateTable()
+{
+    auto* tblCallbacks = GetCtrl<ctrlTable>(ID_tblCallbacks);
+    tblCallbacks->DeleteAllItems();
+    const LuaStatistics* statistics = lua.GetStatistics();
+    if(statistics)
+    {
+        for(const LuaStatistics::Entry& entry : statistics->getEntries())
+        {
+            tblCallbacks->AddRow({entry.name, helpers::toString(entry.count), formatTime(entry.time), formatTime(entry.maxTime),
+                                  helpers::toString(entry.maxInstructions)});
+        }
+    }
+    UpdateHistogram();
+}
+
+void iwLuaDebug::UpdateHistogram()
+{
+    const LuaStatistics* statistics = lua.GetStatistics();
+    const LuaStatistics::Entry* selectedEntry = nullptr;
+    std::vector<LuaStatistics::Entry> entries;
+    if(statistics)
+        entries = statistics->getEntries();
+    for(const LuaStatistics::Entry& entry : entries)
+    {
+        if(entry.name == selectedCallback)
+            selectedEntry = &entry;
+    }
+    const std::string title =
+      selectedEntry ? helpers::format(_("Run times of %1%:"), selectedEntry->name) : _("Select a callback to show its run times");
+    GetCtrl<ctrlText>(ID_txtHistogram)->SetText(title);
+    for(unsigned i = 0; i < LuaStatistics::NUM_BUCKETS; i++)
+    {
+        std::string text;
+        if(selectedEntry)
+            text = helpers::format("%1%: %2%", LuaStatistics::getBucketName(i), selectedEntry->histogram[i]);
+        GetCtrl<ctrlText>(ID_txtBucket + i)->SetText(text);
+    }
+}
@@ -55,6 +55,8 @@ private:
 
     // Durchgereichte Methoden vom Window
     void Draw_() override;
+    /// Draws the statistic of the running game
+    bool IsContentVolatile() const override { return true; }
     void Msg_OptionGroupChange(unsigned ctrl_id, unsigned selection) override;
     void Msg_ButtonClick(unsigned ctrl_id) override;
 };
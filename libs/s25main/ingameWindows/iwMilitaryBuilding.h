@@ -41,6 +41,8 @@ public:
 
 private:
     void Draw_() override;
+    /// Shows the current soldiers and coins
+    bool IsContentVolatile() const override { return true; }
     void Msg_ButtonClick(unsigned ctrl_id) override;
 };
 
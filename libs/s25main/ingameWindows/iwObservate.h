@@ -51,6 +51,8 @@ public:
 
 private:
     void Draw_() override;
+    /// Shows the running game
+    bool IsContentVolatile() const override { return true; }
     void Msg_ButtonClick(unsigned ctrl_id) override;
     bool Msg_MouseMove(const MouseCoords& mc) override;
     bool Msg_RightDown(const MouseCoords& mc) override;
@@ -37,6 +37,8 @@ public:
 
 private:
     void Draw_() override;
+    /// Shows the current state of the ship
+    bool IsContentVolatile() const override { return true; }
     void Msg_ButtonClick(unsigned ctrl_id) override;
 
     void DrawCargo();
@@ -45,6 +45,8 @@ private:
 
     void Msg_ButtonClick(unsigned ctrl_id) override;
     void Draw_() override;
+    /// Draws the statistic of the running game
+    bool IsContentVolatile() const override { return true; }
     void Msg_OptionGroupChange(unsigned ctrl_id, unsigned selection) override;
     void DrawStatistic(StatisticType type);
     void DrawAxis();
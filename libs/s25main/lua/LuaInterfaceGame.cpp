@@ -19,6 +19,7 @@
 #include "LuaInterfaceGame.h"
 #include "EventManager.h"
 #include "Game.h"
+#include "SerializedGameData.h"
 #include "WindowManager.h"
 #include "ai/AIInterface.h"
 #include "ai/AIPlayer.h"
@@ -31,6 +32,14 @@
 #include "world/GameWorldGame.h"
 #include "gameTypes/Resource.h"
 #include "s25util/Serializer.h"
+#include <utility>
+
+namespace {
+/// Names of the event handlers in the order of their ids
+const std::array<const char*, 13> EVENT_HANDLER_NAMES = {{"onExplored", "onExploredBatch", "onOccupied", "onOccupiedBatch", "onStart",
+                                                          "onGameFrame", "onResourceFound", "onCancelPactRequest", "onSuggestPact",
+                                                          "onPactCanceled", "onPactCreated", "onSave", "onLoad"}};
+} // namespace
 
 LuaInterfaceGame::LuaInterfaceGame(const std::weak_ptr<Game>& gameInstance) : gw(gameInstance.lock()->world_), game(gameInstance)
 {
@@ -173,10 +182,49 @@ LuaInterfaceGame::LuaInterfaceGame(const std::weak_ptr<Game>& gameInstance) : gw
     LuaWorld::Register(lua);
 
     lua["rttr"] = this;
+
+    InitEventHandlers();
 }
 
 LuaInterfaceGame::~LuaInterfaceGame() = default;
 
+template<typename T, typename... Args>
+T LuaInterfaceGame::CallEventHandler(EventHandlerId id, Args&&... args)
+{
+    const CallbackScope scope(*this, EVENT_HANDLER_NAMES[id]);
+    // Use a copy as the handler might replace itself
+    kaguya::LuaRef handler = eventHandlers[id];
+    return handler.call<T>(std::forward<Args>(args)...);
+}
+
+void LuaInterfaceGame::InitEventHandlers()
+{
+    static_assert(EVENT_HANDLER_NAMES.size() == NUM_EVENT_HANDLERS, "Missing handler name");
+    kaguya::LuaTable handlerIds = lua.newTable();
+    for(unsigned i = 0; i < NUM_EVENT_HANDLERS; i++)
+        handlerIds[EVENT_HANDLER_NAMES[i]] = i;
+    // Handlers are never stored in the global table itself, so __newindex is called on every assignment.
+    // Note: This does not work anymore if the script replaces the metatable of _G
+    kaguya::LuaFunction setMetatable = lua.loadstring("local handlerIds, setHandler = ...\n"
+                                                      "local handlers = {}\n"
+                                                      "setmetatable(_G, {\n"
+                                                      "  __index = handlers,\n"
+                                                      "  __newindex = function(t, k, v)\n"
+                                                      "    local id = handlerIds[k]\n"
+                                                      "    if id == nil then\n"
+                                                      "      rawset(t, k, v)\n"
+                                                      "    else\n"
+                                                      "      handlers[k] = v\n"
+                                                      "      setHandler(id, v)\n"
+                                                      "    end\n"
+                                                      "  end\n"
+                                                      "})\n");
+    setMetatable.call<void>(handlerIds, kaguya::function([this](unsigned id, const kaguya::LuaRef& handler) {
+                                RTTR_Assert(id < NUM_EVENT_HANDLERS);
+                                eventHandlers[id] = (handler.type() == LUA_TFUNCTION) ? handler : kaguya::LuaRef();
+                            }));
+}
+
 KAGUYA_MEMBER_FUNCTION_OVERLOADS(SetMissionGoalWrapper, LuaInterfaceGame, SetMissionGoal, 1, 2)
 
 void LuaInterfaceGame::Register(kaguya::State& state)
@@ -207,11 +255,10 @@ void LuaInterfaceGame::Register(kaguya::State& state)
 
 bool LuaInterfaceGame::Serialize(Serializer& luaSaveState)
 {
-    kaguya::LuaRef save = lua["onSave"];
-    if(save.type() == LUA_TFUNCTION)
+    if(HasEventHandler(EH_SAVE))
     {
         ClearErrorOccured();
-        if(save.call<bool>(kaguya::standard::ref(luaSaveState)) && !HasErrorOccurred())
+        if(CallEventHandler<bool>(EH_SAVE, kaguya::standard::ref(luaSaveState)) && !HasErrorOccurred())
             return true;
         else
         {
@@ -224,15 +271,48 @@ bool LuaInterfaceGame::Serialize(Serializer& luaSaveState)
 
 bool LuaInterfaceGame::Deserialize(Serializer& luaSaveState)
 {
-    kaguya::LuaRef load = lua["onLoad"];
-    if(load.type() == LUA_TFUNCTION)
+    if(HasEventHandler(EH_LOAD))
     {
         ClearErrorOccured();
-        return load.call<bool>(kaguya::standard::ref(luaSaveState)) && !HasErrorOccurred();
+        return CallEventHandler<bool>(EH_LOAD, kaguya::standard::ref(luaSaveState)) && !HasErrorOccurred();
     } else
         return true;
 }
 
+void LuaInterfaceGame::SerializeEventBatches(SerializedGameData& sgd) const
+{
+    sgd.PushUnsignedInt(exploredEvents.size());
+    for(const ExploredEvent& event : exploredEvents)
+    {
+        sgd.PushUnsignedChar(event.player);
+        sgd.PushMapPoint(event.pt);
+        sgd.PushUnsignedChar(event.owner);
+    }
+    sgd.PushUnsignedInt(occupiedEvents.size());
+    for(const OccupiedEvent& event : occupiedEvents)
+    {
+        sgd.PushUnsignedChar(event.player);
+        sgd.PushMapPoint(event.pt);
+    }
+}
+
+void LuaInterfaceGame::DeserializeEventBatches(SerializedGameData& sgd)
+{
+    exploredEvents.resize(sgd.PopUnsignedInt());
+    for(ExploredEvent& event : exploredEvents)
+    {
+        event.player = sgd.PopUnsignedChar();
+        event.pt = sgd.PopMapPoint();
+        event.owner = sgd.PopUnsignedChar();
+    }
+    occupiedEvents.resize(sgd.PopUnsignedInt());
+    for(OccupiedEvent& event : occupiedEvents)
+    {
+        event.player = sgd.PopUnsignedChar();
+        event.pt = sgd.PopMapPoint();
+    }
+}
+
 void LuaInterfaceGame::ClearResources()
 {
     for(unsigned p = 0; p < gw.GetNumPlayers(); p++)
@@ -308,54 +388,97 @@ LuaWorld LuaInterfaceGame::GetWorld()
 
 void LuaInterfaceGame::EventExplored(unsigned player, const MapPoint pt, unsigned char owner)
 {
-    kaguya::LuaRef onExplored = lua["onExplored"];
-    if(onExplored.type() == LUA_TFUNCTION)
+    if(HasEventHandler(EH_EXPLORED_BATCH))
+        exploredEvents.push_back(ExploredEvent{player, pt, owner});
+    if(!HasEventHandler(EH_EXPLORED))
+        return;
+    if(owner == 0)
     {
-        if(owner == 0)
-        {
-            // No owner? Pass nil value to Lua.
-            onExplored.call<void>(player, pt.x, pt.y, kaguya::NilValue());
-        } else
-        {
-            // Adapt owner to be comparable with the player index
-            onExplored.call<void>(player, pt.x, pt.y, owner - 1);
-        }
+        // No owner? Pass nil value to Lua.
+        CallEventHandler(EH_EXPLORED, player, pt.x, pt.y, kaguya::NilValue());
+    } else
+    {
+        // Adapt owner to be comparable with the player index
+        CallEventHandler(EH_EXPLORED, player, pt.x, pt.y, owner - 1);
     }
 }
 
 void LuaInterfaceGame::EventOccupied(unsigned player, const MapPoint pt)
 {
-    kaguya::LuaRef onOccupied = lua["onOccupied"];
-    if(onOccupied.type() == LUA_TFUNCTION)
-        onOccupied.call<void>(player, pt.x, pt.y);
+    if(HasEventHandler(EH_OCCUPIED_BATCH))
+        occupiedEvents.push_back(OccupiedEvent{player, pt});
+    if(HasEventHandler(EH_OCCUPIED))
+        CallEventHandler(EH_OCCUPIED, player, pt.x, pt.y);
 }
 
 void LuaInterfaceGame::EventStart(bool isFirstStart)
 {
-    kaguya::LuaRef onStart = lua["onStart"];
-    if(onStart.type() == LUA_TFUNCTION)
-        onStart.call<void>(isFirstStart);
+    if(HasEventHandler(EH_START))
+        CallEventHandler(EH_START, isFirstStart);
 }
 
 void LuaInterfaceGame::EventGameFrame(unsigned nr)
 {
-    kaguya::LuaRef onGameFrame = lua["onGameFrame"];
-    if(onGameFrame.type() == LUA_TFUNCTION)
-        onGameFrame.call<void>(nr);
+    FlushEventBatches();
+    if(HasEventHandler(EH_GAMEFRAME))
+        CallEventHandler(EH_GAMEFRAME, nr);
+}
+
+void LuaInterfaceGame::FlushEventBatches()
+{
+    // Swap out first as the handlers might cause new events
+    if(!exploredEvents.empty())
+    {
+        std::vector<ExploredEvent> events;
+        events.swap(exploredEvents);
+        // Handler might have been removed since the events were collected
+        if(HasEventHandler(EH_EXPLORED_BATCH))
+        {
+            kaguya::LuaTable luaEvents = lua.newTable();
+            for(unsigned i = 0; i < events.size(); i++)
+            {
+                kaguya::LuaTable luaEvent = lua.newTable();
+                luaEvent["player"] = events[i].player;
+                luaEvent["x"] = events[i].pt.x;
+                luaEvent["y"] = events[i].pt.y;
+                // No owner is nil, else adapt owner to be comparable with the player index
+                if(events[i].owner != 0)
+                    luaEvent["owner"] = events[i].owner - 1;
+                luaEvents[i + 1] = luaEvent;
+            }
+            CallEventHandler(EH_EXPLORED_BATCH, luaEvents);
+        }
+    }
+    if(!occupiedEvents.empty())
+    {
+        std::vector<OccupiedEvent> events;
+        events.swap(occupiedEvents);
+        if(HasEventHandler(EH_OCCUPIED_BATCH))
+        {
+            kaguya::LuaTable luaEvents = lua.newTable();
+            for(unsigned i = 0; i < events.size(); i++)
+            {
+                kaguya::LuaTable luaEvent = lua.newTable();
+                luaEvent["player"] = events[i].player;
+                luaEvent["x"] = events[i].pt.x;
+                luaEvent["y"] = events[i].pt.y;
+                luaEvents[i + 1] = luaEvent;
+            }
+            CallEventHandler(EH_OCCUPIED_BATCH, luaEvents);
+        }
+    }
 }
 
 void LuaInterfaceGame::EventResourceFound(unsigned char player, const MapPoint pt, unsigned char type, unsigned char quantity)
 {
-    kaguya::LuaRef onResourceFound = lua["onResourceFound"];
-    if(onResourceFound.type() == LUA_TFUNCTION)
-        onResourceFound.call<void>(player, pt.x, pt.y, type, quantity);
+    if(HasEventHandler(EH_RESOURCE_FOUND))
+        CallEventHandler(EH_RESOURCE_FOUND, player, pt.x, pt.y, type, quantity);
 }
 
 bool LuaInterfaceGame::EventCancelPactRequest(PactType pt, unsigned char canceledByPlayerId, unsigned char targetPlayerId)
 {
-    kaguya::LuaRef onPactCancel = lua["onCancelPactRequest"];
-    if(onPactCancel.type() == LUA_TFUNCTION)
-        return onPactCancel.call<bool>(pt, canceledByPlayerId, targetPlayerId);
+    if(HasEventHandler(EH_CANCEL_PACT_REQUEST))
+        return CallEventHandler<bool>(EH_CANCEL_PACT_REQUEST, pt, canceledByPlayerId, targetPlayerId);
     return true; // always accept pact cancel if there is no handler
 }
 
@@ -366,36 +489,26 @@ void LuaInterfaceGame::EventSuggestPact(const PactType pt, unsigned char suggest
     if(!gameInst)
         return;
     AIPlayer* ai = gameInst->GetAIPlayer(targetPlayerId);
-    if(ai != nullptr)
+    if(ai != nullptr && HasEventHandler(EH_SUGGEST_PACT))
     {
-        kaguya::LuaRef onPactCancel = lua["onSuggestPact"];
-        if(onPactCancel.type() == LUA_TFUNCTION)
-        {
-            AIInterface& aii = ai->getAIInterface();
-            auto luaResult = onPactCancel.call<bool>(pt, suggestedByPlayerId, targetPlayerId, duration);
-            if(luaResult)
-                aii.AcceptPact(gw.GetEvMgr().GetCurrentGF(), pt, suggestedByPlayerId);
-            else
-                aii.CancelPact(pt, suggestedByPlayerId);
-        }
+        AIInterface& aii = ai->getAIInterface();
+        auto luaResult = CallEventHandler<bool>(EH_SUGGEST_PACT, pt, suggestedByPlayerId, targetPlayerId, duration);
+        if(luaResult)
+            aii.AcceptPact(gw.GetEvMgr().GetCurrentGF(), pt, suggestedByPlayerId);
+        else
+            aii.CancelPact(pt, suggestedByPlayerId);
     }
 }
 
 void LuaInterfaceGame::EventPactCanceled(const PactType pt, unsigned char canceledByPlayerId, unsigned char targetPlayerId)
 {
-    kaguya::LuaRef onPactCanceled = lua["onPactCanceled"];
-    if(onPactCanceled.type() == LUA_TFUNCTION)
-    {
-        onPactCanceled.call<void>(pt, canceledByPlayerId, targetPlayerId);
-    }
+    if(HasEventHandler(EH_PACT_CANCELED))
+        CallEventHandler(EH_PACT_CANCELED, pt, canceledByPlayerId, targetPlayerId);
 }
 
 void LuaInterfaceGame::EventPactCreated(const PactType pt, unsigned char suggestedByPlayerId, unsigned char targetPlayerId,
                                         const unsigned duration)
 {
-    kaguya::LuaRef onPactCreated = lua["onPactCreated"];
-    if(onPactCreated.type() == LUA_TFUNCTION)
-    {
-        onPactCreated.call<void>(pt, suggestedByPlayerId, targetPlayerId, duration);
-    }
+    if(HasEventHandler(EH_PACT_CREATED))
+        CallEventHandler(EH_PACT_CREATED, pt, suggestedByPlayerId, targetPlayerId, duration);
 }
@@ -21,13 +21,16 @@
 #include "LuaInterfaceGameBase.h"
 #include "gameTypes/MapCoordinates.h"
 #include "gameTypes/PactTypes.h"
+#include <array>
 #include <memory>
 #include <string>
+#include <vector>
 
 class GameWorldGame;
 class LuaPlayer;
 class LuaWorld;
 class Serializer;
+class SerializedGameData;
 class Game;
 
 class LuaInterfaceGame : public LuaInterfaceGameBase
@@ -40,6 +43,9 @@ public:
 
     bool Serialize(Serializer& luaSaveState);
     bool Deserialize(Serializer& luaSaveState);
+    /// Save/Load the events not yet delivered to the batch handlers
+    void SerializeEventBatches(SerializedGameData& sgd) const;
+    void DeserializeEventBatches(SerializedGameData& sgd);
 
     void EventExplored(unsigned player, MapPoint pt, unsigned char owner);
     void EventOccupied(unsigned player, MapPoint pt);
@@ -67,8 +73,53 @@ public:
     void PostMessageWithLocation(int playerIdx, const std::string& msg, int x, int y);
 
 private:
+    /// Event handlers the script can define
+    enum EventHandlerId
+    {
+        EH_EXPLORED,
+        EH_EXPLORED_BATCH,
+        EH_OCCUPIED,
+        EH_OCCUPIED_BATCH,
+        EH_START,
+        EH_GAMEFRAME,
+        EH_RESOURCE_FOUND,
+        EH_CANCEL_PACT_REQUEST,
+        EH_SUGGEST_PACT,
+        EH_PACT_CANCELED,
+        EH_PACT_CREATED,
+        EH_SAVE,
+        EH_LOAD,
+        NUM_EVENT_HANDLERS
+    };
+    struct ExploredEvent
+    {
+        unsigned player;
+        MapPoint pt;
+        unsigned char owner;
+    };
+    struct OccupiedEvent
+    {
+        unsigned player;
+        MapPoint pt;
+    };
+
     GameWorldGame& gw;
     std::weak_ptr<Game> game;
+    /// Handler functions by id or nil references if not defined.
+    /// Updated whenever the script assigns them, so they do not need to be looked up for every event
+    std::array<kaguya::LuaRef, NUM_EVENT_HANDLERS> eventHandlers;
+    /// Events for the batch handlers collected until the next game frame
+    std::vector<ExploredEvent> exploredEvents;
+    std::vector<OccupiedEvent> occupiedEvents;
+
+    /// Keep the event handlers out of the global table, so the script assigning them always updates eventHandlers
+    void InitEventHandlers();
+    bool HasEventHandler(EventHandlerId id) const { return !eventHandlers[id].isNilref(); }
+    /// Call the handler with the given id, accounting it as a callback
+    template<typename T = void, typename... Args>
+    T CallEventHandler(EventHandlerId id, Args&&... args);
+    /// Call the batch handlers with the events collected since the last call
+    void FlushEventBatches();
     LuaPlayer GetPlayer(int playerIdx);
     LuaWorld GetWorld();
 };
@@ -17,11 +17,21 @@
 
 #include "rttrDefines.h" // IWYU pragma: keep
 #include "LuaInterfaceGameBase.h"
+#include "LuaStatistics.h"
 #include "WindowManager.h"
 #include "ingameWindows/iwMsgbox.h"
 #include "mygettext/mygettext.h"
 #include "network/GameClient.h"
 #include "s25util/Log.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+/// Address used as the registry key for the interface owning a lua state
+const char HOOK_OWNER_KEY = 0;
+} // namespace
+
+constexpr unsigned LuaInterfaceGameBase::INSTRUCTION_HOOK_INTERVAL;
 
 unsigned LuaInterfaceGameBase::GetVersion()
 {
@@ -30,14 +40,19 @@ unsigned LuaInterfaceGameBase::GetVersion()
 
 unsigned LuaInterfaceGameBase::GetFeatureLevel()
 {
-    return 3;
+    return 5;
 }
 
-LuaInterfaceGameBase::LuaInterfaceGameBase()
+LuaInterfaceGameBase::LuaInterfaceGameBase() : instructionBudget(0), callbackDepth(0), numInstructions(0)
 {
     Register(lua);
+    lua_State* L = lua.state();
+    lua_pushlightuserdata(L, this);
+    lua_rawsetp(L, LUA_REGISTRYINDEX, &HOOK_OWNER_KEY);
 }
 
+LuaInterfaceGameBase::~LuaInterfaceGameBase() = default;
+
 void LuaInterfaceGameBase::Register(kaguya::State& state)
 {
     state["RTTRGameBase"].setClass(
@@ -45,6 +60,7 @@ void LuaInterfaceGameBase::Register(kaguya::State& state)
         .addStaticFunction("GetFeatureLevel", &LuaInterfaceGameBase::GetFeatureLevel)
         .addFunction("IsHost", &LuaInterfaceGameBase::IsHost)
         .addFunction("GetLocalPlayerIdx", &LuaInterfaceGameBase::GetLocalPlayerIdx)
+        .addFunction("SetInstructionBudget", &LuaInterfaceGameBase::SetInstructionBudget)
         .addOverloadedFunctions("MsgBox", &LuaInterfaceGameBase::MsgBox, &LuaInterfaceGameBase::MsgBox2)
         .addOverloadedFunctions("MsgBoxEx", &LuaInterfaceGameBase::MsgBoxEx, &LuaInterfaceGameBase::MsgBoxEx2));
 }
@@ -69,6 +85,57 @@ bool LuaInterfaceGameBase::CheckScriptVersion()
     }
 }
 
+void LuaInterfaceGameBase::SetStatisticsEnabled(bool enabled)
+{
+    if(!enabled)
+        statistics.reset();
+    else if(!statistics)
+        statistics = std::make_unique<LuaStatistics>();
+}
+
+void LuaInterfaceGameBase::SetInstructionBudget(unsigned maxInstructions)
+{
+    // Must fit into the error message
+    instructionBudget = std::min<unsigned>(maxInstructions, std::numeric_limits<int>::max());
+}
+
+void LuaInterfaceGameBase::InstructionHook(lua_State* L, lua_Debug* /*ar*/)
+{
+    lua_rawgetp(L, LUA_REGISTRYINDEX, &HOOK_OWNER_KEY);
+    auto* luaInterface = static_cast<LuaInterfaceGameBase*>(lua_touserdata(L, -1));
+    lua_pop(L, 1);
+    RTTR_Assert(luaInterface);
+    luaInterface->numInstructions += INSTRUCTION_HOOK_INTERVAL;
+    const unsigned budget = luaInterface->instructionBudget;
+    // Note: Only trivially destructible objects here as this does a longjmp
+    if(budget && luaInterface->numInstructions > budget)
+        luaL_error(L, "Callback exceeded the instruction budget of %d", static_cast<int>(budget));
+}
+
+LuaInterfaceGameBase::CallbackScope::CallbackScope(LuaInterfaceGameBase& luaInterface, const char* name)
+    : luaInterface_(luaInterface), name_(name)
+{
+    if(luaInterface_.callbackDepth++ > 0)
+        return;
+    luaInterface_.numInstructions = 0;
+    // The hook is only installed when required to not slow down the script otherwise.
+    // Setting it also resets the instruction counter of lua so counting is deterministic
+    if(luaInterface_.statistics || luaInterface_.instructionBudget)
+        lua_sethook(luaInterface_.lua.state(), InstructionHook, LUA_MASKCOUNT, INSTRUCTION_HOOK_INTERVAL);
+    if(luaInterface_.statistics)
+        startTime_ = LuaStatistics::clock::now();
+}
+
+LuaInterfaceGameBase::CallbackScope::~CallbackScope()
+{
+    if(--luaInterface_.callbackDepth > 0)
+        return;
+    lua_sethook(luaInterface_.lua.state(), nullptr, 0, 0);
+    // Statistics might have been enabled during the call
+    if(luaInterface_.statistics && startTime_ != LuaStatistics::clock::time_point())
+        luaInterface_.statistics->addCall(name_, LuaStatistics::clock::now() - startTime_, luaInterface_.numInstructions);
+}
+
 bool LuaInterfaceGameBase::IsHost() const
 {
     return GAMECLIENT.IsHost();
@@ -19,6 +19,10 @@
 #define LuaInterfaceGameBase_h__
 
 #include "lua/LuaInterfaceBase.h"
+#include <chrono>
+#include <memory>
+
+class LuaStatistics;
 
 class LuaInterfaceGameBase : public LuaInterfaceBase
 {
@@ -32,8 +36,38 @@ public:
     /// Get the feature level of this version. Reset on Version increase, increase for added features
     static unsigned GetFeatureLevel();
 
+    /// Enable or disable accounting of the time and instructions spent in the callbacks of the script
+    void SetStatisticsEnabled(bool enabled);
+    /// Return the statistics or nullptr if accounting is disabled
+    const LuaStatistics* GetStatistics() const { return statistics.get(); }
+    /// Limit the number of lua instructions a single callback may execute (0 = unlimited).
+    /// A callback exceeding it is aborted with an error. As it counts instructions (in steps of INSTRUCTION_HOOK_INTERVAL)
+    /// and not time, this happens at the same point on all clients.
+    void SetInstructionBudget(unsigned maxInstructions);
+    unsigned GetInstructionBudget() const { return instructionBudget; }
+
+    /// Granularity of the instruction counting
+    static constexpr unsigned INSTRUCTION_HOOK_INTERVAL = 1000;
+
 protected:
     LuaInterfaceGameBase();
+    ~LuaInterfaceGameBase() override;
+
+    /// Accounts a call from the engine into a lua callback during its lifetime and enforces the instruction budget.
+    /// Nested calls (callbacks triggered by the script) are accounted as part of the outermost one
+    class CallbackScope
+    {
+    public:
+        CallbackScope(LuaInterfaceGameBase& luaInterface, const char* name);
+        ~CallbackScope();
+        CallbackScope(const CallbackScope&) = delete;
+        CallbackScope& operator=(const CallbackScope&) = delete;
+
+    private:
+        LuaInterfaceGameBase& luaInterface_;
+        const char* name_;
+        std::chrono::steady_clock::time_point startTime_;
+    };
 
     /// Return true, if local player is the host
     bool IsHost() const;
@@ -46,6 +80,16 @@ protected:
     /// Shows a message with a custom icon. Image with iconIdx must exist in iconFile and iconFile must be loaded!
     void MsgBoxEx(const std::string& title, const std::string& msg, const std::string& iconFile, unsigned iconIdx);
     void MsgBoxEx2(const std::string& title, const std::string& msg, const std::string& iconFile, unsigned iconIdx, int iconX, int iconY);
+
+private:
+    static void InstructionHook(lua_State* L, lua_Debug* ar);
+
+    std::unique_ptr<LuaStatistics> statistics;
+    unsigned instructionBudget;
+    /// Number of active (nested) callback calls
+    unsigned callbackDepth;
+    /// Instructions executed by the current callback
+    unsigned numInstructions;
 };
 
 #endif // LuaInterfaceGameBase_h__
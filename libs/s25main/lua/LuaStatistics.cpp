@@ -0,0 +1,91 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "LuaStatistics.h"
+#include "helpers/format.hpp"
+#include "mygettext/mygettext.h"
+#include "s25util/Log.h"
+#include <algorithm>
+
+namespace {
+/// Upper limits of the run times of the buckets except the last one in microseconds
+const std::array<unsigned, LuaStatistics::NUM_BUCKETS - 1> BUCKET_LIMITS = {{100, 500, 1000, 2500, 5000, 10000, 25000}};
+
+double toMs(LuaStatistics::clock::duration time)
+{
+    return std::chrono::duration<double, std::milli>(time).count();
+}
+} // namespace
+
+constexpr unsigned LuaStatistics::NUM_BUCKETS;
+
+void LuaStatistics::addCall(const std::string& name, clock::duration time, unsigned instructions)
+{
+    auto it = entries_.find(name);
+    if(it == entries_.end())
+    {
+        Entry newEntry{name, 0, clock::duration::zero(), clock::duration::zero(), 0, 0, {}};
+        newEntry.histogram.fill(0);
+        it = entries_.emplace(name, newEntry).first;
+    }
+    Entry& entry = it->second;
+    entry.count++;
+    entry.time += time;
+    entry.maxTime = std::max(entry.maxTime, time);
+    entry.instructions += instructions;
+    entry.maxInstructions = std::max(entry.maxInstructions, instructions);
+    entry.histogram[getBucket(time)]++;
+}
+
+std::vector<LuaStatistics::Entry> LuaStatistics::getEntries() const
+{
+    std::vector<Entry> result;
+    result.reserve(entries_.size());
+    for(const auto& entry : entries_)
+        result.push_back(entry.second);
+    std::stable_sort(result.begin(), result.end(), [](const Entry& lhs, const Entry& rhs) { return lhs.time > rhs.time; });
+    return result;
+}
+
+void LuaStatistics::writeToLog() const
+{
+    for(const Entry& entry : getEntries())
+    {
+        LOG.write(_("Lua callback %1%: %2% calls, %3$.3f ms total, %4$.3f ms max, %5% instructions max\n")) % entry.name % entry.count
+          % toMs(entry.time) % toMs(entry.maxTime) % entry.maxInstructions;
+        for(unsigned i = 0; i < NUM_BUCKETS; i++)
+        {
+            if(entry.histogram[i])
+                LOG.write("  %1%: %2%\n") % getBucketName(i) % entry.histogram[i];
+        }
+    }
+}
+
+unsigned LuaStatistics::getBucket(clock::duration time)
+{
+    const auto us = std::chrono::duration_cast<std::chrono::microseconds>(time).count();
+    const auto it = std::upper_bound(BUCKET_LIMITS.begin(), BUCKET_LIMITS.end(), us);
+    return static_cast<unsigned>(it - BUCKET_LIMITS.begin());
+}
+
+std::string LuaStatistics::getBucketName(unsigned bucket)
+{
+    if(bucket < BUCKET_LIMITS.size())
+        return helpers::format("< %1% ms", BUCKET_LIMITS[bucket] / 1000.);
+    return helpers::format(">= %1% ms", BUCKET_LIMITS.back() / 1000.);
+}
@@ -0,0 +1,64 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef LuaStatistics_h__
+#define LuaStatistics_h__
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/// Accounts the calls from the engine into the lua callbacks of a script.
+/// Records number of calls, run time and executed instructions per callback and a histogram of the run times
+class LuaStatistics
+{
+public:
+    using clock = std::chrono::steady_clock;
+    static constexpr unsigned NUM_BUCKETS = 8;
+
+    struct Entry
+    {
+        std::string name;
+        unsigned count;
+        clock::duration time;
+        clock::duration maxTime;
+        uint64_t instructions;
+        unsigned maxInstructions;
+        /// Number of calls per run time bucket
+        std::array<unsigned, NUM_BUCKETS> histogram;
+    };
+
+    /// Account a call of the given callback
+    void addCall(const std::string& name, clock::duration time, unsigned instructions);
+    /// Return all entries sorted by time (descending)
+    std::vector<Entry> getEntries() const;
+    /// Write all entries including their histograms to the log
+    void writeToLog() const;
+
+    /// Return the bucket of the histogram the given run time belongs to
+    static unsigned getBucket(clock::duration time);
+    /// Return the description of the run times in the given bucket, e.g. "< 0.5 ms"
+    static std::string getBucketName(unsigned bucket);
+
+private:
+    std::map<std::string, Entry> entries_;
+};
+
+#endif // LuaStatistics_h__
@@ -0,0 +1,90 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "mapGenerator/HillRasterizer.h"
+#include "mapGenerator/Map.h"
+#include <algorithm>
+#include <cmath>
+
+HillRasterizer::HillRasterizer(Map& map) : map(map) {}
+
+const HillRasterizer::Profile& HillRasterizer::GetProfile(int z)
+{
+    if(static_cast<unsigned>(z) >= profiles.size())
+        profiles.resize(z + 1);
+    Profile& profile = profiles[z];
+    if(profile.empty())
+    {
+        profile.resize(2 * z + 1);
+        for(int dy = -z; dy <= z; dy++)
+        {
+            ProfileRow& row = profile[dy + z];
+            row.halfWidth = static_cast<int>(std::sqrt(static_cast<double>(z * z - dy * dy)));
+            // Correct rounding errors of the square root
+            while((row.halfWidth + 1) * (row.halfWidth + 1) + dy * dy <= z * z)
+                row.halfWidth++;
+            while(row.halfWidth * row.halfWidth + dy * dy > z * z)
+                row.halfWidth--;
+            row.heights.resize(2 * row.halfWidth + 1);
+            for(int dx = -row.halfWidth; dx <= row.halfWidth; dx++)
+            {
+                // Same calculation as with the vertex distance to get the same rounding
+                const double distance = std::sqrt(static_cast<double>(dx * dx + dy * dy));
+                row.heights[dx + row.halfWidth] = static_cast<unsigned char>(z - distance);
+            }
+        }
+    }
+    return profile;
+}
+
+void HillRasterizer::AddHill(const Position& center, int z)
+{
+    if(z < 0)
+        return;
+    const Profile& profile = GetProfile(z);
+    const int width = map.size.x;
+    const int height = map.size.y;
+    // Wrap the center to the map first so only small offsets need to be wrapped later
+    const int cx = ((center.x % width) + width) % width;
+    const int cy = ((center.y % height) + height) % height;
+
+    for(int dy = -z; dy <= z; dy++)
+    {
+        const ProfileRow& row = profile[dy + z];
+        const int y = (((cy + dy) % height) + height) % height;
+        unsigned char* rowHeights = &map.z[y * width];
+        const int xStart = cx - row.halfWidth;
+        if(xStart >= 0 && cx + row.halfWidth < width)
+        {
+            // Whole row inside the map -> No wrapping
+            unsigned char* curHeight = rowHeights + xStart;
+            for(unsigned char hillHeight : row.heights)
+            {
+                *curHeight = std::max(*curHeight, hillHeight);
+                ++curHeight;
+            }
+        } else
+        {
+            for(int i = 0; i < static_cast<int>(row.heights.size()); i++)
+            {
+                const int x = (((xStart + i) % width) + width) % width;
+                rowHeights[x] = std::max(rowHeights[x], row.heights[i]);
+            }
+        }
+    }
+}
@@ -0,0 +1,65 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HillRasterizer_h__
+#define HillRasterizer_h__
+
+#include "Point.h"
+#include <vector>
+
+struct Map;
+
+/**
+ * Rasterizes hills into the height values of a map. Each vertex gets the maximum of its current height
+ * and the heights of all hills covering it (max-envelope). The height profile of a hill only depends on
+ * its height, so it is computed once per height and then written row by row.
+ */
+class HillRasterizer
+{
+public:
+    /**
+     * Creates a rasterizer working on the height values of the specified map.
+     * @param map map to modify
+     */
+    explicit HillRasterizer(Map& map);
+
+    /**
+     * Adds a hill at the specified center with the specified height. A vertex in distance d gets
+     * the height z - d (rounded down) if d <= z.
+     * @param center center point of the hill (highest elevation)
+     * @param z maximum height (elevation) of the hill
+     */
+    void AddHill(const Position& center, int z);
+
+private:
+    /// Heights of one row of a hill profile from -halfWidth to +halfWidth
+    struct ProfileRow
+    {
+        int halfWidth;
+        std::vector<unsigned char> heights;
+    };
+    /// Height profile of a hill: Rows from -z to +z
+    using Profile = std::vector<ProfileRow>;
+
+    const Profile& GetProfile(int z);
+
+    Map& map;
+    /// Profiles by height (computed on first use)
+    std::vector<Profile> profiles;
+};
+
+#endif // HillRasterizer_h__
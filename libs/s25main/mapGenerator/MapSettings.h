@@ -32,7 +32,7 @@ struct MapSettings
 {
     MapSettings()
         : numPlayers(2), size(MapExtent::all(256)), ratioGold(9), ratioIron(36), ratioCoal(40), ratioGranite(15), minPlayerRadius(0.31),
-          maxPlayerRadius(0.51), type(0), style(MapStyle::Random)
+          maxPlayerRadius(0.51), type(0), style(MapStyle::Random), numThreads(0)
     {}
 
     void Validate();
@@ -88,6 +88,12 @@ struct MapSettings
      * Style of the map.
      */
     MapStyle style;
+
+    /**
+     * Maximum number of threads used for the map generation, 0 for automatic.
+     * The generated map does not depend on it.
+     */
+    unsigned numThreads;
 };
 
 #endif // MapSettings_h__
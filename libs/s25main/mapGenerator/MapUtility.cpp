@@ -20,69 +20,36 @@
 #include "rttrDefines.h" // IWYU pragma: keep
 #include "mapGenerator/MapUtility.h"
 #include "RandomConfig.h"
+#include "mapGenerator/HillRasterizer.h"
 #include "mapGenerator/Map.h"
 #include "mapGenerator/ObjectGenerator.h"
 #include "mapGenerator/VertexUtility.h"
+#include "world/FloodFill.h"
+#include "world/MapGeometry.h"
 #include "gameData/TerrainDesc.h"
 #include <libsiedler2/enumTypes.h>
 #include <algorithm>
 #include <cmath>
-#include <queue>
-#include <set>
 #include <vector>
 
 void MapUtility::SetHill(Map& map, const Position& center, int z)
 {
-    std::vector<int> neighbors = VertexUtility::GetNeighbors(center, map.size, z);
-    for(int& it : neighbors)
-    {
-        const Position neighbor = VertexUtility::GetPosition(it, map.size);
-        const double d = VertexUtility::Distance(center, neighbor, map.size);
-        map.z[it] = std::max((unsigned char)(z - d), (unsigned char)map.z[it]);
-    }
+    HillRasterizer(map).AddHill(center, z);
 }
 
 unsigned MapUtility::GetBodySize(Map& map, const Position& p, unsigned max)
 {
-    // compute index of the initial position
-    int index = VertexUtility::GetIndexOf(p, map.size);
+    const MapPoint start = MakeMapPoint(p, map.size);
 
     // figure out terrain type of the initial position
-    uint8_t type = map.textureRsu[index];
-
-    std::queue<Position> searchSpace;
-    std::set<int> body;
-
-    // put initial position to the search space
-    searchSpace.push(p);
-
-    // stop search if no further neighbors are available or
-    // the maximum the body size is reached
-    while(!searchSpace.empty() && body.size() < max)
-    {
-        // get and remove the last element from the queue
-        Position pos = searchSpace.front();
-        searchSpace.pop();
-
-        // compute the index of the current element
-        index = VertexUtility::GetIndexOf(pos, map.size);
-
-        // check if the element has the right terrain and is not yet
-        // part of the terrain body
-        if((map.textureRsu[index] == type || map.textureLsd[index] == type) && body.find(index) == body.end())
-        {
-            // add the current element to the body
-            body.insert(index);
-
-            // push neighbor elements to the search space
-            searchSpace.push(Position(pos.x + 1, pos.y));
-            searchSpace.push(Position(pos.x, pos.y + 1));
-            searchSpace.push(Position(pos.x - 1, pos.y));
-            searchSpace.push(Position(pos.x, pos.y - 1));
-        }
-    }
-
-    return body.size();
+    const uint8_t type = map.textureRsu[VertexUtility::GetIndexOf(p, map.size)];
+
+    return CountComponent(map.size, FloodFillNeighbors::Orthogonal, start,
+                          [&map, type](const MapPoint pt) {
+                              const int index = pt.y * map.size.x + pt.x;
+                              return map.textureRsu[index] == type || map.textureLsd[index] == type;
+                          },
+                          max);
 }
 
 void MapUtility::Smooth(Map& map)
@@ -206,7 +173,7 @@ void MapUtility::SetHarbour(Map& map, const Position& center, int waterLevel)
     }
 }
 
-void MapUtility::SetTree(Map& map, const Position& position)
+void MapUtility::SetTree(Map& map, const Position& position, TileRandom& rnd)
 {
     int index = VertexUtility::GetIndexOf(position, map.size);
 
@@ -215,13 +182,13 @@ void MapUtility::SetTree(Map& map, const Position& position)
        && !objGen.IsTexture(map, index, [](const auto& desc) { return desc.Is(ETerrain::Unreachable); }))
     {
         if(objGen.IsTexture(map, index, [](const auto& desc) { return desc.humidity < 90; }))
-            objGen.CreateRandomPalm(map, index);
+            objGen.CreateRandomPalm(map, index, rnd);
         else
-            objGen.CreateRandomTree(map, index);
+            objGen.CreateRandomTree(map, index, rnd);
     }
 }
 
-void MapUtility::SetStones(Map& map, const Position& center, double radius)
+void MapUtility::SetStones(Map& map, const Position& center, double radius, TileRandom& rnd)
 {
     int cx = center.x;
     int cy = center.y;
@@ -234,13 +201,13 @@ void MapUtility::SetStones(Map& map, const Position& center, double radius)
             Position p(x, y);
             if(VertexUtility::Distance(center, p, map.size) < radius)
             {
-                SetStone(map, p);
+                SetStone(map, p, rnd);
             }
         }
     }
 }
 
-void MapUtility::SetStone(Map& map, const Position& position)
+void MapUtility::SetStone(Map& map, const Position& position, TileRandom& rnd)
 {
     int index = VertexUtility::GetIndexOf(position, map.size);
 
@@ -248,7 +215,7 @@ void MapUtility::SetStone(Map& map, const Position& position)
        && !objGen.IsTexture(map, index, [](const auto& desc) { return desc.kind == TerrainKind::WATER; })
        && !objGen.IsTexture(map, index, [](const auto& desc) { return desc.Is(ETerrain::Unreachable); }))
     {
-        objGen.CreateRandomStone(map, index);
+        objGen.CreateRandomStone(map, index, rnd);
     }
 }
 
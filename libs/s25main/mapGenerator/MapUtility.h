@@ -64,8 +64,9 @@ public:
      * Places a tree to the specified position if possible.
      * @param map map to modify the terrain for
      * @param position position of the tree
+     * @param rnd random number generator to use
      */
-    void SetTree(Map& map, const Position& position);
+    void SetTree(Map& map, const Position& position, TileRandom& rnd);
 
     /**
      * Sets stone on the map around the specified center within the specified radius.
@@ -73,15 +74,17 @@ public:
      * @param map map to modify the terrain for
      * @param center center point for stone placement
      * @param radius radius around the center to place stone in
+     * @param rnd random number generator to use
      */
-    void SetStones(Map& map, const Position& center, double radius);
+    void SetStones(Map& map, const Position& center, double radius, TileRandom& rnd);
 
     /**
      * Places a stone to the specified position if possible.
      * @param map map to modify the terrain for
      * @param position position of the stone
+     * @param rnd random number generator to use
      */
-    void SetStone(Map& map, const Position& position);
+    void SetStone(Map& map, const Position& position, TileRandom& rnd);
 
     /**
      * Computes the size of a terrain body starting from the specified position.
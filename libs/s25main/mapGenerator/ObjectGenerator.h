@@ -86,23 +86,26 @@ public:
     /**
      * Creates a new duck.
      * @param likelihood likelihood for object generation in percent
+     * @param rnd random number generator of the current vertex
      * @return a new duck animal
      */
-    uint8_t CreateDuck(int likelihood);
+    uint8_t CreateDuck(int likelihood, TileRandom& rnd);
 
     /**
      * Creates a new sheep.
      * @param likelihood likelihood for object generation in percent
+     * @param rnd random number generator of the current vertex
      * @return a new sheep animal
      */
-    uint8_t CreateSheep(int likelihood);
+    uint8_t CreateSheep(int likelihood, TileRandom& rnd);
 
     /**
      * Creates a new, random animal to be placed inside of a forest.
      * @param likelihood likelihood for object generation in percent
+     * @param rnd random number generator of the current vertex
      * @return a new forest animal
      */
-    uint8_t CreateRandomForestAnimal(int likelihood);
+    uint8_t CreateRandomForestAnimal(int likelihood, TileRandom& rnd);
 
     /**
      * Creates a new random mountain resources (gold, coal, granite, iron).
@@ -110,16 +113,18 @@ public:
      * @param ratioIron ratio of iron placed as mountain resource on the map
      * @param ratioCoal ratio of coal placed as mountain resource on the map
      * @param ratioGranite ratio of granite placed as mountain resource on the map
+     * @param rnd random number generator of the current vertex
      * @return random piles of gold, coal, granite or iron
      */
-    uint8_t CreateRandomResource(unsigned ratioGold, unsigned ratioIron, unsigned ratioCoal, unsigned ratioGranite);
+    uint8_t CreateRandomResource(unsigned ratioGold, unsigned ratioIron, unsigned ratioCoal, unsigned ratioGranite, TileRandom& rnd);
 
     /**
      * Creates a new, random ground animal.
      * @param likelihood likelihood for object generation in percent
+     * @param rnd random number generator of the current vertex
      * @return a new ground animal
      */
-    uint8_t CreateRandomAnimal(int likelihood);
+    uint8_t CreateRandomAnimal(int likelihood, TileRandom& rnd);
 
     /**
      * Checks whether or not the specified object is a tree.
@@ -133,29 +138,33 @@ public:
      * Creates a new, random tree (excluding palm trees).
      * @param map map to place the object upon
      * @param index index of the vertex for the new object
+     * @param rnd random number generator of the current vertex
      */
-    void CreateRandomTree(Map& map, int index);
+    void CreateRandomTree(Map& map, int index, TileRandom& rnd);
 
     /**
      * Creates a new, random palm.
      * @param map map of the vertex to create a new tree on
      * @param index index of the vertex to create a new tree on
+     * @param rnd random number generator of the current vertex
      */
-    void CreateRandomPalm(Map& map, int index);
+    void CreateRandomPalm(Map& map, int index, TileRandom& rnd);
 
     /**
      * Creates a new, random tree (including palm trees).
      * @param map map of the vertex to create a new tree on
      * @param index index of the vertex to create a new tree on
+     * @param rnd random number generator of the current vertex
      */
-    void CreateRandomMixedTree(Map& map, int index);
+    void CreateRandomMixedTree(Map& map, int index, TileRandom& rnd);
 
     /**
      * Creates a random amount of stone.
      * @param map map of the vertex to create a new stone pile on
      * @param index index of the vertex to create a new stone pile on
+     * @param rnd random number generator of the current vertex
      */
-    void CreateRandomStone(Map& map, int index);
+    void CreateRandomStone(Map& map, int index, TileRandom& rnd);
 };
 
 template<class T_Predicate>
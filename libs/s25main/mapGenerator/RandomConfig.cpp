@@ -42,6 +42,7 @@ bool RandomConfig::Init(MapStyle mapStyle, DescIdx<LandscapeDesc> landscape, uin
             landscapeTerrains.push_back(t);
     }
     rng_.seed(static_cast<UsedRNG::result_type>(seed));
+    seed_ = seed;
     switch(mapStyle)
     {
         case MapStyle::Greenland: CreateGreenland(); break;
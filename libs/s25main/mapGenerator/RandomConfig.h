@@ -20,6 +20,7 @@
 
 #include "mapGenerator/AreaDesc.h"
 #include "mapGenerator/MapStyle.h"
+#include "mapGenerator/TileRandom.h"
 #include "random/XorShift.h"
 #include "gameData/DescIdx.h"
 #include "gameData/WorldDescription.h"
@@ -75,6 +76,14 @@ public:
      */
     double DRand(double min, double max);
 
+    /**
+     * Creates the random number generator for the given vertex (or other element) of a generation stage.
+     * Other than Rand the numbers do not depend on the order of the calls, so it can be used by concurrent stages.
+     * @param stage current stage of the map generation
+     * @param index index of the vertex (or other element) to generate random numbers for
+     */
+    TileRandom GetTileRandom(RandStage stage, unsigned index) const { return TileRandom(seed_, stage, index); }
+
     const TerrainDesc& GetTerrainByS2Id(uint8_t s2Id) const;
 
     template<class T_Predicate>
@@ -98,6 +107,7 @@ private:
 
     using UsedRNG = XorShift;
     UsedRNG rng_;
+    uint64_t seed_ = 0;
 };
 
 template<class T_Predicate>
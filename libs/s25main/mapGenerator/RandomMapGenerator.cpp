@@ -17,6 +17,7 @@
 
 #include "rttrDefines.h" // IWYU pragma: keep
 #include "mapGenerator/RandomMapGenerator.h"
+#include "mapGenerator/HillRasterizer.h"
 #include "mapGenerator/MapSettings.h"
 #include "mapGenerator/ObjectGenerator.h"
 #include "mapGenerator/RandomConfig.h"
@@ -25,11 +26,50 @@
 #include "gameData/TerrainDesc.h"
 #include "libsiedler2/enumTypes.h"
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <future>
+#include <thread>
+#include <utility>
 
 // harbor placement
 #define MIN_HARBOR_DISTANCE 35.0
 #define MIN_HARBOR_WATER 200
 
+/// Offsets of the vertices in distance <= 1 in the order of VertexUtility::GetNeighbors
+static const std::array<Position, 5> DIRECT_NEIGHBOR_OFFSETS = {
+  {Position(-1, 0), Position(0, -1), Position(0, 0), Position(0, 1), Position(1, 0)}};
+
+namespace {
+/**
+ * Calls func(firstRow, endRow) for consecutive bands of rows of the map on up to numThreads threads.
+ * As all random numbers of a vertex come from a TileRandom the result does not depend on the number of bands
+ * as long as func only writes the vertices of its rows.
+ * @param numThreads number of threads to use, 0 to use all cores (only for big enough maps)
+ */
+template<class T_Func>
+void ForEachRowBand(const MapExtent& size, unsigned numThreads, const T_Func& func)
+{
+    // Below this number of vertices per thread starting threads costs more than it saves
+    static const unsigned MIN_VERTICES_PER_THREAD = 4096;
+
+    if(numThreads == 0)
+        numThreads = std::min(std::thread::hardware_concurrency(), prodOfComponents(size) / MIN_VERTICES_PER_THREAD);
+    numThreads = std::max(1u, std::min(numThreads, static_cast<unsigned>(size.y)));
+    const unsigned rowsPerBand = (size.y + numThreads - 1) / numThreads;
+
+    std::vector<std::future<void>> workers;
+    for(unsigned firstRow = rowsPerBand; firstRow < size.y; firstRow += rowsPerBand)
+    {
+        const unsigned endRow = std::min<unsigned>(firstRow + rowsPerBand, size.y);
+        workers.push_back(std::async(std::launch::async, [&func, firstRow, endRow]() { func(firstRow, endRow); }));
+    }
+    func(0u, std::min<unsigned>(rowsPerBand, size.y));
+    for(std::future<void>& worker : workers)
+        worker.get();
+}
+} // namespace
+
 RandomMapGenerator::RandomMapGenerator(RandomConfig& config) : config(config), helper(config) {}
 
 unsigned RandomMapGenerator::GetMaxTerrainHeight(const DescIdx<TerrainDesc> terrain)
@@ -79,101 +119,139 @@ void RandomMapGenerator::PlacePlayerResources(const MapSettings& settings, Map&
         int offset2 = config.Rand(180, 360);
         const Position p(map.hqPositions[i]);
 
-        helper.SetStones(map, MapUtility::ComputePointOnCircle(offset1, 360, p, 12), 2.0F);
-        helper.SetStones(map, MapUtility::ComputePointOnCircle(offset2, 360, p, 12), 2.7F);
+        TileRandom rnd = config.GetTileRandom(RandStage::PlayerResources, i);
+        helper.SetStones(map, MapUtility::ComputePointOnCircle(offset1, 360, p, 12), 2.0F, rnd);
+        helper.SetStones(map, MapUtility::ComputePointOnCircle(offset2, 360, p, 12), 2.7F, rnd);
     }
 }
 
-void RandomMapGenerator::CreateHills(const MapSettings& settings, Map& map)
+std::vector<double> RandomMapGenerator::ComputeDistanceToPlayers(const MapSettings& settings, const Map& map)
 {
-    const int players = settings.numPlayers;
-    std::vector<AreaDesc> areas = config.areas;
+    std::vector<Position> hqPositions;
+    for(unsigned i = 0; i < settings.numPlayers; i++)
+        hqPositions.push_back(Position(map.hqPositions[i]));
+    const std::vector<unsigned> squaredDistances = VertexUtility::SquaredDistanceField(hqPositions, map.size);
 
-    for(int x = 0; x < map.size.x; x++)
+    std::vector<double> distances(squaredDistances.size());
+    for(unsigned i = 0; i < squaredDistances.size(); i++)
     {
-        for(int y = 0; y < map.size.y; y++)
-        {
-            auto distanceToPlayer = (double)(map.size.x + map.size.y);
-            Position tile(x, y);
+        // Without players every tile is "far away"
+        if(squaredDistances[i] == VertexUtility::DIST_INFINITE)
+            distances[i] = static_cast<double>(map.size.x + map.size.y);
+        else
+            distances[i] = std::sqrt(static_cast<double>(squaredDistances[i]));
+    }
+    return distances;
+}
 
-            for(int i = 0; i < players; i++)
-            {
-                distanceToPlayer = std::min(distanceToPlayer, VertexUtility::Distance(tile, Position(map.hqPositions[i]), map.size));
-            }
+void RandomMapGenerator::CreateHills(const MapSettings& settings, const std::vector<double>& distanceToPlayers, Map& map)
+{
+    const std::vector<AreaDesc>& areas = config.areas;
 
-            for(auto& area : areas)
+    // Choose the hills of each row in parallel and add them afterwards, which is order independent
+    std::vector<std::vector<std::pair<Position, unsigned>>> hillsPerRow(map.size.y);
+    ForEachRowBand(map.size, settings.numThreads, [&](unsigned firstRow, unsigned endRow) {
+        for(unsigned y = firstRow; y < endRow; y++)
+        {
+            for(int x = 0; x < map.size.x; x++)
             {
-                if(area.IsInArea(tile, distanceToPlayer, map.size))
-                {
-                    const auto pr = (int)area.likelyhoodHill;
-                    const int maxZ = area.maxElevation;
+                Position tile(x, y);
+                const int index = VertexUtility::GetIndexOf(tile, map.size);
+                const double distanceToPlayer = distanceToPlayers[index];
+                TileRandom rnd = config.GetTileRandom(RandStage::Hills, index);
 
-                    if(maxZ > 0 && config.Rand(101) <= pr)
+                for(const auto& area : areas)
+                {
+                    if(area.IsInArea(tile, distanceToPlayer, map.size))
                     {
-                        auto z = (unsigned)config.Rand(area.minElevation, maxZ + 1);
-                        MapUtility::SetHill(map, tile, z);
+                        const auto pr = (int)area.likelyhoodHill;
+                        const int maxZ = area.maxElevation;
+
+                        if(maxZ > 0 && rnd.Rand(101) <= pr)
+                        {
+                            auto z = (unsigned)rnd.Rand(area.minElevation, maxZ + 1);
+                            hillsPerRow[y].emplace_back(tile, z);
+                        }
                     }
                 }
             }
         }
+    });
+
+    HillRasterizer hills(map);
+    for(const auto& rowHills : hillsPerRow)
+    {
+        for(const auto& hill : rowHills)
+            hills.AddHill(hill.first, hill.second);
     }
 }
 
-void RandomMapGenerator::FillRemainingTerrain(const MapSettings& settings, Map& map)
+void RandomMapGenerator::FillRemainingTerrain(const MapSettings& settings, const std::vector<double>& distanceToPlayers, Map& map)
 {
-    const int players = settings.numPlayers;
-    std::vector<AreaDesc> areas = config.areas;
-    std::vector<DescIdx<TerrainDesc>> textures = config.textures;
+    const std::vector<AreaDesc>& areas = config.areas;
+    const std::vector<DescIdx<TerrainDesc>>& textures = config.textures;
 
-    RTTR_FOREACH_PT(Position, map.size)
-    {
-        const int index = VertexUtility::GetIndexOf(pt, map.size);
-        const int level = map.z[index];
-
-        // create texture for current height value
-        helper.objGen.CreateTexture(map, index, textures[level]);
+    // Each vertex only reads and writes its own texture and object
+    ForEachRowBand(map.size, settings.numThreads, [&](unsigned firstRow, unsigned endRow) {
+        for(unsigned y = firstRow; y < endRow; y++)
+        {
+            for(int x = 0; x < map.size.x; x++)
+            {
+                const Position pt(x, y);
+                const int index = VertexUtility::GetIndexOf(pt, map.size);
+                const int level = map.z[index];
 
-        auto distanceToPlayer = (double)(map.size.x + map.size.y);
+                // create texture for current height value
+                helper.objGen.CreateTexture(map, index, textures[level]);
 
-        for(int i = 0; i < players; i++)
-            distanceToPlayer = std::min(distanceToPlayer, VertexUtility::Distance(pt, Position(map.hqPositions[i]), map.size));
+                const double distanceToPlayer = distanceToPlayers[index];
+                TileRandom rnd = config.GetTileRandom(RandStage::Objects, index);
 
-        for(auto& area : areas)
-        {
-            if(area.IsInArea(pt, distanceToPlayer, map.size))
-            {
-                if(static_cast<unsigned>(config.Rand(0, 100)) < area.likelyhoodTree)
-                    helper.SetTree(map, pt);
-                else if(static_cast<unsigned>(config.Rand(0, 100)) < area.likelyhoodStone)
-                    helper.SetStone(map, pt);
+                for(const auto& area : areas)
+                {
+                    if(area.IsInArea(pt, distanceToPlayer, map.size))
+                    {
+                        if(static_cast<unsigned>(rnd.Rand(0, 100)) < area.likelyhoodTree)
+                            helper.SetTree(map, pt, rnd);
+                        else if(static_cast<unsigned>(rnd.Rand(0, 100)) < area.likelyhoodStone)
+                            helper.SetStone(map, pt, rnd);
+                    }
+                }
             }
         }
-    }
+    });
     // post-processing of texture (add animals, adapt height, ...)
-    RTTR_FOREACH_PT(Position, map.size)
-    {
-        const int index = VertexUtility::GetIndexOf(pt, map.size);
-        const int level = map.z[index];
-        const TerrainDesc& t = config.worldDesc.get(textures[level]);
-        if(t.kind == TerrainKind::WATER)
-        {
-            map.z[index] = GetMaxTerrainHeight(textures[level]);
-            map.animal[index] = helper.objGen.CreateDuck(3);
-        } else if(t.humidity > 0 && t.IsUsableByAnimals())
+    // Reads the objects of the neighbors which are not changed anymore and writes only the current vertex
+    ForEachRowBand(map.size, settings.numThreads, [&](unsigned firstRow, unsigned endRow) {
+        for(unsigned y = firstRow; y < endRow; y++)
         {
-            std::vector<int> positions = VertexUtility::GetNeighbors(pt, map.size, 1);
-            bool treeFound = false;
-            for(int curIdx : positions)
+            for(int x = 0; x < map.size.x; x++)
             {
-                if(ObjectGenerator::IsTree(map, curIdx))
+                const Position pt(x, y);
+                const int index = VertexUtility::GetIndexOf(pt, map.size);
+                const int level = map.z[index];
+                const TerrainDesc& t = config.worldDesc.get(textures[level]);
+                TileRandom rnd = config.GetTileRandom(RandStage::Animals, index);
+                if(t.kind == TerrainKind::WATER)
                 {
-                    treeFound = true;
-                    break;
+                    map.z[index] = GetMaxTerrainHeight(textures[level]);
+                    map.animal[index] = helper.objGen.CreateDuck(3, rnd);
+                } else if(t.humidity > 0 && t.IsUsableByAnimals())
+                {
+                    bool treeFound = false;
+                    for(const Position& offset : DIRECT_NEIGHBOR_OFFSETS)
+                    {
+                        if(ObjectGenerator::IsTree(map, VertexUtility::GetIndexOf(pt + offset, map.size)))
+                        {
+                            treeFound = true;
+                            break;
+                        }
+                    }
+                    map.animal[index] = treeFound ? helper.objGen.CreateRandomForestAnimal(4, rnd) : helper.objGen.CreateSheep(4, rnd);
                 }
             }
-            map.animal[index] = treeFound ? helper.objGen.CreateRandomForestAnimal(4) : helper.objGen.CreateSheep(4);
         }
-    }
+    });
 
     ///////
     /// Harbour placement
@@ -200,9 +278,9 @@ void RandomMapGenerator::FillRemainingTerrain(const MapSettings& settings, Map&
             Position water(0, 0);
             // ensure there's water close to the coast texture
             bool waterNeighbor = false;
-            std::vector<int> neighbors = VertexUtility::GetNeighbors(pt, map.size, 1);
-            for(int& neighbor : neighbors)
+            for(const Position& offset : DIRECT_NEIGHBOR_OFFSETS)
             {
+                const int neighbor = VertexUtility::GetIndexOf(pt + offset, map.size);
                 if(helper.objGen.IsTexture(map, neighbor, textures[maxWaterIndex]))
                 {
                     waterNeighbor = true;
@@ -235,45 +313,56 @@ void RandomMapGenerator::FillRemainingTerrain(const MapSettings& settings, Map&
 
 void RandomMapGenerator::SetResources(const MapSettings& settings, Map& map)
 {
-    RTTR_FOREACH_PT(Position, map.size)
-    {
-        const int index = VertexUtility::GetIndexOf(pt, map.size);
-        const TerrainDesc& tRsu = config.GetTerrainByS2Id(map.textureRsu[index]);
-        const TerrainDesc& tLsd = config.GetTerrainByS2Id(map.textureLsd[index]);
+    // Reads only the textures and writes the resource of the current vertex
+    ForEachRowBand(map.size, settings.numThreads, [&](unsigned firstRow, unsigned endRow) {
+        for(unsigned y = firstRow; y < endRow; y++)
+        {
+            for(int x = 0; x < map.size.x; x++)
+            {
+                const Position pt(x, y);
+                const int index = VertexUtility::GetIndexOf(pt, map.size);
+                const TerrainDesc& tRsu = config.GetTerrainByS2Id(map.textureRsu[index]);
+                const TerrainDesc& tLsd = config.GetTerrainByS2Id(map.textureLsd[index]);
 
-        uint8_t res = libsiedler2::R_None;
+                uint8_t res = libsiedler2::R_None;
 
-        if(tRsu.kind == TerrainKind::WATER && tLsd.kind == TerrainKind::WATER)
-        {
-            res = libsiedler2::R_Fish;
-        } else if(tRsu.IsVital() && tLsd.IsVital())
-        {
-            int nb = VertexUtility::GetIndexOf(GetNeighbour(pt, Direction::NORTHWEST), map.size);
-            const TerrainDesc& t1 = config.GetTerrainByS2Id(map.textureRsu[nb]);
-            const TerrainDesc& t2 = config.GetTerrainByS2Id(map.textureLsd[nb]);
-            nb = VertexUtility::GetIndexOf(GetNeighbour(pt, Direction::NORTHEAST), map.size);
-            const TerrainDesc& t3 = config.GetTerrainByS2Id(map.textureLsd[nb]);
-            nb = VertexUtility::GetIndexOf(GetNeighbour(pt, Direction::EAST), map.size);
-            const TerrainDesc& t4 = config.GetTerrainByS2Id(map.textureRsu[nb]);
-            // Less strict check: Include all terrain that can also be used by animals
-            if(tRsu.humidity > 0 && tLsd.humidity > 0 && t1.IsUsableByAnimals() && t2.IsUsableByAnimals() && t3.IsUsableByAnimals()
-               && t4.IsUsableByAnimals())
-                res = libsiedler2::R_Water;
-        } else if(tRsu.Is(ETerrain::Mineable) && tLsd.Is(ETerrain::Mineable))
-        {
-            int nb = VertexUtility::GetIndexOf(GetNeighbour(pt, Direction::NORTHWEST), map.size);
-            const TerrainDesc& t1 = config.GetTerrainByS2Id(map.textureRsu[nb]);
-            const TerrainDesc& t2 = config.GetTerrainByS2Id(map.textureLsd[nb]);
-            nb = VertexUtility::GetIndexOf(GetNeighbour(pt, Direction::NORTHEAST), map.size);
-            const TerrainDesc& t3 = config.GetTerrainByS2Id(map.textureLsd[nb]);
-            nb = VertexUtility::GetIndexOf(GetNeighbour(pt, Direction::EAST), map.size);
-            const TerrainDesc& t4 = config.GetTerrainByS2Id(map.textureRsu[nb]);
-            if(t1.Is(ETerrain::Mineable) && t2.Is(ETerrain::Mineable) && t3.Is(ETerrain::Mineable) && t4.Is(ETerrain::Mineable))
-                res = helper.objGen.CreateRandomResource(settings.ratioGold, settings.ratioIron, settings.ratioCoal, settings.ratioGranite);
-        }
+                if(tRsu.kind == TerrainKind::WATER && tLsd.kind == TerrainKind::WATER)
+                {
+                    res = libsiedler2::R_Fish;
+                } else if(tRsu.IsVital() && tLsd.IsVital())
+                {
+                    int nb = VertexUtility::GetIndexOf(GetNeighbour(pt, Direction::NORTHWEST), map.size);
+                    const TerrainDesc& t1 = config.GetTerrainByS2Id(map.textureRsu[nb]);
+                    const TerrainDesc& t2 = config.GetTerrainByS2Id(map.textureLsd[nb]);
+                    nb = VertexUtility::GetIndexOf(GetNeighbour(pt, Direction::NORTHEAST), map.size);
+                    const TerrainDesc& t3 = config.GetTerrainByS2Id(map.textureLsd[nb]);
+                    nb = VertexUtility::GetIndexOf(GetNeighbour(pt, Direction::EAST), map.size);
+                    const TerrainDesc& t4 = config.GetTerrainByS2Id(map.textureRsu[nb]);
+                    // Less strict check: Include all terrain that can also be used by animals
+                    if(tRsu.humidity > 0 && tLsd.humidity > 0 && t1.IsUsableByAnimals() && t2.IsUsableByAnimals()
+                       && t3.IsUsableByAnimals() && t4.IsUsableByAnimals())
+                        res = libsiedler2::R_Water;
+                } else if(tRsu.Is(ETerrain::Mineable) && tLsd.Is(ETerrain::Mineable))
+                {
+                    int nb = VertexUtility::GetIndexOf(GetNeighbour(pt, Direction::NORTHWEST), map.size);
+                    const TerrainDesc& t1 = config.GetTerrainByS2Id(map.textureRsu[nb]);
+                    const TerrainDesc& t2 = config.GetTerrainByS2Id(map.textureLsd[nb]);
+                    nb = VertexUtility::GetIndexOf(GetNeighbour(pt, Direction::NORTHEAST), map.size);
+                    const TerrainDesc& t3 = config.GetTerrainByS2Id(map.textureLsd[nb]);
+                    nb = VertexUtility::GetIndexOf(GetNeighbour(pt, Direction::EAST), map.size);
+                    const TerrainDesc& t4 = config.GetTerrainByS2Id(map.textureRsu[nb]);
+                    if(t1.Is(ETerrain::Mineable) && t2.Is(ETerrain::Mineable) && t3.Is(ETerrain::Mineable) && t4.Is(ETerrain::Mineable))
+                    {
+                        TileRandom rnd = config.GetTileRandom(RandStage::Resources, index);
+                        res = helper.objGen.CreateRandomResource(settings.ratioGold, settings.ratioIron, settings.ratioCoal,
+                                                                 settings.ratioGranite, rnd);
+                    }
+                }
 
-        map.resource[index] = res;
-    }
+                map.resource[index] = res;
+            }
+        }
+    });
 }
 
 Map RandomMapGenerator::Create(MapSettings settings)
@@ -288,8 +377,9 @@ Map RandomMapGenerator::Create(MapSettings settings)
     // the actual map generation
     PlacePlayers(settings, map);
     PlacePlayerResources(settings, map);
-    CreateHills(settings, map);
-    FillRemainingTerrain(settings, map);
+    const std::vector<double> distanceToPlayers = ComputeDistanceToPlayers(settings, map);
+    CreateHills(settings, distanceToPlayers, map);
+    FillRemainingTerrain(settings, distanceToPlayers, map);
     helper.Smooth(map);
     SetResources(settings, map);
 
@@ -19,6 +19,7 @@
 #define RandomMapGenerator_h__
 
 #include "mapGenerator/MapUtility.h"
+#include <vector>
 
 class RandomConfig;
 struct TerrainDesc;
@@ -81,21 +82,29 @@ private:
      */
     void PlacePlayerResources(const MapSettings& settings, Map& map);
 
+    /**
+     * Computes the distance from every vertex to the closest player headquarters.
+     * @param settings settings used for map generation
+     * @param map map with the player positions
+     * @return distances for all vertices by index
+     */
+    static std::vector<double> ComputeDistanceToPlayers(const MapSettings& settings, const Map& map);
+
     /**
      * Create a elevation (hills) for the specified map.
      * @param settings settings used for map generation
-     * @param config configuration for the random map generator
+     * @param distanceToPlayers distance of each vertex to the closest player
      * @param map map to modify
      */
-    void CreateHills(const MapSettings& settings, Map& map);
+    void CreateHills(const MapSettings& settings, const std::vector<double>& distanceToPlayers, Map& map);
 
     /**
      * Fill the remaining terrain (apart from the player positions) according to the generated hills.
      * @param settings settings used for map generation
-     * @param config configuration for the random map generator
+     * @param distanceToPlayers distance of each vertex to the closest player
      * @param map map to modify
      */
-    void FillRemainingTerrain(const MapSettings& settings, Map& map);
+    void FillRemainingTerrain(const MapSettings& settings, const std::vector<double>& distanceToPlayers, Map& map);
 
     /// Set the resources (water, fish, coal...) for the map
     void SetResources(const MapSettings& settings, Map& map);
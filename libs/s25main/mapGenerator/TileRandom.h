@@ -0,0 +1,86 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef TileRandom_h__
+#define TileRandom_h__
+
+#include "RTTR_Assert.h"
+#include <cstdint>
+
+/**
+ * Stages of the map generation which draw random numbers per vertex.
+ * Each stage gets its own random numbers so adding draws to one stage does not change the others.
+ */
+enum class RandStage : unsigned
+{
+    PlayerResources,
+    Hills,
+    Objects,
+    Animals,
+    Resources
+};
+
+/**
+ * Counter based random number generator for the map generation.
+ * The numbers only depend on the seed, the stage and the index (usually of the vertex) and on how many numbers
+ * were already drawn from this instance. So vertices can be processed in any order and on any thread while
+ * still producing the same map for the same seed.
+ */
+class TileRandom
+{
+public:
+    TileRandom(uint64_t seed, RandStage stage, unsigned index)
+        : key_(Mix(Mix(seed) ^ ((static_cast<uint64_t>(stage) << 32) | index))), counter_(0)
+    {}
+
+    /**
+     * Generates a random number between 0 and max-1.
+     * @param max maximum value
+     * @return a new random number
+     */
+    int Rand(int max) { return Rand(0, max); }
+
+    /**
+     * Generates a random number between min and max-1.
+     * @param min minimum value
+     * @param max maximum value
+     * @return a new random number
+     */
+    int Rand(int min, int max)
+    {
+        RTTR_Assert(max > min);
+        const auto range = static_cast<uint64_t>(static_cast<int64_t>(max) - min);
+        // Scale the upper 32 bits to the range. The bias is at most range / 2^32 and hence negligible here
+        return static_cast<int>(min + static_cast<int64_t>(((Next() >> 32) * range) >> 32));
+    }
+
+private:
+    /// Finalizer of SplitMix64: Bijective and mixes every input bit into all output bits
+    static uint64_t Mix(uint64_t z)
+    {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t Next() { return Mix(key_ + (++counter_) * 0x9e3779b97f4a7c15ULL); }
+
+    uint64_t key_;
+    uint64_t counter_;
+};
+
+#endif // TileRandom_h__
@@ -19,6 +19,56 @@
 #include "mapGenerator/VertexUtility.h"
 #include <algorithm>
 #include <cmath>
+#include <limits>
+
+constexpr unsigned VertexUtility::DIST_INFINITE;
+
+namespace {
+/// 1D squared distance transform with wrap around: d[i] = min_j(dist(i, j)^2 + f[j]) with dist being the distance on a circle.
+/// Computes the lower envelope of the parabolas rooted at all j (Felzenszwalb & Huttenlocher). Each sample is also placed at
+/// j - n and j + n, so the envelope covers the wrapped distances too.
+void transformWrapped(const std::vector<unsigned>& f, std::vector<unsigned>& d, std::vector<int>& vertices, std::vector<double>& bounds)
+{
+    const int n = static_cast<int>(f.size());
+    vertices.clear();
+    bounds.clear();
+    for(int q = -n; q < 2 * n; q++)
+    {
+        const unsigned fq = f[(q + n) % n];
+        if(fq == VertexUtility::DIST_INFINITE)
+            continue;
+        const double valueQ = fq + static_cast<double>(q) * q;
+        double intersection = -std::numeric_limits<double>::infinity();
+        while(!vertices.empty())
+        {
+            const int p = vertices.back();
+            const double valueP = f[(p + n) % n] + static_cast<double>(p) * p;
+            intersection = (valueQ - valueP) / (2. * (q - p));
+            if(intersection > bounds.back())
+                break;
+            // Parabola at p is never the lowest one
+            vertices.pop_back();
+            bounds.pop_back();
+        }
+        vertices.push_back(q);
+        bounds.push_back(intersection);
+    }
+
+    if(vertices.empty())
+    {
+        std::fill(d.begin(), d.end(), VertexUtility::DIST_INFINITE);
+        return;
+    }
+    unsigned k = 0;
+    for(int i = 0; i < n; i++)
+    {
+        while(k + 1 < vertices.size() && bounds[k + 1] < i)
+            k++;
+        const int delta = i - vertices[k];
+        d[i] = static_cast<unsigned>(delta * delta) + f[(vertices[k] + n) % n];
+    }
+}
+} // namespace
 
 Position VertexUtility::GetPosition(int index, const MapExtent& size)
 {
@@ -69,3 +119,37 @@ double VertexUtility::Distance(const Position& p1, const Position& p2, const Map
     Position deltaSq = delta * delta;
     return std::sqrt(deltaSq.x + deltaSq.y);
 }
+
+std::vector<unsigned> VertexUtility::SquaredDistanceField(const std::vector<Position>& sources, const MapExtent& size)
+{
+    std::vector<unsigned> field(size.x * size.y, DIST_INFINITE);
+    for(const Position& source : sources)
+        field[GetIndexOf(source, size)] = 0;
+
+    std::vector<unsigned> f, d;
+    std::vector<int> vertices;
+    std::vector<double> bounds;
+
+    // Distances within each column
+    f.resize(size.y);
+    d.resize(size.y);
+    for(int x = 0; x < size.x; x++)
+    {
+        for(int y = 0; y < size.y; y++)
+            f[y] = field[x + y * size.x];
+        transformWrapped(f, d, vertices, bounds);
+        for(int y = 0; y < size.y; y++)
+            field[x + y * size.x] = d[y];
+    }
+
+    // Combine with the distances within each row
+    f.resize(size.x);
+    d.resize(size.x);
+    for(int y = 0; y < size.y; y++)
+    {
+        std::copy_n(field.begin() + y * size.x, size.x, f.begin());
+        transformWrapped(f, d, vertices, bounds);
+        std::copy(d.begin(), d.end(), field.begin() + y * size.x);
+    }
+    return field;
+}
@@ -19,6 +19,7 @@
 #define VertexUtility_h__
 
 #include "gameTypes/MapCoordinates.h"
+#include <limits>
 #include <vector>
 
 class VertexUtility
@@ -58,6 +59,17 @@ public:
      * @return the distance between the two vertices
      */
     static double Distance(const Position& p1, const Position& p2, const MapExtent& size);
+
+    /**
+     * Computes the squared distance (as used by Distance) from every vertex to the closest of the specified sources.
+     * Uses a separable distance transform, so the runtime is linear in the map size and independent of the number of sources.
+     * @param sources positions of the sources
+     * @param size of the map
+     * @return squared distances for all vertices by index or DIST_INFINITE if there are no sources
+     */
+    static std::vector<unsigned> SquaredDistanceField(const std::vector<Position>& sources, const MapExtent& size);
+
+    static constexpr unsigned DIST_INFINITE = std::numeric_limits<unsigned>::max();
 };
 
 #endif // VertexUtility_h__
@@ -22,6 +22,7 @@
 #include "ReplayInfo.h"
 #include "ai/AIPlayer.h"
 #include "network/GameClient.h"
+#include "network/GameMessages.h"
 
 void GameClient::ExecuteNWF()
 {
@@ -57,6 +58,8 @@ void GameClient::ExecuteNWF()
             gameCommands_.insert(gameCommands_.end(), aiGCs.begin(), aiGCs.end());
         else
             mainPlayer.sendMsgAsync(new GameMessage_GameCommand(ai.GetPlayerId(), checksum, aiGCs));
+        for(const std::string& msg : ai.FetchChatMessages())
+            mainPlayer.sendMsgAsync(new GameMessage_Chat(ai.GetPlayerId(), CD_ALL, msg));
     }
     mainPlayer.sendMsgAsync(new GameMessage_GameCommand(0xFF, checksum, gameCommands_));
     gameCommands_.clear();
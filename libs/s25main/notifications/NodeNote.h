@@ -28,7 +28,9 @@ struct NodeNote
     enum Type
     {
         Altitude, // Nodes altitude was changed
-        BQ        // Building quality
+        BQ,       // Building quality
+        Owner,    // Owner of the node was changed
+        Road      // A road point at the node was set or removed
     };
 
     NodeNote(Type type, const MapPoint& pt) : type(type), pos(pt) {}
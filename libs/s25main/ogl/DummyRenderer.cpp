@@ -33,11 +33,16 @@ void APIENTRY glDeleteTextures(GLsizei, const GLuint*) {}
 void APIENTRY glBindTexture(GLenum, GLuint) {}
 void APIENTRY glTexParameteri(GLenum, GLenum, GLint) {}
 void APIENTRY glTexImage2D(GLenum, GLint, GLint, GLsizei, GLsizei, GLint, GLenum, GLenum, const GLvoid*) {}
+void APIENTRY glTexSubImage2D(GLenum, GLint, GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, const GLvoid*) {}
+void APIENTRY glCopyTexSubImage2D(GLenum, GLint, GLint, GLint, GLint, GLint, GLsizei, GLsizei) {}
 void APIENTRY glClear(GLbitfield) {}
 void APIENTRY glVertexPointer(GLint, GLenum, GLsizei, const GLvoid*) {}
 void APIENTRY glTexCoordPointer(GLint, GLenum, GLsizei, const GLvoid*) {}
 void APIENTRY glColor4ub(GLubyte, GLubyte, GLubyte, GLubyte) {}
 void APIENTRY glDrawArrays(GLenum, GLint, GLsizei) {}
+void APIENTRY glPushMatrix() {}
+void APIENTRY glPopMatrix() {}
+void APIENTRY glTranslatef(GLfloat, GLfloat, GLfloat) {}
 void APIENTRY glGetTexLevelParameteriv(GLenum, GLint, GLenum, GLint* params)
 {
     *params = 1;
@@ -55,11 +60,16 @@ bool DummyRenderer::initOpenGL(OpenGL_Loader_Proc)
     MOCK(glBindTexture);
     MOCK(glTexParameteri);
     MOCK(glTexImage2D);
+    MOCK(glTexSubImage2D);
+    MOCK(glCopyTexSubImage2D);
     MOCK(glClear);
     MOCK(glVertexPointer);
     MOCK(glTexCoordPointer);
     MOCK(glColor4ub);
     MOCK(glDrawArrays);
+    MOCK(glPushMatrix);
+    MOCK(glPopMatrix);
+    MOCK(glTranslatef);
     MOCK(glGetTexLevelParameteriv);
     return true;
 }
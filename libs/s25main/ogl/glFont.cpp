@@ -28,6 +28,8 @@
 #include "libsiedler2/libsiedler2.h"
 #include <utf8.h>
 #include <boost/algorithm/string.hpp>
+#include <boost/functional/hash.hpp>
+#include <algorithm>
 #include <cmath>
 #include <vector>
 
@@ -43,7 +45,8 @@ T_Iterator nextIt(T_Iterator it)
 
 //////////////////////////////////////////////////////////////////////////
 
-glFont::glFont(const libsiedler2::ArchivItem_Font& font) : maxCharSize(font.getDx(), font.getDy()), asciiMapping{}
+glFont::glFont(const libsiedler2::ArchivItem_Font& font)
+    : maxCharSize(font.getDx(), font.getDy()), asciiMapping{}, maxLayoutCacheSize(1024)
 {
     fontWithOutline = libsiedler2::getAllocator().create<glArchivItem_Bitmap>(libsiedler2::BOBTYPE_BITMAP_RAW);
     fontNoOutline = libsiedler2::getAllocator().create<glArchivItem_Bitmap>(libsiedler2::BOBTYPE_BITMAP_RAW);
@@ -171,41 +174,85 @@ inline void glFont::DrawChar(char32_t curChar, VertexArrays& vertices, DrawPoint
     curPos.x += ci.width;
 }
 
-/**
- *  Zeichnet einen Text.
- *
- *  @param[in] x      X-Koordinate
- *  @param[in] y      Y-Koordinate
- *  @param[in] text   Der Text
- *  @param[in] format Format des Textes (verodern)
- *                      @p FontStyle::LEFT    - Text links ( standard )
- *                      @p FontStyle::CENTER  - Text mittig
- *                      @p FontStyle::RIGHT   - Text rechts
- *                      @p FontStyle::TOP     - Text oben ( standard )
- *                      @p FontStyle::VCENTER - Text vertikal zentriert
- *                      @p FontStyle::BOTTOM  - Text unten
- *  @param[in] color  Farbe des Textes
- *  @param[in] length Länge des Textes
- *  @param[in] max    maximale Länge
- *  @param     end    Suffix for displaying a truncation of the text (...)
- */
-void glFont::Draw(DrawPoint pos, const std::string& text, FontStyle format, unsigned color, unsigned short maxWidth,
-                  const std::string& end) const
+bool glFont::LayoutKey::operator==(const LayoutKey& rhs) const
 {
-    RTTR_Assert(utf8::is_valid(text));
+    return maxWidth == rhs.maxWidth && noOutline == rhs.noOutline && text == rhs.text && end == rhs.end;
+}
+
+size_t glFont::LayoutKeyHasher::operator()(const LayoutKey& key) const
+{
+    size_t seed = boost::hash_range(key.text.begin(), key.text.end());
+    boost::hash_combine(seed, boost::hash_range(key.end.begin(), key.end.end()));
+    boost::hash_combine(seed, key.maxWidth);
+    boost::hash_combine(seed, key.noOutline);
+    return seed;
+}
+
+void glFont::SetLayoutCacheSize(unsigned maxSize)
+{
+    maxLayoutCacheSize = std::max(maxSize, 1u);
+    while(layoutCache.size() > maxLayoutCacheSize)
+    {
+        layoutCache.erase(layouts.back().key);
+        layouts.pop_back();
+        ++layoutCacheStats.numEvictions;
+    }
+}
+
+void glFont::ClearLayoutCache()
+{
+    layoutCache.clear();
+    layouts.clear();
+}
+
+const glFont::TextLayout& glFont::GetLayout(const LayoutKey& key, const Extent& texSize) const
+{
+    auto it = layoutCache.find(key);
+    if(it != layoutCache.end())
+    {
+        ++layoutCacheStats.numHits;
+        // Move to front as it is the most recently used one now
+        layouts.splice(layouts.begin(), layouts, it->second);
+        return *it->second;
+    }
+    ++layoutCacheStats.numMisses;
+    if(layoutCache.size() >= maxLayoutCacheSize)
+    {
+        // Reuse the least recently used entry to avoid reallocating the vertex buffers
+        layoutCache.erase(layouts.back().key);
+        layouts.splice(layouts.begin(), layouts, std::prev(layouts.end()));
+        ++layoutCacheStats.numEvictions;
+    } else
+        layouts.emplace_front();
+    // Only copy the strings now that they are needed for the cached layout
+    TextLayout& layout = layouts.front();
+    layout.text.assign(key.text.data(), key.text.size());
+    layout.end.assign(key.end.data(), key.end.size());
+    layout.key = LayoutKey{layout.text, layout.end, key.maxWidth, key.noOutline};
+    CreateLayout(layout, texSize);
+    layoutCache.emplace(layout.key, layouts.begin());
+    return layout;
+}
+
+void glFont::CreateLayout(TextLayout& layout, const Extent& texSize) const
+{
+    const std::string& text = layout.text;
+    const std::string& end = layout.end;
+    layout.glyphs.texCoords.clear();
+    layout.glyphs.vertices.clear();
+    layout.width = 0;
 
     unsigned maxNumChars;
     unsigned short textWidth;
     bool drawEnd;
-    if(maxWidth == 0xFFFF)
+    if(layout.key.maxWidth == 0xFFFF)
     {
         maxNumChars = text.size();
         textWidth = getWidth(text);
         drawEnd = false;
     } else
     {
-        RTTR_Assert(utf8::is_valid(end));
-        textWidth = getWidth(text, maxWidth, &maxNumChars);
+        textWidth = getWidth(text, layout.key.maxWidth, &maxNumChars);
         if(!end.empty() && maxNumChars < text.size())
         {
             unsigned short endWidth = getWidth(end);
@@ -225,24 +272,11 @@ void glFont::Draw(DrawPoint pos, const std::string& text, FontStyle format, unsi
         return;
     const auto itEnd = text.cbegin() + maxNumChars;
 
-    // Vertical alignment (assumes 1 line only!)
-    if(format.is(FontStyle::BOTTOM))
-        pos.y -= maxCharSize.y;
-    else if(format.is(FontStyle::VCENTER))
-        pos.y -= maxCharSize.y / 2;
-    // Horizontal alignment
-    if(format.is(FontStyle::RIGHT))
-        pos.x -= textWidth;
-    else if(format.is(FontStyle::CENTER))
-        pos.x -= textWidth / 2;
-
-    texList.texCoords.clear();
-    texList.vertices.clear();
-
+    DrawPoint pos(0, 0);
     for(auto it = text.begin(); it != itEnd;)
     {
         const uint32_t curChar = utf8::next(it, itEnd);
-        DrawChar(curChar, texList, pos);
+        DrawChar(curChar, layout.glyphs, pos);
     }
 
     if(drawEnd)
@@ -250,29 +284,78 @@ void glFont::Draw(DrawPoint pos, const std::string& text, FontStyle format, unsi
         for(auto it = end.begin(); it != end.end();)
         {
             const uint32_t curChar = utf8::next(it, end.end());
-            DrawChar(curChar, texList, pos);
+            DrawChar(curChar, layout.glyphs, pos);
         }
     }
 
-    if(texList.vertices.empty())
+    RTTR_Assert(layout.glyphs.texCoords.size() == layout.glyphs.vertices.size());
+    RTTR_Assert(layout.glyphs.texCoords.size() % 4u == 0);
+    const GlPoint texSizeF(texSize);
+    for(GlPoint& pt : layout.glyphs.texCoords)
+        pt /= texSizeF;
+    layout.width = textWidth;
+}
+
+/**
+ *  Zeichnet einen Text.
+ *
+ *  @param[in] x      X-Koordinate
+ *  @param[in] y      Y-Koordinate
+ *  @param[in] text   Der Text
+ *  @param[in] format Format des Textes (verodern)
+ *                      @p FontStyle::LEFT    - Text links ( standard )
+ *                      @p FontStyle::CENTER  - Text mittig
+ *                      @p FontStyle::RIGHT   - Text rechts
+ *                      @p FontStyle::TOP     - Text oben ( standard )
+ *                      @p FontStyle::VCENTER - Text vertikal zentriert
+ *                      @p FontStyle::BOTTOM  - Text unten
+ *  @param[in] color  Farbe des Textes
+ *  @param[in] length Länge des Textes
+ *  @param[in] max    maximale Länge
+ *  @param     end    Suffix for displaying a truncation of the text (...)
+ */
+void glFont::Draw(DrawPoint pos, const std::string& text, FontStyle format, unsigned color, unsigned short maxWidth,
+                  const std::string& end) const
+{
+    RTTR_Assert(utf8::is_valid(text));
+    RTTR_Assert(maxWidth == 0xFFFF || utf8::is_valid(end));
+
+    if(text.empty())
         return;
 
     // Get texture first as it might need to be created
-    glArchivItem_Bitmap& usedFont = format.is(FontStyle::NO_OUTLINE) ? *fontNoOutline : *fontWithOutline;
+    const bool noOutline = format.is(FontStyle::NO_OUTLINE);
+    glArchivItem_Bitmap& usedFont = noOutline ? *fontNoOutline : *fontWithOutline;
     unsigned texture = usedFont.GetTexture();
     if(!texture)
         return;
-    const GlPoint texSize(usedFont.GetTexSize());
-    RTTR_Assert(texList.texCoords.size() == texList.vertices.size());
-    RTTR_Assert(texList.texCoords.size() % 4u == 0);
-    for(GlPoint& pt : texList.texCoords)
-        pt /= texSize;
-
-    glVertexPointer(2, GL_FLOAT, 0, &texList.vertices[0]);
-    glTexCoordPointer(2, GL_FLOAT, 0, &texList.texCoords[0]);
+
+    // The suffix is not used if the width is unlimited so do not distinguish layouts by it
+    const boost::string_view usedEnd = maxWidth == 0xFFFF ? boost::string_view() : boost::string_view(end);
+    const TextLayout& layout = GetLayout(LayoutKey{text, usedEnd, maxWidth, noOutline}, usedFont.GetTexSize());
+    if(layout.glyphs.vertices.empty())
+        return;
+
+    // Vertical alignment (assumes 1 line only!)
+    if(format.is(FontStyle::BOTTOM))
+        pos.y -= maxCharSize.y;
+    else if(format.is(FontStyle::VCENTER))
+        pos.y -= maxCharSize.y / 2;
+    // Horizontal alignment
+    if(format.is(FontStyle::RIGHT))
+        pos.x -= layout.width;
+    else if(format.is(FontStyle::CENTER))
+        pos.x -= layout.width / 2;
+
+    // Glyphs are relative to the top left corner so move them to the final position
+    glPushMatrix();
+    glTranslatef(static_cast<GLfloat>(pos.x), static_cast<GLfloat>(pos.y), 0.0f);
+    glVertexPointer(2, GL_FLOAT, 0, &layout.glyphs.vertices[0]);
+    glTexCoordPointer(2, GL_FLOAT, 0, &layout.glyphs.texCoords[0]);
     VIDEODRIVER.BindTexture(texture);
     glColor4ub(GetRed(color), GetGreen(color), GetBlue(color), GetAlpha(color));
-    glDrawArrays(GL_QUADS, 0, texList.vertices.size());
+    glDrawArrays(GL_QUADS, 0, layout.glyphs.vertices.size());
+    glPopMatrix();
 }
 
 template<bool T_limitWidth>
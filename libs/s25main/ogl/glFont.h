@@ -24,11 +24,15 @@
 #include "ogl/FontStyle.h"
 #include "ogl/glArchivItem_Bitmap.h"
 #include "s25util/colors.h"
+#include <boost/utility/string_view.hpp>
 #include <glad/glad.h>
 #include <array>
+#include <cstdint>
+#include <list>
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace libsiedler2 {
@@ -38,6 +42,16 @@ class ArchivItem_Font;
 class glFont
 {
 public:
+    struct LayoutCacheStats
+    {
+        /// Number of draws using an already laid out text
+        uint64_t numHits = 0;
+        /// Number of draws requiring to lay out the text
+        uint64_t numMisses = 0;
+        /// Number of layouts removed because the cache was full
+        uint64_t numEvictions = 0;
+    };
+
     glFont(const libsiedler2::ArchivItem_Font&);
 
     /// Draw the the text at the given position with format (alignment) and color.
@@ -83,6 +97,13 @@ public:
     /// liefert die Breite eines Zeichens
     unsigned CharWidth(char32_t c) const { return GetCharInfo(c).width; }
 
+    /// Set the maximum number of text layouts kept for reuse by Draw. At least one layout is always kept
+    void SetLayoutCacheSize(unsigned maxSize);
+    unsigned GetLayoutCacheSize() const { return layoutCache.size(); }
+    void ClearLayoutCache();
+    const LayoutCacheStats& GetLayoutCacheStats() const { return layoutCacheStats; }
+    void ResetLayoutCacheStats() { layoutCacheStats = LayoutCacheStats(); }
+
 private:
     struct CharInfo
     {
@@ -97,11 +118,41 @@ private:
         std::vector<GlPoint> texCoords;
         std::vector<GlPoint> vertices;
     };
+    /// Everything that influences the glyphs drawn for a text.
+    /// Only refers to the strings so looking up a layout does not copy them. Cached layouts refer to their own copies
+    struct LayoutKey
+    {
+        boost::string_view text;
+        /// Suffix used for truncated texts. Empty if the width is not limited
+        boost::string_view end;
+        unsigned short maxWidth;
+        bool noOutline;
+
+        bool operator==(const LayoutKey& rhs) const;
+    };
+    struct LayoutKeyHasher
+    {
+        size_t operator()(const LayoutKey& key) const;
+    };
+    /// Glyph quads of a single line text relative to its top left corner. Texture coordinates are already normalized
+    struct TextLayout
+    {
+        /// Strings the key refers to
+        std::string text, end;
+        LayoutKey key;
+        VertexArrays glyphs;
+        unsigned short width;
+    };
+    using LayoutList = std::list<TextLayout>;
 
     void AddCharInfo(char32_t c, const CharInfo& info);
     /// liefert das Char-Info eines Zeichens
     const CharInfo& GetCharInfo(char32_t c) const;
     void DrawChar(char32_t curChar, VertexArrays& vertices, DrawPoint& curPos) const;
+    /// Return the layout for the key from the cache, creating it if required
+    const TextLayout& GetLayout(const LayoutKey& key, const Extent& texSize) const;
+    /// Fill the glyph quads and width of the layout from its key
+    void CreateLayout(TextLayout& layout, const Extent& texSize) const;
 
     Extent maxCharSize; // How big each char is at most (aka dx,dy)
     std::unique_ptr<glArchivItem_Bitmap> fontNoOutline;
@@ -110,8 +161,13 @@ private:
     /// Holds ascii chars only. As most chars are ascii this is faster then accessing the map
     std::array<std::pair<bool, CharInfo>, 256> asciiMapping;
     std::map<char32_t, CharInfo> utf8_mapping;
-    CharInfo placeHolder;         /// Placeholder if glyph is missing
-    mutable VertexArrays texList; /// Buffer to hold last textures. Used so memory reallocations are avoided
+    CharInfo placeHolder; /// Placeholder if glyph is missing
+
+    /// Laid out texts, most recently used first
+    mutable LayoutList layouts;
+    mutable std::unordered_map<LayoutKey, LayoutList::iterator, LayoutKeyHasher> layoutCache;
+    unsigned maxLayoutCacheSize;
+    mutable LayoutCacheStats layoutCacheStats;
 
     /// Get width of the sequence defined by the begin/end pair of iterators
     template<bool T_unlimitedWidth>
@@ -20,6 +20,7 @@
 #include "Loader.h"
 #include "drivers/VideoDriverWrapper.h"
 #include "ogl/glBitmapItem.h"
+#include "ogl/glSpriteAtlas.h"
 #include "libsiedler2/ArchivItem_Bitmap.h"
 #include "libsiedler2/ArchivItem_Bitmap_Player.h"
 #include "libsiedler2/PixelBufferBGRA.h"
@@ -34,7 +35,9 @@ struct GL_RGBAColor
 };
 } // namespace
 
-glSmartBitmap::glSmartBitmap() : origin_(0, 0), size_(0, 0), sharedTexture(false), texture(0), hasPlayer(false) {}
+glSmartBitmap::glSmartBitmap()
+    : origin_(0, 0), size_(0, 0), sharedTexture(false), texture(0), hasPlayer(false), atlas_(nullptr), atlasPage_(NO_ATLAS_PAGE)
+{}
 
 glSmartBitmap::~glSmartBitmap()
 {
@@ -43,6 +46,11 @@ glSmartBitmap::~glSmartBitmap()
 
 void glSmartBitmap::reset()
 {
+    if(atlas_)
+    {
+        atlas_->remove(*this);
+        atlas_ = nullptr;
+    }
     if(texture && !sharedTexture)
         VIDEODRIVER.DeleteTexture(texture);
     texture = 0;
@@ -55,6 +63,16 @@ void glSmartBitmap::reset()
     items.clear();
 }
 
+void glSmartBitmap::setAtlas(glSpriteAtlas* atlas)
+{
+    if(atlas_)
+        atlas_->remove(*this);
+    if(texture && !sharedTexture)
+        VIDEODRIVER.DeleteTexture(texture);
+    texture = 0;
+    atlas_ = atlas;
+}
+
 Extent glSmartBitmap::getRequiredTexSize() const
 {
     Extent texSize(size_);
@@ -252,6 +270,9 @@ void glSmartBitmap::draw(DrawPoint drawPt, unsigned color, unsigned player_color
 
 void glSmartBitmap::drawPercent(DrawPoint drawPt, unsigned percent, unsigned color, unsigned player_color)
 {
+    // If the bitmap can't be put into the atlas an own texture is generated below
+    if(atlas_)
+        atlas_->acquire(*this);
     if(!texture)
     {
         generateTexture();
@@ -32,9 +32,12 @@ class PixelBufferBGRA;
 } // namespace libsiedler2
 
 class glBitmapItem;
+class glSpriteAtlas;
 
 class glSmartBitmap : public ITexture
 {
+    friend class glSpriteAtlas;
+
 private:
     DrawPoint origin_;
     Extent size_;
@@ -46,6 +49,11 @@ private:
 
     std::vector<glBitmapItem> items;
 
+    /// Atlas used to get a texture on demand (if any) and the index of the page this is on
+    glSpriteAtlas* atlas_;
+    unsigned atlasPage_;
+    static constexpr unsigned NO_ATLAS_PAGE = 0xFFFFFFFF;
+
     /// Calculate size, origin and hasPlayer based on current images
     void calcDimensions();
 
@@ -71,6 +79,8 @@ public:
         sharedTexture = (tex != 0);
     }
     unsigned getTexture() const { return texture; }
+    /// Use the given atlas to pack this bitmap when it is drawn instead of creating an own texture
+    void setAtlas(glSpriteAtlas* atlas);
 
     void generateTexture();
     void DrawFull(const Position& dstPos, unsigned color = 0xFFFFFFFF) override { draw(dstPos, color); }
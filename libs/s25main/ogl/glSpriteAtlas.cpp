@@ -0,0 +1,150 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "glSpriteAtlas.h"
+#include "ogl/glSmartBitmap.h"
+#include "ogl/glTexturePackerNode.h"
+#include "libsiedler2/PixelBufferBGRA.h"
+#include <algorithm>
+
+glSpriteAtlas::glSpriteAtlas(uint64_t memoryBudget, const Extent& pageSize)
+    : memoryBudget_(memoryBudget), pageSize_(pageSize), useCounter_(0)
+{}
+
+glSpriteAtlas::~glSpriteAtlas()
+{
+    clear();
+}
+
+bool glSpriteAtlas::Page::allocate(const Extent& size, const Extent& pageSize, Extent& pos)
+{
+    Extent curPos(curX, shelfY);
+    unsigned curShelfHeight = shelfHeight;
+    // Start a new shelf if the current one is full
+    if(curPos.x + size.x > pageSize.x)
+    {
+        curPos = Extent(0, shelfY + shelfHeight);
+        curShelfHeight = 0;
+    }
+    if(curPos.x + size.x > pageSize.x || curPos.y + size.y > pageSize.y)
+        return false;
+    pos = curPos;
+    curX = curPos.x + size.x;
+    shelfY = curPos.y;
+    shelfHeight = std::max(curShelfHeight, size.y);
+    return true;
+}
+
+bool glSpriteAtlas::acquire(glSmartBitmap& bmp)
+{
+    RTTR_Assert(bmp.atlas_ == this);
+    if(bmp.atlasPage_ != glSmartBitmap::NO_ATLAS_PAGE)
+    {
+        pages_[bmp.atlasPage_]->lastUse = ++useCounter_;
+        ++stats_.numHits;
+        return true;
+    }
+    // Already using an own texture as it didn't fit
+    if(bmp.empty() || (bmp.texture && !bmp.sharedTexture))
+        return false;
+    const Extent size = bmp.getRequiredTexSize();
+    if(size.x > pageSize_.x || size.y > pageSize_.y)
+        return false;
+
+    ++stats_.numMisses;
+    Extent pos;
+    const unsigned pageIdx = getPageWithSpace(size, pos);
+    if(pageIdx == glSmartBitmap::NO_ATLAS_PAGE)
+        return false;
+    Page& page = *pages_[pageIdx];
+
+    libsiedler2::PixelBufferBGRA buffer(size.x, size.y);
+    bmp.drawTo(buffer);
+    if(!page.texture.uploadSubData(buffer, pos))
+        return false;
+
+    glTexturePackerNode::setTexCoords(bmp, pos, pageSize_);
+    bmp.setSharedTexture(page.texture.get());
+    bmp.atlasPage_ = pageIdx;
+    page.bmps.push_back(&bmp);
+    page.lastUse = ++useCounter_;
+    return true;
+}
+
+void glSpriteAtlas::remove(glSmartBitmap& bmp)
+{
+    if(bmp.atlasPage_ == glSmartBitmap::NO_ATLAS_PAGE)
+        return;
+    std::vector<glSmartBitmap*>& bmps = pages_[bmp.atlasPage_]->bmps;
+    bmps.erase(std::remove(bmps.begin(), bmps.end(), &bmp), bmps.end());
+    bmp.atlasPage_ = glSmartBitmap::NO_ATLAS_PAGE;
+    bmp.setSharedTexture(0);
+}
+
+void glSpriteAtlas::clear()
+{
+    for(const auto& page : pages_)
+        clearPage(*page);
+    pages_.clear();
+}
+
+uint64_t glSpriteAtlas::getMemoryUsage() const
+{
+    return static_cast<uint64_t>(pages_.size()) * pageSize_.x * pageSize_.y * 4u;
+}
+
+unsigned glSpriteAtlas::getPageWithSpace(const Extent& size, Extent& pos)
+{
+    for(unsigned i = 0; i < pages_.size(); i++)
+    {
+        if(pages_[i]->allocate(size, pageSize_, pos))
+            return i;
+    }
+    unsigned pageIdx;
+    const uint64_t pageMemory = static_cast<uint64_t>(pageSize_.x) * pageSize_.y * 4u;
+    if(pages_.empty() || getMemoryUsage() + pageMemory <= memoryBudget_)
+    {
+        auto page = std::make_unique<Page>();
+        if(!page->texture.uploadData(libsiedler2::PixelBufferBGRA(pageSize_.x, pageSize_.y)))
+            return glSmartBitmap::NO_ATLAS_PAGE;
+        pageIdx = pages_.size();
+        pages_.emplace_back(std::move(page));
+    } else
+    {
+        // Budget exceeded -> Reuse the least recently used page
+        const auto itLRU =
+          std::min_element(pages_.begin(), pages_.end(), [](const auto& lhs, const auto& rhs) { return lhs->lastUse < rhs->lastUse; });
+        clearPage(**itLRU);
+        ++stats_.numEvictions;
+        pageIdx = static_cast<unsigned>(std::distance(pages_.begin(), itLRU));
+    }
+    if(!pages_[pageIdx]->allocate(size, pageSize_, pos))
+        return glSmartBitmap::NO_ATLAS_PAGE;
+    return pageIdx;
+}
+
+void glSpriteAtlas::clearPage(Page& page)
+{
+    for(glSmartBitmap* bmp : page.bmps)
+    {
+        bmp->atlasPage_ = glSmartBitmap::NO_ATLAS_PAGE;
+        bmp->setSharedTexture(0);
+    }
+    page.bmps.clear();
+    page.shelfY = page.shelfHeight = page.curX = 0;
+}
@@ -0,0 +1,93 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef glSpriteAtlas_h__
+#define glSpriteAtlas_h__
+
+#include "Point.h"
+#include "ogl/glTexturePacker.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class glSmartBitmap;
+
+/// Shared texture for glSmartBitmaps that are only packed when they are drawn for the first time.
+/// Bitmaps are put onto fixed size pages. If the memory budget is reached, the least recently used page is cleared
+/// and reused. Its bitmaps are packed again when they are drawn the next time.
+/// The atlas must outlive all bitmaps using it.
+class glSpriteAtlas
+{
+public:
+    struct Stats
+    {
+        /// Number of draws of bitmaps already on a page
+        uint64_t numHits = 0;
+        /// Number of draws requiring to pack the bitmap onto a page
+        uint64_t numMisses = 0;
+        /// Number of cleared pages
+        uint64_t numEvictions = 0;
+    };
+
+    explicit glSpriteAtlas(uint64_t memoryBudget = 0, const Extent& pageSize = Extent(1024, 1024));
+    ~glSpriteAtlas();
+
+    /// Make sure the bitmap is on a page and mark the page as used.
+    /// Returns false if the bitmap cannot be put onto a page (e.g. it is to big)
+    bool acquire(glSmartBitmap& bmp);
+    /// Remove the bitmap from its page. The space will be reused when the page is cleared
+    void remove(glSmartBitmap& bmp);
+    /// Remove all bitmaps and free all pages
+    void clear();
+
+    /// Set the maximum memory in bytes used for all pages. At least one page is always used
+    void setMemoryBudget(uint64_t memoryBudget) { memoryBudget_ = memoryBudget; }
+    unsigned getNumPages() const { return pages_.size(); }
+    /// Memory in bytes used by all pages
+    uint64_t getMemoryUsage() const;
+    const Stats& getStats() const { return stats_; }
+    void resetStats() { stats_ = Stats(); }
+
+private:
+    struct Page
+    {
+        glTexture texture;
+        std::vector<glSmartBitmap*> bmps;
+        /// Value of the use counter when the page was last used
+        uint64_t lastUse = 0;
+        /// Bitmaps are put in rows (shelves) from left to right
+        unsigned shelfY = 0, shelfHeight = 0, curX = 0;
+
+        /// Reserve space for a bitmap of the given size. Return false if there is no space left
+        bool allocate(const Extent& size, const Extent& pageSize, Extent& pos);
+    };
+
+    /// Find a page with enough space for the size, creating or clearing one if required.
+    /// Returns the index of the page or glSmartBitmap::NO_ATLAS_PAGE on failure
+    unsigned getPageWithSpace(const Extent& size, Extent& pos);
+    /// Remove all bitmaps from the page so it can be reused
+    static void clearPage(Page& page);
+
+    uint64_t memoryBudget_;
+    Extent pageSize_;
+    std::vector<std::unique_ptr<Page>> pages_;
+    /// Incremented on every use of a page. 64 bit so it never wraps around, which would break the LRU order
+    uint64_t useCounter_;
+    Stats stats_;
+};
+
+#endif // glSpriteAtlas_h__
@@ -22,10 +22,63 @@
 #include "ogl/glTexturePackerNode.h"
 #include "ogl/saveBitmap.h"
 #include "libsiedler2/PixelBufferBGRA.h"
+#include "s25util/BinaryFile.h"
+#include "s25util/Log.h"
 #include <glad/glad.h>
+#include <boost/endian/arithmetic.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <algorithm>
+#include <array>
+#include <cstring>
+#include <map>
+#include <stdexcept>
 #include <utility>
 
+namespace {
+const char* const CACHE_SIGNATURE = "RTTRTEXC";
+constexpr unsigned CACHE_SIGNATURE_LEN = 8;
+constexpr uint16_t CACHE_VERSION = 2;
+
+// All values are stored little endian so the file can be read directly from memory
+void writeUInt(BinaryFile& file, unsigned value)
+{
+    const boost::endian::little_uint32_t leValue(value);
+    file.WriteRawData(&leValue, sizeof(leValue));
+}
+
+/// Reads the values of a memory-mapped cache file
+class CacheReader
+{
+    const char* cur_;
+    const char* const end_;
+
+public:
+    explicit CacheReader(const boost::iostreams::mapped_file_source& file) : cur_(file.data()), end_(file.data() + file.size()) {}
+
+    /// Return a pointer to the next len bytes and skip them
+    const char* readRaw(size_t len)
+    {
+        if(len > static_cast<size_t>(end_ - cur_))
+            throw std::range_error("Texture cache is truncated");
+        const char* result = cur_;
+        cur_ += len;
+        return result;
+    }
+    template<typename T>
+    T read()
+    {
+        T value;
+        std::memcpy(&value, readRaw(sizeof(value)), sizeof(value));
+        return value;
+    }
+    unsigned readUInt() { return read<boost::endian::little_uint32_t>(); }
+};
+} // namespace
+
+glTexturePacker::glTexturePacker() = default;
+glTexturePacker::~glTexturePacker() = default;
+
 static bool isSizeGreater(glSmartBitmap* a, glSmartBitmap* b)
 {
     const Extent sizeA = a->getRequiredTexSize();
@@ -74,12 +127,14 @@ bool glTexturePacker::packHelper(std::vector<glSmartBitmap*>& list)
             // list to store bitmaps we could not fit in our current texture
             std::vector<glSmartBitmap*> left;
 
-            libsiedler2::PixelBufferBGRA buffer(curSize.x, curSize.y);
+            auto buffer = std::make_unique<libsiedler2::PixelBufferBGRA>(curSize.x, curSize.y);
+            PackedTexture packedTexture;
 
             // try storing bitmaps in the big texture
             for(glSmartBitmap* bmp : list)
             {
-                if(!root->insert(bmp, buffer, tmpVec))
+                Extent pos;
+                if(!root->insert(bmp, *buffer, tmpVec, &pos))
                 {
                     // inserting this bitmap failed? just remember it for next texture
                     left.push_back(bmp);
@@ -87,21 +142,29 @@ bool glTexturePacker::packHelper(std::vector<glSmartBitmap*>& list)
                 {
                     // tell or glSmartBitmap, that it uses a shared texture (so it won't try to delete/free it)
                     bmp->setSharedTexture(texture.get());
+                    if(keepPackedData)
+                        packedTexture.placements.emplace_back(bmp, pos);
                 }
             }
             if((false))
             {
                 bfs::path outFilepath =
                   std::to_string(texture.get()) + "-" + std::to_string(curSize.x) + "x" + std::to_string(curSize.y) + ".bmp";
-                saveBitmap(buffer, outFilepath);
+                saveBitmap(*buffer, outFilepath);
             }
             // free texture packer, as it is not needed any more
             root->destroy(list.size());
             delete root;
 
-            if(!texture.uploadData(buffer))
+            if(!texture.uploadData(*buffer))
                 return false;
 
+            if(keepPackedData && (left.empty() || maxTex))
+            {
+                packedTexture.buffer = std::move(buffer);
+                packedTextures.emplace_back(std::move(packedTexture));
+            }
+
             if(left.empty()) // nothing left, just generate texture and return success
             {
                 textures.emplace_back(std::move(texture));
@@ -139,10 +202,133 @@ bool glTexturePacker::pack()
         bmp->setSharedTexture(0);
 
     textures.clear();
+    packedTextures.clear();
 
     return false;
 }
 
+bool glTexturePacker::pack(const boost::filesystem::path& cacheFilePath)
+{
+    std::sort(items.begin(), items.end(), isSizeGreater);
+
+    if(bfs::exists(cacheFilePath))
+    {
+        if(loadCache(cacheFilePath))
+            return true;
+        LOG.write("Texture cache %1% is outdated or invalid. Recreating it\n") % cacheFilePath.string();
+    }
+
+    keepPackedData = true;
+    const bool result = pack();
+    keepPackedData = false;
+    if(result && !saveCache(cacheFilePath))
+        LOG.write("Could not write texture cache %1%\n") % cacheFilePath.string();
+    packedTextures.clear();
+    return result;
+}
+
+bool glTexturePacker::loadCache(const boost::filesystem::path& cacheFilePath)
+{
+    std::vector<glTexture> cachedTextures;
+    try
+    {
+        // The pixel data is uploaded straight from the mapped file without copying it
+        boost::iostreams::mapped_file_source file(cacheFilePath);
+        CacheReader reader(file);
+        if(!std::equal(CACHE_SIGNATURE, CACHE_SIGNATURE + CACHE_SIGNATURE_LEN, reader.readRaw(CACHE_SIGNATURE_LEN))
+           || reader.read<boost::endian::little_uint16_t>() != CACHE_VERSION)
+            return false;
+        // Check that the cache was created for the same bitmaps (in the same order)
+        if(reader.readUInt() != items.size())
+            return false;
+        for(const glSmartBitmap* bmp : items)
+        {
+            const Extent texSize = bmp->getRequiredTexSize();
+            if(reader.readUInt() != texSize.x || reader.readUInt() != texSize.y)
+                return false;
+        }
+
+        const unsigned numTextures = reader.readUInt();
+        std::vector<Extent> textureSizes;
+        for(unsigned i = 0; i < numTextures; i++)
+        {
+            Extent size;
+            size.x = reader.readUInt();
+            size.y = reader.readUInt();
+            const char* pixels = reader.readRaw(static_cast<size_t>(size.x) * size.y * 4u);
+            glTexture texture;
+            if(!texture.uploadData(size, pixels))
+                return false;
+            cachedTextures.emplace_back(std::move(texture));
+            textureSizes.push_back(size);
+        }
+        for(glSmartBitmap* bmp : items)
+        {
+            const unsigned texIdx = reader.readUInt();
+            Extent pos;
+            pos.x = reader.readUInt();
+            pos.y = reader.readUInt();
+            if(texIdx >= cachedTextures.size())
+                throw std::range_error("Invalid texture index");
+            glTexturePackerNode::setTexCoords(*bmp, pos, textureSizes[texIdx]);
+            bmp->setSharedTexture(cachedTextures[texIdx].get());
+        }
+    } catch(const std::exception&)
+    {
+        for(glSmartBitmap* bmp : items)
+            bmp->setSharedTexture(0);
+        return false;
+    }
+    textures = std::move(cachedTextures);
+    return true;
+}
+
+bool glTexturePacker::saveCache(const boost::filesystem::path& cacheFilePath) const
+{
+    boost::system::error_code ec;
+    bfs::create_directories(cacheFilePath.parent_path(), ec);
+    BinaryFile file;
+    if(!file.Open(cacheFilePath.string(), OFM_WRITE))
+        return false;
+
+    std::map<const glSmartBitmap*, std::pair<unsigned, Extent>> placements;
+    for(unsigned i = 0; i < packedTextures.size(); i++)
+    {
+        for(const auto& placement : packedTextures[i].placements)
+            placements[placement.first] = std::make_pair(i, placement.second);
+    }
+    if(placements.size() != items.size())
+        return false;
+
+    file.WriteRawData(CACHE_SIGNATURE, CACHE_SIGNATURE_LEN);
+    const boost::endian::little_uint16_t version(CACHE_VERSION);
+    file.WriteRawData(&version, sizeof(version));
+    writeUInt(file, items.size());
+    for(const glSmartBitmap* bmp : items)
+    {
+        const Extent texSize = bmp->getRequiredTexSize();
+        writeUInt(file, texSize.x);
+        writeUInt(file, texSize.y);
+    }
+    writeUInt(file, packedTextures.size());
+    for(const PackedTexture& packedTexture : packedTextures)
+    {
+        const libsiedler2::PixelBufferBGRA& buffer = *packedTexture.buffer;
+        writeUInt(file, buffer.getWidth());
+        writeUInt(file, buffer.getHeight());
+        file.WriteRawData(buffer.getPixelPtr(), buffer.getWidth() * buffer.getHeight() * 4u);
+    }
+    for(const glSmartBitmap* bmp : items)
+    {
+        const auto& placement = placements[bmp];
+        writeUInt(file, placement.first);
+        writeUInt(file, placement.second.x);
+        writeUInt(file, placement.second.y);
+    }
+    file.Flush();
+    return true;
+}
+
 glTexture::glTexture() : handle(VIDEODRIVER.GenerateTexture()), size(0, 0)
 {
     if(!handle)
@@ -187,13 +373,27 @@ bool glTexture::checkSize(const Extent& size)
 }
 
 bool glTexture::uploadData(const libsiedler2::PixelBufferBGRA& buffer)
+{
+    return uploadData(Extent(buffer.getWidth(), buffer.getHeight()), buffer.getPixelPtr());
+}
+
+bool glTexture::uploadData(const Extent& newSize, const void* bgraPixels)
 {
     if(!handle)
         return false;
     VIDEODRIVER.BindTexture(handle);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, buffer.getWidth(), buffer.getHeight(), 0, GL_BGRA, GL_UNSIGNED_BYTE, buffer.getPixelPtr());
-    size = Extent(buffer.getWidth(), buffer.getHeight());
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, newSize.x, newSize.y, 0, GL_BGRA, GL_UNSIGNED_BYTE, bgraPixels);
+    size = newSize;
     int resultWidth;
     glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &resultWidth);
     return resultWidth > 0;
 }
+
+bool glTexture::uploadSubData(const libsiedler2::PixelBufferBGRA& buffer, const Extent& pos)
+{
+    if(!handle || pos.x + buffer.getWidth() > size.x || pos.y + buffer.getHeight() > size.y)
+        return false;
+    VIDEODRIVER.BindTexture(handle);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, pos.x, pos.y, buffer.getWidth(), buffer.getHeight(), GL_BGRA, GL_UNSIGNED_BYTE, buffer.getPixelPtr());
+    return true;
+}
@@ -19,6 +19,8 @@
 #define glTexturePacker_h__
 
 #include "Point.h"
+#include <boost/filesystem/path.hpp>
+#include <memory>
 #include <vector>
 
 class glSmartBitmap;
@@ -47,18 +49,39 @@ public:
     void bind();
     bool checkSize(const Extent&);
     bool uploadData(const libsiedler2::PixelBufferBGRA&);
+    /// Upload pixels in BGRA format, 4 bytes per pixel without padding
+    bool uploadData(const Extent& newSize, const void* bgraPixels);
+    /// Overwrite a part of the (already uploaded) texture starting at pos
+    bool uploadSubData(const libsiedler2::PixelBufferBGRA&, const Extent& pos);
 };
 
 class glTexturePacker
 {
 private:
+    /// Pixel data and placements of a packed texture. Only kept while a cache is written
+    struct PackedTexture
+    {
+        std::unique_ptr<libsiedler2::PixelBufferBGRA> buffer;
+        std::vector<std::pair<const glSmartBitmap*, Extent>> placements;
+    };
+
     std::vector<glTexture> textures;
     std::vector<glSmartBitmap*> items;
+    std::vector<PackedTexture> packedTextures;
+    bool keepPackedData = false;
 
     bool packHelper(std::vector<glSmartBitmap*>& list);
+    /// Restore the textures from a cache file written by saveCache. Fails if the cache does not match the current items
+    bool loadCache(const boost::filesystem::path& cacheFilePath);
+    bool saveCache(const boost::filesystem::path& cacheFilePath) const;
 
 public:
+    glTexturePacker();
+    ~glTexturePacker();
+
     bool pack();
+    /// Same as pack() but uses the pixel data from the cache file if it is valid and (re)creates it otherwise
+    bool pack(const boost::filesystem::path& cacheFilePath);
     void add(glSmartBitmap& bmp) { items.push_back(&bmp); }
     const auto& getTextures() const { return textures; }
 };
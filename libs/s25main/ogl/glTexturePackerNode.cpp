@@ -20,7 +20,8 @@
 #include "ogl/glSmartBitmap.h"
 #include "libsiedler2/PixelBufferBGRA.h"
 
-bool glTexturePackerNode::insert(glSmartBitmap* b, libsiedler2::PixelBufferBGRA& buffer, std::vector<glTexturePackerNode*>& todo)
+bool glTexturePackerNode::insert(glSmartBitmap* b, libsiedler2::PixelBufferBGRA& buffer, std::vector<glTexturePackerNode*>& todo,
+                                 Extent* insertPos)
 {
     todo.clear();
 
@@ -52,24 +53,9 @@ bool glTexturePackerNode::insert(glSmartBitmap* b, libsiedler2::PixelBufferBGRA&
         {
             b->drawTo(buffer, current->pos);
             current->bmp = b;
-
-            const Point<float> bufferSize(buffer.getWidth(), buffer.getHeight());
-            Extent currentSize(current->size);
-            if(b->isPlayer())
-                currentSize.x /= 2;
-
-            b->texCoords[0] = current->pos / bufferSize;
-            b->texCoords[2] = (current->pos + currentSize) / bufferSize;
-            b->texCoords[1] = {b->texCoords[0].x, b->texCoords[2].y};
-            b->texCoords[3] = {b->texCoords[2].x, b->texCoords[0].y};
-
-            if(b->isPlayer())
-            {
-                b->texCoords[4] = b->texCoords[3];
-                b->texCoords[6] = (current->pos + current->size) / bufferSize;
-                b->texCoords[5] = {b->texCoords[4].x, b->texCoords[6].y};
-                b->texCoords[7] = {b->texCoords[6].x, b->texCoords[4].y};
-            }
+            setTexCoords(*b, current->pos, Extent(buffer.getWidth(), buffer.getHeight()));
+            if(insertPos)
+                *insertPos = current->pos;
             return true;
         }
 
@@ -102,6 +88,28 @@ bool glTexturePackerNode::insert(glSmartBitmap* b, libsiedler2::PixelBufferBGRA&
     return false;
 }
 
+void glTexturePackerNode::setTexCoords(glSmartBitmap& b, const Extent& pos, const Extent& textureSize)
+{
+    const Point<float> bufferSize(textureSize);
+    const Extent size = b.getRequiredTexSize();
+    Extent halfSize(size);
+    if(b.isPlayer())
+        halfSize.x /= 2;
+
+    b.texCoords[0] = pos / bufferSize;
+    b.texCoords[2] = (pos + halfSize) / bufferSize;
+    b.texCoords[1] = {b.texCoords[0].x, b.texCoords[2].y};
+    b.texCoords[3] = {b.texCoords[2].x, b.texCoords[0].y};
+
+    if(b.isPlayer())
+    {
+        b.texCoords[4] = b.texCoords[3];
+        b.texCoords[6] = (pos + size) / bufferSize;
+        b.texCoords[5] = {b.texCoords[4].x, b.texCoords[6].y};
+        b.texCoords[7] = {b.texCoords[6].x, b.texCoords[4].y};
+    }
+}
+
 void glTexturePackerNode::destroy(unsigned reserve)
 {
     std::vector<glTexturePackerNode*> todo;
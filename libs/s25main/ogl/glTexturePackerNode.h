@@ -41,7 +41,11 @@ public:
     glTexturePackerNode(const Extent& size) : pos(0, 0), size(size), bmp(nullptr) { child[0] = child[1] = nullptr; }
     /// Find a position in the buffer to draw the bitmap starting at this node
     /// todo list is cleared and used to avoid frequent allocations
-    bool insert(glSmartBitmap* b, libsiedler2::PixelBufferBGRA& buffer, std::vector<glTexturePackerNode*>& todo);
+    /// If insertPos is given, it receives the position the bitmap was drawn at
+    bool insert(glSmartBitmap* b, libsiedler2::PixelBufferBGRA& buffer, std::vector<glTexturePackerNode*>& todo,
+                Extent* insertPos = nullptr);
+    /// Set the texture coordinates of a bitmap placed at pos in a texture of the given size
+    static void setTexCoords(glSmartBitmap& b, const Extent& pos, const Extent& textureSize);
     void destroy(unsigned reserve = 0);
 };
 
@@ -0,0 +1,75 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "glWindowCache.h"
+#include "Point.h"
+#include "drivers/VideoDriverWrapper.h"
+#include <glad/glad.h>
+#include <array>
+
+bool glWindowCache::capture(const Rect& screenRect)
+{
+    isValid_ = false;
+    if(!texture_)
+        return false;
+    const Extent renderSize = VIDEODRIVER.GetRenderSize();
+    if(screenRect.left < 0 || screenRect.top < 0 || screenRect.right > static_cast<int>(renderSize.x)
+       || screenRect.bottom > static_cast<int>(renderSize.y))
+        return false;
+    const Extent size = screenRect.getSize();
+    if(size.x == 0 || size.y == 0)
+        return false;
+
+    texture_.bind();
+    if(texSize_.x < size.x || texSize_.y < size.y)
+    {
+        texSize_ = VIDEODRIVER.calcPreferredTextureSize(elMax(size, texSize_));
+        // Windows are opaque so no alpha channel is required
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, texSize_.x, texSize_.y, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+    }
+    // The framebuffer rows start at the bottom, so the texture contains the area upside down
+    glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, screenRect.left, static_cast<int>(renderSize.y) - screenRect.bottom, size.x, size.y);
+    size_ = size;
+    isValid_ = true;
+    return true;
+}
+
+void glWindowCache::draw(const DrawPoint& pos)
+{
+    RTTR_Assert(isValid_);
+    const Rect dstArea(pos, size_);
+    const GLfloat texRight = static_cast<GLfloat>(size_.x) / texSize_.x;
+    const GLfloat texTop = static_cast<GLfloat>(size_.y) / texSize_.y;
+
+    std::array<Point<GLfloat>, 4> texCoords, vertices;
+    vertices[0].x = vertices[1].x = GLfloat(dstArea.left);
+    vertices[2].x = vertices[3].x = GLfloat(dstArea.right);
+    vertices[0].y = vertices[3].y = GLfloat(dstArea.top);
+    vertices[1].y = vertices[2].y = GLfloat(dstArea.bottom);
+
+    texCoords[0].x = texCoords[1].x = 0.f;
+    texCoords[2].x = texCoords[3].x = texRight;
+    texCoords[0].y = texCoords[3].y = texTop;
+    texCoords[1].y = texCoords[2].y = 0.f;
+
+    glVertexPointer(2, GL_FLOAT, 0, vertices.data());
+    glTexCoordPointer(2, GL_FLOAT, 0, texCoords.data());
+    texture_.bind();
+    glColor4ub(0xFF, 0xFF, 0xFF, 0xFF);
+    glDrawArrays(GL_QUADS, 0, 4);
+}
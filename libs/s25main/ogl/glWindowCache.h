@@ -0,0 +1,47 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef glWindowCache_h__
+#define glWindowCache_h__
+
+#include "DrawPoint.h"
+#include "Rect.h"
+#include "ogl/glTexturePacker.h"
+
+/// Copy of a rectangular area of the back buffer in a texture.
+/// Used to compose unchanged windows with a single textured quad instead of drawing all their controls
+class glWindowCache
+{
+public:
+    /// Copy the given area of the back buffer. Returns false if it is not fully on screen
+    bool capture(const Rect& screenRect);
+    /// Draw the captured area with its top left corner at the given position
+    void draw(const DrawPoint& pos);
+    /// Return true if a capture of the given size is available
+    bool isValid(const Extent& size) const { return isValid_ && size == size_; }
+    void invalidate() { isValid_ = false; }
+
+private:
+    glTexture texture_;
+    /// Size of the allocated texture (power of 2 if required)
+    Extent texSize_ = Extent(0, 0);
+    /// Size of the captured area
+    Extent size_ = Extent(0, 0);
+    bool isValid_ = false;
+};
+
+#endif // glWindowCache_h__
@@ -23,17 +23,14 @@
 #include "pathfinding/PathfindingPoint.h"
 #include "world/GameWorldBase.h"
 #include "s25util/Log.h"
+#include <algorithm>
+#include <queue>
+#include <utility>
 
 //////////////////////////////////////////////////////////////////////////
 /// FreePathFinder implementation
 //////////////////////////////////////////////////////////////////////////
 
-/// MapNodes
-using MapNodes = std::vector<NewNode>;
-using FreePathNodes = std::vector<FreePathNode>;
-MapNodes nodes;
-FreePathNodes fpNodes;
-
 void FreePathFinder::Init(const MapExtent& mapSize)
 {
     currentVisit = 0;
@@ -264,3 +261,129 @@ bool FreePathFinder::FindPathAlternatingConditions(const MapPoint start, const M
     // Liste leer und kein Ziel erreicht --> kein Weg
     return false;
 }
+
+std::vector<std::vector<Direction>> FreePathFinder::FindPathsAlternatingConditions(const MapPoint start, const std::vector<MapPoint>& dests,
+                                                                                   const unsigned maxLength, FP_Node_OK_Callback IsNodeOK,
+                                                                                   FP_Node_OK_Callback IsNodeOKAlternate, const void* param)
+{
+    std::vector<std::vector<Direction>> routes(dests.size());
+    // Node ids of the destinations and their index in dests
+    std::vector<std::pair<unsigned, unsigned>> destIds;
+    for(unsigned i = 0; i < dests.size(); i++)
+    {
+        if(dests[i] != start)
+            destIds.push_back(std::make_pair(gwb_.GetIdx(dests[i]), i));
+    }
+    unsigned numDestsLeft = destIds.size();
+    if(!numDestsLeft)
+        return routes;
+
+    IncreaseCurrentVisit();
+
+    // Same breadth first search as in FindPathAlternatingConditions which switches the conditions with every layer
+    std::queue<unsigned> todo;
+    bool prevStepEven = true;
+    unsigned stepsTilSwitch = 1;
+
+    const unsigned startId = gwb_.GetIdx(start);
+    todo.push(startId);
+    nodes[startId].prevEven = INVALID_PREV;
+    nodes[startId].lastVisitedEven = currentVisit;
+    nodes[startId].wayEven = 0;
+
+    while(!todo.empty() && numDestsLeft > 0)
+    {
+        if(!stepsTilSwitch)
+        {
+            prevStepEven = !prevStepEven;
+            stepsTilSwitch = todo.size();
+        }
+        stepsTilSwitch--;
+
+        const unsigned bestId = todo.front();
+        todo.pop();
+
+        if((prevStepEven && nodes[bestId].wayEven == maxLength) || (!prevStepEven && nodes[bestId].way == maxLength))
+            continue;
+
+        for(unsigned z = 3; z < 9; ++z)
+        {
+            Direction dir(z);
+            const MapPoint neighbourPos = gwb_.GetNeighbour(nodes[bestId].mapPt, dir);
+            const unsigned nbId = gwb_.GetIdx(neighbourPos);
+
+            if((prevStepEven && nodes[nbId].lastVisited == currentVisit) || (!prevStepEven && nodes[nbId].lastVisitedEven == currentVisit))
+                continue;
+
+            const auto itDest =
+              std::find_if(destIds.begin(), destIds.end(), [nbId](const std::pair<unsigned, unsigned>& it) { return it.first == nbId; });
+            const bool isDest = itDest != destIds.end();
+
+            // Check additional constraints for non-destination points
+            if(!isDest)
+            {
+                if(prevStepEven)
+                {
+                    if(!IsNodeOK(gwb_, neighbourPos, dir, param))
+                        continue;
+                } else
+                {
+                    if(!IsNodeOKAlternate(gwb_, neighbourPos, dir, param))
+                        continue;
+                    MapPoint p = nodes[bestId].mapPt;
+
+                    bool tooClose = false;
+                    bool alternate = false;
+                    unsigned back_id = bestId;
+                    // backtrack the plannend route and check if another "even" position is too close
+                    for(unsigned i = nodes[bestId].way - 1; i > 1 && !tooClose; i--)
+                    {
+                        Direction pdir = alternate ? nodes[back_id].dirEven : nodes[back_id].dir;
+                        p = gwb_.GetNeighbour(p, pdir + 3u);
+                        if(i % 2 == 0 && gwb_.CalcDistance(neighbourPos, p) < 2)
+                            tooClose = true;
+                        back_id = alternate ? nodes[back_id].prevEven : nodes[back_id].prev;
+                        alternate = !alternate;
+                    }
+                    if(tooClose || gwb_.CalcDistance(neighbourPos, start) < 2)
+                        continue;
+                }
+            }
+
+            if(prevStepEven)
+            {
+                nodes[nbId].lastVisited = currentVisit;
+                nodes[nbId].way = nodes[bestId].wayEven + 1;
+                nodes[nbId].dir = dir;
+                nodes[nbId].prev = bestId;
+            } else
+            {
+                nodes[nbId].lastVisitedEven = currentVisit;
+                nodes[nbId].wayEven = nodes[bestId].way + 1;
+                nodes[nbId].dirEven = dir;
+                nodes[nbId].prevEven = bestId;
+            }
+
+            if(!isDest)
+            {
+                todo.push(nbId);
+                continue;
+            }
+            std::vector<Direction>& route = routes[itDest->second];
+            if(!route.empty())
+                continue;
+            // Reconstruct route. The node was reached by the other layer type, so alternate is inverted
+            const unsigned routeLen = prevStepEven ? nodes[nbId].way : nodes[nbId].wayEven;
+            route.resize(routeLen);
+            bool alternate = !prevStepEven;
+            for(unsigned z2 = routeLen - 1, curId = nbId; curId != startId; --z2)
+            {
+                route[z2] = alternate ? nodes[curId].dirEven : nodes[curId].dir;
+                curId = alternate ? nodes[curId].prevEven : nodes[curId].prev;
+                alternate = !alternate;
+            }
+            numDestsLeft--;
+        }
+    }
+    return routes;
+}
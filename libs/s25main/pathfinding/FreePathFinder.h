@@ -18,6 +18,7 @@
 #ifndef FreePathFinder_h__
 #define FreePathFinder_h__
 
+#include "pathfinding/NewNode.h"
 #include "gameTypes/Direction.h"
 #include "gameTypes/MapCoordinates.h"
 #include <vector>
@@ -35,6 +36,9 @@ class FreePathFinder
     GameWorldBase& gwb_;
     unsigned currentVisit;
     Extent size_;
+    /// Nodes used by the searches. Owned by the pathfinder, so each world has its own
+    std::vector<NewNode> nodes;
+    std::vector<FreePathNode> fpNodes;
 
 public:
     FreePathFinder(GameWorldBase& gwb) : gwb_(gwb), currentVisit(0), size_(0, 0) {}
@@ -50,6 +54,12 @@ public:
     bool FindPathAlternatingConditions(MapPoint start, MapPoint dest, bool randomRoute, unsigned maxLength, std::vector<Direction>* route,
                                        unsigned* length, Direction* firstDir, FP_Node_OK_Callback IsNodeOK,
                                        FP_Node_OK_Callback IsNodeOKAlternate, FP_Node_OK_Callback IsNodeToDestOk, const void* param);
+    /// Like FindPathAlternatingConditions (no random route) but searches the paths to all destinations at once.
+    /// Destinations are only used as end points. Returns the route to each destination or an empty route if none was found.
+    /// Note: Unlike the single destination search, this does not check that the alternate nodes are not directly next to the destination
+    std::vector<std::vector<Direction>> FindPathsAlternatingConditions(MapPoint start, const std::vector<MapPoint>& dests,
+                                                                       unsigned maxLength, FP_Node_OK_Callback IsNodeOK,
+                                                                       FP_Node_OK_Callback IsNodeOKAlternate, const void* param);
 
     /// Ermittelt, ob eine freie Route noch passierbar ist und gibt den Endpunkt der Route zurück
     template<class TNodeChecker>
@@ -26,9 +26,6 @@
 #include "pathfinding/PathfindingPoint.h"
 #include "world/GameWorldBase.h"
 
-using FreePathNodes = std::vector<FreePathNode>;
-extern FreePathNodes fpNodes;
-
 struct NodePtrCmpGreater
 {
     bool operator()(const FreePathNode* const lhs, const FreePathNode* const rhs) const
@@ -44,7 +44,8 @@ struct RoadNodeComperatorGreater
 
 using QueueImpl = OpenListPrioQueue<const noRoadNode*, RoadNodeComperatorGreater>;
 using VecImpl = OpenListVector<const noRoadNode*>;
-VecImpl todo;
+/// Open list reused by all searches of the current thread
+thread_local VecImpl todo;
 
 // Namespace with all functors usable as additional cost functors
 namespace AdditonalCosts {
@@ -0,0 +1,178 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef FloodFill_h__
+#define FloodFill_h__
+
+#include "gameTypes/MapCoordinates.h"
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+/// Neighbours of a node used by the flood fills. The map wraps around in both directions.
+enum class FloodFillNeighbors
+{
+    /// Left, right, above and below (as used by the map generator)
+    Orthogonal,
+    /// The 6 neighbours of GetNeighbour: Every 2nd row is shifted by half a node.
+    /// Like on real maps the height must be even, otherwise the rows at the border do not fit together
+    Hexagonal
+};
+
+namespace detail {
+/// Scanline flood fill from start: Takes whole spans of a row at once and only looks at the nodes of the
+/// adjacent rows touching a span. tryTake(pt, idx) must return true exactly once for every node of the
+/// component (i.e. mark it) and false for all other nodes.
+/// Stops after at least maxCount nodes are taken and returns the number of taken nodes
+template<class T_TryTake>
+unsigned FillScanline(const MapExtent& size, FloodFillNeighbors neighbors, MapPoint start, T_TryTake&& tryTake, unsigned maxCount)
+{
+    /// Nodes x ... x + len - 1 (modulo width) of row y
+    struct Span
+    {
+        unsigned y;
+        int x;
+        unsigned len;
+    };
+    const int width = size.x;
+    const auto take = [&tryTake, width](unsigned y, int x) {
+        x %= width;
+        if(x < 0)
+            x += width;
+        return tryTake(MapPoint(x, y), y * width + x);
+    };
+    // Extends the span of the already taken node x to the left and right
+    const auto takeSpan = [&take, &size](unsigned y, int x) {
+        Span span{y, x, 1};
+        while(span.len < size.x && take(y, span.x - 1))
+        {
+            --span.x;
+            ++span.len;
+        }
+        while(span.len < size.x && take(y, span.x + static_cast<int>(span.len)))
+            ++span.len;
+        return span;
+    };
+
+    if(!take(start.y, start.x))
+        return 0;
+    std::vector<Span> todo(1, takeSpan(start.y, start.x));
+    unsigned count = todo.back().len;
+    while(!todo.empty() && count < maxCount)
+    {
+        const Span span = todo.back();
+        todo.pop_back();
+        // Nodes of the rows above and below touching this span
+        int first = span.x;
+        int last = span.x + static_cast<int>(span.len) - 1;
+        if(neighbors == FloodFillNeighbors::Hexagonal)
+        {
+            if(span.y & 1)
+                ++last;
+            else
+                --first;
+        }
+        const int end = first + std::min(last - first + 1, width);
+        for(const unsigned y : {(span.y + size.y - 1) % size.y, (span.y + 1) % size.y})
+        {
+            for(int x = first; x < end; ++x)
+            {
+                if(!take(y, x))
+                    continue;
+                const Span newSpan = takeSpan(y, x);
+                count += newSpan.len;
+                todo.push_back(newSpan);
+                // The node after the span is either not part of the component or already taken
+                x = newSpan.x + static_cast<int>(newSpan.len);
+            }
+        }
+    }
+    return count;
+}
+} // namespace detail
+
+/**
+ * Counts the nodes of the component containing start, i.e. all nodes connected to it for which isPart(pt) is true.
+ * Nodes are only checked as far as required, so this is cheap for small components or a low maxCount.
+ * @param start first node, must be part of the component
+ * @param isPart callable (MapPoint) -> bool
+ * @param maxCount stop counting after this number of nodes
+ * @return size of the component but at most maxCount
+ */
+template<class T_IsPart>
+unsigned CountComponent(const MapExtent& size, FloodFillNeighbors neighbors, MapPoint start, T_IsPart&& isPart,
+                        unsigned maxCount = std::numeric_limits<unsigned>::max())
+{
+    std::vector<bool> visited(prodOfComponents(size), false);
+    const unsigned count = detail::FillScanline(
+      size, neighbors, start,
+      [&visited, &isPart](const MapPoint pt, unsigned idx) {
+          if(visited[idx] || !isPart(pt))
+              return false;
+          visited[idx] = true;
+          return true;
+      },
+      maxCount);
+    return std::min(count, maxCount);
+}
+
+/**
+ * Labels all connected components of nodes for which isPart(pt) is true in one pass.
+ * isPart is called exactly once per node.
+ * @param isPart callable (MapPoint) -> bool
+ * @param labels Receives the label of each node by index: 0 if it is not part of any component,
+ *               else the components are numbered from 1 in the order of their first node (row by row)
+ * @return number of nodes of each component, i.e. result[label - 1]
+ */
+template<class T_IsPart>
+std::vector<unsigned> LabelComponents(const MapExtent& size, FloodFillNeighbors neighbors, T_IsPart&& isPart,
+                                      std::vector<unsigned>& labels)
+{
+    static constexpr unsigned UNLABELED = std::numeric_limits<unsigned>::max();
+
+    labels.resize(prodOfComponents(size));
+    unsigned idx = 0;
+    for(MapPoint pt(0, 0); pt.y < size.y; ++pt.y)
+    {
+        for(pt.x = 0; pt.x < size.x; ++pt.x, ++idx)
+            labels[idx] = isPart(pt) ? UNLABELED : 0u;
+    }
+
+    std::vector<unsigned> componentSizes;
+    idx = 0;
+    for(MapPoint pt(0, 0); pt.y < size.y; ++pt.y)
+    {
+        for(pt.x = 0; pt.x < size.x; ++pt.x, ++idx)
+        {
+            if(labels[idx] != UNLABELED)
+                continue;
+            const auto label = static_cast<unsigned>(componentSizes.size() + 1u);
+            componentSizes.push_back(detail::FillScanline(
+              size, neighbors, pt,
+              [&labels, label](MapPoint, unsigned nodeIdx) {
+                  if(labels[nodeIdx] != UNLABELED)
+                      return false;
+                  labels[nodeIdx] = label;
+                  return true;
+              },
+              std::numeric_limits<unsigned>::max()));
+        }
+    }
+    return componentSizes;
+}
+
+#endif // FloodFill_h__
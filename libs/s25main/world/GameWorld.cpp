@@ -88,6 +88,8 @@ void GameWorld::Serialize(SerializedGameData& sgd) const
         sgd.PushUnsignedInt(luaSaveState.GetLength());
         sgd.PushRawData(luaSaveState.GetData(), luaSaveState.GetLength());
         sgd.PushUnsignedInt(0xC001C0DE); // End Lua identifier
+        // Events collected for the batch handlers during the current GF, delivered with the next one
+        GetLua().SerializeEventBatches(sgd);
     }
 }
 
@@ -130,5 +132,7 @@ void GameWorld::Deserialize(const std::shared_ptr<Game>& game, SerializedGameDat
         {
             throw SerializedGameData::Error(std::string(_("Failed to load lua state!")) + _("Error: ") + e.what());
         }
+        if(sgd.GetGameDataVersion() >= 4)
+            GetLua().DeserializeEventBatches(sgd);
     }
 }
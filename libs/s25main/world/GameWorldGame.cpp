@@ -21,7 +21,6 @@
 #include "GameInterface.h"
 #include "GamePlayer.h"
 #include "GlobalGameSettings.h"
-#include "TradePathCache.h"
 #include "addons/const_addons.h"
 #include "buildings/noBuildingSite.h"
 #include "buildings/nobMilitary.h"
@@ -33,6 +32,7 @@
 #include "lua/LuaInterfaceGame.h"
 #include "notifications/BuildingNote.h"
 #include "notifications/ExpeditionNote.h"
+#include "notifications/NodeNote.h"
 #include "notifications/RoadNote.h"
 #include "pathfinding/PathConditionHuman.h"
 #include "pathfinding/PathConditionRoad.h"
@@ -65,7 +65,6 @@ inline std::vector<GamePlayer> CreatePlayers(const std::vector<PlayerInfo>& play
 GameWorldGame::GameWorldGame(const std::vector<PlayerInfo>& players, const GlobalGameSettings& gameSettings, EventManager& em)
     : GameWorldBase(CreatePlayers(players, *this), gameSettings, em)
 {
-    TradePathCache::inst().Clear();
     GameObject::AttachWorld(this);
 }
 
@@ -136,6 +135,8 @@ void GameWorldGame::SetPointRoad(MapPoint pt, Direction dir, unsigned char type)
         pt = GetNeighbour(pt, dir);
 
     SetRoad(pt, dir.toUInt(), type);
+    GetNotifications().publish(NodeNote(NodeNote::Road, pt));
+    GetNotifications().publish(NodeNote(NodeNote::Road, GetNeighbour(pt, dir + 3u)));
 
     if(gi)
         gi->GI_UpdateMinimap(pt);
@@ -466,6 +467,9 @@ void GameWorldGame::RecalcTerritory(const noBaseBuilding& building, TerritoryCha
 
     RecalcBorderStones(region.startPt, region.size);
 
+    for(const MapPoint& pt : ptsWithChangedOwners)
+        GetNotifications().publish(NodeNote(NodeNote::Owner, pt));
+
     // Recalc visibilities if building was destroyed
     // Otherwise just set everything to visible
     const unsigned visualRadius = militaryRadius + VISUALRANGE_MILITARY;
@@ -1177,16 +1181,14 @@ void GameWorldGame::MakeVisible(const MapPoint pt, const unsigned char player)
 void GameWorldGame::RecalcVisibilitiesAroundPoint(const MapPoint pt, const MapCoord radius, const unsigned char player,
                                                   const noBaseBuilding* const exception)
 {
-    std::vector<MapPoint> pts = GetPointsInRadiusWithCenter(pt, radius);
-    for(const MapPoint& pt : pts)
-        RecalcVisibility(pt, player, exception);
+    for(const MapPoint& curPt : PointsInRadius(pt, radius, true))
+        RecalcVisibility(curPt, player, exception);
 }
 
 /// Setzt die Sichtbarkeiten um einen Punkt auf sichtbar (aus Performancegründen Alternative zu oberem)
 void GameWorldGame::MakeVisibleAroundPoint(const MapPoint pt, const MapCoord radius, const unsigned char player)
 {
-    std::vector<MapPoint> pts = GetPointsInRadiusWithCenter(pt, radius);
-    for(const MapPoint& curPt : pts)
+    for(const MapPoint& curPt : PointsInRadius(pt, radius, true))
         MakeVisible(curPt, player);
 }
 
@@ -1417,5 +1419,5 @@ void GameWorldGame::CreateTradeGraphs()
     if(!GetGGS().isEnabled(AddonId::TRADE))
         return;
 
-    TradePathCache::inst().Clear();
+    tradePathCache.Clear();
 }
@@ -18,6 +18,7 @@
 #ifndef GameWorldGame_h__
 #define GameWorldGame_h__
 
+#include "TradePathCache.h"
 #include "world/GameWorldBase.h"
 #include "gameTypes/MapCoordinates.h"
 #include <vector>
@@ -43,6 +44,8 @@ enum class TerritoryChangeReason
 /// "Interface-Klasse" für das Spiel
 class GameWorldGame : public GameWorldBase
 {
+    TradePathCache tradePathCache;
+
     /// Destroys player belongings if that pint does not belong to the player anymore
     void DestroyPlayerRests(MapPoint pt, unsigned char newOwner, const noBaseBuilding* exception);
 
@@ -131,6 +134,7 @@ public:
     void AttackViaSea(unsigned char player_attacker, MapPoint pt, unsigned short soldiers_count, bool strong_soldiers);
 
     MilitarySquares& GetMilitarySquares();
+    TradePathCache& GetTradePathCache() { return tradePathCache; }
 
     /// Lässt alles spielerische abbrennen, indem es alle Flaggen der Spieler zerstört
     void Armageddon();
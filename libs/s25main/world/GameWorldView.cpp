@@ -23,6 +23,7 @@
 #include "GlobalGameSettings.h"
 #include "Loader.h"
 #include "MapGeometry.h"
+#include "Profiler.h"
 #include "addons/AddonMaxWaterwayLength.h"
 #include "buildings/noBuildingSite.h"
 #include "buildings/nobMilitary.h"
@@ -120,6 +121,7 @@ struct ObjectBetweenLines
 
 void GameWorldView::Draw(const RoadBuildState& rb, const MapPoint selected, bool drawMouse, unsigned* water)
 {
+    ProfilingScope profilingScope(ProfilingZone::GameWorld);
     SetNextZoomFactor();
 
     int shortestDistToMouse = 100000;
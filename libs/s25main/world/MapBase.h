@@ -23,8 +23,11 @@
 #include "gameTypes/Direction.h"
 #include "gameTypes/MapCoordinates.h"
 #include "gameTypes/ShipDirection.h"
+#include <iterator>
 #include <vector>
 
+class MapRadiusRange;
+
 /// Base class for a map. A map has a size and functions for getting from one point to another in that map
 class MapBase
 {
@@ -70,6 +73,10 @@ public:
     /// If includePt is true, then the point itself is also checked
     template<class T_IsValidPt>
     bool CheckPointsInRadius(MapPoint pt, unsigned radius, T_IsValidPt&& isValid, bool includePt) const;
+    /// Lazily evaluated range of all points in a radius around pt in the same order as GetPointsInRadius. Does not allocate
+    MapRadiusRange PointsInRadius(MapPoint pt, unsigned radius, bool includePt = false) const;
+    /// Lazily evaluated range of all points with a distance of exactly radius to pt
+    MapRadiusRange PointsOnRing(MapPoint pt, unsigned radius) const;
 
     /// Return the distance between 2 points on the map (includes wrapping around map borders)
     unsigned CalcDistance(const Position& p1, const Position& p2) const;
@@ -78,10 +85,112 @@ public:
     ShipDirection GetShipDir(MapPoint fromPt, MapPoint toPt) const;
 };
 
+/// Range over the points around a center point with a distance in [minRadius, maxRadius].
+/// Order is ring by ring (increasing distance) where each ring starts at its west most point and goes clockwise.
+/// The points are calculated while iterating, so you can stop (e.g. at a ring) without additional costs
+class MapRadiusRange
+{
+public:
+    class iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = MapPoint;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const MapPoint*;
+        using reference = const MapPoint&;
+
+        /// Create an iterator at the start of the ring with the given radius
+        iterator(const MapBase& map, MapPoint ringStartPt, unsigned radius)
+            : map_(&map), ringStartPt_(ringStartPt), curPt_(ringStartPt), radius_(radius), dir_(0), step_(0)
+        {}
+
+        reference operator*() const { return curPt_; }
+        pointer operator->() const { return &curPt_; }
+        iterator& operator++();
+        iterator operator++(int)
+        {
+            iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        bool operator==(const iterator& rhs) const { return radius_ == rhs.radius_ && dir_ == rhs.dir_ && step_ == rhs.step_; }
+        bool operator!=(const iterator& rhs) const { return !(*this == rhs); }
+        /// Distance of the current point to the center
+        unsigned GetRadius() const { return radius_; }
+
+    private:
+        const MapBase* map_;
+        /// Start of the current ring
+        MapPoint ringStartPt_;
+        MapPoint curPt_;
+        unsigned radius_;
+        /// Offset to NORTHEAST of the current direction and number of steps taken in it
+        unsigned dir_, step_;
+    };
+    using const_iterator = iterator;
+
+    MapRadiusRange(const MapBase& map, MapPoint center, unsigned minRadius, unsigned maxRadius)
+        : map_(&map), center_(center), minRadius_(minRadius), maxRadius_(maxRadius)
+    {}
+
+    iterator begin() const;
+    /// End iterators only compare the position on the ring, so the start point is not calculated
+    iterator end() const { return iterator(*map_, center_, maxRadius_ + 1u); }
+
+private:
+    const MapBase* map_;
+    MapPoint center_;
+    unsigned minRadius_, maxRadius_;
+};
+
 //////////////////////////////////////////////////////////////////////////
 // Implementation
 //////////////////////////////////////////////////////////////////////////
 
+inline MapRadiusRange::iterator MapRadiusRange::begin() const
+{
+    if(minRadius_ > maxRadius_)
+        return end();
+    MapPoint startPt = center_;
+    for(unsigned r = 0; r < minRadius_; ++r)
+        startPt = map_->GetNeighbour(startPt, Direction::WEST);
+    return iterator(*map_, startPt, minRadius_);
+}
+
+inline MapRadiusRange::iterator& MapRadiusRange::iterator::operator++()
+{
+    if(radius_ == 0u)
+    {
+        // Center -> Start of the first ring
+        radius_ = 1;
+        ringStartPt_ = curPt_ = map_->GetNeighbour(ringStartPt_, Direction::WEST);
+        return *this;
+    }
+    // Go r steps in one direction, turn right and repeat
+    curPt_ = map_->GetNeighbour(curPt_, Direction(Direction::NORTHEAST + dir_));
+    if(++step_ < radius_)
+        return *this;
+    step_ = 0;
+    if(++dir_ < Direction::COUNT)
+        return *this;
+    // Go one level/hull to the left
+    dir_ = 0;
+    ++radius_;
+    ringStartPt_ = curPt_ = map_->GetNeighbour(ringStartPt_, Direction::WEST);
+    return *this;
+}
+
+inline MapRadiusRange MapBase::PointsInRadius(const MapPoint pt, unsigned radius, bool includePt) const
+{
+    return MapRadiusRange(*this, pt, includePt ? 0u : 1u, radius);
+}
+
+inline MapRadiusRange MapBase::PointsOnRing(const MapPoint pt, unsigned radius) const
+{
+    return MapRadiusRange(*this, pt, radius, radius);
+}
+
 // Convenience functions
 inline MapCoord MapBase::GetXA(const MapPoint pt, Direction dir) const
 {
@@ -100,62 +209,30 @@ MapBase::GetPointsInRadius(const MapPoint pt, unsigned radius, T_TransformPt&& t
 {
     using Element = typename T_TransformPt::result_type;
     std::vector<Element> result;
-    if(includePt)
+    const MapRadiusRange range = PointsInRadius(pt, radius, includePt);
+    for(auto it = range.begin(); it != range.end(); ++it)
     {
-        Element el = transformPt(pt, 0);
+        Element el = transformPt(*it, it.GetRadius());
         if(isValid(el))
         {
             result.push_back(el);
-            if(T_maxResults == 1u)
+            // A single result may be the center, otherwise rings are stopped after exceeding the maximum
+            const int maxResults = (it.GetRadius() == 0u) ? T_maxResults - 1 : T_maxResults;
+            if(T_maxResults > 0 && static_cast<int>(result.size()) > maxResults)
                 return result;
         }
     }
-    MapPoint curStartPt = pt;
-    for(unsigned r = 1; r <= radius; ++r)
-    {
-        // Go one level/hull to the left
-        curStartPt = GetNeighbour(curStartPt, Direction::WEST);
-        // Now iterate over the "circle" of radius r by going r steps in one direction, turn right and repeat
-        MapPoint curPt = curStartPt;
-        for(unsigned i = Direction::NORTHEAST; i < Direction::NORTHEAST + Direction::COUNT; ++i)
-        {
-            for(unsigned step = 0; step < r; ++step)
-            {
-                Element el = transformPt(curPt, r);
-                if(isValid(el))
-                {
-                    result.push_back(el);
-                    if(T_maxResults > 0 && static_cast<int>(result.size()) > T_maxResults)
-                        return result;
-                }
-                curPt = GetNeighbour(curPt, Direction(i));
-            }
-        }
-    }
     return result;
 }
 
 template<class T_IsValidPt>
 inline bool MapBase::CheckPointsInRadius(const MapPoint pt, unsigned radius, T_IsValidPt&& isValid, bool includePt) const
 {
-    if(includePt && isValid(pt, 0))
-        return true;
-    MapPoint curStartPt = pt;
-    for(unsigned r = 1; r <= radius; ++r)
+    const MapRadiusRange range = PointsInRadius(pt, radius, includePt);
+    for(auto it = range.begin(); it != range.end(); ++it)
     {
-        // Go one level/hull to the left
-        curStartPt = GetNeighbour(curStartPt, Direction::WEST);
-        // Now iterate over the "circle" of radius r by going r steps in one direction, turn right and repeat
-        MapPoint curPt = curStartPt;
-        for(unsigned i = Direction::NORTHEAST; i < Direction::NORTHEAST + Direction::COUNT; ++i)
-        {
-            for(unsigned step = 0; step < r; ++step)
-            {
-                if(isValid(curPt, r))
-                    return true;
-                curPt = GetNeighbour(curPt, Direction(i));
-            }
-        }
+        if(isValid(*it, it.GetRadius()))
+            return true;
     }
     return false;
 }
@@ -25,6 +25,7 @@
 #include "ogl/glArchivItem_Map.h"
 #include "pathfinding/PathConditionShip.h"
 #include "random/Random.h"
+#include "world/FloodFill.h"
 #include "world/World.h"
 #include "nodeObjs/noAnimal.h"
 #include "nodeObjs/noEnvObject.h"
@@ -37,8 +38,11 @@
 #include "libsiedler2/ArchivItem_Map_Header.h"
 #include "s25util/Log.h"
 #include <algorithm>
-#include <map>
+#include <future>
+#include <limits>
 #include <queue>
+#include <thread>
+#include <utility>
 
 class noBase;
 
@@ -66,6 +70,7 @@ bool MapLoader::Load(const glArchivItem_Map& map, Exploration exploration)
         return false;
     PlaceObjects(map);
     PlaceAnimals(map);
+    world_.RecalcResourceSquares();
     if(!InitSeasAndHarbors(world_))
         return false;
 
@@ -438,15 +443,13 @@ bool MapLoader::InitSeasAndHarbors(World& world, const std::vector<MapPoint>& ad
 
     /// Weltmeere vermessen
     world.seas.clear();
+    std::vector<unsigned> seaIds;
+    const std::vector<unsigned> seaSizes =
+      LabelComponents(world.GetSize(), FloodFillNeighbors::Hexagonal, [&world](const MapPoint pt) { return world.IsSeaPoint(pt); }, seaIds);
     RTTR_FOREACH_PT(MapPoint, world.GetSize())
-    {
-        // Noch kein Meer an diesem Punkt  Aber trotzdem Teil eines noch nicht vermessenen Meeres?
-        if(!world.GetNode(pt).seaId && world.IsSeaPoint(pt))
-        {
-            unsigned sea_size = MeasureSea(world, pt, world.seas.size() + 1);
-            world.seas.push_back(World::Sea(sea_size));
-        }
-    }
+        world.GetNodeInt(pt).seaId = static_cast<unsigned short>(seaIds[world.GetIdx(pt)]);
+    for(unsigned seaSize : seaSizes)
+        world.seas.push_back(World::Sea(seaSize));
 
     /// Die Meere herausfinden, an die die Hafenpunkte grenzen
     unsigned curHarborId = 1;
@@ -521,160 +524,211 @@ void MapLoader::CalcHarborPosNeighbors(World& world)
         for(unsigned z = 0; z < 6; ++z)
             harbor.neighbors[z].clear();
     }
-    PathConditionShip shipPathChecker(world);
+    // We need at least 2 harbors (index 0 is unused) for any neighbors
+    if(world.harbor_pos.size() < 3u)
+        return;
 
-    // pre-calculate sea-points, as IsSeaPoint is rather expensive
-    std::vector<int8_t> ptIsSeaPt(world.nodes.size()); //-V656
+    PathConditionShip shipPathChecker(world);
+    const auto calcShipDirs = [&shipPathChecker](const MapPoint pt) {
+        uint8_t shipDirs = 0;
+        for(unsigned dir = 0; dir < Direction::COUNT; ++dir)
+        {
+            if(shipPathChecker.IsEdgeOk(pt, Direction::fromInt(dir)))
+                shipDirs |= 1u << dir;
+        }
+        return shipDirs;
+    };
 
+    // pre-calculate sea-points and the directions a ship can go from there, as IsSeaPoint and IsEdgeOk are rather expensive
+    std::vector<bool> ptIsSeaPt(world.nodes.size()); //-V656
+    std::vector<uint8_t> ptShipDirs(world.nodes.size());
     RTTR_FOREACH_PT(MapPoint, world.GetSize())
     {
         if(shipPathChecker.IsNodeOk(pt))
-            ptIsSeaPt[world.GetIdx(pt)] = -1;
+        {
+            const unsigned idx = world.GetIdx(pt);
+            ptIsSeaPt[idx] = true;
+            ptShipDirs[idx] = calcShipDirs(pt);
+        }
     }
 
-    // FIFO queue used for a BFS
-    std::queue<CalcHarborPosNeighborsNode> todo_list;
-
-    for(unsigned startHbId = 1; startHbId < world.harbor_pos.size(); ++startHbId)
+    // Coastal points of all harbors as (node index, harbor id) sorted by both.
+    // All harbors at a coastal point use it for the same sea (the one of GetSeaFromCoastalPoint)
+    // and every harbor has at most 1 coastal point per sea, so this does not change during the search
+    std::vector<std::pair<unsigned, unsigned>> coastToHarbor;
+    std::vector<bool> ptIsCoastPt(world.nodes.size());
+    for(unsigned hbId = 1; hbId < world.harbor_pos.size(); ++hbId)
     {
-        RTTR_Assert(todo_list.empty());
-
-        // Copy sea points to working flags. Possible values are
-        // -1 - sea point, not already visited
-        // 0 - visited or no sea point
-        // 1 - Coast to a harbor
-        std::vector<int8_t> ptToVisitOrHb(ptIsSeaPt);
-
-        std::vector<bool> hbFound(world.harbor_pos.size(), false);
-        // For each sea, store the coastal point indices and their harbor
-        std::vector<std::multimap<unsigned, unsigned>> coastToHarborPerSea(world.seas.size() + 1);
-        std::vector<MapPoint> ownCoastalPoints;
-
-        // mark coastal points around harbors
+        for(unsigned d = 0; d < Direction::COUNT; d++)
+        {
+            // No sea? -> Next
+            if(!world.GetSeaId(hbId, Direction::fromInt(d)))
+                continue;
+            const MapPoint coastPt = world.GetNeighbour(world.GetHarborPoint(hbId), Direction::fromInt(d));
+            const unsigned idx = world.GetIdx(coastPt);
+            RTTR_Assert(!ptIsSeaPt[idx]);
+            coastToHarbor.push_back(std::make_pair(idx, hbId));
+            ptIsCoastPt[idx] = true;
+            ptShipDirs[idx] = calcShipDirs(coastPt);
+        }
+    }
+    std::sort(coastToHarbor.begin(), coastToHarbor.end());
+
+    // A search can only get from one sea to another through a coastal point, so join the seas next to them into groups.
+    // Only harbors in a group of the start harbor can be found
+    std::vector<unsigned> seaGroup(world.seas.size() + 1u);
+    for(unsigned seaId = 0; seaId < seaGroup.size(); seaId++)
+        seaGroup[seaId] = seaId;
+    const auto findGroup = [&seaGroup](unsigned seaId) {
+        while(seaGroup[seaId] != seaId)
+            seaId = seaGroup[seaId] = seaGroup[seaGroup[seaId]];
+        return seaId;
+    };
+    for(const auto& coastAndHb : coastToHarbor)
+    {
+        const MapPoint coastPt(coastAndHb.first % world.GetWidth(), coastAndHb.first / world.GetWidth());
+        const unsigned group = findGroup(world.GetSeaFromCoastalPoint(coastPt));
+        for(unsigned dir = 0; dir < Direction::COUNT; ++dir)
+        {
+            const MapPoint nbPt = world.GetNeighbour(coastPt, Direction::fromInt(dir));
+            const unsigned nbIdx = world.GetIdx(nbPt);
+            unsigned short nbSeaId = 0;
+            if(ptIsSeaPt[nbIdx])
+                nbSeaId = world.GetNode(nbPt).seaId;
+            else if(ptIsCoastPt[nbIdx])
+                nbSeaId = world.GetSeaFromCoastalPoint(nbPt);
+            if(nbSeaId)
+                seaGroup[findGroup(nbSeaId)] = findGroup(group);
+        }
+    }
+    // Resolve all groups so seaGroup can be read concurrently
+    for(unsigned seaId = 0; seaId < seaGroup.size(); seaId++)
+        seaGroup[seaId] = findGroup(seaId);
+    const auto isAtSeaGroup = [&world, &seaGroup](unsigned hbId, unsigned group) {
+        for(unsigned d = 0; d < Direction::COUNT; d++)
+        {
+            const unsigned short seaId = world.GetSeaId(hbId, Direction::fromInt(d));
+            if(seaId && seaGroup[seaId] == group)
+                return true;
+        }
+        return false;
+    };
+    const auto getHarborsAtCoast = [&coastToHarbor](unsigned idx) {
+        return std::equal_range(coastToHarbor.begin(), coastToHarbor.end(), std::make_pair(idx, 0u),
+                                [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    };
+
+    // BFS over the sea from the coastal points of the start harbor. Only writes the neighbors of the start harbor
+    // so searches for different harbors can run concurrently. visitedBy holds the start harbor of the search
+    // which last visited a node so it can be reused without resetting it.
+    const auto findNeighbors = [&](const unsigned startHbId, std::vector<unsigned>& visitedBy) {
+        HarborPos& startHb = world.harbor_pos[startHbId];
+
+        // Harbors which might be reached. Once all of them are found there is nothing left to do
+        unsigned numHbsToFind = 0;
         for(unsigned otherHbId = 1; otherHbId < world.harbor_pos.size(); ++otherHbId)
         {
+            if(otherHbId == startHbId)
+                continue;
             for(unsigned d = 0; d < Direction::COUNT; d++)
             {
-                unsigned seaId = world.GetSeaId(otherHbId, Direction::fromInt(d));
-                // No sea? -> Next
-                if(!seaId)
-                    continue;
-                const MapPoint coastPt = world.GetNeighbour(world.GetHarborPoint(otherHbId), Direction::fromInt(d));
-                // This should not be marked for visit
-                unsigned idx = world.GetIdx(coastPt);
-                RTTR_Assert(ptToVisitOrHb[idx] != -1);
-                if(otherHbId == startHbId)
+                const unsigned short seaId = world.GetSeaId(startHbId, Direction::fromInt(d));
+                if(seaId && isAtSeaGroup(otherHbId, seaGroup[seaId]))
                 {
-                    // This is our start harbor. Add the coast points around it to our todo list.
-                    ownCoastalPoints.push_back(coastPt);
-                } else
-                {
-                    ptToVisitOrHb[idx] = 1;
-                    coastToHarborPerSea[seaId].insert(std::make_pair(idx, otherHbId));
+                    numHbsToFind++;
+                    break;
                 }
             }
         }
+        std::vector<bool> hbFound(world.harbor_pos.size(), false);
+        unsigned numHbsFound = 0;
 
-        for(const MapPoint& ownCoastPt : ownCoastalPoints)
+        // FIFO queue used for a BFS
+        std::queue<CalcHarborPosNeighborsNode> todo_list;
+        for(unsigned d = 0; d < Direction::COUNT; d++)
         {
+            if(!world.GetSeaId(startHbId, Direction::fromInt(d)))
+                continue;
+            const MapPoint ownCoastPt = world.GetNeighbour(startHb.pos, Direction::fromInt(d));
             // Special case: Get all harbors that share the coast point with us
-            unsigned short seaId = world.GetSeaFromCoastalPoint(ownCoastPt);
-            auto const coastToHbs = coastToHarborPerSea[seaId].equal_range(world.GetIdx(ownCoastPt));
+            const auto coastToHbs = getHarborsAtCoast(world.GetIdx(ownCoastPt));
             for(auto it = coastToHbs.first; it != coastToHbs.second; ++it)
             {
+                if(it->second == startHbId)
+                    continue;
                 ShipDirection shipDir = world.GetShipDir(ownCoastPt, ownCoastPt);
-                world.harbor_pos[startHbId].neighbors[shipDir.toUInt()].push_back(HarborPos::Neighbor(it->second, 0));
+                startHb.neighbors[shipDir.toUInt()].push_back(HarborPos::Neighbor(it->second, 0));
                 hbFound[it->second] = true;
+                numHbsFound++;
             }
             todo_list.push(CalcHarborPosNeighborsNode(ownCoastPt, 0));
         }
 
-        while(!todo_list.empty()) // as long as there are sea points on our todo list...
+        // as long as there are sea points on our todo list and harbors to find...
+        while(!todo_list.empty() && numHbsFound < numHbsToFind)
         {
             CalcHarborPosNeighborsNode curNode = todo_list.front();
             todo_list.pop();
+            const uint8_t shipDirs = ptShipDirs[world.GetIdx(curNode.pos)];
 
             for(unsigned dir = 0; dir < Direction::COUNT; ++dir)
             {
                 MapPoint curPt = world.GetNeighbour(curNode.pos, Direction::fromInt(dir));
                 unsigned idx = world.GetIdx(curPt);
 
-                int ptValue = ptToVisitOrHb[idx];
                 // Already visited
-                if(ptValue == 0)
+                if(visitedBy[idx] == startHbId)
+                    continue;
+                // Coast of other harbor(s)?
+                auto coastToHbs = std::make_pair(coastToHarbor.cend(), coastToHarbor.cend());
+                bool isOtherHbCoast = false;
+                if(ptIsCoastPt[idx])
+                {
+                    coastToHbs = getHarborsAtCoast(idx);
+                    isOtherHbCoast = std::any_of(coastToHbs.first, coastToHbs.second,
+                                                 [startHbId](const auto& entry) { return entry.second != startHbId; });
+                }
+                if(!isOtherHbCoast && !ptIsSeaPt[idx])
                     continue;
                 // Not reachable
-                if(!shipPathChecker.IsEdgeOk(curNode.pos, Direction::fromInt(dir)))
+                if(!(shipDirs & (1u << dir)))
                     continue;
 
-                if(ptValue > 0) // found harbor(s)
+                if(isOtherHbCoast) // found harbor(s)
                 {
-                    ShipDirection shipDir = world.GetShipDir(world.harbor_pos[startHbId].pos, curPt);
-                    unsigned seaId = world.GetSeaFromCoastalPoint(curPt);
-                    auto const coastToHbs = coastToHarborPerSea[seaId].equal_range(idx);
+                    ShipDirection shipDir = world.GetShipDir(startHb.pos, curPt);
                     for(auto it = coastToHbs.first; it != coastToHbs.second; ++it)
                     {
                         unsigned otherHbId = it->second;
-                        if(hbFound[otherHbId])
+                        if(otherHbId == startHbId || hbFound[otherHbId])
                             continue;
 
                         hbFound[otherHbId] = true;
-                        world.harbor_pos[startHbId].neighbors[shipDir.toUInt()].push_back(
-                          HarborPos::Neighbor(otherHbId, curNode.distance + 1));
-
-                        // Make this the only coastal point of this harbor for this sea
-                        HarborPos& otherHb = world.harbor_pos[otherHbId];
-                        RTTR_Assert(seaId);
-                        for(unsigned hbDir = 0; hbDir < Direction::COUNT; ++hbDir)
-                        {
-                            if(otherHb.cps[hbDir].seaId == seaId && world.GetNeighbour(otherHb.pos, Direction::fromInt(hbDir)) != curPt)
-                                otherHb.cps[hbDir].seaId = 0;
-                        }
+                        numHbsFound++;
+                        startHb.neighbors[shipDir.toUInt()].push_back(HarborPos::Neighbor(otherHbId, curNode.distance + 1));
                     }
                 }
                 todo_list.push(CalcHarborPosNeighborsNode(curPt, curNode.distance + 1));
-                ptToVisitOrHb[idx] = 0; // mark as visited, so we do not go here again
+                visitedBy[idx] = startHbId; // mark as visited, so we do not go here again
             }
         }
-    }
-}
-
-/// Vermisst ein neues Weltmeer von einem Punkt aus, indem es alle mit diesem Punkt verbundenen
-/// Wasserpunkte mit der gleichen ID belegt und die Anzahl zur�ckgibt
-unsigned MapLoader::MeasureSea(World& world, const MapPoint start, unsigned short seaId)
-{
-    // Breitensuche von diesem Punkt aus durchf�hren
-    std::vector<bool> visited(world.GetWidth() * world.GetHeight(), false);
-    std::queue<MapPoint> todo;
-
-    todo.push(start);
-    visited[world.GetIdx(start)] = true;
-
-    // Count of nodes (including start node)
-    unsigned count = 0;
-
-    while(!todo.empty())
-    {
-        MapPoint p = todo.front();
-        todo.pop();
-
-        RTTR_Assert(visited[world.GetIdx(p)]);
-        world.GetNodeInt(p).seaId = seaId;
-
-        for(unsigned i = 0; i < 6; ++i)
-        {
-            MapPoint neighbourPt = world.GetNeighbour(p, Direction::fromInt(i));
-            if(visited[world.GetIdx(neighbourPt)])
-                continue;
-            visited[world.GetIdx(neighbourPt)] = true;
-
-            // Ist das dort auch ein Meerespunkt?
-            if(world.IsSeaPoint(neighbourPt))
-                todo.push(neighbourPt);
-        }
-
-        ++count;
-    }
-
-    return count;
+    };
+
+    // Below this number of nodes (summed over all searches) per thread starting threads costs more than it saves
+    static const uint64_t MIN_NODES_PER_THREAD = 1 << 16;
+    const unsigned numStartHbs = world.harbor_pos.size() - 1u;
+    const auto maxThreadsForWork = static_cast<unsigned>(std::min<uint64_t>(
+      uint64_t(world.nodes.size()) * numStartHbs / MIN_NODES_PER_THREAD, std::numeric_limits<unsigned>::max()));
+    const unsigned numThreads = std::max(1u, std::min({std::thread::hardware_concurrency(), numStartHbs, maxThreadsForWork}));
+    const auto findNeighborsOfHarbors = [&findNeighbors, &world](unsigned firstHbId, unsigned step) {
+        std::vector<unsigned> visitedBy(world.nodes.size(), 0u);
+        for(unsigned startHbId = firstHbId; startHbId < world.harbor_pos.size(); startHbId += step)
+            findNeighbors(startHbId, visitedBy);
+    };
+    std::vector<std::future<void>> workers;
+    for(unsigned i = 1; i < numThreads; i++)
+        workers.push_back(std::async(std::launch::async, findNeighborsOfHarbors, 1u + i, numThreads));
+    findNeighborsOfHarbors(1u, numThreads);
+    for(std::future<void>& worker : workers)
+        worker.get();
 }
@@ -40,9 +40,6 @@ class MapLoader
     void PlaceObjects(const glArchivItem_Map& map);
     void PlaceAnimals(const glArchivItem_Map& map);
 
-    /// Vermisst ein neues Weltmeer von einem Punkt aus, indem es alle mit diesem Punkt verbundenen
-    /// Wasserpunkte mit der gleichen seaId belegt und die Anzahl zurückgibt
-    static unsigned MeasureSea(World& world, MapPoint start, unsigned short seaId);
     static void CalcHarborPosNeighbors(World& world);
 
 public:
@@ -151,4 +151,6 @@ void MapSerializer::Deserialize(World& world, const unsigned numPlayers, Seriali
             }
         }
     }
+
+    world.RecalcResourceSquares();
 }
@@ -0,0 +1,117 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "world/ResourceSquares.h"
+#include "nodeObjs/noBase.h"
+#include <algorithm>
+
+ResourceSquares::ResourceSquares() : mapSize_(MapExtent::all(0)), size_(MapExtent::all(0)) {}
+
+void ResourceSquares::Init(const MapExtent& mapSize)
+{
+    RTTR_Assert(size_ == MapExtent::all(0));     // Already initialized
+    RTTR_Assert(mapSize.x > 0 && mapSize.y > 0); // No empty map
+    mapSize_ = mapSize;
+    // Calculate size (rounding up)
+    size_ = MapExtent((mapSize.x + SQUARE_SIZE - 1) / SQUARE_SIZE, (mapSize.y + SQUARE_SIZE - 1) / SQUARE_SIZE);
+    Counts emptyCounts;
+    emptyCounts.fill(0);
+    squares.resize(size_.x * size_.y, emptyCounts);
+}
+
+void ResourceSquares::Clear()
+{
+    squares.clear();
+    mapSize_ = size_ = MapExtent::all(0);
+}
+
+ResourceSquares::Counts& ResourceSquares::GetSquare(const MapPoint pt)
+{
+    return squares[(pt.y / SQUARE_SIZE) * size_.x + pt.x / SQUARE_SIZE];
+}
+
+void ResourceSquares::Change(Type type, const MapPoint pt, bool add)
+{
+    unsigned& count = GetSquare(pt)[type];
+    if(add)
+        count++;
+    else
+    {
+        RTTR_Assert(count > 0u);
+        count--;
+    }
+}
+
+void ResourceSquares::AddObject(const MapPoint pt, const noBase& obj)
+{
+    if(obj.GetType() == NOP_TREE)
+        Change(TREES, pt, true);
+    else if(obj.GetType() == NOP_GRANITE)
+        Change(GRANITE, pt, true);
+}
+
+void ResourceSquares::RemoveObject(const MapPoint pt, const noBase& obj)
+{
+    if(obj.GetType() == NOP_TREE)
+        Change(TREES, pt, false);
+    else if(obj.GetType() == NOP_GRANITE)
+        Change(GRANITE, pt, false);
+}
+
+void ResourceSquares::AddResource(const MapPoint pt, Resource resource)
+{
+    if(resource.has(Resource::Fish))
+        Change(FISH, pt, true);
+}
+
+void ResourceSquares::RemoveResource(const MapPoint pt, Resource resource)
+{
+    if(resource.has(Resource::Fish))
+        Change(FISH, pt, false);
+}
+
+bool ResourceSquares::HasAnyInRange(Type type, const MapPoint pt, unsigned radius) const
+{
+    // All points in range are at most radius nodes away in x and y direction, so check all squares overlapping that rectangle
+    const unsigned numX = std::min(2 * radius + 1, static_cast<unsigned>(mapSize_.x));
+    const unsigned numY = std::min(2 * radius + 1, static_cast<unsigned>(mapSize_.y));
+    const unsigned startX = (pt.x + mapSize_.x - radius % mapSize_.x) % mapSize_.x;
+    const unsigned startY = (pt.y + mapSize_.y - radius % mapSize_.y) % mapSize_.y;
+    for(unsigned dy = 0; dy < numY;)
+    {
+        // Handle wrap-around
+        const unsigned y = (startY + dy) % mapSize_.y;
+        for(unsigned dx = 0; dx < numX;)
+        {
+            const unsigned x = (startX + dx) % mapSize_.x;
+            if(squares[(y / SQUARE_SIZE) * size_.x + x / SQUARE_SIZE][type] > 0u)
+                return true;
+            dx += std::min(SQUARE_SIZE - x % SQUARE_SIZE, mapSize_.x - x);
+        }
+        dy += std::min(SQUARE_SIZE - y % SQUARE_SIZE, mapSize_.y - y);
+    }
+    return false;
+}
+
+unsigned ResourceSquares::GetNumTotal(Type type) const
+{
+    unsigned result = 0;
+    for(const Counts& counts : squares)
+        result += counts[type];
+    return result;
+}
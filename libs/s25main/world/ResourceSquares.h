@@ -0,0 +1,66 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ResourceSquares_h__
+#define ResourceSquares_h__
+
+#include "gameTypes/MapCoordinates.h"
+#include "gameTypes/Resource.h"
+#include <array>
+#include <vector>
+
+class noBase;
+
+/// Counts the objects and resources used by workers (trees, granite, fish) per square of the map.
+/// Used to skip searching areas which do not contain any of them
+class ResourceSquares
+{
+public:
+    enum Type
+    {
+        TREES,
+        GRANITE,
+        FISH,
+        NUM_TYPES
+    };
+
+    ResourceSquares();
+    void Init(const MapExtent& mapSize);
+    void Clear();
+    /// Add/Remove a node object at the given point. Objects of untracked types are ignored
+    void AddObject(MapPoint pt, const noBase& obj);
+    void RemoveObject(MapPoint pt, const noBase& obj);
+    /// Add/Remove a resource at the given point. Untracked resources are ignored
+    void AddResource(MapPoint pt, Resource resource);
+    void RemoveResource(MapPoint pt, Resource resource);
+    /// Return true, if there is something of the given type at any point with a distance of at most radius to pt.
+    /// Might also return true if it is only close to the radius (same square)
+    bool HasAnyInRange(Type type, MapPoint pt, unsigned radius) const;
+    unsigned GetNumTotal(Type type) const;
+
+private:
+    static constexpr unsigned SQUARE_SIZE = 8;
+    using Counts = std::array<unsigned, NUM_TYPES>;
+    /// Counts per square
+    std::vector<Counts> squares;
+    MapExtent mapSize_, size_;
+
+    Counts& GetSquare(MapPoint pt);
+    void Change(Type type, MapPoint pt, bool add);
+};
+
+#endif // ResourceSquares_h__
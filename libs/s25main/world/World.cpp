@@ -105,10 +105,27 @@ void World::Resize(const MapExtent& newSize)
     MapBase::Resize(newSize);
     nodes.clear();
     militarySquares.Clear();
+    resourceSquares.Clear();
     if(GetSize().x > 0)
     {
         nodes.resize(prodOfComponents(GetSize()));
         militarySquares.Init(GetSize());
+        resourceSquares.Init(GetSize());
+    }
+}
+
+void World::RecalcResourceSquares()
+{
+    resourceSquares.Clear();
+    if(GetSize().x == 0)
+        return;
+    resourceSquares.Init(GetSize());
+    RTTR_FOREACH_PT(MapPoint, GetSize())
+    {
+        const MapNode& node = GetNode(pt);
+        if(node.obj)
+            resourceSquares.AddObject(pt, *node.obj);
+        resourceSquares.AddResource(pt, node.resources);
     }
 }
 
@@ -158,7 +175,12 @@ void World::SetNO(const MapPoint pt, noBase* obj, const bool replace /* = false*
 #if RTTR_ENABLE_ASSERTS
     RTTR_Assert(!dynamic_cast<noMovable*>(obj)); // It should be a static, non-movable object
 #endif
-    GetNodeInt(pt).obj = obj;
+    noBase*& nodeObj = GetNodeInt(pt).obj;
+    if(nodeObj)
+        resourceSquares.RemoveObject(pt, *nodeObj);
+    nodeObj = obj;
+    if(obj)
+        resourceSquares.AddObject(pt, *obj);
 }
 
 void World::DestroyNO(const MapPoint pt, const bool checkExists /* = true*/)
@@ -169,6 +191,7 @@ void World::DestroyNO(const MapPoint pt, const bool checkExists /* = true*/)
         // Destroy may remove the NO already from the map or replace it (e.g. building -> fire)
         // So remove from map, then destroy and free
         GetNodeInt(pt).obj = nullptr;
+        resourceSquares.RemoveObject(pt, *obj);
         obj->Destroy();
         deletePtr(obj);
     } else
@@ -187,9 +210,19 @@ GO_Type World::GetGOT(const MapPoint pt) const
 
 void World::ReduceResource(const MapPoint pt)
 {
-    uint8_t curAmount = GetNodeInt(pt).resources.getAmount();
+    Resource resources = GetNode(pt).resources;
+    const uint8_t curAmount = resources.getAmount();
     RTTR_Assert(curAmount > 0);
-    GetNodeInt(pt).resources.setAmount(curAmount - 1u);
+    resources.setAmount(curAmount - 1u);
+    SetResource(pt, resources);
+}
+
+void World::SetResource(const MapPoint pt, Resource newResource)
+{
+    Resource& resources = GetNodeInt(pt).resources;
+    resourceSquares.RemoveResource(pt, resources);
+    resources = newResource;
+    resourceSquares.AddResource(pt, resources);
 }
 
 void World::SetReserved(const MapPoint pt, const bool reserved)
@@ -20,6 +20,7 @@
 
 #include "world/MapBase.h"
 #include "world/MilitarySquares.h"
+#include "world/ResourceSquares.h"
 #include "gameTypes/Direction.h"
 #include "gameTypes/GO_Type.h"
 #include "gameTypes/HarborPos.h"
@@ -66,7 +67,11 @@ class World : public MapBase
     WorldDescription description_;
 
     std::unique_ptr<noBase> noNodeObj;
+    /// Trees, granite and fish per square for the searches of the workers
+    ResourceSquares resourceSquares;
     void Resize(const MapExtent& newSize) override final;
+    /// Recalculate the resource squares from the nodes (after nodes were changed directly)
+    void RecalcResourceSquares();
 
 public:
     /// Currently flying catapult stones
@@ -105,7 +110,7 @@ public:
     /// Return the game object type of the object at that point or GOT_NONE of there is none
     GO_Type GetGOT(MapPoint pt) const;
     void ReduceResource(MapPoint pt);
-    void SetResource(const MapPoint pt, Resource newResource) { GetNodeInt(pt).resources = newResource; }
+    void SetResource(MapPoint pt, Resource newResource);
     void SetOwner(const MapPoint pt, unsigned char newOwner) { GetNodeInt(pt).owner = newOwner; }
     void SetReserved(MapPoint pt, bool reserved);
     /// Sets the visibility and fires a Visibility Changed event if different
@@ -123,6 +128,8 @@ public:
     /// Incorporates node ownership into the given BQ
     BuildingQuality AdjustBQ(MapPoint pt, unsigned char player, BuildingQuality nodeBQ) const;
 
+    const ResourceSquares& GetResourceSquares() const { return resourceSquares; }
+
     /// Return the figures currently on the node
     const std::list<noBase*>& GetFigures(const MapPoint pt) const { return GetNode(pt).figures; }
 
@@ -0,0 +1,228 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "FileChecksum.h"
+#include "MapFileCache.h"
+#include "test/testConfig.h"
+#include "s25util/tmpFile.h"
+#include <boost/filesystem/operations.hpp>
+#include <boost/nowide/fstream.hpp>
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <thread>
+
+namespace {
+const std::string testMapPath = RTTR_BASE_DIR "/tests/testData/maps/LuaFunctions.SWD";
+
+template<class T_Pred>
+bool waitFor(T_Pred pred)
+{
+    for(unsigned i = 0; i < 1000 && !pred(); i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    return pred();
+}
+
+std::vector<MapFileInfo> scan(MapFileCache& cache, std::vector<std::string> files)
+{
+    cache.Scan(std::move(files));
+    BOOST_TEST_REQUIRE(waitFor([&cache]() { return !cache.IsScanning(); }));
+    return cache.GetScannedInfos();
+}
+
+MapPreview waitForPreview(MapFileCache& cache, const std::string& filePath)
+{
+    MapPreview preview;
+    BOOST_TEST_REQUIRE(waitFor([&]() {
+        preview = cache.RequestPreview(filePath);
+        return !preview.IsLoading();
+    }));
+    return preview;
+}
+
+std::string getThumbnailFileName(const std::string& mapPath)
+{
+    bnw::ifstream file(mapPath, std::ios::binary);
+    const std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::stringstream fileName;
+    fileName << std::setw(8) << std::setfill('0') << std::hex << CalcChecksumOfBuffer(data.data(), data.size()) << ".dat";
+    return fileName.str();
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(MapFileCacheSuite)
+
+BOOST_AUTO_TEST_CASE(ScanReadsOnlyValidMapsAndCachesThem)
+{
+    const bfs::path cacheDir = bfs::absolute(bfs::unique_path());
+    TmpFile brokenMap(".swd");
+    BOOST_TEST_REQUIRE(brokenMap.isValid());
+    brokenMap.getStream() << "This is not a map";
+    brokenMap.close();
+    const std::vector<std::string> files = {testMapPath, brokenMap.filePath, testMapPath + ".missing"};
+
+    MapFileInfo info;
+    {
+        MapFileCache cache(cacheDir);
+        std::vector<MapFileInfo> infos = scan(cache, files);
+        BOOST_TEST_REQUIRE(infos.size() == 1u);
+        info = infos.front();
+        BOOST_TEST(info.filePath == testMapPath);
+        BOOST_TEST(info.name == "Tot-Ecke");
+        BOOST_TEST(info.numPlayers == 3u);
+        BOOST_TEST(info.gfxSet == 0u);
+        BOOST_TEST(info.width == 80u);
+        BOOST_TEST(info.height == 48u);
+        BOOST_TEST(info.hasLua);
+        // Infos are only returned once
+        BOOST_TEST(cache.GetScannedInfos().empty());
+    }
+    BOOST_TEST_REQUIRE(bfs::file_size(cacheDir / "mapInfos.dat") > 0u);
+    // Previews are only created on request
+    BOOST_TEST(!bfs::exists(cacheDir / "mapPreviews"));
+
+    // A new instance uses the cache file and returns the same
+    MapFileCache cache(cacheDir);
+    const std::vector<MapFileInfo> infos = scan(cache, files);
+    BOOST_TEST_REQUIRE(infos.size() == 1u);
+    BOOST_TEST(infos.front().filePath == info.filePath);
+    BOOST_TEST(infos.front().name == info.name);
+    BOOST_TEST(infos.front().author == info.author);
+    BOOST_TEST(infos.front().numPlayers == info.numPlayers);
+    BOOST_TEST(infos.front().gfxSet == info.gfxSet);
+    BOOST_TEST(infos.front().width == info.width);
+    BOOST_TEST(infos.front().height == info.height);
+    BOOST_TEST(infos.front().hasLua == info.hasLua);
+    bfs::remove_all(cacheDir);
+}
+
+BOOST_AUTO_TEST_CASE(PreviewsAreLoadedOnRequest)
+{
+    TmpFile brokenMap(".swd");
+    BOOST_TEST_REQUIRE(brokenMap.isValid());
+    brokenMap.getStream() << "This is not a map";
+    brokenMap.close();
+
+    MapFileCache cache("");
+    BOOST_TEST_REQUIRE(scan(cache, {testMapPath}).size() == 1u);
+
+    MapPreview preview = waitForPreview(cache, testMapPath);
+    BOOST_TEST_REQUIRE(preview.thumbnail);
+    BOOST_TEST(preview.error.empty());
+    BOOST_TEST(preview.info.name == "Tot-Ecke");
+    BOOST_TEST(preview.thumbnail->size.x == 80u);
+    BOOST_TEST(preview.thumbnail->size.y == 48u);
+    // 2 pixels per node
+    BOOST_TEST(preview.thumbnail->pixels.size() == 80u * 2u * 48u);
+    unsigned numStartPositions = 0;
+    for(const MapPoint& pos : preview.thumbnail->startPositions)
+    {
+        if(pos.isValid())
+            numStartPositions++;
+    }
+    BOOST_TEST(numStartPositions == 3u);
+    // Now it is cached
+    BOOST_TEST(cache.RequestPreview(testMapPath).thumbnail == preview.thumbnail);
+
+    // Broken maps report an error
+    preview = waitForPreview(cache, brokenMap.filePath);
+    BOOST_TEST(!preview.thumbnail);
+    BOOST_TEST(!preview.error.empty());
+
+    // Invalidating drops the cached preview
+    const MapPreview oldPreview = cache.RequestPreview(testMapPath);
+    cache.Invalidate(testMapPath);
+    preview = waitForPreview(cache, testMapPath);
+    BOOST_TEST_REQUIRE(preview.thumbnail);
+    BOOST_TEST(preview.thumbnail != oldPreview.thumbnail);
+}
+
+BOOST_AUTO_TEST_CASE(PrefetchedPreviewsAreKeptUpToLimit)
+{
+    // Copies of the same map share a preview as it is identified by the checksum
+    TmpFile mapCopy(".swd");
+    BOOST_TEST_REQUIRE(mapCopy.isValid());
+    mapCopy.close();
+    bfs::remove(mapCopy.filePath);
+    bfs::copy_file(testMapPath, mapCopy.filePath);
+
+    MapFileCache cache("", 1);
+    BOOST_TEST_REQUIRE(scan(cache, {testMapPath, mapCopy.filePath}).size() == 2u);
+    cache.PrefetchPreview(testMapPath);
+    const MapPreview preview = waitForPreview(cache, testMapPath);
+    BOOST_TEST_REQUIRE(preview.thumbnail);
+    // The checksum of the copy is only known after reading it
+    const MapPreview copyPreview = waitForPreview(cache, mapCopy.filePath);
+    BOOST_TEST(copyPreview.thumbnail == preview.thumbnail);
+    BOOST_TEST(cache.RequestPreview(testMapPath).thumbnail == preview.thumbnail);
+}
+
+BOOST_AUTO_TEST_CASE(ThumbnailsAreStoredByChecksum)
+{
+    const bfs::path cacheDir = bfs::absolute(bfs::unique_path());
+    TmpFile mapCopy(".swd");
+    BOOST_TEST_REQUIRE(mapCopy.isValid());
+    mapCopy.close();
+    bfs::remove(mapCopy.filePath);
+    bfs::copy_file(testMapPath, mapCopy.filePath);
+
+    MapPreview preview;
+    {
+        MapFileCache cache(cacheDir);
+        BOOST_TEST_REQUIRE(scan(cache, {mapCopy.filePath}).size() == 1u);
+        preview = waitForPreview(cache, mapCopy.filePath);
+        BOOST_TEST_REQUIRE(preview.thumbnail);
+    }
+    BOOST_TEST_REQUIRE(bfs::exists(cacheDir / "mapPreviews" / getThumbnailFileName(testMapPath)));
+
+    // Overwrite the map but keep its size and modification time, so it counts as unchanged.
+    // The stored thumbnail must be used as the map itself can no longer be read
+    const auto fileSize = bfs::file_size(mapCopy.filePath);
+    const std::time_t lastWriteTime = bfs::last_write_time(mapCopy.filePath);
+    {
+        bnw::ofstream file(mapCopy.filePath, std::ios::binary);
+        file << std::string(fileSize, '\0');
+    }
+    bfs::last_write_time(mapCopy.filePath, lastWriteTime);
+    {
+        MapFileCache cache(cacheDir);
+        BOOST_TEST_REQUIRE(scan(cache, {mapCopy.filePath}).size() == 1u);
+        const MapPreview cachedPreview = waitForPreview(cache, mapCopy.filePath);
+        BOOST_TEST_REQUIRE(cachedPreview.thumbnail);
+        BOOST_TEST(cachedPreview.info.name == "Tot-Ecke");
+        BOOST_TEST(cachedPreview.thumbnail->size.x == preview.thumbnail->size.x);
+        BOOST_TEST(cachedPreview.thumbnail->size.y == preview.thumbnail->size.y);
+        BOOST_TEST(cachedPreview.thumbnail->pixels == preview.thumbnail->pixels, boost::test_tools::per_element());
+        BOOST_TEST_REQUIRE((cachedPreview.thumbnail->startPositions == preview.thumbnail->startPositions));
+    }
+
+    // Now it really changed, so the map is read again
+    bfs::last_write_time(mapCopy.filePath, lastWriteTime + 10);
+    {
+        MapFileCache cache(cacheDir);
+        BOOST_TEST(scan(cache, {mapCopy.filePath}).empty());
+        const MapPreview brokenPreview = waitForPreview(cache, mapCopy.filePath);
+        BOOST_TEST(!brokenPreview.thumbnail);
+        BOOST_TEST(!brokenPreview.error.empty());
+    }
+    bfs::remove_all(cacheDir);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
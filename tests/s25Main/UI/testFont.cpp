@@ -48,4 +48,80 @@ BOOST_FIXTURE_TEST_CASE(WrapInfoWithTrailingNewlines, uiHelper::Fixture)
     BOOST_TEST(wrapInfo.CreateSingleStrings(input) == output, boost::test_tools::per_element{});
 }
 
+BOOST_FIXTURE_TEST_CASE(DrawReusesLayouts, uiHelper::Fixture)
+{
+    BOOST_TEST_REQUIRE(LOADER.LoadFonts());
+    glFont& font = *SmallFont;
+    font.ClearLayoutCache();
+    font.ResetLayoutCacheStats();
+
+    for(int i = 0; i < 10; i++)
+        font.Draw(DrawPoint(i, 2 * i), "Hello", FontStyle::LEFT);
+    BOOST_TEST(font.GetLayoutCacheStats().numMisses == 1u);
+    BOOST_TEST(font.GetLayoutCacheStats().numHits == 9u);
+    BOOST_TEST(font.GetLayoutCacheSize() == 1u);
+
+    // Alignment and color only move/tint the glyphs
+    font.Draw(DrawPoint(0, 0), "Hello", FontStyle::CENTER | FontStyle::VCENTER, COLOR_RED);
+    font.Draw(DrawPoint(0, 0), "Hello", FontStyle::RIGHT | FontStyle::BOTTOM);
+    BOOST_TEST(font.GetLayoutCacheStats().numMisses == 1u);
+    BOOST_TEST(font.GetLayoutCacheStats().numHits == 11u);
+    // Other glyphs, width limits and truncation suffixes require a new layout
+    font.Draw(DrawPoint(0, 0), "Hello", FontStyle::NO_OUTLINE);
+    font.Draw(DrawPoint(0, 0), "Hello", FontStyle::LEFT, COLOR_WHITE, font.getWidth("Hel"));
+    font.Draw(DrawPoint(0, 0), "Hello", FontStyle::LEFT, COLOR_WHITE, font.getWidth("Hel"), "..");
+    font.Draw(DrawPoint(0, 0), "Hello World", FontStyle::LEFT);
+    BOOST_TEST(font.GetLayoutCacheStats().numMisses == 5u);
+    BOOST_TEST(font.GetLayoutCacheStats().numHits == 11u);
+    BOOST_TEST(font.GetLayoutCacheSize() == 5u);
+    // Suffix is ignored when the width is not limited
+    font.Draw(DrawPoint(0, 0), "Hello", FontStyle::LEFT, COLOR_WHITE, 0xFFFF, "..");
+    BOOST_TEST(font.GetLayoutCacheStats().numHits == 12u);
+    // Empty texts are not laid out at all
+    font.Draw(DrawPoint(0, 0), "", FontStyle::LEFT);
+    BOOST_TEST(font.GetLayoutCacheStats().numMisses == 5u);
+    BOOST_TEST(font.GetLayoutCacheStats().numHits == 12u);
+    BOOST_TEST(font.GetLayoutCacheStats().numEvictions == 0u);
+    // Layouts keep their own copy of the text which was only a temporary when they were created
+    std::string text = "Hello World";
+    font.Draw(DrawPoint(0, 0), text, FontStyle::LEFT);
+    text = "Hello Moon!";
+    font.Draw(DrawPoint(0, 0), "Hello World", FontStyle::LEFT);
+    BOOST_TEST(font.GetLayoutCacheStats().numMisses == 5u);
+    BOOST_TEST(font.GetLayoutCacheStats().numHits == 14u);
+}
+
+BOOST_FIXTURE_TEST_CASE(LayoutCacheEvictsLeastRecentlyUsed, uiHelper::Fixture)
+{
+    BOOST_TEST_REQUIRE(LOADER.LoadFonts());
+    glFont& font = *SmallFont;
+    font.ClearLayoutCache();
+    font.ResetLayoutCacheStats();
+    font.SetLayoutCacheSize(2);
+
+    font.Draw(DrawPoint(0, 0), "a", FontStyle::LEFT);
+    font.Draw(DrawPoint(0, 0), "b", FontStyle::LEFT);
+    // Use "a" so "b" is the oldest one
+    font.Draw(DrawPoint(0, 0), "a", FontStyle::LEFT);
+    font.Draw(DrawPoint(0, 0), "c", FontStyle::LEFT);
+    BOOST_TEST(font.GetLayoutCacheSize() == 2u);
+    BOOST_TEST(font.GetLayoutCacheStats().numEvictions == 1u);
+    BOOST_TEST(font.GetLayoutCacheStats().numMisses == 3u);
+    BOOST_TEST(font.GetLayoutCacheStats().numHits == 1u);
+    font.Draw(DrawPoint(0, 0), "a", FontStyle::LEFT);
+    font.Draw(DrawPoint(0, 0), "c", FontStyle::LEFT);
+    BOOST_TEST(font.GetLayoutCacheStats().numHits == 3u);
+    font.Draw(DrawPoint(0, 0), "b", FontStyle::LEFT);
+    BOOST_TEST(font.GetLayoutCacheStats().numMisses == 4u);
+    BOOST_TEST(font.GetLayoutCacheStats().numEvictions == 2u);
+
+    // Shrinking removes the oldest entries
+    font.SetLayoutCacheSize(1);
+    BOOST_TEST(font.GetLayoutCacheSize() == 1u);
+    BOOST_TEST(font.GetLayoutCacheStats().numEvictions == 3u);
+    font.Draw(DrawPoint(0, 0), "b", FontStyle::LEFT);
+    BOOST_TEST(font.GetLayoutCacheStats().numHits == 4u);
+    font.SetLayoutCacheSize(1024);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
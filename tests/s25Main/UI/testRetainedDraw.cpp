@@ -0,0 +1,228 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "WindowManager.h"
+#include "desktops/Desktop.h"
+#include "driver/MouseCoords.h"
+#include "ingameWindows/IngameWindow.h"
+#include "uiHelper/uiHelpers.hpp"
+#include "gameData/const_gui_ids.h"
+#include <boost/test/unit_test.hpp>
+
+namespace {
+/// Control counting how often it was drawn
+class ctrlDrawCounter : public Window
+{
+public:
+    ctrlDrawCounter(Window* parent, unsigned id, const DrawPoint& pos, unsigned& numDraws)
+        : Window(parent, id, pos, Extent(10, 10)), numDraws_(numDraws)
+    {}
+
+protected:
+    void Draw_() override { ++numDraws_; }
+
+private:
+    unsigned& numDraws_;
+};
+
+template<class T>
+void addCounters(T& wnd, unsigned numCtrls, unsigned& numDraws)
+{
+    for(unsigned i = 0; i < numCtrls; i++)
+        wnd.AddCtrl(new ctrlDrawCounter(&wnd, i, DrawPoint(10 + (i % 10) * 12, 30 + (i / 10) * 12), numDraws));
+}
+
+class dskDrawCounter : public Desktop
+{
+public:
+    dskDrawCounter(unsigned numCtrls, unsigned& numDraws) : Desktop(nullptr) { addCounters(*this, numCtrls, numDraws); }
+};
+
+/// Desktop polling for a background result each frame like dskSelectMap and showing it in a control
+class dskPolling : public Desktop
+{
+public:
+    unsigned numPolls = 0;
+    bool resultReady = false;
+
+    dskPolling(unsigned& numDraws) : Desktop(nullptr)
+    {
+        AddCtrl(new ctrlDrawCounter(this, 0, DrawPoint(10, 30), numDraws))->SetVisible(false);
+    }
+
+    void Msg_PaintBefore() override
+    {
+        Desktop::Msg_PaintBefore();
+        ++numPolls;
+        if(resultReady)
+            GetCtrl<Window>(0)->SetVisible(true);
+    }
+};
+
+class iwDrawCounter : public IngameWindow
+{
+public:
+    iwDrawCounter(unsigned numCtrls, unsigned& numDraws) : IngameWindow(CGI_HELP, DrawPoint(100, 100), Extent(200, 200), "", nullptr)
+    {
+        addCounters(*this, numCtrls, numDraws);
+    }
+};
+
+struct RetainedDrawFixture : uiHelper::Fixture
+{
+    const unsigned numCtrls = 50;
+    const unsigned numFrames = 10;
+    unsigned numDraws = 0;
+    dskDrawCounter* dsk;
+
+    RetainedDrawFixture()
+    {
+        dsk = static_cast<dskDrawCounter*>(WINDOWMANAGER.Switch(std::make_unique<dskDrawCounter>(numCtrls, numDraws)));
+        WINDOWMANAGER.Draw();
+    }
+    ~RetainedDrawFixture()
+    {
+        WINDOWMANAGER.SetRetainedMode(false);
+        // Don't leave the desktop referencing the counter behind
+        WINDOWMANAGER.Switch(std::make_unique<Desktop>(nullptr));
+        WINDOWMANAGER.Draw();
+    }
+
+    /// Draw some frames without any input and return the number of control draws per frame
+    unsigned drawIdleFrames()
+    {
+        numDraws = 0;
+        for(unsigned i = 0; i < numFrames; i++)
+            WINDOWMANAGER.Draw();
+        return numDraws / numFrames;
+    }
+};
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(RetainedDraw, RetainedDrawFixture)
+
+BOOST_AUTO_TEST_CASE(IdleFrames)
+{
+    WINDOWMANAGER.SetRetainedMode(false);
+    const unsigned numDrawsImmediate = drawIdleFrames();
+    BOOST_TEST(numDrawsImmediate == numCtrls);
+
+    WINDOWMANAGER.SetRetainedMode(true);
+    // First frame has to draw everything to fill the cache
+    numDraws = 0;
+    WINDOWMANAGER.Draw();
+    BOOST_TEST(numDraws == numCtrls);
+    const unsigned numDrawsRetained = drawIdleFrames();
+    BOOST_TEST(numDrawsRetained == 0u);
+
+    BOOST_TEST_MESSAGE("Control draws per idle frame: " << numDrawsImmediate << " (immediate) vs. " << numDrawsRetained
+                                                        << " (retained)");
+}
+
+BOOST_AUTO_TEST_CASE(ChangesCauseRedraw)
+{
+    WINDOWMANAGER.SetRetainedMode(true);
+    WINDOWMANAGER.Draw();
+    BOOST_TEST(drawIdleFrames() == 0u);
+
+    // A changed control redraws its desktop once
+    dsk->GetCtrl<Window>(5)->Invalidate();
+    numDraws = 0;
+    WINDOWMANAGER.Draw();
+    BOOST_TEST(numDraws == numCtrls);
+    BOOST_TEST(drawIdleFrames() == 0u);
+
+    // Same for hiding a control and for input
+    dsk->GetCtrl<Window>(7)->SetVisible(false);
+    numDraws = 0;
+    WINDOWMANAGER.Draw();
+    BOOST_TEST(numDraws == numCtrls - 1u);
+    WINDOWMANAGER.Msg_MouseMove(MouseCoords(Position(20, 40)));
+    numDraws = 0;
+    WINDOWMANAGER.Draw();
+    BOOST_TEST(numDraws == numCtrls - 1u);
+    BOOST_TEST(drawIdleFrames() == 0u);
+
+    // Disabling retained mode draws everything again
+    WINDOWMANAGER.SetRetainedMode(false);
+    BOOST_TEST(drawIdleFrames() == numCtrls - 1u);
+}
+
+BOOST_AUTO_TEST_CASE(IngameWindows)
+{
+    WINDOWMANAGER.SetRetainedMode(true);
+    unsigned numWndDraws = 0;
+    auto& wnd = WINDOWMANAGER.Show(std::make_unique<iwDrawCounter>(numCtrls, numWndDraws));
+    WINDOWMANAGER.Draw();
+    BOOST_TEST(numWndDraws == numCtrls);
+
+    numWndDraws = 0;
+    BOOST_TEST(drawIdleFrames() == 0u);
+    BOOST_TEST(numWndDraws == 0u);
+
+    // Moving the window does not change its content
+    wnd.SetPos(wnd.GetPos() + DrawPoint(20, 10));
+    WINDOWMANAGER.Draw();
+    BOOST_TEST(numWndDraws == 0u);
+
+    // But changing it does
+    wnd.SetTitle("Changed");
+    WINDOWMANAGER.Draw();
+    BOOST_TEST(numWndDraws == numCtrls);
+
+    // Window partially off screen can't be cached
+    wnd.SetPos(DrawPoint(700, 100));
+    numWndDraws = 0;
+    for(unsigned i = 0; i < numFrames; i++)
+        WINDOWMANAGER.Draw();
+    BOOST_TEST(numWndDraws == numFrames * numCtrls);
+
+    wnd.Close();
+    WINDOWMANAGER.Draw();
+}
+
+BOOST_AUTO_TEST_CASE(DesktopPollsWithoutInput)
+{
+    WINDOWMANAGER.SetRetainedMode(true);
+    unsigned numPollingDraws = 0;
+    auto* pollingDsk = static_cast<dskPolling*>(WINDOWMANAGER.Switch(std::make_unique<dskPolling>(numPollingDraws)));
+    WINDOWMANAGER.Draw();
+    // A window like iwPleaseWait gets all input
+    unsigned numWndDraws = 0;
+    auto& wnd = WINDOWMANAGER.Show(std::make_unique<iwDrawCounter>(1, numWndDraws));
+    WINDOWMANAGER.Draw();
+    BOOST_TEST_REQUIRE(!pollingDsk->IsActive());
+
+    // Polling continues although the desktop is drawn from its cache
+    pollingDsk->numPolls = 0;
+    numWndDraws = 0;
+    for(unsigned i = 0; i < numFrames; i++)
+        WINDOWMANAGER.Draw();
+    BOOST_TEST(pollingDsk->numPolls == numFrames);
+    BOOST_TEST(numPollingDraws == 0u);
+    BOOST_TEST(numWndDraws == 0u);
+    // And the result is shown in the same frame
+    pollingDsk->resultReady = true;
+    WINDOWMANAGER.Draw();
+    BOOST_TEST(numPollingDraws == 1u);
+
+    wnd.Close();
+    WINDOWMANAGER.Draw();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
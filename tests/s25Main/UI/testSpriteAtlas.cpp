@@ -0,0 +1,135 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "ogl/glSmartBitmap.h"
+#include "ogl/glSpriteAtlas.h"
+#include "uiHelper/uiHelpers.hpp"
+#include "libsiedler2/ArchivItem_Bitmap_Raw.h"
+#include "libsiedler2/PixelBufferBGRA.h"
+#include <boost/test/unit_test.hpp>
+#include <array>
+
+BOOST_FIXTURE_TEST_SUITE(SpriteAtlas, uiHelper::Fixture)
+
+BOOST_AUTO_TEST_CASE(PacksOnFirstUse)
+{
+    // Atlas must outlive the bitmaps
+    glSpriteAtlas atlas(0, Extent(64, 64));
+    std::array<libsiedler2::ArchivItem_Bitmap_Raw, 3> bmps;
+    std::array<glSmartBitmap, 3> smartBmps;
+    for(unsigned i = 0; i < bmps.size(); ++i)
+    {
+        libsiedler2::PixelBufferBGRA buffer(10 + i, 12, libsiedler2::ColorBGRA(0xFFFFFFFF));
+        bmps[i].create(buffer);
+        smartBmps[i].add(&bmps[i]);
+        smartBmps[i].setAtlas(&atlas);
+    }
+    // Nothing packed before drawing
+    BOOST_TEST(atlas.getNumPages() == 0u);
+    for(const auto& bmp : smartBmps)
+        BOOST_TEST(!bmp.isGenerated());
+
+    BOOST_TEST(atlas.acquire(smartBmps[0]));
+    BOOST_TEST(atlas.getNumPages() == 1u);
+    BOOST_TEST(smartBmps[0].isGenerated());
+    BOOST_TEST(!smartBmps[1].isGenerated());
+    BOOST_TEST(atlas.getStats().numMisses == 1u);
+
+    BOOST_TEST(atlas.acquire(smartBmps[1]));
+    BOOST_TEST(atlas.acquire(smartBmps[0]));
+    BOOST_TEST(atlas.getStats().numMisses == 2u);
+    BOOST_TEST(atlas.getStats().numHits == 1u);
+    // All on the same page
+    BOOST_TEST(smartBmps[0].getTexture() == smartBmps[1].getTexture());
+    // And not overlapping
+    BOOST_TEST(smartBmps[0].texCoords[2].x <= smartBmps[1].texCoords[0].x);
+
+    // Removing bitmaps from the atlas frees its texture
+    smartBmps[0].reset();
+    BOOST_TEST(!smartBmps[0].isGenerated());
+}
+
+BOOST_AUTO_TEST_CASE(EvictsLeastRecentlyUsedPage)
+{
+    // Only 2 pages allowed, each bitmap needs its own page
+    const Extent pageSize(32, 32);
+    glSpriteAtlas atlas(2 * pageSize.x * pageSize.y * 4u, pageSize);
+    std::array<libsiedler2::ArchivItem_Bitmap_Raw, 3> bmps;
+    std::array<glSmartBitmap, 3> smartBmps;
+    for(unsigned i = 0; i < bmps.size(); ++i)
+    {
+        libsiedler2::PixelBufferBGRA buffer(30, 30, libsiedler2::ColorBGRA(0xFFFFFFFF));
+        bmps[i].create(buffer);
+        smartBmps[i].add(&bmps[i]);
+        smartBmps[i].setAtlas(&atlas);
+    }
+    BOOST_TEST(atlas.acquire(smartBmps[0]));
+    BOOST_TEST(atlas.acquire(smartBmps[1]));
+    BOOST_TEST(atlas.acquire(smartBmps[0]));
+    BOOST_TEST(atlas.getNumPages() == 2u);
+    BOOST_TEST(atlas.getStats().numEvictions == 0u);
+    // Page of bmp 1 is the LRU one
+    BOOST_TEST(atlas.acquire(smartBmps[2]));
+    BOOST_TEST(atlas.getNumPages() == 2u);
+    BOOST_TEST(atlas.getStats().numEvictions == 1u);
+    BOOST_TEST(smartBmps[0].isGenerated());
+    BOOST_TEST(!smartBmps[1].isGenerated());
+    BOOST_TEST(smartBmps[2].isGenerated());
+    BOOST_TEST(atlas.getMemoryUsage() <= 2 * pageSize.x * pageSize.y * 4u);
+
+    // Evicted bitmap is packed again when drawn replacing the now least recently used bitmap
+    BOOST_TEST(atlas.acquire(smartBmps[1]));
+    BOOST_TEST(!smartBmps[0].isGenerated());
+    BOOST_TEST(smartBmps[1].isGenerated());
+    BOOST_TEST(smartBmps[2].isGenerated());
+    BOOST_TEST(atlas.getStats().numEvictions == 2u);
+}
+
+BOOST_AUTO_TEST_CASE(HugeBudgetDoesNotOverflow)
+{
+    // 4 GiB would wrap to 0 in 32 bit allowing only one page
+    glSpriteAtlas atlas(uint64_t(4096) * 1024u * 1024u, Extent(32, 32));
+    std::array<libsiedler2::ArchivItem_Bitmap_Raw, 3> bmps;
+    std::array<glSmartBitmap, 3> smartBmps;
+    for(unsigned i = 0; i < bmps.size(); ++i)
+    {
+        libsiedler2::PixelBufferBGRA buffer(30, 30, libsiedler2::ColorBGRA(0xFFFFFFFF));
+        bmps[i].create(buffer);
+        smartBmps[i].add(&bmps[i]);
+        smartBmps[i].setAtlas(&atlas);
+        BOOST_TEST(atlas.acquire(smartBmps[i]));
+    }
+    BOOST_TEST(atlas.getNumPages() == 3u);
+    BOOST_TEST(atlas.getStats().numEvictions == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(TooBigBitmapsGetOwnTexture)
+{
+    glSpriteAtlas atlas(0, Extent(32, 32));
+    libsiedler2::ArchivItem_Bitmap_Raw bmp;
+    libsiedler2::PixelBufferBGRA buffer(40, 10, libsiedler2::ColorBGRA(0xFFFFFFFF));
+    bmp.create(buffer);
+    glSmartBitmap smartBmp;
+    smartBmp.add(&bmp);
+    smartBmp.setAtlas(&atlas);
+    BOOST_TEST(!atlas.acquire(smartBmp));
+    BOOST_TEST(!smartBmp.isGenerated());
+    BOOST_TEST(atlas.getNumPages() == 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -21,6 +21,8 @@
 #include "uiHelper/uiHelpers.hpp"
 #include "libsiedler2/ArchivItem_Bitmap_Raw.h"
 #include "libsiedler2/PixelBufferBGRA.h"
+#include <rttr/test/LogAccessor.hpp>
+#include <boost/filesystem/operations.hpp>
 #include <boost/test/unit_test.hpp>
 #include <Rect.h>
 #include <array>
@@ -74,4 +76,63 @@ BOOST_AUTO_TEST_CASE(SizeAndPosCorrect)
     }
 }
 
+BOOST_AUTO_TEST_CASE(CachedPackingMatchesPacking)
+{
+    rttr::test::LogAccessor logAcc;
+    const bfs::path cacheFilePath = bfs::absolute(bfs::unique_path()) / "textures.dat";
+    std::array<libsiedler2::ArchivItem_Bitmap_Raw, 4> bmps;
+    for(unsigned i = 0; i < bmps.size(); ++i)
+    {
+        libsiedler2::PixelBufferBGRA buffer(5 + i, 11 + i * 3, libsiedler2::ColorBGRA(0xFF000000 + i));
+        bmps[i].create(buffer);
+    }
+    std::array<glSmartBitmap, 4> smartBmps;
+    {
+        glTexturePacker packer;
+        for(unsigned i = 0; i < bmps.size(); ++i)
+        {
+            smartBmps[i].add(&bmps[i]);
+            packer.add(smartBmps[i]);
+        }
+        BOOST_TEST_REQUIRE(packer.pack(cacheFilePath));
+        BOOST_TEST_REQUIRE(bfs::exists(cacheFilePath));
+    }
+    // Same bitmaps -> Cache is used and results in the same texture coordinates
+    {
+        std::array<glSmartBitmap, 4> cachedBmps;
+        glTexturePacker packer;
+        for(unsigned i = 0; i < bmps.size(); ++i)
+        {
+            cachedBmps[i].add(&bmps[i]);
+            packer.add(cachedBmps[i]);
+        }
+        BOOST_TEST_REQUIRE(packer.pack(cacheFilePath));
+        BOOST_TEST_REQUIRE(packer.getTextures().size() == 1u);
+        for(unsigned i = 0; i < bmps.size(); ++i)
+        {
+            BOOST_TEST(cachedBmps[i].isGenerated());
+            for(unsigned j = 0; j < smartBmps[i].texCoords.size(); ++j)
+            {
+                BOOST_TEST(cachedBmps[i].texCoords[j].x == smartBmps[i].texCoords[j].x);
+                BOOST_TEST(cachedBmps[i].texCoords[j].y == smartBmps[i].texCoords[j].y);
+            }
+        }
+    }
+    // Different bitmaps -> Cache is rejected and recreated
+    {
+        std::array<glSmartBitmap, 3> otherBmps;
+        glTexturePacker packer;
+        for(unsigned i = 0; i < otherBmps.size(); ++i)
+        {
+            otherBmps[i].add(&bmps[i]);
+            packer.add(otherBmps[i]);
+        }
+        BOOST_TEST_REQUIRE(packer.pack(cacheFilePath));
+        for(const auto& bmp : otherBmps)
+            BOOST_TEST(bmp.isGenerated());
+    }
+    logAcc.clearLog();
+    bfs::remove_all(cacheFilePath.parent_path());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
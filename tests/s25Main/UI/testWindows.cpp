@@ -23,8 +23,11 @@
 #include "desktops/Desktop.h"
 #include "ingameWindows/iwVictory.h"
 #include "uiHelper/uiHelpers.hpp"
+#include "driver/KeyEvent.h"
+#include "driver/MouseCoords.h"
 #include <turtle/mock.hpp>
 #include <boost/test/unit_test.hpp>
+#include <functional>
 
 //-V:MOCK_METHOD:813
 //-V:MOCK_EXPECT:807
@@ -101,4 +104,85 @@ BOOST_AUTO_TEST_CASE(DrawOrder)
     mock::verify();
 }
 
+namespace {
+/// Records the IDs of all windows receiving an input message and optionally runs an action on it
+class RecordingWindow : public Window
+{
+public:
+    RecordingWindow(Window* parent, unsigned id, std::vector<unsigned>& receivedIds)
+        : Window(parent, id, DrawPoint(0, 0), Extent(10, 10)), receivedIds_(receivedIds)
+    {}
+    std::function<void()> onMessage;
+
+    bool Msg_LeftDown(const MouseCoords&) override { return OnMessage(); }
+    bool Msg_KeyDown(const KeyEvent&) override { return OnMessage(); }
+
+private:
+    std::vector<unsigned>& receivedIds_;
+
+    bool OnMessage()
+    {
+        receivedIds_.push_back(GetID());
+        if(onMessage)
+            onMessage();
+        return false;
+    }
+};
+} // namespace
+
+BOOST_AUTO_TEST_CASE(CtrlsOrderedById)
+{
+    Window wnd(nullptr, 0, DrawPoint(0, 0), Extent(100, 100));
+    std::vector<unsigned> receivedIds;
+    for(unsigned id : {5u, 1u, 3u})
+        wnd.AddCtrl(new RecordingWindow(&wnd, id, receivedIds));
+    ctrlButton* bt = wnd.AddColorButton(2, DrawPoint(0, 0), Extent(10, 10), TC_GREY, COLOR_RED);
+
+    BOOST_TEST(wnd.GetCtrl<ctrlButton>(2) == bt);
+    BOOST_TEST(!wnd.GetCtrl<ctrlButton>(3));
+    BOOST_TEST(!wnd.GetCtrl<Window>(4));
+    std::vector<unsigned> ids;
+    for(const Window* ctrl : wnd.GetCtrls<Window>())
+        ids.push_back(ctrl->GetID());
+    BOOST_TEST(ids == std::vector<unsigned>({1, 2, 3, 5}), boost::test_tools::per_element());
+    BOOST_TEST(wnd.GetCtrls<RecordingWindow>().size() == 3u);
+    BOOST_TEST(wnd.GetCtrls<ctrlButton>() == std::vector<ctrlButton*>(1, bt), boost::test_tools::per_element());
+
+    // Lists are updated when controls change
+    wnd.DeleteCtrl(1);
+    wnd.DeleteCtrl(2);
+    wnd.AddCtrl(new RecordingWindow(&wnd, 4, receivedIds));
+    ids.clear();
+    for(const RecordingWindow* ctrl : static_cast<const Window&>(wnd).GetCtrls<RecordingWindow>())
+        ids.push_back(ctrl->GetID());
+    BOOST_TEST(ids == std::vector<unsigned>({3, 4, 5}), boost::test_tools::per_element());
+    BOOST_TEST(wnd.GetCtrls<ctrlButton>().empty());
+}
+
+BOOST_AUTO_TEST_CASE(CtrlsChangedDuringRelay)
+{
+    Window wnd(nullptr, 0, DrawPoint(0, 0), Extent(100, 100));
+    std::vector<unsigned> receivedIds;
+    for(unsigned id = 1; id <= 5; id++)
+        wnd.AddCtrl(new RecordingWindow(&wnd, id, receivedIds));
+    wnd.SetActive(true);
+
+    // Mouse messages go to the topmost (highest ID) controls first
+    wnd.GetCtrl<RecordingWindow>(4)->onMessage = [&wnd, &receivedIds]() {
+        wnd.DeleteCtrl(2);
+        wnd.AddCtrl(new RecordingWindow(&wnd, 10, receivedIds));
+    };
+    wnd.RelayMouseMessage(&Window::Msg_LeftDown, MouseCoords(1, 1));
+    BOOST_TEST(receivedIds == std::vector<unsigned>({5, 4, 3, 1}), boost::test_tools::per_element());
+
+    // Keyboard messages go to the controls in order of their IDs. The deleted control is skipped, the new one is reached
+    receivedIds.clear();
+    wnd.GetCtrl<RecordingWindow>(3)->onMessage = [&wnd, &receivedIds]() {
+        wnd.DeleteCtrl(4);
+        wnd.AddCtrl(new RecordingWindow(&wnd, 6, receivedIds));
+    };
+    wnd.RelayKeyboardMessage(&Window::Msg_KeyDown, KeyEvent{KT_CHAR, 'a', false, false, false});
+    BOOST_TEST(receivedIds == std::vector<unsigned>({1, 3, 5, 6, 10}), boost::test_tools::per_element());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
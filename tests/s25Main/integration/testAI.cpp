@@ -16,8 +16,12 @@
 // along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
 
 #include "rttrDefines.h" // IWYU pragma: keep
+#include "PointOutput.h"
+#include "ai/AIInterface.h"
 #include "ai/AIPlayer.h"
+#include "ai/aijh/AIConstruction.h"
 #include "ai/aijh/AIPlayerJH.h"
+#include "ai/aijh/Jobs.h"
 #include "buildings/noBuilding.h"
 #include "buildings/noBuildingSite.h"
 #include "buildings/nobBaseWarehouse.h"
@@ -26,13 +30,21 @@
 #include "factories/BuildingFactory.h"
 #include "worldFixtures/WorldWithGCExecution.h"
 #include "nodeObjs/noFlag.h"
+#include "nodeObjs/noGranite.h"
 #include "nodeObjs/noTree.h"
 #include "gameData/BuildingProperties.h"
+#include "rttr/test/random.hpp"
 #include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <limits>
 #include <memory>
 
 // We need border land
 using BiggerWorldWithGCExecution = WorldWithGCExecution<1, 24, 22>;
+using ResourceWorldWithGCExecution = WorldWithGCExecution<2, 40, 30>;
+using BigWorld8P = WorldFixture<CreateEmptyWorld, 8, 512, 512>;
 
 template<class T_Col>
 inline bool containsBldType(const T_Col& collection, BuildingType type)
@@ -149,6 +161,79 @@ BOOST_FIXTURE_TEST_CASE(KeepBQUpdated, BiggerWorldWithGCExecution)
     }
 }
 
+BOOST_FIXTURE_TEST_CASE(KeepNodesUpdatedByNotifications, BiggerWorldWithGCExecution)
+{
+    auto ai = AIFactory::Create(AI::Info(AI::DEFAULT, AI::HARD), curPlayer, world);
+    const AIJH::AIPlayerJH& aijh = static_cast<AIJH::AIPlayerJH&>(*ai);
+    const auto runGF = [&]() {
+        em.ExecuteNextGF();
+        ai->RunGF(em.GetCurrentGF(), true);
+    };
+    // Compare to the nodes of a newly created AI which calculates them from scratch
+    const auto checkNodes = [&]() {
+        auto freshAI = AIFactory::Create(AI::Info(AI::DEFAULT, AI::HARD), curPlayer, world);
+        const AIJH::AIPlayerJH& freshAIJH = static_cast<AIJH::AIPlayerJH&>(*freshAI);
+        RTTR_FOREACH_PT(MapPoint, world.GetSize())
+        {
+            const AIJH::Node& node = aijh.GetAINode(pt);
+            const AIJH::Node& expectedNode = freshAIJH.GetAINode(pt);
+            BOOST_TEST_INFO("Point " << pt);
+            BOOST_TEST_REQUIRE(node.owned == expectedNode.owned);
+            BOOST_TEST_REQUIRE(node.border == expectedNode.border);
+            BOOST_TEST_REQUIRE(node.reachable == expectedNode.reachable);
+        }
+    };
+    runGF();
+    checkNodes();
+
+    // Flag and road
+    const MapPoint flagPos = world.MakeMapPoint(world.GetNeighbour(hqPos, Direction::SOUTHEAST) + Position(4, 0));
+    this->SetFlag(flagPos);
+    this->BuildRoad(flagPos, false, std::vector<Direction>(4, Direction::WEST));
+    BOOST_TEST_REQUIRE(world.GetSpecObj<noFlag>(flagPos)->GetRoute(Direction::WEST));
+    runGF();
+    checkNodes();
+
+    // Destroy road and flag
+    this->DestroyFlag(flagPos);
+    runGF();
+    checkNodes();
+
+    // Area enclosed by granite with a flag as its only source
+    const MapPoint enclosedFlagPos = world.MakeMapPoint(hqPos + Position(-5, 0));
+    for(const MapPoint pt : world.PointsOnRing(enclosedFlagPos, 2))
+    {
+        world.SetNO(pt, new noGranite(GT_1, 5));
+        world.RecalcBQAroundPoint(pt);
+    }
+    runGF();
+    checkNodes();
+    this->SetFlag(enclosedFlagPos);
+    BOOST_TEST_REQUIRE(world.GetSpecObj<noFlag>(enclosedFlagPos));
+    runGF();
+    checkNodes();
+    BOOST_TEST_REQUIRE(aijh.GetAINode(enclosedFlagPos).reachable);
+    // Without the flag the area is not reachable anymore
+    this->DestroyFlag(enclosedFlagPos);
+    runGF();
+    checkNodes();
+    BOOST_TEST_REQUIRE(!aijh.GetAINode(enclosedFlagPos).reachable);
+
+    // Gain land
+    const MapPoint bldPos = world.MakeMapPoint(hqPos + Position(6, 0));
+    this->SetBuildingSite(bldPos, BLD_BARRACKS);
+    this->BuildRoad(world.GetNeighbour(bldPos, Direction::SOUTHEAST), false, std::vector<Direction>(6, Direction::WEST));
+    runGF();
+    checkNodes();
+    RTTR_EXEC_TILL(2000, world.GetSpecObj<nobMilitary>(bldPos));
+    const nobMilitary* bld = world.GetSpecObj<nobMilitary>(bldPos);
+    for(unsigned i = 0; i < 500 && bld->GetNumTroops() == 0; i++)
+        runGF();
+    BOOST_TEST_REQUIRE(bld->GetNumTroops() > 0u);
+    runGF();
+    checkNodes();
+}
+
 BOOST_FIXTURE_TEST_CASE(BuildWoodIndustry, WorldWithGCExecution<1>)
 {
     // Place a few trees
@@ -214,4 +299,267 @@ BOOST_FIXTURE_TEST_CASE(ExpandWhenNoSpace, BiggerWorldWithGCExecution)
     BOOST_REQUIRE(containsBldType(bldSites, BLD_BARRACKS) || containsBldType(bldSites, BLD_GUARDHOUSE));
 }
 
+BOOST_FIXTURE_TEST_CASE(JobBudgetLimitsWorkPerGF, WorldWithGCExecution<1>)
+{
+    // Jobs executed per call of ExecuteJobs (at most 5 of each kind) for 5 connect and 5 build jobs.
+    // First with only the budget of the current GF, then with the maximum saved from previous GFs
+    struct LevelBudget
+    {
+        AI::Level level;
+        unsigned budget;
+        unsigned numConnectJobs, numBuildJobs;
+        unsigned numConnectJobsSaved, numBuildJobsSaved;
+    };
+    const std::array<LevelBudget, 3> levelBudgets{{
+      {AI::EASY, 6, 3, 0, 5, 1},
+      {AI::MEDIUM, 12, 5, 1, 5, 4},
+      {AI::HARD, 20, 5, 3, 5, 5},
+    }};
+    // Build jobs for a disabled building finish right away but cost 4 units for the position search
+    world.GetPlayer(curPlayer).DisableBuilding(BLD_WOODCUTTER);
+    // Connect jobs for a removed flag fail right away but cost 2 units for the road search
+    std::vector<MapPoint> flagPositions;
+    for(const MapPoint pt : world.GetPointsInRadius(hqPos, 6))
+    {
+        if(flagPositions.size() < 5u && world.GetBQ(pt, curPlayer) != BQ_NOTHING && !world.GetSpecObj<noFlag>(pt))
+            flagPositions.push_back(pt);
+    }
+    BOOST_TEST_REQUIRE(flagPositions.size() == 5u);
+
+    for(const LevelBudget& levelBudget : levelBudgets)
+    {
+        auto ai = AIFactory::Create(AI::Info(AI::DEFAULT, levelBudget.level), curPlayer, world);
+        AIJH::AIPlayerJH& aijh = static_cast<AIJH::AIPlayerJH&>(*ai);
+        AIJH::AIConstruction& construction = aijh.GetConstruction();
+        const unsigned budget = aijh.GetJobBudgetPerGF();
+        BOOST_TEST_REQUIRE(budget == levelBudget.budget);
+        BOOST_TEST_REQUIRE(construction.GetConnectJobNum() == 0u);
+        BOOST_TEST_REQUIRE(construction.GetBuildJobNum() == 0u);
+
+        const auto addJobs = [&]() {
+            for(const MapPoint pt : flagPositions)
+            {
+                world.SetFlag(pt, curPlayer);
+                construction.AddConnectFlagJob(world.GetSpecObj<noFlag>(pt));
+                world.DestroyFlag(pt, curPlayer);
+            }
+            for(unsigned i = 0; i < 5; i++)
+                construction.AddBuildJob(new AIJH::BuildJob(aijh, BLD_WOODCUTTER, hqPos), false);
+            BOOST_TEST_REQUIRE(construction.GetConnectJobNum() == 5u);
+            BOOST_TEST_REQUIRE(construction.GetBuildJobNum() == 5u);
+        };
+
+        // The budget stops the jobs before the limit of 5 jobs of each kind per GF is reached
+        addJobs();
+        construction.ExecuteJobs(100, budget);
+        BOOST_TEST(5u - construction.GetConnectJobNum() == levelBudget.numConnectJobs);
+        BOOST_TEST(5u - construction.GetBuildJobNum() == levelBudget.numBuildJobs);
+        BOOST_TEST(construction.GetAvailableJobBudget() <= 0);
+
+        // Work off the remaining jobs, then let the budget accumulate over some GFs without jobs
+        for(unsigned gf = 0; gf < 10 && (construction.GetConnectJobNum() > 0u || construction.GetBuildJobNum() > 0u); gf++)
+            construction.ExecuteJobs(100, budget);
+        BOOST_TEST_REQUIRE(construction.GetConnectJobNum() == 0u);
+        BOOST_TEST_REQUIRE(construction.GetBuildJobNum() == 0u);
+        for(unsigned gf = 0; gf < 3; gf++)
+            construction.ExecuteJobs(100, budget);
+        // Only the budget of a single GF is saved
+        BOOST_TEST(construction.GetAvailableJobBudget() == static_cast<int>(2 * budget));
+
+        // The saved budget allows more jobs in the next GF
+        addJobs();
+        construction.ExecuteJobs(100, budget);
+        BOOST_TEST(5u - construction.GetConnectJobNum() == levelBudget.numConnectJobsSaved);
+        BOOST_TEST(5u - construction.GetBuildJobNum() == levelBudget.numBuildJobsSaved);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(MultiTargetRoadSearchMatchesSingleSearch, WorldWithGCExecution<1>)
+{
+    auto ai = AIFactory::Create(AI::Info(AI::DEFAULT, AI::HARD), curPlayer, world);
+    const AIInterface& aii = static_cast<AIJH::AIPlayerJH&>(*ai).GetInterface();
+    // Place some flags in the territory
+    std::vector<MapPoint> flags;
+    for(const MapPoint pt : world.GetPointsInRadius(hqPos, 8))
+    {
+        if(flags.size() < 10u && world.GetBQ(pt, curPlayer) != BQ_NOTHING && rttr::test::randomValue(0u, 5u) == 0u)
+        {
+            world.SetFlag(pt, curPlayer);
+            flags.push_back(pt);
+        }
+    }
+    BOOST_TEST_REQUIRE(!flags.empty());
+    for(const MapPoint start : world.GetPointsInRadius(hqPos, 6))
+    {
+        if(world.GetBQ(start, curPlayer) == BQ_NOTHING)
+            continue;
+        const std::vector<std::vector<Direction>> routes = aii.FindFreePathsForNewRoad(start, flags);
+        BOOST_TEST_REQUIRE(routes.size() == flags.size());
+        for(unsigned i = 0; i < flags.size(); i++)
+        {
+            std::vector<Direction> singleRoute;
+            const bool found = aii.FindFreePathForNewRoad(start, flags[i], &singleRoute);
+            if(found)
+                BOOST_TEST_REQUIRE(!routes[i].empty());
+            if(routes[i].empty())
+                continue;
+            // Every found route must actually lead to the target
+            // and may only contain possible flag positions next to it where the single search would avoid them
+            MapPoint curPt = start;
+            bool isValidRouteEnd = true;
+            for(unsigned j = 0; j < routes[i].size(); j++)
+            {
+                curPt = world.GetNeighbour(curPt, routes[i][j]);
+                if(j + 1 < routes[i].size() && j % 2 == 1 && world.CalcDistance(curPt, flags[i]) < 2)
+                    isValidRouteEnd = false;
+            }
+            BOOST_TEST_REQUIRE(curPt == flags[i]);
+            // Those routes are the ones the single search would have found
+            if(isValidRouteEnd)
+            {
+                BOOST_TEST_REQUIRE(found);
+                BOOST_TEST_REQUIRE((routes[i] == singleRoute));
+            } else if(found)
+                BOOST_TEST_REQUIRE(routes[i].size() <= singleRoute.size());
+        }
+    }
+}
+
+namespace {
+/// Place trees, granite and resources randomly
+template<class T_World>
+void addRandomResources(T_World& world)
+{
+    RTTR_FOREACH_PT(MapPoint, world.GetSize())
+    {
+        const unsigned rnd = rttr::test::randomValue(0u, 9u);
+        if(!world.GetNode(pt).obj && rnd == 0)
+            world.SetNO(pt, new noTree(pt, 0, 3));
+        else if(!world.GetNode(pt).obj && rnd == 1)
+            world.SetNO(pt, new noGranite(GT_1, 5));
+        else if(rnd > 6)
+            world.GetNodeWriteable(pt).resources = Resource(Resource::Type(rnd - 6), 7);
+    }
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(ResourceMapsMatchSplatting, ResourceWorldWithGCExecution)
+{
+    addRandomResources(world);
+    auto ai = AIFactory::Create(AI::Info(AI::DEFAULT, AI::HARD), curPlayer, world);
+    const AIJH::AIPlayerJH& aijh = static_cast<AIJH::AIPlayerJH&>(*ai);
+    for(unsigned i = 0; i < NUM_AIRESOURCES; i++)
+    {
+        const AIJH::AIResourceMap& resMap = aijh.GetResMap(AIResource(i));
+        AIJH::AIResourceMap expectedResMap = resMap;
+        expectedResMap.InitBySplatting();
+        RTTR_FOREACH_PT(MapPoint, world.GetSize())
+        {
+            BOOST_TEST_INFO("Resource " << i << " at " << pt);
+            BOOST_TEST_REQUIRE(resMap[pt] == expectedResMap[pt]);
+        }
+    }
+}
+
+namespace {
+/// Linear search over all points in the radius as done before the tile index was used
+MapPoint findGoodPositionLinear(const AIJH::AIPlayerJH& aijh, const AIJH::AIResourceMap& resMap, const MapPoint pt, int threshold,
+                                BuildingQuality size, unsigned radius)
+{
+    for(const MapPoint curPt : aijh.GetWorld().GetPointsInRadiusWithCenter(pt, radius))
+    {
+        const AIJH::Node& node = aijh.GetAINode(curPt);
+        if(resMap[curPt] >= threshold && node.owned && !node.farmed && canUseBq(node.bq, size))
+            return curPt;
+    }
+    return MapPoint::Invalid();
+}
+
+MapPoint findBestPositionLinear(const AIJH::AIPlayerJH& aijh, const AIJH::AIResourceMap& resMap, const MapPoint pt, BuildingQuality size,
+                                unsigned radius)
+{
+    MapPoint best = MapPoint::Invalid();
+    int bestValue = 0;
+    for(const MapPoint curPt : aijh.GetWorld().GetPointsInRadiusWithCenter(pt, radius))
+    {
+        const AIJH::Node& node = aijh.GetAINode(curPt);
+        if(resMap[curPt] > bestValue && node.reachable && node.owned && !node.farmed && canUseBq(node.bq, size))
+        {
+            best = curPt;
+            bestValue = resMap[curPt];
+        }
+    }
+    return best;
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(ResourceMapSearchesMatchLinearSearch, ResourceWorldWithGCExecution)
+{
+    addRandomResources(world);
+    auto ai = AIFactory::Create(AI::Info(AI::DEFAULT, AI::HARD), curPlayer, world);
+    const AIJH::AIPlayerJH& aijh = static_cast<AIJH::AIPlayerJH&>(*ai);
+    const MapPoint hqPos = world.GetPlayer(curPlayer).GetHQPos();
+    for(unsigned i = 0; i < NUM_AIRESOURCES; i++)
+    {
+        AIJH::AIResourceMap resMap = aijh.GetResMap(AIResource(i));
+        for(unsigned j = 0; j < 20; j++)
+        {
+            // Modify the ratings (incrementally updated) and by direct writes (lazily updated)
+            const MapPoint changePt(rttr::test::randomValue<MapCoord>(0, world.GetWidth() - 1),
+                                    rttr::test::randomValue<MapCoord>(0, world.GetHeight() - 1));
+            resMap.Change(changePt, rttr::test::randomValue(1u, 8u), rttr::test::randomValue(-5, 5));
+            resMap[hqPos] = rttr::test::randomValue(-10, 50);
+
+            const MapPoint pt = aijh.GetWorld().GetNeighbour(hqPos, Direction(rttr::test::randomValue(0u, 5u)));
+            const unsigned radius = rttr::test::randomValue(1u, 30u);
+            const BuildingQuality size = rttr::test::randomValue(0, 1) ? BQ_HUT : BQ_HOUSE;
+            int maxRating = std::numeric_limits<int>::min();
+            for(const MapPoint curPt : aijh.GetWorld().GetPointsInRadiusWithCenter(pt, radius))
+                maxRating = std::max(maxRating, resMap[curPt]);
+            BOOST_TEST_INFO("Resource " << i << " at " << pt << " radius " << radius);
+            BOOST_TEST(resMap.GetMaxRating(pt, radius) >= maxRating);
+            const int threshold = rttr::test::randomValue(0, std::max(0, maxRating));
+            BOOST_TEST(resMap.FindGoodPosition(pt, threshold, size, radius)
+                       == findGoodPositionLinear(aijh, resMap, pt, threshold, size, radius));
+            BOOST_TEST(resMap.FindBestPosition(pt, size, 1, static_cast<int>(radius))
+                       == findBestPositionLinear(aijh, resMap, pt, size, radius));
+        }
+    }
+}
+
+// Compares the time to initialize the resource maps of 8 AIs on a big map. Run explicitly with --run_test=AI/ResourceMapsBenchmark
+BOOST_FIXTURE_TEST_CASE(ResourceMapsBenchmark, BigWorld8P, *boost::unit_test::disabled())
+{
+    using clock = std::chrono::steady_clock;
+    addRandomResources(world);
+    std::vector<std::unique_ptr<AIPlayer>> ais;
+    for(unsigned player = 0; player < world.GetNumPlayers(); player++)
+        ais.push_back(AIFactory::Create(AI::Info(AI::DEFAULT, AI::HARD), player, world));
+
+    clock::duration timeSplatting(0), timePrefixSums(0);
+    for(const std::unique_ptr<AIPlayer>& ai : ais)
+    {
+        const AIJH::AIPlayerJH& aijh = static_cast<AIJH::AIPlayerJH&>(*ai);
+        for(unsigned i = 0; i < NUM_AIRESOURCES; i++)
+        {
+            AIJH::AIResourceMap resMap = aijh.GetResMap(AIResource(i));
+            AIJH::AIResourceMap expectedResMap = resMap;
+            clock::time_point start = clock::now();
+            expectedResMap.InitBySplatting();
+            timeSplatting += clock::now() - start;
+            start = clock::now();
+            resMap.Init();
+            timePrefixSums += clock::now() - start;
+            RTTR_FOREACH_PT(MapPoint, world.GetSize())
+            {
+                BOOST_TEST_REQUIRE(resMap[pt] == expectedResMap[pt]);
+            }
+        }
+    }
+    using std::chrono::milliseconds;
+    BOOST_TEST_MESSAGE("Resource maps of " << ais.size() << " AIs on " << world.GetSize() << ": Splatting "
+                                          << std::chrono::duration_cast<milliseconds>(timeSplatting).count() << "ms, prefix sums "
+                                          << std::chrono::duration_cast<milliseconds>(timePrefixSums).count() << "ms");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
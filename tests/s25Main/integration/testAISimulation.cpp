@@ -0,0 +1,307 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "Game.h"
+#include "GameInterface.h"
+#include "GameObject.h"
+#include "GamePlayer.h"
+#include "GlobalGameSettings.h"
+#include "PlayerInfo.h"
+#include "ai/AIPlayer.h"
+#include "factories/AIFactory.h"
+#include "random/Random.h"
+#include "worldFixtures/CreateEmptyWorld.h"
+#include "gameTypes/StatisticTypes.h"
+#include <boost/optional.hpp>
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+namespace {
+/// Records the winner of a simulated game
+class SimulationGameInterface : public GameInterface
+{
+public:
+    boost::optional<unsigned> winner, teamWinner;
+
+    void GI_PlayerDefeated(unsigned) override {}
+    void GI_UpdateMinimap(MapPoint) override {}
+    void GI_FlagDestroyed(MapPoint) override {}
+    void GI_TreatyOfAllianceChanged(unsigned) override {}
+    void GI_Winner(unsigned playerId) override { winner = playerId; }
+    void GI_TeamWinner(unsigned playerMask) override { teamWinner = playerMask; }
+    void GI_WindowClosed(Window*) override {}
+    void GI_StartRoadBuilding(MapPoint, bool) override {}
+    void GI_CancelRoadBuilding() override {}
+    void GI_BuildRoad() override {}
+};
+
+struct AISimulationSettings
+{
+    unsigned numPlayers = 4;
+    MapExtent mapSize = MapExtent(64, 64);
+    unsigned numGFs = 20000;
+    AI::Level level = AI::HARD;
+    /// Length of a network frame. AI game commands are executed at the start of each NWF
+    unsigned nwfLength = 5;
+    /// GF at which the HQ of the last player gets destroyed (0 = never). Lets the AI of that player run into its defeat handling
+    unsigned destroyHQGF = 0;
+};
+
+struct AIGameResult
+{
+    unsigned seed = 0;
+    unsigned numGFs = 0;
+    double seconds = 0;
+    /// Winning player or -1 if the game did not finish
+    int winner = -1;
+    /// Current statistic values (see StatisticType) per player
+    std::vector<std::array<unsigned, NUM_STAT_TYPES>> statistics;
+    std::vector<bool> defeated;
+    /// Maximum number of game objects alive at the same time
+    unsigned peakNumObjs = 0;
+    /// Number of game objects created
+    unsigned numObjsCreated = 0;
+    unsigned rngChecksum = 0;
+    /// Number of chat messages the AIs wanted to send
+    unsigned numChatMsgs = 0;
+    /// Peak memory of the whole process (so shared by all parallel games) in KB, 0 if unknown
+    unsigned long peakMemoryKB = 0;
+
+    double GetGFsPerSecond() const { return seconds > 0 ? numGFs / seconds : 0; }
+};
+
+unsigned long getPeakMemoryKB()
+{
+#ifdef _WIN32
+    return 0;
+#else
+    rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#ifdef __APPLE__
+    return static_cast<unsigned long>(usage.ru_maxrss) / 1024u; // Bytes
+#else
+    return static_cast<unsigned long>(usage.ru_maxrss); // KB
+#endif
+#endif
+}
+
+/// Run a game with AI players only. The game (and all game objects) live on the calling thread only.
+/// Throws on error as the Boost.Test assertions must not be used from worker threads
+AIGameResult runAIGame(const AISimulationSettings& settings, unsigned seed)
+{
+    using clock = std::chrono::steady_clock;
+
+    std::vector<PlayerInfo> players(settings.numPlayers);
+    for(PlayerInfo& player : players)
+    {
+        player.ps = PS_AI;
+        player.aiInfo = AI::Info(AI::DEFAULT, settings.level);
+    }
+    GlobalGameSettings ggs;
+    ggs.objective = GO_CONQUER3_4;
+    // Explored area stays explored. Avoids fow creation
+    ggs.exploration = EXP_CLASSIC;
+    SimulationGameInterface gi;
+    Game game(ggs, 0u, players);
+    GameWorld& world = game.world_;
+    world.SetGameInterface(&gi);
+    if(!CreateEmptyWorld(settings.mapSize)(world))
+        throw std::runtime_error("Could not create the world");
+    RANDOM.Init(seed);
+    for(unsigned i = 0; i < world.GetNumPlayers(); i++)
+        game.AddAIPlayer(AIFactory::Create(world.GetPlayer(i).aiInfo, i, world));
+    game.Start(false);
+
+    AIGameResult result;
+    result.seed = seed;
+    const clock::time_point startTime = clock::now();
+    for(unsigned gf = 0; gf < settings.numGFs && !game.IsGameFinished(); gf++)
+    {
+        const bool isNWF = gf % settings.nwfLength == 0;
+        if(isNWF)
+        {
+            for(AIPlayer& ai : game.aiPlayers_)
+            {
+                for(const gc::GameCommandPtr& gc : ai.FetchGameCommands())
+                    gc->Execute(world, ai.GetPlayerId());
+                result.numChatMsgs += ai.FetchChatMessages().size();
+            }
+            result.peakNumObjs = std::max(result.peakNumObjs, GameObject::GetNumObjs());
+        }
+        if(settings.destroyHQGF && gf == settings.destroyHQGF)
+            world.DestroyNO(world.GetPlayer(world.GetNumPlayers() - 1).GetHQPos());
+        for(AIPlayer& ai : game.aiPlayers_)
+            ai.RunGF(game.em_->GetCurrentGF(), isNWF);
+        game.RunGF();
+        result.numGFs++;
+    }
+    result.seconds = std::chrono::duration<double>(clock::now() - startTime).count();
+    for(AIPlayer& ai : game.aiPlayers_)
+        result.numChatMsgs += ai.FetchChatMessages().size();
+
+    if(gi.winner)
+        result.winner = static_cast<int>(*gi.winner);
+    for(unsigned i = 0; i < world.GetNumPlayers(); i++)
+    {
+        const GamePlayer& player = world.GetPlayer(i);
+        std::array<unsigned, NUM_STAT_TYPES> stats;
+        for(unsigned j = 0; j < NUM_STAT_TYPES; j++)
+            stats[j] = player.GetStatisticCurrentValue(j);
+        result.statistics.push_back(stats);
+        result.defeated.push_back(player.IsDefeated());
+    }
+    result.numObjsCreated = GameObject::GetObjIDCounter();
+    result.rngChecksum = RANDOM.GetChecksum();
+    result.peakMemoryKB = getPeakMemoryKB();
+    return result;
+}
+
+/// Run the games with the given seeds on up to numThreads threads. Results are in the order of the seeds
+std::vector<AIGameResult> runAIGames(const AISimulationSettings& settings, const std::vector<unsigned>& seeds, unsigned numThreads)
+{
+    std::vector<AIGameResult> results(seeds.size());
+    std::atomic<unsigned> nextGame(0);
+    const auto runGames = [&]() {
+        for(unsigned i = nextGame++; i < seeds.size(); i = nextGame++)
+            results[i] = runAIGame(settings, seeds[i]);
+    };
+    numThreads = std::max(1u, std::min<unsigned>(numThreads, seeds.size()));
+    std::vector<std::future<void>> workers;
+    for(unsigned i = 0; i < numThreads; i++)
+        workers.push_back(std::async(std::launch::async, runGames));
+    for(std::future<void>& worker : workers)
+        worker.get();
+    return results;
+}
+
+void writeCSV(std::ostream& os, const std::vector<AIGameResult>& results)
+{
+    static const std::array<const char*, NUM_STAT_TYPES> statNames = {
+      {"country", "buildings", "inhabitants", "merchandise", "military", "gold", "productivity", "vanquished", "tournament"}};
+    const unsigned numPlayers = results.empty() ? 0 : results.front().statistics.size();
+    os << "game,seed,gfs,seconds,gf_per_s,winner,peak_objects,objects_created,peak_memory_kb";
+    for(unsigned i = 0; i < numPlayers; i++)
+    {
+        for(const char* statName : statNames)
+            os << ",p" << i << "_" << statName;
+        os << ",p" << i << "_defeated";
+    }
+    os << "\n";
+    for(unsigned game = 0; game < results.size(); game++)
+    {
+        const AIGameResult& result = results[game];
+        os << game << "," << result.seed << "," << result.numGFs << "," << result.seconds << "," << result.GetGFsPerSecond() << ","
+           << result.winner << "," << result.peakNumObjs << "," << result.numObjsCreated << "," << result.peakMemoryKB;
+        for(unsigned i = 0; i < result.statistics.size(); i++)
+        {
+            for(unsigned value : result.statistics[i])
+                os << "," << value;
+            os << "," << result.defeated[i];
+        }
+        os << "\n";
+    }
+}
+
+unsigned getEnvValue(const char* name, unsigned defaultValue)
+{
+    const char* value = std::getenv(name);
+    return value ? static_cast<unsigned>(std::stoul(value)) : defaultValue;
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(AISimulation)
+
+BOOST_AUTO_TEST_CASE(ParallelGamesAreIndependent)
+{
+    AISimulationSettings settings;
+    settings.numPlayers = 2;
+    settings.mapSize = MapExtent(40, 20);
+    settings.numGFs = 500;
+    // The AIs chat at GF 100 and when they are defeated which must not touch anything outside of their game
+    settings.destroyHQGF = 200;
+    const std::vector<unsigned> seeds = {42, 1337, 42};
+    const std::vector<AIGameResult> serialResults = runAIGames(settings, seeds, 1);
+    const std::vector<AIGameResult> parallelResults = runAIGames(settings, seeds, seeds.size());
+    BOOST_TEST_REQUIRE(parallelResults.size() == seeds.size());
+    for(const AIGameResult& result : parallelResults)
+    {
+        BOOST_TEST(result.numGFs == settings.numGFs);
+        BOOST_TEST(result.numObjsCreated > 0u);
+        // Greeting of each AI and the defeated one congratulating
+        BOOST_TEST(result.numChatMsgs == settings.numPlayers + 1u);
+        BOOST_TEST(result.defeated.back());
+    }
+#ifndef RTTR_RAND_TEST
+    // Same seed -> Same game no matter what runs in parallel
+    for(unsigned i = 0; i < seeds.size(); i++)
+    {
+        BOOST_TEST_CONTEXT("Game " << i)
+        {
+            const AIGameResult& expected = serialResults[i];
+            const AIGameResult& result = parallelResults[i];
+            BOOST_TEST(result.rngChecksum == expected.rngChecksum);
+            BOOST_TEST(result.numObjsCreated == expected.numObjsCreated);
+            BOOST_TEST(result.peakNumObjs == expected.peakNumObjs);
+            for(unsigned player = 0; player < settings.numPlayers; player++)
+                BOOST_TEST(result.statistics[player] == expected.statistics[player], boost::test_tools::per_element());
+        }
+    }
+    BOOST_TEST(parallelResults[0].rngChecksum == parallelResults[2].rngChecksum);
+#endif
+}
+
+// Runs a batch of AI only games and writes the results as CSV.
+// Run explicitly with --run_test=AISimulation/AIBatch
+// Configure with RTTR_AI_SIM_GAMES, RTTR_AI_SIM_THREADS, RTTR_AI_SIM_GFS, RTTR_AI_SIM_PLAYERS (environment)
+BOOST_AUTO_TEST_CASE(AIBatch, *boost::unit_test::disabled())
+{
+    AISimulationSettings settings;
+    settings.numPlayers = getEnvValue("RTTR_AI_SIM_PLAYERS", settings.numPlayers);
+    settings.numGFs = getEnvValue("RTTR_AI_SIM_GFS", settings.numGFs);
+    const unsigned numGames = getEnvValue("RTTR_AI_SIM_GAMES", 8);
+    const unsigned numThreads = getEnvValue("RTTR_AI_SIM_THREADS", std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<unsigned> seeds;
+    for(unsigned i = 0; i < numGames; i++)
+        seeds.push_back(i + 1);
+
+    using clock = std::chrono::steady_clock;
+    const clock::time_point startTime = clock::now();
+    const std::vector<AIGameResult> results = runAIGames(settings, seeds, numThreads);
+    const double seconds = std::chrono::duration<double>(clock::now() - startTime).count();
+
+    std::ofstream csvFile("aiSimulation.csv");
+    writeCSV(csvFile, results);
+    BOOST_TEST_REQUIRE(static_cast<bool>(csvFile));
+    BOOST_TEST_MESSAGE("Simulated " << numGames << " games of " << settings.numGFs << " GFs on " << numThreads << " threads in " << seconds
+                                    << "s. Results written to aiSimulation.csv");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
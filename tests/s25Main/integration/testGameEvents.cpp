@@ -16,12 +16,14 @@
 // along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
 
 #include "rttrDefines.h" // IWYU pragma: keep
+#include "EventStatistics.h"
 #include "GameEvent.h"
 #include "GameObject.h"
 #include "RTTR_AssertError.h"
 #include "worldFixtures/TestEventManager.h"
 #include <rttr/test/LogAccessor.hpp>
 #include <boost/test/unit_test.hpp>
+#include <algorithm>
 
 BOOST_AUTO_TEST_SUITE(GameEventsTestSuite)
 
@@ -223,6 +225,66 @@ BOOST_AUTO_TEST_CASE(RemoveEvent)
     BOOST_CHECK(!evMgr.ObjectHasEvents(obj));
 }
 
+class RefiringEventHandler : public TestEventHandler
+{
+    EventManager& evMgr;
+
+public:
+    explicit RefiringEventHandler(EventManager& evMgr) : evMgr(evMgr) {}
+    void HandleEvent(unsigned evId) override
+    {
+        TestEventHandler::HandleEvent(evId);
+        evMgr.AddEvent(this, 1, evId);
+    }
+};
+
+BOOST_AUTO_TEST_CASE(EventStatisticsAccounting)
+{
+    EventManager evMgr(0);
+    BOOST_TEST(!evMgr.GetStatistics());
+    evMgr.SetStatisticsEnabled(true);
+    BOOST_TEST_REQUIRE(evMgr.GetStatistics());
+    const EventStatistics& statistics = *evMgr.GetStatistics();
+    const unsigned windowLength = statistics.getWindowLength();
+
+    // Object with an event every GF and one with an event every 10 GFs
+    RefiringEventHandler busyObj(evMgr);
+    TestEventHandler obj;
+    evMgr.AddEvent(&busyObj, 1, 1);
+    for(unsigned gf = 1; gf <= windowLength; gf += 10)
+        evMgr.AddEvent(&obj, gf, 2);
+    // Nothing reported till the window is complete
+    for(unsigned gf = 1; gf < windowLength; gf++)
+        evMgr.ExecuteNextGF();
+    BOOST_TEST(statistics.getTopEntries(10).empty());
+    BOOST_TEST(statistics.getSuspiciousObjects().empty());
+    evMgr.ExecuteNextGF();
+    BOOST_TEST(statistics.getNumGFs() == windowLength);
+
+    const std::vector<EventStatistics::Entry> entries = statistics.getTopEntries(10);
+    BOOST_TEST_REQUIRE(entries.size() == 2u);
+    const auto itBusy = std::find_if(entries.begin(), entries.end(), [](const EventStatistics::Entry& e) { return e.eventId == 1u; });
+    const auto itOther = std::find_if(entries.begin(), entries.end(), [](const EventStatistics::Entry& e) { return e.eventId == 2u; });
+    BOOST_TEST_REQUIRE((itBusy != entries.end() && itOther != entries.end()));
+    BOOST_TEST(itBusy->got == GOT_UNKNOWN);
+    BOOST_TEST(itBusy->count == windowLength);
+    BOOST_TEST(itOther->count == windowLength / 10);
+    BOOST_TEST(statistics.getTopEntries(1).size() == 1u);
+
+    // Only the object firing every GF is flagged
+    BOOST_TEST_REQUIRE(statistics.getSuspiciousObjects().size() == 1u);
+    const EventStatistics::SuspiciousObject& suspicious = statistics.getSuspiciousObjects().front();
+    BOOST_TEST(suspicious.objId == busyObj.GetObjId());
+    BOOST_TEST(suspicious.numGFs == windowLength);
+    BOOST_TEST(suspicious.numEvents == windowLength);
+
+    // Disabling discards everything, execution continues normally
+    evMgr.SetStatisticsEnabled(false);
+    BOOST_TEST(!evMgr.GetStatistics());
+    evMgr.ExecuteNextGF();
+    BOOST_TEST(busyObj.handledEventIds.size() == windowLength + 1u);
+}
+
 BOOST_AUTO_TEST_CASE(InvalidEvent)
 {
     rttr::test::LogAccessor logAcc;
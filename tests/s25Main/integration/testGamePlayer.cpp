@@ -16,14 +16,29 @@
 // along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
 
 #include "rttrDefines.h" // IWYU pragma: keep
+#include "FindWhConditions.h"
 #include "GamePlayer.h"
+#include "PointOutput.h"
+#include "Ware.h"
+#include "ai/AIPlayer.h"
 #include "buildings/nobBaseWarehouse.h"
 #include "buildings/nobMilitary.h"
+#include "buildings/nobUsual.h"
+#include "factories/AIFactory.h"
 #include "factories/BuildingFactory.h"
 #include "figures/nofPassiveSoldier.h"
+#include "pathfinding/RoadPathFinder.h"
 #include "worldFixtures/CreateEmptyWorld.h"
 #include "worldFixtures/WorldFixture.h"
+#include "worldFixtures/WorldWithGCExecution.h"
+#include "nodeObjs/noFlag.h"
+#include "nodeObjs/noTree.h"
+#include "gameTypes/JobTypes.h"
+#include "gameTypes/StatisticTypes.h"
+#include "gameData/BuildingConsts.h"
 #include <boost/test/unit_test.hpp>
+#include <array>
+#include <limits>
 
 using WorldFixtureEmpty2P = WorldFixture<CreateEmptyWorld, 2>;
 
@@ -48,3 +63,224 @@ BOOST_FIXTURE_TEST_CASE(Defeat, WorldFixtureEmpty2P)
     world.DestroyNO(milBldPos);
     BOOST_REQUIRE(world.GetPlayer(0).IsDefeated());
 }
+
+namespace {
+/// Reference: Check all military buildings in list order and take the first one with the most points
+nobBaseMilitary* findClientForCoinLinear(GameWorldGame& world, const GamePlayer& player, Ware& ware)
+{
+    nobBaseMilitary* best = nullptr;
+    unsigned bestPoints = 0;
+    for(nobMilitary* milBld : player.GetBuildingRegister().GetMilitaryBuildings())
+    {
+        unsigned points = milBld->CalcCoinsPoints();
+        unsigned wayPoints;
+        if(points && world.FindPathForWareOnRoads(*ware.GetLocation(), *milBld, &wayPoints) != 0xFF)
+        {
+            points -= wayPoints;
+            if(points > bestPoints)
+            {
+                bestPoints = points;
+                best = milBld;
+            }
+        }
+    }
+    return best ? best : player.FindWarehouseForWare(ware);
+}
+
+/// Reference: Check all warehouses in list order and take the first one with the shortest way
+nobBaseWarehouse* findWarehouseLinear(GameWorldGame& world, const GamePlayer& player, const noRoadNode& start, unsigned& length)
+{
+    nobBaseWarehouse* best = nullptr;
+    length = std::numeric_limits<unsigned>::max();
+    for(nobBaseWarehouse* wh : player.GetBuildingRegister().GetStorehouses())
+    {
+        unsigned curLength;
+        if(world.GetRoadPathFinder().FindPath(start, *wh, false, std::numeric_limits<unsigned>::max(), nullptr, &curLength)
+           && (!best || curLength < length))
+        {
+            length = curLength;
+            best = wh;
+        }
+    }
+    return best;
+}
+} // namespace
+
+using WorldWithGCExecution1PLarge = WorldWithGCExecution<1, 48, 40>;
+
+BOOST_FIXTURE_TEST_CASE(FindCoinClientAndWarehouseLikeLinearSearch, WorldWithGCExecution1PLarge)
+{
+    GamePlayer& player = world.GetPlayer(curPlayer);
+    const MapPoint hqFlagPos = world.GetNeighbour(hqPos, Direction::SOUTHEAST);
+    // Road with flags every 2 nodes to the west and east of the HQ flag
+    std::vector<noFlag*> flags;
+    for(const Direction dir : {Direction::WEST, Direction::EAST})
+    {
+        MapPoint curPos = hqFlagPos;
+        for(unsigned i = 0; i < 4; i++)
+        {
+            this->BuildRoad(curPos, false, std::vector<Direction>(2, dir));
+            curPos = world.GetNeighbour(world.GetNeighbour(curPos, dir), dir);
+            flags.push_back(world.GetSpecObj<noFlag>(curPos));
+            BOOST_REQUIRE(flags.back());
+        }
+    }
+    // Military buildings at the same distance on both sides (ties) and a storehouse on each side
+    // Order of creation differs from position order to check the tie breaker
+    const std::vector<unsigned> milBldFlagIdxs = {5, 1, 2, 6, 7, 3};
+    for(unsigned flagIdx : milBldFlagIdxs)
+    {
+        const MapPoint bldPos = world.GetNeighbour(flags[flagIdx]->GetPos(), Direction::NORTHWEST);
+        auto* milBld = dynamic_cast<nobMilitary*>(BuildingFactory::CreateBuilding(world, BLD_BARRACKS, bldPos, curPlayer, NAT_ROMANS));
+        BOOST_REQUIRE(milBld);
+        auto* soldier = new nofPassiveSoldier(bldPos, curPlayer, milBld, milBld, 0);
+        player.IncreaseInventoryJob(soldier->GetJobType(), 1);
+        world.AddFigure(bldPos, soldier);
+        soldier->WalkToGoal();
+        BOOST_REQUIRE(!milBld->IsNewBuilt());
+    }
+    for(unsigned flagIdx : {0u, 4u})
+    {
+        const MapPoint bldPos = world.GetNeighbour(flags[flagIdx]->GetPos(), Direction::NORTHWEST);
+        BOOST_REQUIRE(BuildingFactory::CreateBuilding(world, BLD_STOREHOUSE, bldPos, curPlayer, NAT_ROMANS));
+    }
+
+    const auto checkAllLocations = [&]() {
+        for(noFlag* flag : flags)
+        {
+            BOOST_TEST_CONTEXT("Flag at " << flag->GetPos())
+            {
+                Ware coin(GD_COINS, nullptr, flag);
+                BOOST_TEST(player.FindClientForCoin(&coin) == findClientForCoinLinear(world, player, coin));
+                player.RemoveWare(&coin);
+
+                unsigned length, expectedLength;
+                nobBaseWarehouse* wh = player.FindWarehouse(*flag, FW::NoCondition(), true, false, &length);
+                BOOST_TEST(wh == findWarehouseLinear(world, player, *flag, expectedLength));
+                BOOST_TEST(length == expectedLength);
+            }
+        }
+    };
+    checkAllLocations();
+    // Different points per building
+    this->SetCoinsAllowed(world.GetNeighbour(flags[1]->GetPos(), Direction::NORTHWEST), false);
+    checkAllLocations();
+    this->SetCoinsAllowed(world.GetNeighbour(flags[5]->GetPos(), Direction::NORTHWEST), false);
+    this->SetCoinsAllowed(world.GetNeighbour(flags[6]->GetPos(), Direction::NORTHWEST), false);
+    checkAllLocations();
+    // No military building wants coins -> Warehouse
+    for(unsigned flagIdx : milBldFlagIdxs)
+        this->SetCoinsAllowed(world.GetNeighbour(flags[flagIdx]->GetPos(), Direction::NORTHWEST), false);
+    checkAllLocations();
+}
+
+namespace {
+/// Average productivity of the buildings of the given type by iterating over all of them
+unsigned calcAverageProductivityFromBuildings(const BuildingRegister& buildings, BuildingType bldType)
+{
+    if(BLD_WORK_DESC[bldType].producedWare == GD_NOTHING || buildings.GetBuildings(bldType).empty())
+        return 0;
+    unsigned productivity = 0;
+    for(const nobUsual* bld : buildings.GetBuildings(bldType))
+        productivity += bld->GetProductivity();
+    return productivity / buildings.GetBuildings(bldType).size();
+}
+
+/// Recalculate all statistic values from the current game state
+/// Gold and vanquished enemies are only counted when they happen, so they are taken from the player
+std::array<int, NUM_STAT_TYPES> calcStatisticsFromState(const GameWorldGame& world, const GamePlayer& player)
+{
+    std::array<int, NUM_STAT_TYPES> result{};
+    RTTR_FOREACH_PT(MapPoint, world.GetSize())
+    {
+        if(world.GetNode(pt).owner == player.GetPlayerId() + 1)
+            result[STAT_COUNTRY]++;
+    }
+    const BuildingRegister& buildings = player.GetBuildingRegister();
+    const BuildingCount bldCount = buildings.GetBuildingNums();
+    for(unsigned numBlds : bldCount.buildings)
+        result[STAT_BUILDINGS] += numBlds;
+    const Inventory& inventory = player.GetInventory();
+    for(unsigned i = 0; i < NUM_WARE_TYPES; ++i)
+        result[STAT_MERCHANDISE] += inventory.goods[i];
+    for(unsigned i = 0; i < NUM_JOB_TYPES; ++i)
+        result[STAT_INHABITANTS] += inventory.people[i];
+    for(unsigned i = 0; i < SOLDIER_JOBS.size(); ++i)
+        result[STAT_MILITARY] += inventory.people[SOLDIER_JOBS[i]] * (i + 1);
+    result[STAT_GOLD] = player.GetStatisticCurrentValue(STAT_GOLD);
+    unsigned totalProductivity = 0, numBlds = 0;
+    for(unsigned i = FIRST_USUAL_BUILDING; i < NUM_BUILDING_TYPES; ++i)
+    {
+        const auto bldType = BuildingType(i);
+        if(BLD_WORK_DESC[bldType].producedWare == GD_NOTHING)
+            continue;
+        for(const nobUsual* bld : buildings.GetBuildings(bldType))
+            totalProductivity += bld->GetProductivity();
+        numBlds += buildings.GetBuildings(bldType).size();
+    }
+    result[STAT_PRODUCTIVITY] = numBlds ? totalProductivity / numBlds : 0;
+    result[STAT_VANQUISHED] = player.GetStatisticCurrentValue(STAT_VANQUISHED);
+    result[STAT_TOURNAMENT] = result[STAT_MILITARY] + 3 * result[STAT_VANQUISHED];
+    return result;
+}
+
+void checkStatisticsMatchState(const GameWorldGame& world, GamePlayer& player)
+{
+    player.CalcStatistics();
+    const std::array<int, NUM_STAT_TYPES> expected = calcStatisticsFromState(world, player);
+    for(unsigned i = 0; i < NUM_STAT_TYPES; ++i)
+    {
+        BOOST_TEST_INFO("Statistic type " << i);
+        BOOST_TEST(player.GetStatisticCurrentValue(i) == static_cast<unsigned>(expected[i]));
+    }
+    for(unsigned i = FIRST_USUAL_BUILDING; i < NUM_BUILDING_TYPES; ++i)
+    {
+        BOOST_TEST_INFO("Building type " << i);
+        BOOST_TEST(player.GetBuildingRegister().CalcAverageProductivity(BuildingType(i))
+                   == calcAverageProductivityFromBuildings(player.GetBuildingRegister(), BuildingType(i)));
+    }
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(StatisticCountersMatchFullRecalculation, WorldWithGCExecution1PLarge)
+{
+    GamePlayer& player = world.GetPlayer(curPlayer);
+    checkStatisticsMatchState(world, player);
+
+    // Let the AI build an economy to get changes in all counters
+    for(const MapPoint& pt : world.GetPointsInRadius(hqPos + MapPoint(4, 0), 2))
+    {
+        if(!world.GetNode(pt).obj)
+            world.SetNO(pt, new noTree(pt, 0, 3));
+    }
+    auto ai = AIFactory::Create(AI::Info(AI::DEFAULT, AI::HARD), curPlayer, world);
+    for(unsigned gf = 0; gf < 6000;)
+    {
+        std::vector<gc::GameCommandPtr> aiGcs = ai->FetchGameCommands();
+        for(unsigned i = 0; i < 5; i++, gf++)
+        {
+            em.ExecuteNextGF();
+            ai->RunGF(em.GetCurrentGF(), i == 0);
+        }
+        for(gc::GameCommandPtr& gc : aiGcs)
+            gc->Execute(world, curPlayer);
+        if(gf % 500 == 0)
+        {
+            BOOST_TEST_CONTEXT("GF " << gf) { checkStatisticsMatchState(world, player); }
+        }
+    }
+    BOOST_TEST_REQUIRE(player.GetStatisticCurrentValue(STAT_BUILDINGS) > 1u);
+
+    // Remove all buildings but the HQ
+    std::vector<MapPoint> bldPositions;
+    for(unsigned i = FIRST_USUAL_BUILDING; i < NUM_BUILDING_TYPES; ++i)
+    {
+        for(const nobUsual* bld : player.GetBuildingRegister().GetBuildings(BuildingType(i)))
+            bldPositions.push_back(bld->GetPos());
+    }
+    for(const nobMilitary* bld : player.GetBuildingRegister().GetMilitaryBuildings())
+        bldPositions.push_back(bld->GetPos());
+    for(const MapPoint& pt : bldPositions)
+        this->DestroyBuilding(pt);
+    checkStatisticsMatchState(world, player);
+}
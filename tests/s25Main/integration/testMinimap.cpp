@@ -0,0 +1,104 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "IngameMinimap.h"
+#include "Rect.h"
+#include "uiHelper/uiHelpers.hpp"
+#include "worldFixtures/WorldWithGCExecution.h"
+#include "world/GameWorldViewer.h"
+#include "libsiedler2/PixelBufferBGRA.h"
+#include <glad/glad.h>
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <set>
+#include <vector>
+
+namespace {
+std::vector<Rect> uploadedRects;
+void APIENTRY recordTexSubImage2D(GLenum, GLint, GLint x, GLint y, GLsizei w, GLsizei h, GLenum, GLenum, const GLvoid*)
+{
+    uploadedRects.push_back(Rect(x, y, w, h));
+}
+
+class TestMinimap : public IngameMinimap
+{
+public:
+    using IngameMinimap::IngameMinimap;
+    static constexpr unsigned tileSize = 32;
+
+    unsigned getTileIdx(const MapPoint& pt) const { return (pt.y / tileSize) * (GetMapSize().x / tileSize) + pt.x / tileSize; }
+
+    std::vector<uint8_t> getPixels()
+    {
+        libsiedler2::PixelBufferBGRA buffer(GetMapSize().x * 2, GetMapSize().y);
+        BOOST_TEST_REQUIRE(map.print(buffer, nullptr, 0, 0, 0, 0) == 0);
+        return std::vector<uint8_t>(buffer.getPixelPtr(), buffer.getPixelPtr() + buffer.getWidth() * buffer.getHeight() * 4u);
+    }
+};
+
+using MinimapFixture = WorldWithGCExecution<1, 96, 64>;
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(MinimapUpdatesOnlyChangedTiles, MinimapFixture)
+{
+    uiHelper::initGUITests();
+    GameWorldViewer gwv(curPlayer, world);
+    TestMinimap minimap(gwv);
+    const Rect drawRect(0, 0, 96, 64);
+    // Create the texture
+    minimap.Draw(drawRect);
+
+    const MapPoint flagPos = world.GetNeighbour(hqPos, Direction::SOUTHEAST);
+    this->BuildRoad(flagPos, false, std::vector<Direction>(4, Direction::WEST));
+    // Notify all nodes of the tiles containing the road
+    std::set<unsigned> changedTiles;
+    MapPoint curPt = flagPos;
+    for(unsigned i = 0; i <= 4; i++)
+    {
+        changedTiles.insert(minimap.getTileIdx(curPt));
+        curPt = world.GetNeighbour(curPt, Direction::WEST);
+    }
+    RTTR_FOREACH_PT(MapPoint, world.GetSize())
+    {
+        if(changedTiles.count(minimap.getTileIdx(pt)))
+            minimap.UpdateNode(pt);
+    }
+
+    const auto origTexSubImage2D = glTexSubImage2D;
+    glTexSubImage2D = recordTexSubImage2D;
+    uploadedRects.clear();
+    // Large updates may be spread over multiple frames
+    for(int i = 0; i < 5; i++)
+        minimap.Draw(drawRect);
+    glTexSubImage2D = origTexSubImage2D;
+
+    BOOST_TEST_REQUIRE(changedTiles.size() < 6u);
+    // One upload per changed tile, which covers only that tile (+1 pixel as odd rows are shifted by half a node)
+    BOOST_TEST(uploadedRects.size() == changedTiles.size());
+    for(const Rect& rect : uploadedRects)
+    {
+        const MapPoint firstNode(rect.getOrigin().x / 2, rect.getOrigin().y);
+        BOOST_TEST(changedTiles.count(minimap.getTileIdx(firstNode)) == 1u);
+        BOOST_TEST(rect.getSize().x <= TestMinimap::tileSize * 2 + 1);
+        BOOST_TEST(rect.getSize().y <= TestMinimap::tileSize);
+    }
+
+    // Result is the same as calculating the whole minimap
+    TestMinimap fullMinimap(gwv);
+    BOOST_TEST(minimap.getPixels() == fullMinimap.getPixels(), boost::test_tools::per_element());
+}
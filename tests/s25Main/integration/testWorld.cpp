@@ -28,9 +28,11 @@
 #include "worldFixtures/WorldFixture.h"
 #include "world/MapLoader.h"
 #include "nodeObjs/noBase.h"
+#include "gameTypes/Resource.h"
 #include "libsiedler2/ArchivItem_Map_Header.h"
 #include "s25util/tmpFile.h"
 #include <boost/test/unit_test.hpp>
+#include <chrono>
 #include <vector>
 
 struct MapTestFixture
@@ -140,6 +142,56 @@ BOOST_FIXTURE_TEST_CASE(HQPlacement, WorldLoaded1PFixture)
     BOOST_REQUIRE_EQUAL(world.GetNO(worldCreator.hqs[0])->GetGOT(), GOT_NOB_HQ);
 }
 
+namespace {
+bool isResourceNode(const GameWorldBase& world, ResourceSquares::Type type, MapPoint pt)
+{
+    const NodalObjectType nop = world.GetNO(pt)->GetType();
+    return (type == ResourceSquares::TREES && nop == NOP_TREE) || (type == ResourceSquares::GRANITE && nop == NOP_GRANITE)
+           || (type == ResourceSquares::FISH && world.GetNode(pt).resources.has(Resource::Fish));
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(ResourceSquaresMatchWorld, WorldLoadedFixture)
+{
+    const ResourceSquares& squares = world.GetResourceSquares();
+    // Remove some objects and fish to check the updates
+    RTTR_FOREACH_PT(MapPoint, world.GetSize())
+    {
+        if(pt.x % 3 != 0)
+            continue;
+        const NodalObjectType nop = world.GetNO(pt)->GetType();
+        if(nop == NOP_TREE || nop == NOP_GRANITE)
+            world.DestroyNO(pt);
+        if(world.GetNode(pt).resources.has(Resource::Fish))
+            world.SetResource(pt, Resource(Resource::Nothing, 0));
+    }
+    for(unsigned i = 0; i < ResourceSquares::NUM_TYPES; i++)
+    {
+        const auto type = ResourceSquares::Type(i);
+        unsigned numTotal = 0;
+        RTTR_FOREACH_PT(MapPoint, world.GetSize())
+        {
+            if(isResourceNode(world, type, pt))
+                numTotal++;
+        }
+        BOOST_TEST(squares.GetNumTotal(type) == numTotal);
+        RTTR_FOREACH_PT(MapPoint, world.GetSize())
+        {
+            if((pt.x + pt.y) % 7 != 0)
+                continue;
+            for(unsigned radius : {0u, 3u, 8u})
+            {
+                BOOST_TEST_INFO("Type " << i << " at " << pt << " radius " << radius);
+                // Squares may report more but must never miss anything
+                const bool hasAny = world.CheckPointsInRadius(
+                  pt, radius, [&world, type](const MapPoint curPt, unsigned) { return isResourceNode(world, type, curPt); }, true);
+                if(hasAny)
+                    BOOST_TEST_REQUIRE(squares.HasAnyInRange(type, pt, radius));
+            }
+        }
+    }
+}
+
 BOOST_FIXTURE_TEST_CASE(CloseHarborSpots, WorldFixture<UninitializedWorldCreator>)
 {
     loadGameData(world.GetDescriptionWriteable());
@@ -231,4 +283,101 @@ BOOST_FIXTURE_TEST_CASE(CloseHarborSpots, WorldFixture<UninitializedWorldCreator
     }
 }
 
+namespace {
+DescIdx<TerrainDesc> findTerrain(const GameWorldBase& world, TerrainKind kind, bool walkable)
+{
+    DescIdx<TerrainDesc> t(0);
+    for(; t.value < world.GetDescription().terrain.size(); t.value++)
+    {
+        if(world.GetDescription().get(t).kind == kind && world.GetDescription().get(t).Is(ETerrain::Walkable) == walkable)
+            break;
+    }
+    return t;
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(ManyHarborsOnIslands, WorldFixture<UninitializedWorldCreator>)
+{
+    loadGameData(world.GetDescriptionWriteable());
+    const DescIdx<TerrainDesc> tWater = findTerrain(world, TerrainKind::WATER, false);
+    const DescIdx<TerrainDesc> tLand = findTerrain(world, TerrainKind::LAND, true);
+
+    world.Init(MapExtent(160, 160));
+    RTTR_FOREACH_PT(MapPoint, world.GetSize())
+    {
+        MapNode& node = world.GetNodeWriteable(pt);
+        node.t1 = node.t2 = tWater;
+    }
+    // Islands with a harbor each, some with a 2nd harbor sharing the island
+    std::vector<MapPoint> hbPos;
+    for(MapCoord y = 8; y < world.GetHeight(); y += 16)
+    {
+        for(MapCoord x = 8; x < world.GetWidth(); x += 16)
+        {
+            hbPos.push_back(MapPoint(x, y));
+            if((x + y) % 48 == 0)
+                hbPos.push_back(MapPoint(x + 3, y));
+        }
+    }
+    // Split the sea by 2 land bridges so not all harbors can reach each other
+    for(MapCoord x = 0; x < world.GetWidth(); x++)
+    {
+        for(unsigned dir = 0; dir < Direction::COUNT; dir++)
+        {
+            setRightTerrain(world, MapPoint(x, 0), Direction::fromInt(dir), tLand);
+            setRightTerrain(world, MapPoint(x, 80), Direction::fromInt(dir), tLand);
+        }
+    }
+    for(const MapPoint& pt : hbPos)
+    {
+        for(const MapPoint& curPt : world.GetPointsInRadius(pt, 1))
+        {
+            for(unsigned dir = 0; dir < Direction::COUNT; dir++)
+                setRightTerrain(world, curPt, Direction::fromInt(dir), tLand);
+        }
+    }
+
+    using clock = std::chrono::steady_clock;
+    const clock::time_point start = clock::now();
+    BOOST_REQUIRE(MapLoader::InitSeasAndHarbors(world, hbPos));
+    const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - start);
+    BOOST_TEST_MESSAGE("Seas and " << hbPos.size() << " harbors on " << world.GetWidth() << "x" << world.GetHeight()
+                                   << " initialized in " << duration.count() << "ms");
+    BOOST_REQUIRE_EQUAL(world.GetNumHarborPoints(), hbPos.size());
+    for(unsigned startHb = 1; startHb <= world.GetNumHarborPoints(); startHb++)
+    {
+        for(unsigned targetHb = 1; targetHb <= world.GetNumHarborPoints(); targetHb++)
+        {
+            BOOST_TEST_CONTEXT("Harbor " << startHb << " to " << targetHb)
+            {
+                // Distances are symmetric and harbors are only neighbors if they share a sea
+                const unsigned distance = world.CalcHarborDistance(startHb, targetHb);
+                BOOST_TEST_REQUIRE(distance == world.CalcHarborDistance(targetHb, startHb));
+                unsigned short sharedSeaId = 0;
+                for(unsigned dir = 0; dir < Direction::COUNT && !sharedSeaId; dir++)
+                {
+                    const unsigned short seaId = world.GetSeaId(startHb, Direction::fromInt(dir));
+                    if(seaId && world.IsHarborAtSea(targetHb, seaId))
+                        sharedSeaId = seaId;
+                }
+                if(startHb == targetHb)
+                    continue;
+                if(!sharedSeaId)
+                {
+                    BOOST_TEST_REQUIRE(distance == 0xffffffff);
+                    continue;
+                }
+                // Check the distance against a real ship path for some pairs
+                if((startHb + targetHb) % 7 != 0)
+                    continue;
+                const MapPoint startPt = world.GetCoastalPoint(startHb, sharedSeaId);
+                const MapPoint destPt = world.GetCoastalPoint(targetHb, sharedSeaId);
+                std::vector<Direction> route;
+                BOOST_TEST_REQUIRE(world.FindShipPath(startPt, destPt, 10000, &route, nullptr));
+                BOOST_TEST_REQUIRE(route.size() == distance);
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
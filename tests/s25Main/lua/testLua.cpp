@@ -18,8 +18,10 @@
 #include "rttrDefines.h" // IWYU pragma: keep
 #include "GameWithLuaAccess.h"
 #include "PointOutput.h"
+#include "SerializedGameData.h"
 #include "buildings/noBuildingSite.h"
 #include "buildings/nobHQ.h"
+#include "lua/LuaStatistics.h"
 #include "lua/LuaTraits.h" // IWYU pragma: keep
 #include "network/ClientInterface.h"
 #include "network/GameClient.h"
@@ -40,6 +42,7 @@
 #include <boost/test/unit_test.hpp>
 #include <map>
 #include <memory>
+#include <numeric>
 #include <utility>
 #include <vector>
 
@@ -811,6 +814,131 @@ BOOST_AUTO_TEST_CASE(onExplored)
     }
 }
 
+BOOST_AUTO_TEST_CASE(BatchedWorldEvents)
+{
+    const MapPoint pt1(3, 4), pt2(5, 1);
+    LuaInterfaceGame& lua = world.GetLua();
+    executeLua("function onExploredBatch(events)\n"
+               "  for _, e in ipairs(events) do rttr:Log('explored: '..e.player..'('..e.x..', '..e.y..')'..tostring(e.owner)) end\n"
+               "end");
+    executeLua("function onOccupiedBatch(events)\n"
+               "  for _, e in ipairs(events) do rttr:Log('occupied: '..e.player..'('..e.x..', '..e.y..')') end\n"
+               "end");
+    executeLua("function onGameFrame(gameframe_number)\n  rttr:Log('gf: '..gameframe_number)\nend");
+    // Handlers are still readable from lua
+    BOOST_REQUIRE(isLuaEqual("type(onExploredBatch)", "'function'"));
+    clearLog();
+    lua.EventExplored(0, pt1, 0);
+    lua.EventExplored(1, pt2, 2);
+    lua.EventOccupied(1, pt1);
+    // Nothing delivered until the end of the GF and the batches come before onGameFrame
+    BOOST_REQUIRE_EQUAL(getLog(), "");
+    lua.EventGameFrame(1);
+    boost::format explFmt("explored: %1%%2%%3%\n");
+    std::string expectedLog = (explFmt % 0 % pt1 % "nil").str();
+    expectedLog += (explFmt % 1 % pt2 % 1).str();
+    expectedLog += (boost::format("occupied: %1%%2%\n") % 1 % pt1).str();
+    expectedLog += "gf: 1\n";
+    BOOST_REQUIRE_EQUAL(getLog(), expectedLog);
+    // Batches are delivered only once
+    lua.EventGameFrame(2);
+    BOOST_REQUIRE_EQUAL(getLog(), "gf: 2\n");
+
+    // Saving does not deliver pending events but stores them so they are delivered with the next GF after loading
+    lua.EventExplored(1, pt1, 0);
+    lua.EventOccupied(0, pt2);
+    Serializer serData;
+    BOOST_REQUIRE(lua.Serialize(serData));
+    SerializedGameData sgd;
+    lua.SerializeEventBatches(sgd);
+    BOOST_REQUIRE_EQUAL(getLog(), "");
+    const std::string pendingLog =
+      (explFmt % 1 % pt1 % "nil").str() + (boost::format("occupied: %1%%2%\n") % 0 % pt2).str() + "gf: 3\n";
+    lua.EventGameFrame(3);
+    BOOST_REQUIRE_EQUAL(getLog(), pendingLog);
+    lua.DeserializeEventBatches(sgd);
+    lua.EventGameFrame(3);
+    BOOST_REQUIRE_EQUAL(getLog(), pendingLog);
+
+    // Removing and replacing handlers takes effect immediately
+    executeLua("onGameFrame = nil\nonOccupiedBatch = 42");
+    lua.EventOccupied(0, pt2);
+    lua.EventGameFrame(4);
+    BOOST_REQUIRE_EQUAL(getLog(), "");
+    BOOST_REQUIRE(isLuaEqual("onOccupiedBatch", "42"));
+    executeLua("function onGameFrame(gameframe_number)\n  rttr:Log('new gf: '..gameframe_number)\nend");
+    lua.EventGameFrame(5);
+    BOOST_REQUIRE_EQUAL(getLog(), "new gf: 5\n");
+    // Other globals are unaffected
+    executeLua("myGlobal = 1\nrawset(_G, 'myOther', 2)");
+    BOOST_REQUIRE(isLuaEqual("myGlobal + myOther", "3"));
+}
+
+BOOST_AUTO_TEST_CASE(CallbackStatistics)
+{
+    LuaInterfaceGame& lua = world.GetLua();
+    executeLua("function onGameFrame(gf)\n  local x = 0\n  for i = 1, gf do x = x + i end\nend");
+    executeLua("function onStart(isFirstStart)\nend");
+    // Nothing recorded by default
+    lua.EventGameFrame(10);
+    BOOST_REQUIRE(!lua.GetStatistics());
+
+    lua.SetStatisticsEnabled(true);
+    BOOST_REQUIRE(lua.GetStatistics());
+    lua.EventGameFrame(10);
+    lua.EventGameFrame(100000);
+    lua.EventStart(true);
+    // Handlers not defined are not recorded
+    lua.EventOccupied(0, MapPoint(1, 2));
+    const std::vector<LuaStatistics::Entry> entries = lua.GetStatistics()->getEntries();
+    BOOST_REQUIRE_EQUAL(entries.size(), 2u);
+    // Sorted by time
+    BOOST_REQUIRE_EQUAL(entries[0].name, "onGameFrame");
+    BOOST_REQUIRE_EQUAL(entries[0].count, 2u);
+    BOOST_REQUIRE(entries[0].time >= entries[0].maxTime);
+    // Each loop iteration needs multiple instructions
+    BOOST_REQUIRE_GE(entries[0].maxInstructions, 100000u);
+    BOOST_REQUIRE_EQUAL(entries[0].instructions, entries[0].maxInstructions);
+    BOOST_REQUIRE_EQUAL(std::accumulate(entries[0].histogram.begin(), entries[0].histogram.end(), 0u), 2u);
+    BOOST_REQUIRE_EQUAL(entries[1].name, "onStart");
+    BOOST_REQUIRE_EQUAL(entries[1].count, 1u);
+    BOOST_REQUIRE_EQUAL(entries[1].maxInstructions, 0u);
+
+    BOOST_REQUIRE_EQUAL(LuaStatistics::getBucket(std::chrono::microseconds(10)), 0u);
+    BOOST_REQUIRE_EQUAL(LuaStatistics::getBucket(std::chrono::milliseconds(1)), 3u);
+    BOOST_REQUIRE_EQUAL(LuaStatistics::getBucket(std::chrono::seconds(1)), LuaStatistics::NUM_BUCKETS - 1u);
+    BOOST_REQUIRE_EQUAL(LuaStatistics::getBucketName(0), "< 0.1 ms");
+
+    lua.SetStatisticsEnabled(false);
+    BOOST_REQUIRE(!lua.GetStatistics());
+}
+
+BOOST_AUTO_TEST_CASE(InstructionBudget)
+{
+    LuaInterfaceGame& lua = world.GetLua();
+    executeLua("rttr:SetInstructionBudget(50000)");
+    BOOST_REQUIRE_EQUAL(lua.GetInstructionBudget(), 50000u);
+    executeLua("function onGameFrame(gf)\n  local x = 0\n  for i = 1, gf do x = x + i end\n  rttr:Log('gf: '..gf)\nend");
+    clearLog();
+    // Cheap callbacks are not affected
+    lua.EventGameFrame(100);
+    BOOST_REQUIRE_EQUAL(getLog(), "gf: 100\n");
+    BOOST_REQUIRE_THROW(lua.EventGameFrame(100000), LuaExecutionError);
+    BOOST_REQUIRE(getLog().find("instruction budget") != std::string::npos);
+    // Budget is per call and not accumulated
+    std::string expectedLog;
+    for(unsigned i = 0; i < 10; i++)
+    {
+        lua.EventGameFrame(1000);
+        expectedLog += "gf: 1000\n";
+    }
+    BOOST_REQUIRE_EQUAL(getLog(), expectedLog);
+    // Disabled again
+    executeLua("rttr:SetInstructionBudget(0)");
+    lua.EventGameFrame(100000);
+    BOOST_REQUIRE_EQUAL(getLog(), "gf: 100000\n");
+}
+
 BOOST_AUTO_TEST_CASE(LuaPacts)
 {
     initWorld();
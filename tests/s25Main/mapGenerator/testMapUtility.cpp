@@ -16,13 +16,18 @@
 // along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
 
 #include "rttrDefines.h" // IWYU pragma: keep
+#include "mapGenerator/HillRasterizer.h"
 #include "mapGenerator/Map.h"
 #include "mapGenerator/MapUtility.h"
 #include "mapGenerator/ObjectGenerator.h"
 #include "mapGenerator/RandomConfig.h"
+#include "mapGenerator/TileRandom.h"
+#include "mapGenerator/VertexUtility.h"
 #include "gameData/TerrainDesc.h"
 #include "libsiedler2/enumTypes.h"
+#include "rttr/test/random.hpp"
 #include <boost/test/unit_test.hpp>
+#include <algorithm>
 #include <vector>
 
 // LCOV_EXCL_START
@@ -38,9 +43,13 @@ class ObjGenFixture
 protected:
     RandomConfig config;
     MapUtility helper;
+    TileRandom rnd;
 
 public:
-    ObjGenFixture() : helper(config) { BOOST_REQUIRE(config.Init(MapStyle::Random, DescIdx<LandscapeDesc>(0), 0x1337)); }
+    ObjGenFixture() : helper(config), rnd(0x1337, RandStage::Objects, 0)
+    {
+        BOOST_REQUIRE(config.Init(MapStyle::Random, DescIdx<LandscapeDesc>(0), 0x1337));
+    }
 };
 } // namespace
 
@@ -106,6 +115,37 @@ BOOST_AUTO_TEST_CASE(SetHill_Height)
     BOOST_REQUIRE_EQUAL(map.z[0], z);
 }
 
+/**
+ * Tests the HillRasterizer: Every vertex must get the maximum of the heights of all hills
+ * covering it (z - distance) and its previous height, also across the map's boundaries.
+ */
+BOOST_AUTO_TEST_CASE(HillRasterizer_MaxOfHills)
+{
+    const MapExtent size(24, 16);
+    Map map(size, "map", "author");
+    std::vector<unsigned char> expectedZ(size.x * size.y);
+    RTTR_FOREACH_PT(Position, size)
+    {
+        map.z[VertexUtility::GetIndexOf(pt, size)] = expectedZ[VertexUtility::GetIndexOf(pt, size)] = pt.x % 3;
+    }
+
+    HillRasterizer rasterizer(map);
+    // Includes hills bigger than the map
+    for(const int z : {0, 4, 7, 7, 10, 13, 20})
+    {
+        const Position center(rttr::test::randomValue(0, size.x - 1), rttr::test::randomValue(0, size.y - 1));
+        rasterizer.AddHill(center, z);
+        RTTR_FOREACH_PT(Position, size)
+        {
+            const double distance = VertexUtility::Distance(center, pt, size);
+            unsigned char& curZ = expectedZ[VertexUtility::GetIndexOf(pt, size)];
+            if(distance <= z)
+                curZ = std::max(curZ, static_cast<unsigned char>(z - distance));
+        }
+    }
+    BOOST_TEST(map.z == expectedZ, boost::test_tools::per_element());
+}
+
 /**
  * Tests the MapUtility::Smooth method to ensure mountain-meadow textures are
  * replaced by meadow if they have no neighboring mountain-textures.
@@ -357,7 +397,7 @@ BOOST_FIXTURE_TEST_CASE(SetTree_EmptyTerrain, ObjGenFixture)
     Map map(size, "map", "author");
 
     Position p(size / 2);
-    helper.SetTree(map, p);
+    helper.SetTree(map, p, rnd);
 
     BOOST_REQUIRE_NE(map.objectType[p.y * size.x + p.x], libsiedler2::OT_Empty);
     BOOST_REQUIRE_NE(map.objectInfo[p.y * size.x + p.x], libsiedler2::OI_Empty);
@@ -382,7 +422,7 @@ BOOST_FIXTURE_TEST_CASE(SetTree_DesertTerrain, ObjGenFixture)
     }
 
     Position p(size / 2);
-    helper.SetTree(map, p);
+    helper.SetTree(map, p, rnd);
 
     BOOST_REQUIRE_NE(map.objectType[p.y * size.x + p.x], libsiedler2::OT_Empty);
     BOOST_REQUIRE_NE(map.objectInfo[p.y * size.x + p.x], libsiedler2::OI_Empty);
@@ -403,7 +443,7 @@ BOOST_FIXTURE_TEST_CASE(SetTree_NonEmptyTerrain, ObjGenFixture)
     map.objectType[index] = libsiedler2::OT_Stone_Begin;
     map.objectInfo[index] = libsiedler2::OI_Stone1;
 
-    helper.SetTree(map, p);
+    helper.SetTree(map, p, rnd);
 
     BOOST_REQUIRE_EQUAL(map.objectType[index], libsiedler2::OT_Stone_Begin);
     BOOST_REQUIRE_EQUAL(map.objectInfo[index], libsiedler2::OI_Stone1);
@@ -420,7 +460,7 @@ BOOST_FIXTURE_TEST_CASE(SetStone_EmptyTerrain, ObjGenFixture)
     Map map(size, "map", "author");
 
     Position p(size / 2);
-    helper.SetStone(map, p);
+    helper.SetStone(map, p, rnd);
 
     BOOST_REQUIRE_NE(map.objectType[p.y * size.x + p.x], libsiedler2::OT_Empty);
     BOOST_REQUIRE_NE(map.objectInfo[p.y * size.x + p.x], libsiedler2::OI_Empty);
@@ -441,7 +481,7 @@ BOOST_FIXTURE_TEST_CASE(SetStone_NonEmptyTerrain, ObjGenFixture)
     map.objectType[index] = libsiedler2::OT_Tree1_Begin;
     map.objectInfo[index] = libsiedler2::OI_TreeOrPalm;
 
-    helper.SetStone(map, p);
+    helper.SetStone(map, p, rnd);
 
     BOOST_REQUIRE_EQUAL(map.objectType[index], libsiedler2::OT_Tree1_Begin);
     BOOST_REQUIRE_EQUAL(map.objectInfo[index], libsiedler2::OI_TreeOrPalm);
@@ -18,6 +18,7 @@
 #include "rttrDefines.h" // IWYU pragma: keep
 #include "mapGenerator/ObjectGenerator.h"
 #include "mapGenerator/RandomConfig.h"
+#include "mapGenerator/TileRandom.h"
 #include "libsiedler2/enumTypes.h"
 #include <boost/test/unit_test.hpp>
 
@@ -27,9 +28,13 @@ class ObjGenFixture
 protected:
     RandomConfig config;
     ObjectGenerator objGen;
+    TileRandom rnd;
 
 public:
-    ObjGenFixture() : objGen(config) { BOOST_REQUIRE(config.Init(MapStyle::Random, DescIdx<LandscapeDesc>(0), 0x1337)); }
+    ObjGenFixture() : objGen(config), rnd(0x1337, RandStage::Animals, 0)
+    {
+        BOOST_REQUIRE(config.Init(MapStyle::Random, DescIdx<LandscapeDesc>(0), 0x1337));
+    }
 };
 } // namespace
 
@@ -41,7 +46,7 @@ BOOST_AUTO_TEST_SUITE(ObjectGeneratorTest)
  */
 BOOST_FIXTURE_TEST_CASE(CreateDuck_FullLikelyhood, ObjGenFixture)
 {
-    BOOST_REQUIRE_EQUAL(objGen.CreateDuck(100), libsiedler2::A_Duck);
+    BOOST_REQUIRE_EQUAL(objGen.CreateDuck(100, rnd), libsiedler2::A_Duck);
 }
 
 /**
@@ -50,7 +55,7 @@ BOOST_FIXTURE_TEST_CASE(CreateDuck_FullLikelyhood, ObjGenFixture)
  */
 BOOST_FIXTURE_TEST_CASE(CreateDuck_ZeroLikelyhood, ObjGenFixture)
 {
-    BOOST_REQUIRE_EQUAL(objGen.CreateDuck(0), libsiedler2::A_None);
+    BOOST_REQUIRE_EQUAL(objGen.CreateDuck(0, rnd), libsiedler2::A_None);
 }
 
 /**
@@ -19,6 +19,7 @@
 #include "mapGenerator/RandomConfig.h"
 #include <boost/test/unit_test.hpp>
 #include <array>
+#include <vector>
 
 BOOST_AUTO_TEST_SUITE(RandomConfigTest)
 
@@ -41,4 +42,56 @@ BOOST_AUTO_TEST_CASE(MaxHeightBelowTextureCount)
     }
 }
 
+/**
+ * Tests that the random numbers of a vertex only depend on the seed, the stage and the index and stay in range.
+ */
+BOOST_AUTO_TEST_CASE(TileRandom_IndependentOfOrder)
+{
+    RandomConfig config;
+    BOOST_REQUIRE(config.Init(MapStyle::Greenland, DescIdx<LandscapeDesc>(0), 0x1337));
+    const unsigned numIndices = 100;
+    const unsigned numDraws = 10;
+
+    std::vector<int> forward;
+    for(unsigned i = 0; i < numIndices; i++)
+    {
+        TileRandom rnd = config.GetTileRandom(RandStage::Objects, i);
+        for(unsigned j = 0; j < numDraws; j++)
+            forward.push_back(rnd.Rand(-5, 20));
+    }
+    for(int value : forward)
+    {
+        BOOST_TEST(value >= -5);
+        BOOST_TEST(value < 20);
+    }
+
+    // Other order and draws from other stages in between
+    std::vector<int> backward(forward.size());
+    for(unsigned i = numIndices; i-- > 0;)
+    {
+        TileRandom rnd = config.GetTileRandom(RandStage::Objects, i);
+        TileRandom otherStage = config.GetTileRandom(RandStage::Hills, i);
+        for(unsigned j = 0; j < numDraws; j++)
+        {
+            otherStage.Rand(100);
+            backward[i * numDraws + j] = rnd.Rand(-5, 20);
+        }
+    }
+    BOOST_TEST(forward == backward, boost::test_tools::per_element());
+
+    // Different stages and seeds give different numbers
+    TileRandom rnd1 = config.GetTileRandom(RandStage::Objects, 0);
+    TileRandom rnd2 = config.GetTileRandom(RandStage::Animals, 0);
+    TileRandom rnd3(0x1338, RandStage::Objects, 0);
+    unsigned numEqual12 = 0, numEqual13 = 0;
+    for(unsigned j = 0; j < 100; j++)
+    {
+        const int value = rnd1.Rand(1000000);
+        numEqual12 += (value == rnd2.Rand(1000000)) ? 1 : 0;
+        numEqual13 += (value == rnd3.Rand(1000000)) ? 1 : 0;
+    }
+    BOOST_TEST(numEqual12 < 3u);
+    BOOST_TEST(numEqual13 < 3u);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -24,6 +24,7 @@
 #include "gameData/MaxPlayers.h"
 #include "libsiedler2/enumTypes.h"
 #include <boost/test/unit_test.hpp>
+#include <chrono>
 #include <memory>
 #include <vector>
 
@@ -132,4 +133,93 @@ BOOST_AUTO_TEST_CASE(InvalidConfig)
     BOOST_REQUIRE_EQUAL(map.size, MapExtent(32, 34));
 }
 
+namespace {
+Map createMap(MapStyle style, unsigned seed, const MapSettings& settings)
+{
+    RandomConfig config;
+    BOOST_TEST_REQUIRE(config.Init(style, DescIdx<LandscapeDesc>(0), seed));
+    RandomMapGenerator generator(config);
+    return generator.Create(settings);
+}
+} // namespace
+
+/**
+ * Tests that the same seed creates the same map.
+ */
+BOOST_AUTO_TEST_CASE(Create_Reproducible)
+{
+    MapSettings settings;
+    settings.size = MapExtent(64, 48);
+    settings.numPlayers = 3;
+    settings.minPlayerRadius = 0.3;
+    settings.maxPlayerRadius = 0.5;
+
+    for(const MapStyle style : {MapStyle::Greenland, MapStyle::Islands, MapStyle::Random})
+    {
+        const Map map1 = createMap(style, 0x1337, settings);
+        const Map map2 = createMap(style, 0x1337, settings);
+        BOOST_TEST(map1.z == map2.z, boost::test_tools::per_element());
+        BOOST_TEST(map1.textureRsu == map2.textureRsu, boost::test_tools::per_element());
+        BOOST_TEST(map1.textureLsd == map2.textureLsd, boost::test_tools::per_element());
+        BOOST_TEST(map1.objectType == map2.objectType, boost::test_tools::per_element());
+        BOOST_TEST(map1.objectInfo == map2.objectInfo, boost::test_tools::per_element());
+        BOOST_TEST(map1.animal == map2.animal, boost::test_tools::per_element());
+        BOOST_TEST(map1.resource == map2.resource, boost::test_tools::per_element());
+    }
+}
+
+/**
+ * Tests that the generated map does not depend on the number of threads used.
+ */
+BOOST_AUTO_TEST_CASE(Create_IndependentOfThreadCount)
+{
+    MapSettings settings;
+    settings.size = MapExtent(64, 48);
+    settings.numPlayers = 3;
+    settings.minPlayerRadius = 0.3;
+    settings.maxPlayerRadius = 0.5;
+
+    for(const MapStyle style : {MapStyle::Greenland, MapStyle::Islands, MapStyle::Random})
+    {
+        settings.numThreads = 1;
+        const Map map1 = createMap(style, 0x1337, settings);
+        for(const unsigned numThreads : {3u, 7u, 0u})
+        {
+            BOOST_TEST_CONTEXT("Style " << static_cast<int>(style) << ", threads " << numThreads)
+            {
+                settings.numThreads = numThreads;
+                const Map map2 = createMap(style, 0x1337, settings);
+                BOOST_TEST(map1.z == map2.z, boost::test_tools::per_element());
+                BOOST_TEST(map1.textureRsu == map2.textureRsu, boost::test_tools::per_element());
+                BOOST_TEST(map1.textureLsd == map2.textureLsd, boost::test_tools::per_element());
+                BOOST_TEST(map1.objectType == map2.objectType, boost::test_tools::per_element());
+                BOOST_TEST(map1.objectInfo == map2.objectInfo, boost::test_tools::per_element());
+                BOOST_TEST(map1.animal == map2.animal, boost::test_tools::per_element());
+                BOOST_TEST(map1.resource == map2.resource, boost::test_tools::per_element());
+            }
+        }
+    }
+}
+
+// Measures the generation time of big maps. Run explicitly with --run_test=RandomMapGeneratorTest/Create_Benchmark
+BOOST_AUTO_TEST_CASE(Create_Benchmark, *boost::unit_test::disabled())
+{
+    using clock = std::chrono::steady_clock;
+    MapSettings settings;
+    settings.size = MapExtent(1024, 1024);
+    settings.numPlayers = 8;
+    settings.minPlayerRadius = 0.4;
+    settings.maxPlayerRadius = 0.6;
+
+    for(const MapStyle style : {MapStyle::Greenland, MapStyle::Riverland, MapStyle::Islands, MapStyle::Random})
+    {
+        const clock::time_point start = clock::now();
+        const Map map = createMap(style, 0x1337, settings);
+        const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - start);
+        BOOST_TEST(map.size == settings.size);
+        BOOST_TEST_MESSAGE("Map style " << static_cast<int>(style) << " (" << settings.size.x << "x" << settings.size.y << ", "
+                                        << settings.numPlayers << " players): " << duration.count() << "ms");
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
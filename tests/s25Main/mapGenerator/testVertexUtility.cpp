@@ -17,7 +17,11 @@
 
 #include "rttrDefines.h" // IWYU pragma: keep
 #include "mapGenerator/VertexUtility.h"
+#include "rttr/test/random.hpp"
 #include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <vector>
 
 BOOST_AUTO_TEST_SUITE(VertexUtilityTest)
@@ -129,4 +133,35 @@ BOOST_FIXTURE_TEST_CASE(Distance_BoundaryNeighbors, VertexUtility)
     BOOST_REQUIRE_LT(distance, 2.0);
 }
 
+/**
+ * Tests the VertexUtility::SquaredDistanceField function against the minimum of the distances
+ * to all sources, including distances across the map's boundaries.
+ */
+BOOST_AUTO_TEST_CASE(SquaredDistanceField_MatchesDistance)
+{
+    for(const MapExtent size : {MapExtent(16, 16), MapExtent(17, 10), MapExtent(3, 40)})
+    {
+        BOOST_TEST_CONTEXT("Size " << size.x << "x" << size.y)
+        {
+            BOOST_TEST(VertexUtility::SquaredDistanceField({}, size)
+                       == std::vector<unsigned>(size.x * size.y, VertexUtility::DIST_INFINITE),
+                       boost::test_tools::per_element());
+            for(unsigned numSources = 1; numSources <= 8; numSources++)
+            {
+                std::vector<Position> sources;
+                for(unsigned i = 0; i < numSources; i++)
+                    sources.push_back(Position(rttr::test::randomValue(0, size.x - 1), rttr::test::randomValue(0, size.y - 1)));
+                const std::vector<unsigned> field = VertexUtility::SquaredDistanceField(sources, size);
+                RTTR_FOREACH_PT(Position, size)
+                {
+                    double expectedDistance = std::numeric_limits<double>::max();
+                    for(const Position& source : sources)
+                        expectedDistance = std::min(expectedDistance, VertexUtility::Distance(pt, source, size));
+                    BOOST_TEST_REQUIRE(std::sqrt(field[VertexUtility::GetIndexOf(pt, size)]) == expectedDistance);
+                }
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
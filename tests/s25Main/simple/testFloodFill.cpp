@@ -0,0 +1,142 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "PointOutput.h"
+#include "world/FloodFill.h"
+#include "world/MapGeometry.h"
+#include "rttr/test/random.hpp"
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <queue>
+#include <vector>
+
+namespace {
+std::vector<Position> getNeighbors(const MapPoint pt, FloodFillNeighbors neighbors)
+{
+    std::vector<Position> result;
+    if(neighbors == FloodFillNeighbors::Hexagonal)
+    {
+        for(unsigned dir = 0; dir < Direction::COUNT; ++dir)
+            result.push_back(GetNeighbour(Position(pt), Direction::fromInt(dir)));
+    } else
+    {
+        const Position p(pt);
+        result = {Position(p.x - 1, p.y), Position(p.x + 1, p.y), Position(p.x, p.y - 1), Position(p.x, p.y + 1)};
+    }
+    return result;
+}
+
+/// Simple BFS labeling the components in the same order as LabelComponents
+std::vector<unsigned> labelComponentsByBFS(const MapExtent& size, FloodFillNeighbors neighbors, const std::vector<bool>& isPart,
+                                           std::vector<unsigned>& labels)
+{
+    std::vector<unsigned> componentSizes;
+    labels.assign(isPart.size(), 0u);
+    RTTR_FOREACH_PT(MapPoint, size)
+    {
+        const unsigned idx = pt.y * size.x + pt.x;
+        if(!isPart[idx] || labels[idx])
+            continue;
+        const auto label = static_cast<unsigned>(componentSizes.size() + 1u);
+        unsigned count = 0;
+        std::queue<MapPoint> todo;
+        todo.push(pt);
+        labels[idx] = label;
+        while(!todo.empty())
+        {
+            const MapPoint curPt = todo.front();
+            todo.pop();
+            ++count;
+            for(const Position& neighbor : getNeighbors(curPt, neighbors))
+            {
+                const MapPoint nbPt = MakeMapPoint(neighbor, size);
+                const unsigned nbIdx = nbPt.y * size.x + nbPt.x;
+                if(isPart[nbIdx] && !labels[nbIdx])
+                {
+                    labels[nbIdx] = label;
+                    todo.push(nbPt);
+                }
+            }
+        }
+        componentSizes.push_back(count);
+    }
+    return componentSizes;
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(FloodFillSuite)
+
+BOOST_AUTO_TEST_CASE(LabelAndCountLikeBFS)
+{
+    for(unsigned i = 0; i < 200; i++)
+    {
+        // Include odd and tiny sizes to check the wrapping
+        MapExtent size = rttr::test::randomPoint<MapExtent>(1, 24);
+        const FloodFillNeighbors neighbors = (i % 2) ? FloodFillNeighbors::Hexagonal : FloodFillNeighbors::Orthogonal;
+        // Hexagonal neighbours are only symmetric for an even height (as on all maps)
+        if(neighbors == FloodFillNeighbors::Hexagonal)
+            size.y = static_cast<MapCoord>(std::max(2, size.y & ~1));
+        const int density = rttr::test::randomValue(0, 100);
+        std::vector<bool> isPart(prodOfComponents(size));
+        for(unsigned j = 0; j < isPart.size(); j++)
+            isPart[j] = rttr::test::randomValue(0, 99) < density;
+        const auto isPartFunc = [&isPart, &size](const MapPoint pt) { return static_cast<bool>(isPart[pt.y * size.x + pt.x]); };
+
+        BOOST_TEST_CONTEXT("Size " << size << ", hexagonal " << (i % 2) << ", density " << density)
+        {
+            std::vector<unsigned> expectedLabels;
+            const std::vector<unsigned> expectedSizes = labelComponentsByBFS(size, neighbors, isPart, expectedLabels);
+            std::vector<unsigned> labels;
+            const std::vector<unsigned> componentSizes = LabelComponents(size, neighbors, isPartFunc, labels);
+            BOOST_TEST(componentSizes == expectedSizes, boost::test_tools::per_element());
+            BOOST_TEST(labels == expectedLabels, boost::test_tools::per_element());
+
+            RTTR_FOREACH_PT(MapPoint, size)
+            {
+                const unsigned label = labels[pt.y * size.x + pt.x];
+                if(!label)
+                    continue;
+                const unsigned compSize = componentSizes[label - 1];
+                BOOST_TEST(CountComponent(size, neighbors, pt, isPartFunc) == compSize);
+                const unsigned maxCount = rttr::test::randomValue(1u, compSize + 1u);
+                BOOST_TEST(CountComponent(size, neighbors, pt, isPartFunc, maxCount) == std::min(compSize, maxCount));
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(WrappingComponents)
+{
+    const MapExtent size(10, 8);
+    // A ring around the map in x direction and a column around it in y direction
+    std::vector<unsigned> labels;
+    const auto isRowOrColumn = [](const MapPoint pt) { return pt.y == 3 || pt.x == 6; };
+    const std::vector<unsigned> componentSizes = LabelComponents(size, FloodFillNeighbors::Orthogonal, isRowOrColumn, labels);
+    BOOST_TEST_REQUIRE(componentSizes.size() == 1u);
+    BOOST_TEST(componentSizes[0] == 10u + 8u - 1u);
+    BOOST_TEST(CountComponent(size, FloodFillNeighbors::Hexagonal, MapPoint(0, 3), isRowOrColumn) == 10u + 8u - 1u);
+
+    // Nothing is part
+    const auto isNothing = [](MapPoint) { return false; };
+    BOOST_TEST(LabelComponents(size, FloodFillNeighbors::Hexagonal, isNothing, labels).empty());
+    BOOST_TEST(labels.size() == prodOfComponents(size));
+    BOOST_TEST(std::all_of(labels.begin(), labels.end(), [](unsigned label) { return label == 0u; }));
+    BOOST_TEST(CountComponent(size, FloodFillNeighbors::Hexagonal, MapPoint(0, 0), isNothing) == 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
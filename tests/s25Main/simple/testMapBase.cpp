@@ -22,6 +22,7 @@
 #include "gameData/MapConsts.h"
 #include <boost/assign/std/vector.hpp>
 #include <boost/test/unit_test.hpp>
+#include <algorithm>
 
 BOOST_AUTO_TEST_SUITE(WorldCreationSuite)
 
@@ -127,4 +128,38 @@ BOOST_AUTO_TEST_CASE(GetIdx)
     BOOST_REQUIRE_EQUAL(world.GetIdx(MapPoint(MAX_MAP_SIZE - 1, MAX_MAP_SIZE - 3)), MAX_MAP_SIZE * (MAX_MAP_SIZE - 2u) - 1u);
 }
 
+BOOST_AUTO_TEST_CASE(RadiusRanges)
+{
+    MapBase world;
+    world.Resize(MapExtent(20, 30));
+    const MapPoint center(3, 28);
+    for(unsigned radius = 0; radius <= 5; radius++)
+    {
+        BOOST_TEST_INFO("Radius " << radius);
+        const std::vector<MapPoint> expectedPts = world.GetPointsInRadius(center, radius);
+        const MapRadiusRange range = world.PointsInRadius(center, radius);
+        const std::vector<MapPoint> pts(range.begin(), range.end());
+        BOOST_TEST(pts == expectedPts, boost::test_tools::per_element());
+
+        const std::vector<MapPoint> expectedPtsWithCenter = world.GetPointsInRadiusWithCenter(center, radius);
+        const MapRadiusRange rangeWithCenter = world.PointsInRadius(center, radius, true);
+        std::vector<MapPoint> ptsWithCenter;
+        for(auto it = rangeWithCenter.begin(); it != rangeWithCenter.end(); ++it)
+        {
+            BOOST_TEST(world.CalcDistance(center, *it) == it.GetRadius());
+            ptsWithCenter.push_back(*it);
+        }
+        BOOST_TEST(ptsWithCenter == expectedPtsWithCenter, boost::test_tools::per_element());
+
+        // The ring contains the last 6 * radius points (or only the center)
+        const MapRadiusRange ring = world.PointsOnRing(center, radius);
+        const std::vector<MapPoint> ringPts(ring.begin(), ring.end());
+        BOOST_TEST_REQUIRE(ringPts.size() == std::max(6u * radius, 1u));
+        BOOST_TEST(std::equal(ringPts.begin(), ringPts.end(), expectedPtsWithCenter.end() - ringPts.size()));
+    }
+    // Empty range
+    const MapRadiusRange range = world.PointsInRadius(center, 0);
+    BOOST_TEST((range.begin() == range.end()));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
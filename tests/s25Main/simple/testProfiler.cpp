@@ -0,0 +1,135 @@
+// Copyright (c) 2019 - 2019 Settlers Freaks (sf-team at siedler25.org)
+//
+// This file is part of Return To The Roots.
+//
+// Return To The Roots is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Return To The Roots is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Return To The Roots. If not, see <http://www.gnu.org/licenses/>.
+
+#include "rttrDefines.h" // IWYU pragma: keep
+#include "Profiler.h"
+#include <rttr/test/MockClock.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/nowide/fstream.hpp>
+#include <boost/test/unit_test.hpp>
+#include <helpers/chronoIO.h>
+#include <string>
+#include <thread>
+
+namespace {
+struct ProfilerFixture : rttr::test::MockClockFixture
+{
+    ProfilerFixture()
+    {
+        Profiler::clear();
+        Profiler::setEnabled(true);
+    }
+    ~ProfilerFixture()
+    {
+        Profiler::setEnabled(false);
+        Profiler::clear();
+    }
+};
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(ProfilerSuite)
+
+BOOST_FIXTURE_TEST_CASE(ScopesRecordDurations, ProfilerFixture)
+{
+    using namespace std::chrono;
+    for(unsigned i = 1; i <= 3; i++)
+    {
+        ProfilingScope scope(ProfilingZone::AI);
+        currentTime += milliseconds(i);
+        {
+            ProfilingScope innerScope(ProfilingZone::Events);
+            currentTime += microseconds(500);
+        }
+    }
+    std::vector<Profiler::duration> durations = Profiler::getRecentDurations(ProfilingZone::AI, 10);
+    BOOST_TEST_REQUIRE(durations.size() == 3u);
+    BOOST_TEST(durations[0] == microseconds(1500));
+    BOOST_TEST(durations[1] == microseconds(2500));
+    BOOST_TEST(durations[2] == microseconds(3500));
+    // Only the most recent ones
+    durations = Profiler::getRecentDurations(ProfilingZone::AI, 2);
+    BOOST_TEST_REQUIRE(durations.size() == 2u);
+    BOOST_TEST(durations[0] == microseconds(2500));
+    BOOST_TEST(durations[1] == microseconds(3500));
+    durations = Profiler::getRecentDurations(ProfilingZone::Events, 10);
+    BOOST_TEST_REQUIRE(durations.size() == 3u);
+    for(const Profiler::duration& curDuration : durations)
+        BOOST_TEST(curDuration == microseconds(500));
+    BOOST_TEST(Profiler::getRecentDurations(ProfilingZone::Terrain, 10).empty());
+
+    // Nothing recorded when disabled
+    Profiler::setEnabled(false);
+    {
+        ProfilingScope scope(ProfilingZone::AI);
+        currentTime += milliseconds(1);
+    }
+    BOOST_TEST(Profiler::getRecentDurations(ProfilingZone::AI, 10).size() == 3u);
+    Profiler::clear();
+    BOOST_TEST(Profiler::getRecentDurations(ProfilingZone::AI, 10).empty());
+}
+
+BOOST_FIXTURE_TEST_CASE(RingBufferKeepsNewest, ProfilerFixture)
+{
+    using namespace std::chrono;
+    const unsigned bufferSize = Profiler::BUFFER_SIZE;
+    const unsigned numSamples = bufferSize + 10;
+    for(unsigned i = 0; i < numSamples; i++)
+    {
+        const Clock::time_point start = Clock::now();
+        currentTime += microseconds(i);
+        Profiler::addSample(ProfilingZone::Minimap, start, Clock::now());
+    }
+    const std::vector<Profiler::duration> durations = Profiler::getRecentDurations(ProfilingZone::Minimap, numSamples);
+    BOOST_TEST_REQUIRE(durations.size() == bufferSize);
+    BOOST_TEST(durations.front() == microseconds(10));
+    BOOST_TEST(durations.back() == microseconds(numSamples - 1));
+}
+
+BOOST_FIXTURE_TEST_CASE(SamplesFromAllThreads, ProfilerFixture)
+{
+    const Clock::time_point start = Clock::now();
+    Profiler::addSample(ProfilingZone::Windows, start, start + std::chrono::milliseconds(1));
+    std::thread worker(
+      [start]() { Profiler::addSample(ProfilingZone::Windows, start + std::chrono::seconds(1), start + std::chrono::seconds(3)); });
+    worker.join();
+    const std::vector<Profiler::duration> durations = Profiler::getRecentDurations(ProfilingZone::Windows, 10);
+    BOOST_TEST_REQUIRE(durations.size() == 2u);
+    // Sorted by start time
+    BOOST_TEST(durations[0] == std::chrono::milliseconds(1));
+    BOOST_TEST(durations[1] == std::chrono::seconds(2));
+}
+
+BOOST_FIXTURE_TEST_CASE(WriteChromeTrace, ProfilerFixture)
+{
+    using namespace std::chrono;
+    currentTime = milliseconds(2);
+    {
+        ProfilingScope scope(ProfilingZone::Terrain);
+        currentTime += microseconds(1500);
+    }
+    const bfs::path tracePath = bfs::absolute(bfs::unique_path("%%%%-%%%%.json"));
+    BOOST_TEST_REQUIRE(Profiler::writeChromeTrace(tracePath));
+    bnw::ifstream file(tracePath);
+    const std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+    bfs::remove(tracePath);
+    BOOST_TEST(content.find("{\"traceEvents\":[") == 0u);
+    BOOST_TEST(content.find("\"name\":\"Terrain\",\"cat\":\"rttr\",\"ph\":\"X\"") != std::string::npos);
+    BOOST_TEST(content.find("\"ts\":2000.000,\"dur\":1500.000}") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -20,11 +20,17 @@
 #include "random/Random.h"
 #include <rttr/test/random.hpp>
 #include <iostream>
+#include <mutex>
 
 void initGameRNG(unsigned defaultValue /*= 1337*/)
 {
 #ifdef RTTR_RAND_TEST
-    defaultValue += rttr::test::randomValue<unsigned>();
+    // Might be called from multiple threads (e.g. AI simulations) but the test RNG is shared
+    static std::mutex randMutex;
+    {
+        std::lock_guard<std::mutex> lock(randMutex);
+        defaultValue += rttr::test::randomValue<unsigned>();
+    }
 #endif
     RANDOM.Init(defaultValue);
 }
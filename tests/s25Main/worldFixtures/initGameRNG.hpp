@@ -18,7 +18,7 @@
 #ifndef initGameRNG_h__
 #define initGameRNG_h__
 
-/// Initialize the ingame-Random Number Generator with the given value
+/// Initialize the ingame-Random Number Generator of the current thread with the given value
 /// unless RTTR_RAND_TEST is defined in which case a random value is used
 void initGameRNG(unsigned defaultValue = 1337);
 